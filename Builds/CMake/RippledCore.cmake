@@ -52,6 +52,7 @@ target_sources (xrpl_core PRIVATE
   src/ripple/basics/impl/Log.cpp
   src/ripple/basics/impl/strHex.cpp
   src/ripple/basics/impl/StringUtilities.cpp
+  src/ripple/basics/impl/ThreadLocalPool.cpp
   #[===============================[
     main sources:
       subdir: json
@@ -90,7 +91,9 @@ target_sources (xrpl_core PRIVATE
   src/ripple/protocol/impl/STBase.cpp
   src/ripple/protocol/impl/STBlob.cpp
   src/ripple/protocol/impl/STInteger.cpp
+  src/ripple/protocol/impl/STJsonWriter.cpp
   src/ripple/protocol/impl/STLedgerEntry.cpp
+  src/ripple/protocol/impl/STLedgerEntryView.cpp
   src/ripple/protocol/impl/STObject.cpp
   src/ripple/protocol/impl/STParsedJSON.cpp
   src/ripple/protocol/impl/STPathSet.cpp
@@ -158,6 +161,7 @@ install (
     src/ripple/basics/safe_cast.h
     src/ripple/basics/Slice.h
     src/ripple/basics/StringUtilities.h
+    src/ripple/basics/ThreadLocalPool.h
     src/ripple/basics/ToString.h
     src/ripple/basics/UnorderedContainers.h
     src/ripple/basics/XRPAmount.h
@@ -190,6 +194,7 @@ install (
 install (
   FILES
     src/ripple/json/impl/json_assert.h
+    src/ripple/json/impl/json_scan.h
   DESTINATION include/ripple/json/impl)
 install (
   FILES
@@ -221,7 +226,9 @@ install (
     src/ripple/protocol/STBlob.h
     src/ripple/protocol/STExchange.h
     src/ripple/protocol/STInteger.h
+    src/ripple/protocol/STJsonWriter.h
     src/ripple/protocol/STLedgerEntry.h
+    src/ripple/protocol/STLedgerEntryView.h
     src/ripple/protocol/STObject.h
     src/ripple/protocol/STParsedJSON.h
     src/ripple/protocol/STPathSet.h
@@ -333,6 +340,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/ledger/AcceptedLedger.cpp
   src/ripple/app/ledger/AcceptedLedgerTx.cpp
   src/ripple/app/ledger/AccountStateSF.cpp
+  src/ripple/app/ledger/BookIndex.cpp
   src/ripple/app/ledger/BookListeners.cpp
   src/ripple/app/ledger/ConsensusTransSetSF.cpp
   src/ripple/app/ledger/Ledger.cpp
@@ -419,6 +427,7 @@ target_sources (rippled PRIVATE
   src/ripple/app/tx/impl/SetSignerList.cpp
   src/ripple/app/tx/impl/SetTrust.cpp
   src/ripple/app/tx/impl/SignerEntries.cpp
+  src/ripple/app/tx/impl/SpeculativeApply.cpp
   src/ripple/app/tx/impl/Taker.cpp
   src/ripple/app/tx/impl/Transactor.cpp
   src/ripple/app/tx/impl/apply.cpp
@@ -504,14 +513,17 @@ target_sources (rippled PRIVATE
   src/ripple/nodestore/backend/NullFactory.cpp
   src/ripple/nodestore/backend/RocksDBFactory.cpp
   src/ripple/nodestore/impl/BatchWriter.cpp
+  src/ripple/nodestore/impl/BloomFilter.cpp
   src/ripple/nodestore/impl/Database.cpp
   src/ripple/nodestore/impl/DatabaseNodeImp.cpp
   src/ripple/nodestore/impl/DatabaseRotatingImp.cpp
+  src/ripple/nodestore/impl/DatabaseTieredImp.cpp
   src/ripple/nodestore/impl/DatabaseShardImp.cpp
   src/ripple/nodestore/impl/DeterministicShard.cpp
   src/ripple/nodestore/impl/DecodedBlob.cpp
   src/ripple/nodestore/impl/DummyScheduler.cpp
   src/ripple/nodestore/impl/EncodedBlob.cpp
+  src/ripple/nodestore/impl/FetchStats.cpp
   src/ripple/nodestore/impl/ManagerImp.cpp
   src/ripple/nodestore/impl/NodeObject.cpp
   src/ripple/nodestore/impl/Shard.cpp
@@ -620,6 +632,7 @@ target_sources (rippled PRIVATE
   src/ripple/rpc/impl/LegacyPathFind.cpp
   src/ripple/rpc/impl/RPCHandler.cpp
   src/ripple/rpc/impl/RPCHelpers.cpp
+  src/ripple/rpc/impl/ResponseStream.cpp
   src/ripple/rpc/impl/Role.cpp
   src/ripple/rpc/impl/ServerHandlerImp.cpp
   src/ripple/rpc/impl/ShardArchiveHandler.cpp
@@ -672,6 +685,7 @@ target_sources (rippled PRIVATE
   src/test/app/MultiSign_test.cpp
   src/test/app/OfferStream_test.cpp
   src/test/app/Offer_test.cpp
+  src/test/app/OrderBookDB_test.cpp
   src/test/app/OversizeMeta_test.cpp
   src/test/app/Path_test.cpp
   src/test/app/PayChan_test.cpp
@@ -680,10 +694,12 @@ target_sources (rippled PRIVATE
   src/test/app/RCLCensorshipDetector_test.cpp
   src/test/app/RCLValidations_test.cpp
   src/test/app/Regression_test.cpp
+  src/test/app/RippleLineCache_test.cpp
   src/test/app/SHAMapStore_test.cpp
   src/test/app/SetAuth_test.cpp
   src/test/app/SetRegularKey_test.cpp
   src/test/app/SetTrust_test.cpp
+  src/test/app/SpeculativeApply_test.cpp
   src/test/app/Taker_test.cpp
   src/test/app/TheoreticalQuality_test.cpp
   src/test/app/Ticket_test.cpp
@@ -698,6 +714,7 @@ target_sources (rippled PRIVATE
      test sources:
        subdir: basics
   #]===============================]
+  src/test/basics/BucketQueue_test.cpp
   src/test/basics/Buffer_test.cpp
   src/test/basics/DetectCrash_test.cpp
   src/test/basics/FileUtilities_test.cpp
@@ -708,6 +725,7 @@ target_sources (rippled PRIVATE
   src/test/basics/Slice_test.cpp
   src/test/basics/StringUtilities_test.cpp
   src/test/basics/TaggedCache_test.cpp
+  src/test/basics/ThreadLocalPool_test.cpp
   src/test/basics/XRPAmount_test.cpp
   src/test/basics/base64_test.cpp
   src/test/basics/base_uint_test.cpp
@@ -778,6 +796,7 @@ target_sources (rippled PRIVATE
   src/test/json/Object_test.cpp
   src/test/json/Output_test.cpp
   src/test/json/Writer_test.cpp
+  src/test/json/json_reader_test.cpp
   src/test/json/json_value_test.cpp
   #[===============================[
      test sources:
@@ -826,6 +845,7 @@ target_sources (rippled PRIVATE
        subdir: ledger
   #]===============================]
   src/test/ledger/BookDirs_test.cpp
+  src/test/ledger/BookIndex_test.cpp
   src/test/ledger/CashDiff_test.cpp
   src/test/ledger/Directory_test.cpp
   src/test/ledger/Invariants_test.cpp
@@ -838,12 +858,14 @@ target_sources (rippled PRIVATE
        subdir: net
   #]===============================]
   src/test/net/DatabaseDownloader_test.cpp
+  src/test/net/InfoSub_test.cpp
   #[===============================[
      test sources:
        subdir: nodestore
   #]===============================]
   src/test/nodestore/Backend_test.cpp
   src/test/nodestore/Basics_test.cpp
+  src/test/nodestore/Benchmark_test.cpp
   src/test/nodestore/DatabaseShard_test.cpp
   src/test/nodestore/Database_test.cpp
   src/test/nodestore/Timing_test.cpp
@@ -877,12 +899,17 @@ target_sources (rippled PRIVATE
   src/test/protocol/Quality_test.cpp
   src/test/protocol/STAccount_test.cpp
   src/test/protocol/STAmount_test.cpp
+  src/test/protocol/STJsonWriter_test.cpp
+  src/test/protocol/STLedgerEntryView_test.cpp
   src/test/protocol/STObject_test.cpp
+  src/test/protocol/STObjectFieldAccess_test.cpp
   src/test/protocol/STTx_test.cpp
+  src/test/protocol/STTxAllocation_test.cpp
   src/test/protocol/STValidation_test.cpp
   src/test/protocol/SecretKey_test.cpp
   src/test/protocol/Seed_test.cpp
   src/test/protocol/SeqProxy_test.cpp
+  src/test/protocol/Serializer_test.cpp
   src/test/protocol/TER_test.cpp
   src/test/protocol/types_test.cpp
   #[===============================[
@@ -921,6 +948,7 @@ target_sources (rippled PRIVATE
   src/test/rpc/OwnerInfo_test.cpp
   src/test/rpc/Peers_test.cpp
   src/test/rpc/ReportingETL_test.cpp
+  src/test/rpc/ResponseStream_test.cpp
   src/test/rpc/Roles_test.cpp
   src/test/rpc/RPCCall_test.cpp
   src/test/rpc/RPCOverload_test.cpp
@@ -942,6 +970,7 @@ target_sources (rippled PRIVATE
        subdir: server
   #]===============================]
   src/test/server/ServerStatus_test.cpp
+  src/test/server/WSBatch_test.cpp
   src/test/server/Server_test.cpp
   #[===============================[
      test sources:
@@ -0,0 +1,202 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/BookIndex.h>
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/basics/Log.h>
+#include <ripple/ledger/View.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/shamap/SHAMapMissingNode.h>
+#include <algorithm>
+
+namespace ripple {
+
+bool
+BookIndex::isQualityRange(uint256 const& key, uint256 const& last)
+{
+    auto const base = keylet::quality({ltDIR_NODE, key}, 0).key;
+    return last == getQualityNext(base);
+}
+
+std::optional<uint256>
+BookIndex::succ(uint256 const& key, uint256 const& last)
+{
+    if (auto const keys =
+            directories(keylet::quality({ltDIR_NODE, key}, 0).key))
+    {
+        auto const it = std::upper_bound(keys->begin(), keys->end(), key);
+        if (it == keys->end() || *it >= last)
+            return std::nullopt;
+        return *it;
+    }
+
+    // Leave a missing node, or a book past maxBooks, to the state map, as
+    // an unindexed view would
+    auto const& map = ledger_.stateMap();
+    auto const item = map.upper_bound(key);
+    if (item == map.end() || item->key() >= last)
+        return std::nullopt;
+    return item->key();
+}
+
+std::optional<BookIndex::Offers>
+BookIndex::offers(Book const& book, std::size_t limit, beast::Journal j)
+{
+    if (limit > maxOffers)
+        return std::nullopt;
+
+    auto const base = getBookBase(book);
+    std::shared_ptr<BookOffers> entry;
+    {
+        std::lock_guard lock(mutex_);
+        if (auto const it = offers_.find(base); it != offers_.end())
+            entry = it->second;
+        else if (offers_.size() < maxBooks)
+            entry = offers_.emplace(base, std::make_shared<BookOffers>())
+                        .first->second;
+        else
+            return std::nullopt;
+    }
+
+    std::lock_guard lock(entry->mutex);
+    if (!entry->dirs && !entry->failed)
+    {
+        entry->dirs = directories(base);
+        entry->failed = !entry->dirs;
+    }
+    if (!entry->failed && !entry->done && entry->offers.size() < limit)
+        read(*entry, book, limit, j);
+    if (entry->failed)
+        return std::nullopt;
+
+    auto const& offers = entry->offers;
+    return Offers(
+        offers.begin(), offers.begin() + std::min(limit, offers.size()));
+}
+
+void
+BookIndex::read(
+    BookOffers& book,
+    Book const& issues,
+    std::size_t limit,
+    beast::Journal j)
+{
+    try
+    {
+        auto const& dirs = *book.dirs;
+        while (book.offers.size() < limit)
+        {
+            if (book.dir == dirs.size())
+            {
+                book.done = true;
+                return;
+            }
+
+            auto const& dir = dirs[book.dir];
+            if (!book.page &&
+                !cdirFirst(ledger_, dir, book.page, book.entry, book.index, j))
+            {
+                book.page.reset();
+                ++book.dir;
+                continue;
+            }
+
+            if (auto sle = ledger_.read(keylet::offer(book.index)))
+            {
+                auto const owner = sle->getAccountID(sfAccount);
+                auto it = book.funds.find(owner);
+                if (it == book.funds.end())
+                {
+                    auto held = accountHolds(
+                        ledger_,
+                        owner,
+                        issues.out.currency,
+                        issues.out.account,
+                        fhZERO_IF_FROZEN,
+                        j);
+                    if (held < beast::zero)
+                        held.clear();
+                    it = book.funds.emplace(owner, held).first;
+                }
+                book.offers.push_back(
+                    {std::move(sle), getQuality(dir), it->second});
+            }
+            else
+            {
+                JLOG(j.warn()) << "Missing offer " << book.index;
+            }
+
+            if (!cdirNext(ledger_, dir, book.page, book.entry, book.index, j))
+            {
+                book.page.reset();
+                ++book.dir;
+            }
+        }
+    }
+    catch (SHAMapMissingNode const&)
+    {
+        book.failed = true;
+    }
+}
+
+std::size_t
+BookIndex::size() const
+{
+    std::lock_guard lock(mutex_);
+    return directories_.size();
+}
+
+BookIndex::Keys
+BookIndex::directories(uint256 const& base)
+{
+    {
+        std::lock_guard lock(mutex_);
+        if (auto const it = directories_.find(base); it != directories_.end())
+            return it->second;
+        if (directories_.size() >= maxBooks)
+            return nullptr;
+    }
+
+    // Another thread may be doing the same, and the first to finish wins
+    auto keys = std::make_shared<std::vector<uint256>>();
+    try
+    {
+        auto const end = getQualityNext(base);
+        auto const& map = ledger_.stateMap();
+        auto before = base;
+        --before;
+        for (auto it = map.upper_bound(before);
+             it != map.end() && it->key() < end;
+             ++it)
+            keys->push_back(it->key());
+    }
+    catch (SHAMapMissingNode const&)
+    {
+        // Remember the failure, so that every step of a walk doesn't scan
+        // the book again before going to the state map
+        std::lock_guard lock(mutex_);
+        directories_.emplace(base, nullptr);
+        return nullptr;
+    }
+
+    std::lock_guard lock(mutex_);
+    return directories_.emplace(base, std::move(keys)).first->second;
+}
+
+}  // namespace ripple
@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_APP_LEDGER_BOOKINDEX_H_INCLUDED
+#define RIPPLE_APP_LEDGER_BOOKINDEX_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/protocol/Book.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace ripple {
+
+class Ledger;
+
+/** The order books of an immutable ledger, indexed as they are walked.
+
+    Walking a book asks the state map for the next quality directory at
+    every step, and each walk of a book starts at its top.  A closed ledger
+    never changes, so the directories of a book are looked up once, when
+    the book is first walked, and the lookups of every later walk are
+    binary searches of them.  Since views pass the lookups down to the
+    ledger they are built on, this serves BookTip and the payment engine
+    as well as book_offers.
+
+    book_offers also takes the offers of a book, with what their owners
+    hold, from here.
+
+    The index must only be used once the ledger is immutable.
+*/
+class BookIndex
+{
+public:
+    struct Offer
+    {
+        std::shared_ptr<SLE const> sle;
+
+        // The quality of the offer's directory
+        std::uint64_t quality;
+
+        // What the owner holds of TakerGets, or zero if that is negative
+        // or frozen
+        STAmount ownerFunds;
+    };
+
+    using Offers = std::vector<Offer>;
+
+    explicit BookIndex(Ledger const& ledger) : ledger_(ledger)
+    {
+    }
+
+    BookIndex(BookIndex const&) = delete;
+    BookIndex&
+    operator=(BookIndex const&) = delete;
+
+    /** Returns `true` if [key, last) is the quality range of a book. */
+    static bool
+    isQualityRange(uint256 const& key, uint256 const& last);
+
+    /** Returns the first key of the ledger after `key` and before `last`.
+
+        The range must be the quality range of a book, or part of one.
+    */
+    std::optional<uint256>
+    succ(uint256 const& key, uint256 const& last);
+
+    /** Returns the best `limit` offers of a book, best first.
+
+        Offers are read from the ledger only as far as they are asked for,
+        and reading resumes there when more are.  Returns nothing if the
+        book is to be walked instead: if `limit` is above maxOffers, if
+        maxBooks other books are indexed already, or if a node of the
+        ledger is missing.
+    */
+    std::optional<Offers>
+    offers(Book const& book, std::size_t limit, beast::Journal j);
+
+    /** Returns the number of books whose directories were looked up.
+
+        This includes books which couldn't be indexed for a missing node.
+    */
+    std::size_t
+    size() const;
+
+    /** The most offers kept of a book. */
+    static constexpr std::size_t maxOffers = 400;
+
+    /** The most books whose directories, or offers, are kept. */
+    static constexpr std::size_t maxBooks = 256;
+
+private:
+    using Keys = std::shared_ptr<std::vector<uint256> const>;
+
+    // The offers of a book read so far, and where reading resumes
+    struct BookOffers
+    {
+        std::mutex mutex;
+        Keys dirs;
+        Offers offers;
+        hash_map<AccountID, STAmount> funds;
+
+        // The directory being read, its current page and the next offer
+        // in it.  There is no page before the directory is started.
+        std::size_t dir = 0;
+        std::shared_ptr<SLE const> page;
+        unsigned int entry = 0;
+        uint256 index;
+
+        bool done = false;
+        bool failed = false;
+    };
+
+    // The keys of the ledger in the quality range starting at `base`, or
+    // nullptr if some of them are missing or too many books are indexed.
+    // A book with a missing node is kept as nullptr, and not scanned again.
+    Keys
+    directories(uint256 const& base);
+
+    // Reads the offers of a book until there are `limit` or no more
+    void
+    read(
+        BookOffers& book,
+        Book const& issues,
+        std::size_t limit,
+        beast::Journal j);
+
+    Ledger const& ledger_;
+
+    std::mutex mutable mutex_;
+    hash_map<uint256, Keys> directories_;
+    hash_map<uint256, std::shared_ptr<BookOffers>> offers_;
+};
+
+}  // namespace ripple
+
+#endif
@@ -420,6 +420,9 @@ Ledger::exists(uint256 const& key) const
 std::optional<uint256>
 Ledger::succ(uint256 const& key, std::optional<uint256> const& last) const
 {
+    if (mImmutable && last && BookIndex::isQualityRange(key, *last))
+        return bookIndex_.succ(key, *last);
+
     auto item = stateMap_->upper_bound(key);
     if (item == stateMap_->end())
         return std::nullopt;
@@ -445,6 +448,25 @@ Ledger::read(Keylet const& k) const
     return sle;
 }
 
+std::shared_ptr<SLEView const>
+Ledger::readLazy(Keylet const& k) const
+{
+    if (k.key == beast::zero)
+    {
+        assert(false);
+        return nullptr;
+    }
+    auto const& item = stateMap_->peekItem(k.key);
+    if (!item)
+        return nullptr;
+    // The view shares the item's buffer, which is immutable
+    auto view =
+        std::make_shared<SLEView const>(item, item->slice(), item->key());
+    if (!k.check(*view))
+        return nullptr;
+    return view;
+}
+
 //------------------------------------------------------------------------------
 
 auto
@@ -20,6 +20,7 @@
 #ifndef RIPPLE_APP_LEDGER_LEDGER_H_INCLUDED
 #define RIPPLE_APP_LEDGER_LEDGER_H_INCLUDED
 
+#include <ripple/app/ledger/BookIndex.h>
 #include <ripple/basics/CountedObject.h>
 #include <ripple/beast/utility/Journal.h>
 #include <ripple/core/TimeKeeper.h>
@@ -31,6 +32,7 @@
 #include <ripple/protocol/STLedgerEntry.h>
 #include <ripple/protocol/Serializer.h>
 #include <ripple/shamap/SHAMap.h>
+#include <cassert>
 #include <mutex>
 
 namespace ripple {
@@ -181,6 +183,9 @@ public:
     std::shared_ptr<SLE const>
     read(Keylet const& k) const override;
 
+    std::shared_ptr<SLEView const>
+    readLazy(Keylet const& k) const override;
+
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const override;
 
@@ -390,6 +395,17 @@ public:
     std::shared_ptr<SLE>
     peek(Keylet const& k) const;
 
+    /** Returns the index of the order books.
+
+        The ledger must be immutable.
+    */
+    BookIndex&
+    bookIndex() const
+    {
+        assert(mImmutable);
+        return bookIndex_;
+    }
+
 private:
     class sles_iter_impl;
     class txs_iter_impl;
@@ -408,6 +424,8 @@ private:
     Fees fees_;
     Rules rules_;
     LedgerInfo info_;
+
+    BookIndex mutable bookIndex_{*this};
 };
 
 /** A ledger wrapped in a CachedView. */
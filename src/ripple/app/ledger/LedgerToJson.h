@@ -66,6 +66,14 @@ struct LedgerFill
 void
 addJson(Json::Value&, LedgerFill const&);
 
+/** Write the ledger to a Json::Object as it is visited.
+
+    Expanded transactions, metadata and ledger entries are streamed to the
+    writer rather than being collected into Json::Values first.
+ */
+void
+addJson(Json::Object&, LedgerFill const&);
+
 /** Return a new Json::Value representing the ledger with given options.*/
 Json::Value
 getJson(LedgerFill const&);
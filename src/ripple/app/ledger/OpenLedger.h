@@ -29,6 +29,7 @@
 #include <ripple/ledger/CachedSLEs.h>
 #include <ripple/ledger/OpenView.h>
 #include <cassert>
+#include <chrono>
 #include <mutex>
 
 namespace ripple {
@@ -55,6 +56,20 @@ private:
     std::mutex mutable current_mutex_;
     std::shared_ptr<OpenView const> current_;
 
+    // How the open ledger was rebuilt on the last closed ledger, and how
+    // long rebuilding has taken in all.  Guarded by current_mutex_.
+    struct Rebuild
+    {
+        LedgerIndex seq = 0;
+        std::chrono::microseconds duration{0};
+        std::size_t transactions = 0;
+        std::size_t skipped = 0;
+        std::uint64_t preflightsCached = 0;
+    };
+    Rebuild lastRebuild_;
+    std::uint64_t rebuilds_ = 0;
+    std::chrono::microseconds rebuildTime_{0};
+
 public:
     /** Signature for modification functions.
 
@@ -170,14 +185,26 @@ public:
         std::string const& suffix = "",
         modify_type const& f = {});
 
+    /** Returns how long the open ledger took to rebuild on the last
+        closed ledger, and on average.
+    */
+    Json::Value
+    getJson() const;
+
 private:
     /** Algorithm for applying transactions.
 
         This has the retry logic and ordering semantics
         used for consensus and building the open ledger.
+
+        A transaction which is to be retried isn't applied again
+        until another transaction has changed the view or the flags
+        have changed, since it would fail the same way.
+
+        @return The number of retries which were skipped.
     */
     template <class FwdRange>
-    static void
+    static std::size_t
     apply(
         Application& app,
         OpenView& view,
@@ -207,7 +234,7 @@ private:
 //------------------------------------------------------------------------------
 
 template <class FwdRange>
-void
+std::size_t
 OpenLedger::apply(
     Application& app,
     OpenView& view,
@@ -218,6 +245,12 @@ OpenLedger::apply(
     std::map<uint256, bool>& shouldRecover,
     beast::Journal j)
 {
+    // How many transactions had changed the view when each transaction
+    // to be retried last failed, and whether it was with tapRETRY
+    std::size_t applied = 0;
+    hash_map<uint256, std::pair<std::size_t, bool>> failed;
+    std::size_t skipped = 0;
+
     for (auto iter = txs.begin(); iter != txs.end(); ++iter)
     {
         try
@@ -230,8 +263,13 @@ OpenLedger::apply(
                 continue;
             auto const result =
                 apply_one(app, view, tx, true, flags, shouldRecover[txId], j);
-            if (result == Result::retry)
+            if (result == Result::success)
+                ++applied;
+            else if (result == Result::retry)
+            {
+                failed[txId] = {applied, true};
                 retries.insert(tx);
+            }
         }
         catch (std::exception const&)
         {
@@ -245,28 +283,33 @@ OpenLedger::apply(
         auto iter = retries.begin();
         while (iter != retries.end())
         {
+            auto const txId = iter->second->getTransactionID();
+            if (auto const last = failed.find(txId);
+                last != failed.end() &&
+                last->second == std::make_pair(applied, retry))
+            {
+                ++skipped;
+                ++iter;
+                continue;
+            }
             switch (apply_one(
-                app,
-                view,
-                iter->second,
-                retry,
-                flags,
-                shouldRecover[iter->second->getTransactionID()],
-                j))
+                app, view, iter->second, retry, flags, shouldRecover[txId], j))
             {
                 case Result::success:
                     ++changes;
+                    ++applied;
                     [[fallthrough]];
                 case Result::failure:
                     iter = retries.erase(iter);
                     break;
                 case Result::retry:
+                    failed[txId] = {applied, retry};
                     ++iter;
             }
         }
         // A non-retry pass made no changes
         if (!changes && !retry)
-            return;
+            return skipped;
         // Stop retriable passes
         if (!changes || (pass >= LEDGER_RETRY_PASSES))
             retry = false;
@@ -275,6 +318,7 @@ OpenLedger::apply(
     // If there are any transactions left, we must have
     // tried them in at least one final pass
     assert(retries.empty() || !retry);
+    return skipped;
 }
 
 //------------------------------------------------------------------------------
@@ -24,9 +24,15 @@
 #include <ripple/core/Config.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/jss.h>
+
+#include <algorithm>
 
 namespace ripple {
 
+// The most ledgers whose changes wait for a rebuild to finish
+static std::size_t constexpr maxPending = 256;
+
 OrderBookDB::OrderBookDB(Application& app, Stoppable& parent)
     : Stoppable("OrderBookDB", parent)
     , app_(app)
@@ -45,31 +51,26 @@ OrderBookDB::invalidate()
 void
 OrderBookDB::setup(std::shared_ptr<ReadView const> const& ledger)
 {
+    if (app_.config().PATH_SEARCH_MAX == 0)
+    {
+        // pathfinding has been disabled
+        return;
+    }
+
     {
         std::lock_guard sl(mLock);
         auto seq = ledger->info().seq;
 
-        // Do a full update every 256 ledgers
-        if (mSeq != 0)
-        {
-            if (seq == mSeq)
-                return;
-            if ((seq > mSeq) && ((seq - mSeq) < 256))
-                return;
-            if ((seq < mSeq) && ((mSeq - seq) < 16))
-                return;
-        }
+        if (seq == mSeq || seq == mBuildSeq)
+            return;
 
-        JLOG(j_.debug()) << "Advancing from " << mSeq << " to " << seq;
+        JLOG(j_.debug()) << "Rebuilding from " << seq << ", was at " << mSeq;
 
-        mSeq = seq;
+        mBuildSeq = seq;
+        mPending.clear();
     }
 
-    if (app_.config().PATH_SEARCH_MAX == 0)
-    {
-        // nothing to do
-    }
-    else if (app_.config().standalone())
+    if (app_.config().standalone())
         update(ledger);
     else
         app_.getJobQueue().addJob(
@@ -81,7 +82,7 @@ OrderBookDB::setup(std::shared_ptr<ReadView const> const& ledger)
 void
 OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
 {
-    hash_set<uint256> seen;
+    hash_map<uint256, std::size_t> directories;
     OrderBookDB::IssueToOrderBook destMap;
     OrderBookDB::IssueToOrderBook sourceMap;
     hash_set<Issue> XRPBooks;
@@ -106,7 +107,12 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
                 JLOG(j_.info())
                     << "OrderBookDB::update exiting due to isStopping";
                 std::lock_guard sl(mLock);
-                mSeq = 0;
+                if (ledger->info().seq == mBuildSeq)
+                {
+                    mSeq = 0;
+                    mBuildSeq = 0;
+                    mPending.clear();
+                }
                 return;
             }
 
@@ -121,7 +127,7 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
                 book.out.currency = sle->getFieldH160(sfTakerGetsCurrency);
 
                 uint256 index = getBookBase(book);
-                if (seen.insert(index).second)
+                if (directories[index]++ == 0)
                 {
                     auto orderBook = std::make_shared<OrderBook>(index, book);
                     sourceMap[book.in].push_back(orderBook);
@@ -137,7 +143,12 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
     {
         JLOG(j_.info()) << "OrderBookDB::update: " << mn.what();
         std::lock_guard sl(mLock);
-        mSeq = 0;
+        if (ledger->info().seq == mBuildSeq)
+        {
+            mSeq = 0;
+            mBuildSeq = 0;
+            mPending.clear();
+        }
         return;
     }
 
@@ -145,9 +156,25 @@ OrderBookDB::update(std::shared_ptr<ReadView const> const& ledger)
     {
         std::lock_guard sl(mLock);
 
+        // A rebuild from another ledger was started meanwhile
+        if (ledger->info().seq != mBuildSeq)
+            return;
+
         mXRPBooks.swap(XRPBooks);
         mSourceMap.swap(sourceMap);
         mDestMap.swap(destMap);
+        mDirectories.swap(directories);
+        mSeq = mBuildSeq;
+        mBuildSeq = 0;
+        ++mFullRebuilds;
+
+        // Catch up with the ledgers validated during the rebuild
+        for (auto const& [seq, changes] : mPending)
+        {
+            applyChanges(changes);
+            mSeq = seq;
+        }
+        mPending.clear();
     }
     app_.getLedgerMaster().newOrderBookDB();
 }
@@ -188,6 +215,184 @@ OrderBookDB::addOrderBook(Book const& book)
         mXRPBooks.insert(book.in);
 }
 
+void
+OrderBookDB::applyLedger(AcceptedLedger const& ledger)
+{
+    if (app_.config().PATH_SEARCH_MAX == 0)
+        return;
+
+    auto const seq = ledger.getLedger()->info().seq;
+    auto changes = bookChanges(ledger);
+    {
+        std::lock_guard sl(mLock);
+
+        if (mBuildSeq != 0)
+        {
+            // Hold on to the changes until the rebuild is done
+            auto const next =
+                (mPending.empty() ? mBuildSeq : mPending.back().first) + 1;
+            if (seq < next)
+                return;
+            if (seq == next && mPending.size() < maxPending)
+            {
+                mPending.emplace_back(seq, std::move(changes));
+                return;
+            }
+        }
+        else if (mSeq != 0 && seq <= mSeq)
+        {
+            return;
+        }
+        else if (mSeq != 0 && seq == mSeq + 1)
+        {
+            applyChanges(changes);
+            mSeq = seq;
+            return;
+        }
+
+        JLOG(j_.info()) << "Ledger " << seq << " doesn't follow "
+                        << (mBuildSeq != 0 ? mBuildSeq : mSeq);
+    }
+
+    setup(ledger.getLedger());
+}
+
+std::vector<OrderBookDB::BookChange>
+OrderBookDB::bookChanges(AcceptedLedger const& ledger)
+{
+    // Fields which hold their default value are left out of the new fields
+    // of a created entry: the currency and issuer of XRP are zero.
+    auto hash160 = [](STObject const& fields, SF_HASH160 const& field) {
+        return fields.isFieldPresent(field) ? fields.getFieldH160(field)
+                                            : uint160{};
+    };
+
+    std::vector<BookChange> changes;
+    for (auto const& [_, alTx] : ledger.getMap())
+    {
+        (void)_;
+        if (!alTx->getMeta())
+            continue;
+
+        // Every transaction which claimed a fee has metadata, and a failed
+        // one may still have removed unfunded or expired offers.
+        for (auto const& node : alTx->getMeta()->getNodes())
+        {
+            if (node.getFieldU16(sfLedgerEntryType) != ltDIR_NODE)
+                continue;
+
+            bool const created = node.getFName() == sfCreatedNode;
+            if (!created && node.getFName() != sfDeletedNode)
+                continue;
+
+            auto const fields = dynamic_cast<STObject const*>(
+                node.peekAtPField(created ? sfNewFields : sfFinalFields));
+            if (!fields || !fields->isFieldPresent(sfExchangeRate) ||
+                !fields->isFieldPresent(sfRootIndex) ||
+                fields->getFieldH256(sfRootIndex) !=
+                    node.getFieldH256(sfLedgerIndex))
+                continue;
+
+            Book book;
+            book.in.currency = hash160(*fields, sfTakerPaysCurrency);
+            book.in.account = hash160(*fields, sfTakerPaysIssuer);
+            book.out.currency = hash160(*fields, sfTakerGetsCurrency);
+            book.out.account = hash160(*fields, sfTakerGetsIssuer);
+            changes.push_back({book, created});
+        }
+    }
+    return changes;
+}
+
+void
+OrderBookDB::applyChanges(std::vector<BookChange> const& changes)
+{
+    for (auto const& change : changes)
+    {
+        uint256 const index = getBookBase(change.book);
+        if (change.created)
+        {
+            if (mDirectories[index]++ == 0)
+                rawAddBook(change.book);
+        }
+        else
+        {
+            auto const it = mDirectories.find(index);
+            if (it == mDirectories.end())
+                continue;
+            if (--it->second == 0)
+            {
+                mDirectories.erase(it);
+                rawRemoveBook(change.book);
+            }
+        }
+    }
+}
+
+void
+OrderBookDB::rawAddBook(Book const& book)
+{
+    auto& source = mSourceMap[book.in];
+    uint256 const index = getBookBase(book);
+    for (auto const& ob : source)
+    {
+        if (ob->getBookBase() == index)
+            return;
+    }
+
+    auto orderBook = std::make_shared<OrderBook>(index, book);
+    source.push_back(orderBook);
+    mDestMap[book.out].push_back(orderBook);
+    if (isXRP(book.out))
+        mXRPBooks.insert(book.in);
+}
+
+void
+OrderBookDB::rawRemoveBook(Book const& book)
+{
+    uint256 const index = getBookBase(book);
+    auto remove = [&index](IssueToOrderBook& map, Issue const& issue) {
+        auto const it = map.find(issue);
+        if (it == map.end())
+            return;
+        auto& books = it->second;
+        books.erase(
+            std::remove_if(
+                books.begin(),
+                books.end(),
+                [&index](auto const& ob) {
+                    return ob->getBookBase() == index;
+                }),
+            books.end());
+        if (books.empty())
+            map.erase(it);
+    };
+    remove(mSourceMap, book.in);
+    remove(mDestMap, book.out);
+    if (isXRP(book.out))
+        mXRPBooks.erase(book.in);
+}
+
+Json::Value
+OrderBookDB::getJson()
+{
+    Json::Value ret(Json::objectValue);
+    std::uint32_t seq;
+    {
+        std::lock_guard sl(mLock);
+        seq = mSeq;
+        ret[jss::books] = Json::UInt(mDirectories.size());
+        ret[jss::full_rebuilds] = mFullRebuilds;
+    }
+    ret[jss::ledger_index] = seq;
+    if (seq != 0)
+    {
+        auto const validated = app_.getLedgerMaster().getValidLedgerIndex();
+        ret[jss::lag_ledgers] = validated > seq ? validated - seq : 0;
+    }
+    return ret;
+}
+
 // return list of all orderbooks that want this issuerID and currencyID
 OrderBook::List
 OrderBookDB::getBooksByTakerPays(Issue const& issue)
@@ -248,7 +453,7 @@ void
 OrderBookDB::processTxn(
     std::shared_ptr<ReadView const> const& ledger,
     const AcceptedLedgerTx& alTx,
-    Json::Value const& jvObj)
+    InfoSub::Message const& message)
 {
     std::lock_guard sl(mLock);
     if (alTx.getResult() == tesSUCCESS)
@@ -296,7 +501,7 @@ OrderBookDB::processTxn(
                             auto listeners = getBookListeners(b);
                             if (listeners)
                             {
-                                listeners->publish(jvObj, havePublished);
+                                listeners->publish(message, havePublished);
                             }
                         }
                     }
@@ -20,10 +20,11 @@
 #ifndef RIPPLE_APP_LEDGER_ORDERBOOKDB_H_INCLUDED
 #define RIPPLE_APP_LEDGER_ORDERBOOKDB_H_INCLUDED
 
-#include <ripple/app/ledger/AcceptedLedgerTx.h>
+#include <ripple/app/ledger/AcceptedLedger.h>
 #include <ripple/app/ledger/BookListeners.h>
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/OrderBook.h>
+#include <deque>
 #include <mutex>
 
 namespace ripple {
@@ -33,6 +34,11 @@ class OrderBookDB : public Stoppable
 public:
     OrderBookDB(Application& app, Stoppable& parent);
 
+    /** Rebuild the index from a ledger, unless it already reflects it.
+
+        The rebuild walks the whole ledger, so it runs as a job outside of
+        standalone mode.
+    */
     void
     setup(std::shared_ptr<ReadView const> const& ledger);
     void
@@ -40,6 +46,20 @@ public:
     void
     invalidate();
 
+    /** Bring the index up to date with a validated ledger.
+
+        Ledgers must be applied in order.  The root directories of book
+        qualities which the ledger's transactions created or deleted are
+        applied to the index; a book is removed once its last quality is.
+        If a ledger was missed the index is rebuilt from this one instead.
+    */
+    void
+    applyLedger(AcceptedLedger const& ledger);
+
+    /** Returns the ledger the index reflects and how it was built. */
+    Json::Value
+    getJson();
+
     void
     addOrderBook(Book const&);
 
@@ -66,14 +86,35 @@ public:
     processTxn(
         std::shared_ptr<ReadView const> const& ledger,
         const AcceptedLedgerTx& alTx,
-        Json::Value const& jvObj);
+        InfoSub::Message const& message);
 
     using IssueToOrderBook = hash_map<Issue, OrderBook::List>;
 
 private:
+    // The root directory of one quality of a book, created or deleted
+    struct BookChange
+    {
+        Book book;
+        bool created;
+    };
+
+    using LedgerChanges = std::pair<std::uint32_t, std::vector<BookChange>>;
+
+    static std::vector<BookChange>
+    bookChanges(AcceptedLedger const& ledger);
+
+    // Requires mLock
+    void
+    applyChanges(std::vector<BookChange> const& changes);
+
+    // Requires mLock
     void
     rawAddBook(Book const&);
 
+    // Requires mLock
+    void
+    rawRemoveBook(Book const&);
+
     Application& app_;
 
     // by ci/ii
@@ -91,8 +132,20 @@ private:
 
     BookToListenersMap mListeners;
 
+    // the number of quality directories of each book, by book base
+    hash_map<uint256, std::size_t> mDirectories;
+
+    // the ledger the index reflects, or 0
     std::uint32_t mSeq;
 
+    // the ledger a full rebuild is in progress for, or 0
+    std::uint32_t mBuildSeq = 0;
+
+    // changes made by the ledgers following mBuildSeq
+    std::deque<LedgerChanges> mPending;
+
+    std::uint32_t mFullRebuilds = 0;
+
     beast::Journal const j_;
 };
 
@@ -22,11 +22,14 @@
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/basics/base_uint.h>
 #include <ripple/core/Pg.h>
+#include <ripple/protocol/STJsonWriter.h>
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/DeliveredAmount.h>
 
 #include <date/date.h>
 
+#include <optional>
+
 namespace ripple {
 
 namespace {
@@ -108,6 +111,28 @@ fillJsonBinary(Object& json, bool closed, LedgerInfo const& info)
     }
 }
 
+// If an offer create is not self funded, return the owner's balance
+std::optional<std::string>
+ownerFunds(LedgerFill const& fill, STTx const& txn)
+{
+    if (!(fill.options & LedgerFill::ownerFunds) ||
+        txn.getTxnType() != ttOFFER_CREATE)
+        return std::nullopt;
+
+    auto const account = txn.getAccountID(sfAccount);
+    auto const amount = txn.getFieldAmount(sfTakerGets);
+    if (account == amount.getIssuer())
+        return std::nullopt;
+
+    return accountFunds(
+               fill.ledger,
+               account,
+               amount,
+               fhIGNORE_FREEZE,
+               beast::Journal{beast::Journal::getNullSink()})
+        .getText();
+}
+
 Json::Value
 fillJsonTx(
     LedgerFill const& fill,
@@ -144,27 +169,81 @@ fillJsonTx(
         }
     }
 
-    if ((fill.options & LedgerFill::ownerFunds) &&
-        txn->getTxnType() == ttOFFER_CREATE)
+    if (auto const funds = ownerFunds(fill, *txn))
+        txJson[jss::owner_funds] = *funds;
+
+    return txJson;
+}
+
+// Write an expanded transaction and its metadata directly to the writer,
+// without building a Json::Value for the whole transaction.
+void
+appendJsonTx(
+    Json::Array& txns,
+    LedgerFill const& fill,
+    bool bBinary,
+    bool bExpanded,
+    std::shared_ptr<STTx const> const& txn,
+    std::shared_ptr<STObject const> const& stMeta)
+{
+    // Hashes and blobs are written as bytes, which are hex in JSON
+    if (!bExpanded)
+    {
+        auto const& id = txn->getTransactionID();
+        txns.append(Slice{id.data(), id.size()});
+        return;
+    }
+
+    auto txJson = txns.appendObject();
+    if (bBinary)
+    {
+        Serializer s;
+        txn->add(s);
+        txJson[jss::tx_blob] = s.slice();
+        if (stMeta)
+        {
+            s.erase();
+            stMeta->add(s);
+            txJson[jss::meta] = s.slice();
+        }
+        if (auto const funds = ownerFunds(fill, *txn))
+            txJson[jss::owner_funds] = *funds;
+        return;
+    }
+
+    writeJson(txJson, *txn);
+
+    if (stMeta)
     {
-        auto const account = txn->getAccountID(sfAccount);
-        auto const amount = txn->getFieldAmount(sfTakerGets);
+        auto meta = Json::addObject(txJson, jss::metaData);
+        writeJson(meta, *stMeta);
 
-        // If the offer create is not self funded then add the
-        // owner balance
-        if (account != amount.getIssuer())
+        auto const txnType = txn->getTxnType();
+        if (txnType == ttPAYMENT || txnType == ttCHECK_CASH)
         {
-            auto const ownerFunds = accountFunds(
-                fill.ledger,
-                account,
-                amount,
-                fhIGNORE_FREEZE,
-                beast::Journal{beast::Journal::getNullSink()});
-            txJson[jss::owner_funds] = ownerFunds.getText();
+            TxMeta const txMeta(
+                txn->getTransactionID(), fill.ledger.seq(), *stMeta);
+            Json::Value delivered{Json::objectValue};
+            RPC::insertDeliveredAmount(delivered, fill.ledger, txn, txMeta);
+            if (delivered.isMember(jss::delivered_amount))
+                meta[jss::delivered_amount] = delivered[jss::delivered_amount];
         }
     }
 
-    return txJson;
+    if (auto const funds = ownerFunds(fill, *txn))
+        txJson[jss::owner_funds] = *funds;
+}
+
+void
+appendJsonTx(
+    Json::Value& txns,
+    LedgerFill const& fill,
+    bool bBinary,
+    bool bExpanded,
+    std::shared_ptr<STTx const> const& txn,
+    std::shared_ptr<STObject const> const& stMeta)
+{
+    txns.append(fillJsonTx(fill, bBinary, bExpanded, txn, stMeta));
 }
 
 template <class Object>
@@ -180,8 +259,8 @@ fillJsonTx(Object& json, LedgerFill const& fill)
         auto appendAll = [&](auto const& txs) {
             for (auto& i : txs)
             {
-                txns.append(
-                    fillJsonTx(fill, bBinary, bExpanded, i.first, i.second));
+                appendJsonTx(
+                    txns, fill, bBinary, bExpanded, i.first, i.second);
             }
         };
 
@@ -200,6 +279,49 @@ fillJsonTx(Object& json, LedgerFill const& fill)
     }
 }
 
+void
+appendJsonState(Json::Array& array, STLedgerEntry const& sle)
+{
+    auto obj = array.appendObject();
+    writeJson(obj, sle);
+}
+
+void
+appendJsonState(Json::Value& array, STLedgerEntry const& sle)
+{
+    array.append(sle.getJson(JsonOptions::none));
+}
+
+void
+appendJsonStateBinary(Json::Array& array, STLedgerEntry const& sle)
+{
+    auto obj = array.appendObject();
+    obj[jss::hash] = Slice{sle.key().data(), sle.key().size()};
+    Serializer s;
+    sle.add(s);
+    obj[jss::tx_blob] = s.slice();
+}
+
+void
+appendJsonStateBinary(Json::Value& array, STLedgerEntry const& sle)
+{
+    auto& obj = array.append(Json::objectValue);
+    obj[jss::hash] = to_string(sle.key());
+    obj[jss::tx_blob] = serializeHex(sle);
+}
+
+void
+appendJsonKey(Json::Array& array, uint256 const& key)
+{
+    array.append(Slice{key.data(), key.size()});
+}
+
+void
+appendJsonKey(Json::Value& array, uint256 const& key)
+{
+    array.append(to_string(key));
+}
+
 template <class Object>
 void
 fillJsonState(Object& json, LedgerFill const& fill)
@@ -214,15 +336,11 @@ fillJsonState(Object& json, LedgerFill const& fill)
         if (fill.type == ltINVALID || sle->getType() == fill.type)
         {
             if (binary)
-            {
-                auto&& obj = appendObject(array);
-                obj[jss::hash] = to_string(sle->key());
-                obj[jss::tx_blob] = serializeHex(*sle);
-            }
+                appendJsonStateBinary(array, *sle);
             else if (expanded)
-                array.append(sle->getJson(JsonOptions::none));
+                appendJsonState(array, *sle);
             else
-                array.append(to_string(sle->key()));
+                appendJsonKey(array, sle->key());
         }
     }
 }
@@ -289,6 +407,18 @@ addJson(Json::Value& json, LedgerFill const& fill)
         fillJsonQueue(json, fill);
 }
 
+void
+addJson(Json::Object& json, LedgerFill const& fill)
+{
+    {
+        auto object = Json::addObject(json, jss::ledger);
+        fillJson(object, fill);
+    }
+
+    if ((fill.options & LedgerFill::dumpQueue) && !fill.txQueue.empty())
+        fillJsonQueue(json, fill);
+}
+
 Json::Value
 getJson(LedgerFill const& fill)
 {
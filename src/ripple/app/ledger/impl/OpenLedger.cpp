@@ -27,6 +27,7 @@
 #include <ripple/overlay/Overlay.h>
 #include <ripple/overlay/predicates.h>
 #include <ripple/protocol/Feature.h>
+#include <ripple/protocol/jss.h>
 #include <boost/range/adaptor/transformed.hpp>
 
 namespace ripple {
@@ -80,6 +81,9 @@ OpenLedger::accept(
     modify_type const& f)
 {
     JLOG(j_.trace()) << "accept ledger " << ledger->seq() << " " << suffix;
+    auto const start = std::chrono::steady_clock::now();
+    auto const preflightHits = app.getTxQ().preflightHits();
+    std::size_t skipped = 0;
     auto next = create(rules, ledger);
     std::map<uint256, bool> shouldRecover;
     if (retriesFirst)
@@ -91,7 +95,8 @@ OpenLedger::accept(
         }
         // Handle disputed tx, outside lock
         using empty = std::vector<std::shared_ptr<STTx const>>;
-        apply(app, *next, *ledger, empty{}, retries, flags, shouldRecover, j_);
+        skipped += apply(
+            app, *next, *ledger, empty{}, retries, flags, shouldRecover, j_);
     }
     // Block calls to modify, otherwise
     // new tx going into the open ledger
@@ -111,7 +116,7 @@ OpenLedger::accept(
                 shouldRecover.emplace_hint(
                     iter, txID, app.getHashRouter().shouldRecover(txID));
         }
-        apply(
+        skipped += apply(
             app,
             *next,
             *ledger,
@@ -156,9 +161,44 @@ OpenLedger::accept(
         }
     }
 
+    Rebuild rebuild;
+    rebuild.seq = ledger->seq();
+    rebuild.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    rebuild.transactions = next->txCount();
+    rebuild.skipped = skipped;
+    rebuild.preflightsCached = app.getTxQ().preflightHits() - preflightHits;
+    JLOG(j_.debug()) << "Rebuilt open ledger on " << rebuild.seq << " in "
+                     << rebuild.duration.count() << "us with "
+                     << rebuild.transactions << " transactions, "
+                     << rebuild.skipped << " retries skipped, "
+                     << rebuild.preflightsCached << " preflights cached";
+
     // Switch to the new open view
     std::lock_guard lock2(current_mutex_);
     current_ = std::move(next);
+    lastRebuild_ = rebuild;
+    ++rebuilds_;
+    rebuildTime_ += rebuild.duration;
+}
+
+Json::Value
+OpenLedger::getJson() const
+{
+    Json::Value ret(Json::objectValue);
+    std::lock_guard lock(current_mutex_);
+    ret[jss::count] = Json::UInt(rebuilds_);
+    if (rebuilds_ != 0)
+    {
+        ret[jss::ledger_index] = lastRebuild_.seq;
+        ret[jss::duration_us] = std::to_string(lastRebuild_.duration.count());
+        ret[jss::average_duration_us] =
+            std::to_string(rebuildTime_.count() / rebuilds_);
+        ret[jss::transactions] = Json::UInt(lastRebuild_.transactions);
+        ret[jss::retries_skipped] = Json::UInt(lastRebuild_.skipped);
+        ret[jss::preflights_cached] = Json::UInt(lastRebuild_.preflightsCached);
+    }
+    return ret;
 }
 
 //------------------------------------------------------------------------------
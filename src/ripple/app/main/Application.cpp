@@ -488,6 +488,8 @@ public:
 
         // VFALCO HACK
         m_nodeStoreScheduler.setJobQueue(*m_jobQueue);
+        m_nodeStoreScheduler.setCollector(
+            m_collectorManager->group("nodestore"));
 
         add(m_ledgerMaster->getPropertySource());
     }
@@ -33,6 +33,22 @@ NodeStoreScheduler::setJobQueue(JobQueue& jobQueue)
     m_jobQueue = &jobQueue;
 }
 
+void
+NodeStoreScheduler::setCollector(
+    beast::insight::Collector::ptr const& collector)
+{
+    auto make = [&](StageEvents& events, std::string const& prefix) {
+        events.cacheLookup = collector->make_event(prefix + "_cache_lookup");
+        events.backendRead = collector->make_event(prefix + "_backend_read");
+        events.decode = collector->make_event(prefix + "_decode");
+        events.canonicalize = collector->make_event(prefix + "_canonicalize");
+    };
+    make(m_stageEvents[static_cast<int>(NodeStore::FetchType::synchronous)],
+         "sync");
+    make(m_stageEvents[static_cast<int>(NodeStore::FetchType::async)],
+         "async");
+}
+
 void
 NodeStoreScheduler::onStop()
 {
@@ -83,6 +99,16 @@ NodeStoreScheduler::onFetch(NodeStore::FetchReport const& report)
                                                         : jtNS_SYNC_READ,
         1,
         report.elapsed);
+
+    auto const& events = m_stageEvents[static_cast<int>(report.fetchType)];
+    if (report.cacheLookup)
+        events.cacheLookup.notify(*report.cacheLookup);
+    if (report.backendRead)
+        events.backendRead.notify(*report.backendRead);
+    if (report.decode)
+        events.decode.notify(*report.decode);
+    if (report.canonicalize)
+        events.canonicalize.notify(*report.canonicalize);
 }
 
 void
@@ -20,9 +20,11 @@
 #ifndef RIPPLE_APP_MAIN_NODESTORESCHEDULER_H_INCLUDED
 #define RIPPLE_APP_MAIN_NODESTORESCHEDULER_H_INCLUDED
 
+#include <ripple/beast/insight/Collector.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/core/Stoppable.h>
 #include <ripple/nodestore/Scheduler.h>
+#include <array>
 #include <atomic>
 
 namespace ripple {
@@ -40,6 +42,10 @@ public:
     void
     setJobQueue(JobQueue& jobQueue);
 
+    /** Report the duration of each stage of node store fetches. */
+    void
+    setCollector(beast::insight::Collector::ptr const& collector);
+
     void
     onStop() override;
     void
@@ -57,6 +63,16 @@ private:
 
     JobQueue* m_jobQueue{nullptr};
     std::atomic<int> m_taskCount{0};
+
+    // Fetch stage durations, indexed by fetch type
+    struct StageEvents
+    {
+        beast::insight::Event cacheLookup;
+        beast::insight::Event backendRead;
+        beast::insight::Event decode;
+        beast::insight::Event canonicalize;
+    };
+    std::array<StageEvents, 2> m_stageEvents;
 };
 
 }  // namespace ripple
@@ -37,6 +37,7 @@
 #include <ripple/app/misc/ValidatorKeys.h>
 #include <ripple/app/misc/ValidatorList.h>
 #include <ripple/app/misc/impl/AccountTxPaging.h>
+#include <ripple/app/paths/PathRequests.h>
 #include <ripple/app/reporting/ReportingETL.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/PerfLog.h>
@@ -66,6 +67,8 @@
 #include <boost/asio/ip/host_name.hpp>
 #include <boost/asio/steady_timer.hpp>
 
+#include <atomic>
+#include <deque>
 #include <mutex>
 #include <string>
 #include <tuple>
@@ -661,6 +664,11 @@ private:
         bool bValidated,
         std::shared_ptr<ReadView const> const& lpCurrent);
 
+    void
+    publishLedgers();
+    void
+    publishLedger(std::shared_ptr<ReadView const> const& lpAccepted);
+
     void
     pubValidatedTransaction(
         std::shared_ptr<ReadView const> const& alAccepted,
@@ -669,7 +677,8 @@ private:
     pubAccountTransaction(
         std::shared_ptr<ReadView const> const& lpCurrent,
         const AcceptedLedgerTx& alTransaction,
-        bool isAccepted);
+        bool isAccepted,
+        InfoSub::Message const& message);
 
     void
     pubServer();
@@ -745,6 +754,28 @@ private:
     DispatchState mDispatchState = DispatchState::none;
     std::vector<TransactionStatus> mTransactions;
 
+    // Accepted ledgers waiting to be published to the streams, in order.
+    // One job at a time publishes them, away from ledger processing.
+    struct PendingLedger
+    {
+        std::shared_ptr<ReadView const> ledger;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    // Past this many, the waiting ledgers are skipped, and publishing
+    // carries on from the newest
+    static constexpr std::size_t maxPendingLedgers = 32;
+
+    std::mutex pubMutex_;
+    std::deque<PendingLedger> pubQueue_;
+    bool pubRunning_ = false;
+    std::uint32_t pubLastSeq_ = 0;
+    std::chrono::milliseconds pubLastLag_{0};
+
+    // Ledgers skipped for every stream when too many waited, and ledgers
+    // not sent to the ledger stream of a backlogged subscriber
+    std::atomic<std::uint64_t> pubSkipped_{0};
+
     StateAccounting accounting_{};
 
 private:
@@ -1926,12 +1957,14 @@ NetworkOPsImp::pubManifest(Manifest const& mo)
             jvObj[jss::domain] = mo.domain;
         jvObj[jss::manifest] = strHex(mo.serialized);
 
+        InfoSub::Message const message(jvObj);
+
         for (auto i = mStreamMaps[sManifests].begin();
              i != mStreamMaps[sManifests].end();)
         {
             if (auto p = i->second.lock())
             {
-                p->send(jvObj, true);
+                p->send(message, true);
                 ++i;
             }
             else
@@ -2029,6 +2062,8 @@ NetworkOPsImp::pubServer()
 
         mLastFeeSummary = f;
 
+        InfoSub::Message const message(jvObj);
+
         for (auto i = mStreamMaps[sServer].begin();
              i != mStreamMaps[sServer].end();)
         {
@@ -2039,7 +2074,7 @@ NetworkOPsImp::pubServer()
             //             sending of JSON data.
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(message, true);
                 ++i;
             }
             else
@@ -2062,11 +2097,13 @@ NetworkOPsImp::pubConsensus(ConsensusPhase phase)
         jvObj[jss::type] = "consensusPhase";
         jvObj[jss::consensus] = to_string(phase);
 
+        InfoSub::Message const message(jvObj);
+
         for (auto i = streamMap.begin(); i != streamMap.end();)
         {
             if (auto p = i->second.lock())
             {
-                p->send(jvObj, true);
+                p->send(message, true);
                 ++i;
             }
             else
@@ -2130,12 +2167,14 @@ NetworkOPsImp::pubValidation(std::shared_ptr<STValidation> const& val)
         if (auto const reserveInc = (*val)[~sfReserveIncrement])
             jvObj[jss::reserve_inc] = *reserveInc;
 
+        InfoSub::Message const message(jvObj);
+
         for (auto i = mStreamMaps[sValidations].begin();
              i != mStreamMaps[sValidations].end();)
         {
             if (auto p = i->second.lock())
             {
-                p->send(jvObj, true);
+                p->send(message, true);
                 ++i;
             }
             else
@@ -2157,6 +2196,8 @@ NetworkOPsImp::pubPeerStatus(std::function<Json::Value(void)> const& func)
 
         jvObj[jss::type] = "peerStatusChange";
 
+        InfoSub::Message const message(jvObj);
+
         for (auto i = mStreamMaps[sPeerStatus].begin();
              i != mStreamMaps[sPeerStatus].end();)
         {
@@ -2164,7 +2205,7 @@ NetworkOPsImp::pubPeerStatus(std::function<Json::Value(void)> const& func)
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(message, true);
                 ++i;
             }
             else
@@ -2856,6 +2897,25 @@ NetworkOPsImp::getServerInfo(bool human, bool admin, bool counters)
             info[jss::published_ledger] = lpPublished->info().seq;
     }
 
+    {
+        std::lock_guard lock(pubMutex_);
+        auto& pub = info[jss::publish_queue] = Json::objectValue;
+        pub[jss::queued_ledgers] = Json::UInt(pubQueue_.size());
+        pub[jss::skipped_ledgers] = Json::UInt(pubSkipped_.load());
+        if (pubLastSeq_ != 0)
+        {
+            auto const validated = m_ledgerMaster.getValidLedgerIndex();
+            pub[jss::lag_ledgers] =
+                validated > pubLastSeq_ ? validated - pubLastSeq_ : 0;
+            pub[jss::lag_ms] = Json::UInt(pubLastLag_.count());
+        }
+    }
+
+    info[jss::order_book_index] = app_.getOrderBookDB().getJson();
+    info[jss::open_ledger_rebuild] = app_.openLedger().getJson();
+    if (app_.config().PATH_SEARCH_MAX != 0)
+        info[jss::path_requests] = app_.getPathRequests().getJson();
+
     std::tie(info[jss::state_accounting], info[jss::server_state_duration_us]) =
         accounting_.json();
     info[jss::uptime] = UptimeClock::now().time_since_epoch().count();
@@ -2895,6 +2955,7 @@ NetworkOPsImp::pubProposedTransaction(
     TER terResult)
 {
     Json::Value jvObj = transJson(*stTxn, terResult, false, lpCurrent);
+    InfoSub::Message const message(jvObj);
 
     {
         std::lock_guard sl(mSubLock);
@@ -2906,7 +2967,7 @@ NetworkOPsImp::pubProposedTransaction(
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(message, true);
                 ++it;
             }
             else
@@ -2918,7 +2979,7 @@ NetworkOPsImp::pubProposedTransaction(
     AcceptedLedgerTx alt(
         lpCurrent, stTxn, terResult, app_.accountIDCache(), app_.logs());
     JLOG(m_journal.trace()) << "pubProposed: " << alt.getJson();
-    pubAccountTransaction(lpCurrent, alt, false);
+    pubAccountTransaction(lpCurrent, alt, false, message);
 }
 
 void
@@ -3040,6 +3101,55 @@ NetworkOPsImp::forwardProposedAccountTransaction(Json::Value const& jvObj)
 
 void
 NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
+{
+    std::lock_guard lock(pubMutex_);
+    if (pubQueue_.size() >= maxPendingLedgers)
+    {
+        // Skipping every waiting ledger at once, rather than one at a time,
+        // leaves a single gap for subscribers and the book index to cross
+        JLOG(m_journal.warn()) << "Publishing is behind, skipping "
+                               << pubQueue_.size() << " ledgers";
+        pubSkipped_ += pubQueue_.size();
+        pubQueue_.clear();
+    }
+    pubQueue_.push_back({lpAccepted, std::chrono::steady_clock::now()});
+
+    if (!pubRunning_ &&
+        m_job_queue.addJob(
+            jtPUBLEDGER, "pubLedger", [this](Job&) { publishLedgers(); }))
+    {
+        pubRunning_ = true;
+    }
+}
+
+void
+NetworkOPsImp::publishLedgers()
+{
+    for (;;)
+    {
+        PendingLedger pending;
+        {
+            std::lock_guard lock(pubMutex_);
+            if (pubQueue_.empty())
+            {
+                pubRunning_ = false;
+                return;
+            }
+            pending = std::move(pubQueue_.front());
+            pubQueue_.pop_front();
+        }
+
+        publishLedger(pending.ledger);
+
+        std::lock_guard lock(pubMutex_);
+        pubLastSeq_ = pending.ledger->info().seq;
+        pubLastLag_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - pending.queued);
+    }
+}
+
+void
+NetworkOPsImp::publishLedger(std::shared_ptr<ReadView const> const& lpAccepted)
 {
     // Ledgers are published only when they acquire sufficient validations
     // Holes are filled across connection loss or other catastrophe
@@ -3053,6 +3163,9 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
             lpAccepted->info().hash, alpAccepted);
     }
 
+    // Ledgers are published in order, so the book index can follow them
+    app_.getOrderBookDB().applyLedger(*alpAccepted);
+
     {
         JLOG(m_journal.debug())
             << "Publishing ledger = " << lpAccepted->info().seq;
@@ -3082,6 +3195,7 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
                 jvObj[jss::validated_ledgers] =
                     app_.getLedgerMaster().getCompleteLedgers();
             }
+            InfoSub::Message const message(jvObj);
 
             auto it = mStreamMaps[sLedger].begin();
             while (it != mStreamMaps[sLedger].end())
@@ -3089,11 +3203,23 @@ NetworkOPsImp::pubLedger(std::shared_ptr<ReadView const> const& lpAccepted)
                 InfoSub::pointer p = it->second.lock();
                 if (p)
                 {
+                    // A slow subscriber misses ledgers on its own, instead
+                    // of holding up or dropping them for everyone
+                    if (p->isBacklogged())
+                    {
+                        JLOG(m_journal.debug())
+                            << "Skipping ledger = " << lpAccepted->info().seq
+                            << " : consumer = " << p->getConsumer();
+                        ++pubSkipped_;
+                        ++it;
+                        continue;
+                    }
+
                     JLOG(m_journal.debug())
                         << "Publishing ledger = " << lpAccepted->info().seq
                         << " : consumer = " << p->getConsumer()
                         << " : obj = " << jvObj;
-                    p->send(jvObj, true);
+                    p->send(message, true);
                     ++it;
                 }
                 else
@@ -3226,6 +3352,9 @@ NetworkOPsImp::pubValidatedTransaction(
             jvObj[jss::meta], *alAccepted, stTxn, *txMeta);
     }
 
+    // Serialized once, for every stream
+    InfoSub::Message const message(jvObj);
+
     {
         std::lock_guard sl(mSubLock);
 
@@ -3236,7 +3365,7 @@ NetworkOPsImp::pubValidatedTransaction(
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(message, true);
                 ++it;
             }
             else
@@ -3251,22 +3380,23 @@ NetworkOPsImp::pubValidatedTransaction(
 
             if (p)
             {
-                p->send(jvObj, true);
+                p->send(message, true);
                 ++it;
             }
             else
                 it = mStreamMaps[sRTTransactions].erase(it);
         }
     }
-    app_.getOrderBookDB().processTxn(alAccepted, alTx, jvObj);
-    pubAccountTransaction(alAccepted, alTx, true);
+    app_.getOrderBookDB().processTxn(alAccepted, alTx, message);
+    pubAccountTransaction(alAccepted, alTx, true, message);
 }
 
 void
 NetworkOPsImp::pubAccountTransaction(
     std::shared_ptr<ReadView const> const& lpCurrent,
     const AcceptedLedgerTx& alTx,
-    bool bAccepted)
+    bool bAccepted,
+    InfoSub::Message const& message)
 {
     hash_set<InfoSub::pointer> notify;
     int iProposed = 0;
@@ -3331,25 +3461,8 @@ NetworkOPsImp::pubAccountTransaction(
         << "pubAccountTransaction:"
         << " iProposed=" << iProposed << " iAccepted=" << iAccepted;
 
-    if (!notify.empty())
-    {
-        std::shared_ptr<STTx const> stTxn = alTx.getTxn();
-        Json::Value jvObj =
-            transJson(*stTxn, alTx.getResult(), bAccepted, lpCurrent);
-
-        if (alTx.isApplied())
-        {
-            if (auto const txMeta = alTx.getMeta())
-            {
-                jvObj[jss::meta] = txMeta->getJson(JsonOptions::none);
-                RPC::insertDeliveredAmount(
-                    jvObj[jss::meta], *lpCurrent, stTxn, *txMeta);
-            }
-        }
-
-        for (InfoSub::ref isrListener : notify)
-            isrListener->send(jvObj, true);
-    }
+    for (InfoSub::ref isrListener : notify)
+        isrListener->send(message, true);
 }
 
 //
@@ -3748,6 +3861,136 @@ NetworkOPsImp::getBookPage(
     auto const rate = transferRate(view, book.out.account);
     auto viewJ = app_.journal("View");
 
+    // Adds an offer, given what its owner holds if that is known
+    auto const addOffer = [&](std::shared_ptr<SLE const> const& sleOffer,
+                              STAmount const& saDirRate,
+                              STAmount const* heldFunds) {
+        auto const uOfferOwnerID = sleOffer->getAccountID(sfAccount);
+        auto const& saTakerGets = sleOffer->getFieldAmount(sfTakerGets);
+        auto const& saTakerPays = sleOffer->getFieldAmount(sfTakerPays);
+        STAmount saOwnerFunds;
+        bool firstOwnerOffer(true);
+
+        if (book.out.account == uOfferOwnerID)
+        {
+            // If an offer is selling issuer's own IOUs, it is fully
+            // funded.
+            saOwnerFunds = saTakerGets;
+        }
+        else if (bGlobalFreeze)
+        {
+            // If either asset is globally frozen, consider all offers
+            // that aren't ours to be totally unfunded
+            saOwnerFunds.clear(book.out);
+        }
+        else
+        {
+            auto umBalanceEntry = umBalance.find(uOfferOwnerID);
+            if (umBalanceEntry != umBalance.end())
+            {
+                // Found in running balance table.
+
+                saOwnerFunds = umBalanceEntry->second;
+                firstOwnerOffer = false;
+            }
+            else
+            {
+                // Did not find balance in table.
+
+                if (heldFunds)
+                {
+                    saOwnerFunds = *heldFunds;
+                }
+                else
+                {
+                    saOwnerFunds = accountHolds(
+                        view,
+                        uOfferOwnerID,
+                        book.out.currency,
+                        book.out.account,
+                        fhZERO_IF_FROZEN,
+                        viewJ);
+
+                    if (saOwnerFunds < beast::zero)
+                    {
+                        // Treat negative funds as zero.
+
+                        saOwnerFunds.clear();
+                    }
+                }
+            }
+        }
+
+        Json::Value jvOffer = sleOffer->getJson(JsonOptions::none);
+
+        STAmount saTakerGetsFunded;
+        STAmount saOwnerFundsLimit = saOwnerFunds;
+        Rate offerRate = parityRate;
+
+        if (rate != parityRate
+            // Have a tranfer fee.
+            && uTakerID != book.out.account
+            // Not taking offers of own IOUs.
+            && book.out.account != uOfferOwnerID)
+        // Offer owner not issuing ownfunds
+        {
+            // Need to charge a transfer fee to offer owner.
+            offerRate = rate;
+            saOwnerFundsLimit = divide(saOwnerFunds, offerRate);
+        }
+
+        if (saOwnerFundsLimit >= saTakerGets)
+        {
+            // Sufficient funds no shenanigans.
+            saTakerGetsFunded = saTakerGets;
+        }
+        else
+        {
+            // Only provide, if not fully funded.
+
+            saTakerGetsFunded = saOwnerFundsLimit;
+
+            saTakerGetsFunded.setJson(jvOffer[jss::taker_gets_funded]);
+            std::min(
+                saTakerPays,
+                multiply(
+                    saTakerGetsFunded, saDirRate, saTakerPays.issue()))
+                .setJson(jvOffer[jss::taker_pays_funded]);
+        }
+
+        STAmount saOwnerPays = (parityRate == offerRate)
+            ? saTakerGetsFunded
+            : std::min(
+                  saOwnerFunds, multiply(saTakerGetsFunded, offerRate));
+
+        umBalance[uOfferOwnerID] = saOwnerFunds - saOwnerPays;
+
+        // Include all offers funded and unfunded
+        Json::Value& jvOf = jvOffers.append(jvOffer);
+        jvOf[jss::quality] = saDirRate.getText();
+
+        if (firstOwnerOffer)
+            jvOf[jss::owner_funds] = saOwnerFunds.getText();
+    };
+
+    // A closed ledger keeps the top of its books, with what the offer
+    // owners hold
+    std::optional<BookIndex::Offers> offers;
+    if (auto const ledger = std::dynamic_pointer_cast<Ledger const>(lpLedger);
+        ledger && ledger->isImmutable())
+        offers = ledger->bookIndex().offers(book, iLimit, viewJ);
+    if (offers)
+    {
+        for (auto const& offer : *offers)
+        {
+            addOffer(
+                offer.sle,
+                amountFromQuality(offer.quality),
+                &offer.ownerFunds);
+        }
+        return;
+    }
+
     while (!bDone && iLimit-- > 0)
     {
         if (bDirectAdvance)
@@ -3793,105 +4036,7 @@ NetworkOPsImp::getBookPage(
 
             if (sleOffer)
             {
-                auto const uOfferOwnerID = sleOffer->getAccountID(sfAccount);
-                auto const& saTakerGets = sleOffer->getFieldAmount(sfTakerGets);
-                auto const& saTakerPays = sleOffer->getFieldAmount(sfTakerPays);
-                STAmount saOwnerFunds;
-                bool firstOwnerOffer(true);
-
-                if (book.out.account == uOfferOwnerID)
-                {
-                    // If an offer is selling issuer's own IOUs, it is fully
-                    // funded.
-                    saOwnerFunds = saTakerGets;
-                }
-                else if (bGlobalFreeze)
-                {
-                    // If either asset is globally frozen, consider all offers
-                    // that aren't ours to be totally unfunded
-                    saOwnerFunds.clear(book.out);
-                }
-                else
-                {
-                    auto umBalanceEntry = umBalance.find(uOfferOwnerID);
-                    if (umBalanceEntry != umBalance.end())
-                    {
-                        // Found in running balance table.
-
-                        saOwnerFunds = umBalanceEntry->second;
-                        firstOwnerOffer = false;
-                    }
-                    else
-                    {
-                        // Did not find balance in table.
-
-                        saOwnerFunds = accountHolds(
-                            view,
-                            uOfferOwnerID,
-                            book.out.currency,
-                            book.out.account,
-                            fhZERO_IF_FROZEN,
-                            viewJ);
-
-                        if (saOwnerFunds < beast::zero)
-                        {
-                            // Treat negative funds as zero.
-
-                            saOwnerFunds.clear();
-                        }
-                    }
-                }
-
-                Json::Value jvOffer = sleOffer->getJson(JsonOptions::none);
-
-                STAmount saTakerGetsFunded;
-                STAmount saOwnerFundsLimit = saOwnerFunds;
-                Rate offerRate = parityRate;
-
-                if (rate != parityRate
-                    // Have a tranfer fee.
-                    && uTakerID != book.out.account
-                    // Not taking offers of own IOUs.
-                    && book.out.account != uOfferOwnerID)
-                // Offer owner not issuing ownfunds
-                {
-                    // Need to charge a transfer fee to offer owner.
-                    offerRate = rate;
-                    saOwnerFundsLimit = divide(saOwnerFunds, offerRate);
-                }
-
-                if (saOwnerFundsLimit >= saTakerGets)
-                {
-                    // Sufficient funds no shenanigans.
-                    saTakerGetsFunded = saTakerGets;
-                }
-                else
-                {
-                    // Only provide, if not fully funded.
-
-                    saTakerGetsFunded = saOwnerFundsLimit;
-
-                    saTakerGetsFunded.setJson(jvOffer[jss::taker_gets_funded]);
-                    std::min(
-                        saTakerPays,
-                        multiply(
-                            saTakerGetsFunded, saDirRate, saTakerPays.issue()))
-                        .setJson(jvOffer[jss::taker_pays_funded]);
-                }
-
-                STAmount saOwnerPays = (parityRate == offerRate)
-                    ? saTakerGetsFunded
-                    : std::min(
-                          saOwnerFunds, multiply(saTakerGetsFunded, offerRate));
-
-                umBalance[uOfferOwnerID] = saOwnerFunds - saOwnerPays;
-
-                // Include all offers funded and unfunded
-                Json::Value& jvOf = jvOffers.append(jvOffer);
-                jvOf[jss::quality] = saDirRate.getText();
-
-                if (firstOwnerOffer)
-                    jvOf[jss::owner_funds] = saOwnerFunds.getText();
+                addOffer(sleOffer, saDirRate, nullptr);
             }
             else
             {
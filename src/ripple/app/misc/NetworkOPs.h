@@ -309,6 +309,16 @@ public:
     //
     // Monitoring: publisher side
     //
+
+    /** Publish an accepted ledger and its transactions to the streams.
+
+        This only queues the ledger: a job publishes the queued ledgers in
+        order, so that subscribers never hold up ledger processing.  A
+        subscriber which can't keep up loses messages on its own: a
+        WebSocket client is disconnected once its send queue is full, and
+        a backlogged subscriber is skipped.  If publishing itself falls
+        too far behind, the waiting ledgers are skipped for every stream.
+    */
     virtual void
     pubLedger(std::shared_ptr<ReadView const> const& lpAccepted) = 0;
     virtual void
@@ -195,6 +195,13 @@ SHAMapStoreImp::SHAMapStoreImp(
                 "online_delete info from config");
         }
 
+        if (section.exists("cold_type"))
+        {
+            Throw<std::runtime_error>(
+                "A tiered node database does not support online_delete. "
+                "Remove online_delete or cold_type from config");
+        }
+
         // Configuration that affects the behavior of online delete
         get_if_exists(section, "delete_batch", deleteBatch_);
         std::uint32_t temp;
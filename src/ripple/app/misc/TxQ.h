@@ -21,19 +21,23 @@
 #define RIPPLE_TXQ_H_INCLUDED
 
 #include <ripple/app/tx/applySteps.h>
+#include <ripple/basics/BucketQueue.h>
+#include <ripple/basics/ThreadLocalPool.h>
+#include <ripple/basics/UnorderedContainers.h>
 #include <ripple/ledger/ApplyView.h>
 #include <ripple/ledger/OpenView.h>
 #include <ripple/protocol/STTx.h>
 #include <ripple/protocol/SeqProxy.h>
 #include <ripple/protocol/TER.h>
 #include <boost/circular_buffer.hpp>
-#include <boost/intrusive/set.hpp>
+#include <mutex>
 #include <optional>
 
 namespace ripple {
 
 class Application;
 class Config;
+class SpeculativeApply;
 
 /**
     Transaction Queue. Used to manage transactions in conjunction with
@@ -149,6 +153,13 @@ public:
             processed.
         */
         std::uint32_t minimumLastLedgerBuffer = 2;
+        /** Number of threads which apply queued transactions to a new
+            open ledger ahead of time, in parallel.  With 1, they are
+            applied one after another.
+
+            @see SpeculativeApply
+        */
+        std::uint32_t applyWorkers = 1;
         /// Use standalone mode behavior.
         bool standAlone = false;
     };
@@ -358,6 +369,12 @@ public:
     Json::Value
     doRPC(Application& app) const;
 
+    /** Returns the number of times a transaction was not preflighted
+        again, because it had passed with the same rules and flags.
+    */
+    std::uint64_t
+    preflightHits() const;
+
 private:
     // Implementation for nextQueuableSeq().  The passed lock must be held.
     SeqProxy
@@ -509,10 +526,11 @@ private:
     class MaybeTx
     {
     public:
-        /// Used by the TxQ::FeeHook and TxQ::FeeMultiSet below
-        /// to put each MaybeTx object into more than one
+        /// Used by the TxQ::FeeHook, TxQ::FeeLastHook and TxQ::FeeQueue
+        /// below to put each MaybeTx object into more than one
         /// set without copies, pointers, etc.
-        boost::intrusive::set_member_hook<> byFeeListHook;
+        boost::intrusive::list_member_hook<> byFeeListHook;
+        boost::intrusive::set_member_hook<> byFeeLastHook;
 
         /// The complete transaction.
         std::shared_ptr<STTx const> txn;
@@ -613,18 +631,15 @@ private:
         }
     };
 
-    /// Used for sorting @ref MaybeTx by `feeLevel`
-    class GreaterFee
+    /// Used for ordering @ref MaybeTx by `feeLevel`
+    class FeeLevelOf
     {
     public:
-        /// Default constructor
-        explicit GreaterFee() = default;
-
-        /// Is the fee level of `lhs` greater than the fee level of `rhs`?
-        bool
-        operator()(const MaybeTx& lhs, const MaybeTx& rhs) const
+        /// The fee level of `tx`
+        FeeLevel64
+        operator()(MaybeTx const& tx) const
         {
-            return lhs.feeLevel > rhs.feeLevel;
+            return tx.feeLevel;
         }
     };
 
@@ -634,7 +649,11 @@ private:
     class TxQAccount
     {
     public:
-        using TxMap = std::map<SeqProxy, MaybeTx>;
+        using TxMap = std::map<
+            SeqProxy,
+            MaybeTx,
+            std::less<SeqProxy>,
+            PoolAllocator<std::pair<SeqProxy const, MaybeTx>>>;
 
         /// The account
         AccountID const account;
@@ -700,6 +719,25 @@ private:
         FeeMetrics::Snapshot const& metricsSnapshot,
         std::lock_guard<std::mutex> const& lock) const;
 
+    // Helper function for TxQ::accept.  Applies the transactions which will
+    // likely go into the view ahead of time, in parallel.
+    std::unique_ptr<SpeculativeApply>
+    speculate(
+        Application& app,
+        OpenView const& view,
+        FeeMetrics::Snapshot const& metricsSnapshot,
+        std::lock_guard<std::mutex> const& lock);
+
+    // Preflight a transaction, or return the result of the last time it
+    // passed with the same rules and flags.
+    PreflightResult
+    preflight(
+        Application& app,
+        Rules const& rules,
+        STTx const& tx,
+        ApplyFlags flags,
+        beast::Journal j);
+
     // Helper function for TxQ::apply.  If a transaction's fee is high enough,
     // attempt to directly apply that transaction to the ledger.
     std::optional<std::pair<TER, bool>>
@@ -718,13 +756,23 @@ private:
 
     using FeeHook = boost::intrusive::member_hook<
         MaybeTx,
-        boost::intrusive::set_member_hook<>,
+        boost::intrusive::list_member_hook<>,
         &MaybeTx::byFeeListHook>;
 
-    using FeeMultiSet = boost::intrusive::
-        multiset<MaybeTx, FeeHook, boost::intrusive::compare<GreaterFee>>;
+    using FeeLastHook = boost::intrusive::member_hook<
+        MaybeTx,
+        boost::intrusive::set_member_hook<>,
+        &MaybeTx::byFeeLastHook>;
 
-    using AccountMap = std::map<AccountID, TxQAccount>;
+    /** Highest fee level first, and first come first served among equal
+        fee levels.  Queues often hold many transactions at few fee levels,
+        where BucketQueue is much faster than a tree of transactions, and
+        it is close to one when every fee level differs.
+    */
+    using FeeQueue =
+        BucketQueue<MaybeTx, FeeLevel64, FeeLevelOf, FeeHook, FeeLastHook>;
+
+    using AccountMap = hash_map<AccountID, TxQAccount>;
 
     /// Setup parameters used to control the behavior of the queue
     Setup const setup_;
@@ -741,7 +789,7 @@ private:
         @note This member must always and only be accessed under
         locked mutex_
     */
-    FeeMultiSet byFee_;
+    FeeQueue byFee_;
     /** All of the accounts which currently have any transactions
         in the queue. Entries are created and destroyed dynamically
         as transactions are added and removed.
@@ -762,6 +810,24 @@ private:
     */
     std::mutex mutable mutex_;
 
+    /** Transactions which passed preflight, and the consequences found.
+        Preflight depends only on the transaction, the rules and the
+        flags, so a transaction which is applied again, as happens to many
+        when the open ledger is rebuilt, need not be checked again.
+        Entries which were not used while one ledger was open are dropped
+        when the next one closes.
+    */
+    struct Preflight
+    {
+        Rules rules;
+        ApplyFlags flags;
+        TxConsequences consequences;
+    };
+    hash_map<uint256, Preflight> preflights_;
+    hash_map<uint256, Preflight> previousPreflights_;
+    std::uint64_t preflightHits_ = 0;
+    std::mutex mutable preflightMutex_;
+
 private:
     /// Is the queue at least `fillPercentage` full?
     template <size_t fillPercentage = 100>
@@ -782,13 +848,12 @@ private:
         std::lock_guard<std::mutex> const& lock);
 
     /// Erase and return the next entry in byFee_ (lower fee level)
-    FeeMultiSet::iterator_type erase(FeeMultiSet::const_iterator_type);
+    FeeQueue::iterator erase(FeeQueue::const_iterator);
     /** Erase and return the next entry for the account (if fee level
         is higher), or next entry in byFee_ (lower fee level).
         Used to get the next "applyable" MaybeTx for accept().
     */
-    FeeMultiSet::iterator_type eraseAndAdvance(
-        FeeMultiSet::const_iterator_type);
+    FeeQueue::iterator eraseAndAdvance(FeeQueue::const_iterator);
     /// Erase a range of items, based on TxQAccount::TxMap iterators
     TxQAccount::TxMap::iterator
     erase(
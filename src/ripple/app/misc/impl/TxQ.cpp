@@ -21,6 +21,7 @@
 #include <ripple/app/main/Application.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/TxQ.h>
+#include <ripple/app/tx/SpeculativeApply.h>
 #include <ripple/app/tx/apply.h>
 #include <ripple/basics/mulDiv.h>
 #include <ripple/protocol/Feature.h>
@@ -299,7 +300,8 @@ TxQ::MaybeTx::apply(Application& app, OpenView& view, beast::Journal j)
                         << pfresult->flags << " to " << flags;
 
         pfresult.emplace(
-            preflight(app, view.rules(), pfresult->tx, flags, pfresult->j));
+            ripple::preflight(
+                app, view.rules(), pfresult->tx, flags, pfresult->j));
     }
 
     auto pcresult = preclaim(*pfresult, app, view);
@@ -433,8 +435,7 @@ TxQ::canBeHeld(
 }
 
 auto
-TxQ::erase(TxQ::FeeMultiSet::const_iterator_type candidateIter)
-    -> FeeMultiSet::iterator_type
+TxQ::erase(TxQ::FeeQueue::const_iterator candidateIter) -> FeeQueue::iterator
 {
     auto& txQAccount = byAccount_.at(candidateIter->account);
     auto const seqProx = candidateIter->seqProxy;
@@ -450,8 +451,8 @@ TxQ::erase(TxQ::FeeMultiSet::const_iterator_type candidateIter)
 }
 
 auto
-TxQ::eraseAndAdvance(TxQ::FeeMultiSet::const_iterator_type candidateIter)
-    -> FeeMultiSet::iterator_type
+TxQ::eraseAndAdvance(TxQ::FeeQueue::const_iterator candidateIter)
+    -> FeeQueue::iterator
 {
     auto& txQAccount = byAccount_.at(candidateIter->account);
     auto const accountIter =
@@ -1347,6 +1348,12 @@ TxQ::processClosedLedger(Application& app, ReadView const& view, bool timeLeap)
 
     auto ledgerSeq = view.info().seq;
 
+    {
+        std::lock_guard preflightLock(preflightMutex_);
+        previousPreflights_ = std::move(preflights_);
+        preflights_.clear();
+    }
+
     if (!timeLeap)
         maxSize_ = std::max(
             snapshot.txnsExpected * setup_.ledgersInQueue, setup_.queueSizeMin);
@@ -1421,6 +1428,10 @@ TxQ::accept(Application& app, OpenView& view)
 
     auto const metricsSnapshot = feeMetrics_.getSnapshot();
 
+    auto const speculation = setup_.applyWorkers > 1
+        ? speculate(app, view, metricsSnapshot, lock)
+        : nullptr;
+
     for (auto candidateIter = byFee_.begin(); candidateIter != byFee_.end();)
     {
         auto& account = byAccount_.at(candidateIter->account);
@@ -1450,8 +1461,14 @@ TxQ::accept(Application& app, OpenView& view)
             JLOG(j_.trace()) << "Applying queued transaction "
                              << candidateIter->txID << " to open ledger.";
 
-            auto const [txnResult, didApply] =
-                candidateIter->apply(app, view, j_);
+            auto const [txnResult, didApply] = speculation
+                ? speculation->apply(
+                      view,
+                      candidateIter->txID,
+                      [&](OpenView& v) {
+                          return candidateIter->apply(app, v, j_);
+                      })
+                : candidateIter->apply(app, view, j_);
 
             if (didApply)
             {
@@ -1540,9 +1557,53 @@ TxQ::accept(Application& app, OpenView& view)
         }
     }
 
+    if (speculation)
+    {
+        JLOG(j_.debug()) << "Applied " << speculation->merged()
+                         << " queued transactions ahead of time, and "
+                         << speculation->conflicts() << " again";
+    }
+
     return ledgerChanged;
 }
 
+std::unique_ptr<SpeculativeApply>
+TxQ::speculate(
+    Application& app,
+    OpenView const& view,
+    FeeMetrics::Snapshot const& metricsSnapshot,
+    std::lock_guard<std::mutex> const&)
+{
+    // Take the transactions accept() will try first, up to what the ledger
+    // is expected to hold.  Only the first transaction of an account is
+    // taken, since the ones which follow it depend on it, and only those
+    // which won't be preflighted again.
+    std::vector<std::pair<uint256, SpeculativeApply::Apply>> txs;
+    hash_set<AccountID> accounts;
+    for (auto& candidate : byFee_)
+    {
+        if (txs.size() >= metricsSnapshot.txnsExpected)
+            break;
+        auto const& account = byAccount_.at(candidate.account);
+        if (candidate.seqProxy.isSeq() &&
+            candidate.seqProxy > account.transactions.begin()->first)
+            continue;
+        if (candidate.pfresult->rules != view.rules() ||
+            candidate.pfresult->flags != candidate.flags)
+            continue;
+        if (!accounts.insert(candidate.account).second)
+            continue;
+        txs.emplace_back(
+            candidate.txID, [this, &app, &candidate](OpenView& v) {
+                return candidate.apply(app, v, j_);
+            });
+    }
+
+    auto speculation = std::make_unique<SpeculativeApply>(view);
+    speculation->run(app.getJobQueue(), setup_.applyWorkers, txs);
+    return speculation;
+}
+
 // Public entry point for nextQueuableSeq().
 //
 // Acquires a lock and calls the implementation.
@@ -1662,8 +1723,9 @@ TxQ::tryDirectApply(
         JLOG(j_.trace()) << "Applying transaction " << transactionID
                          << " to open ledger.";
 
-        auto const [txnResult, didApply] =
-            ripple::apply(app, view, *tx, flags, j);
+        auto const pfresult = preflight(app, view.rules(), *tx, flags, j);
+        auto const pcresult = preclaim(pfresult, app, view);
+        auto const [txnResult, didApply] = doApply(pcresult, app, view);
 
         JLOG(j_.trace()) << "New transaction " << transactionID
                          << (didApply ? " applied successfully with "
@@ -1693,6 +1755,55 @@ TxQ::tryDirectApply(
     return {};
 }
 
+PreflightResult
+TxQ::preflight(
+    Application& app,
+    Rules const& rules,
+    STTx const& tx,
+    ApplyFlags flags,
+    beast::Journal j)
+{
+    auto const txID = tx.getTransactionID();
+    {
+        std::lock_guard lock(preflightMutex_);
+        auto iter = preflights_.find(txID);
+        if (iter == preflights_.end())
+        {
+            if (auto const previous = previousPreflights_.find(txID);
+                previous != previousPreflights_.end())
+            {
+                iter = preflights_.emplace(txID, std::move(previous->second))
+                           .first;
+                previousPreflights_.erase(previous);
+            }
+        }
+        if (iter != preflights_.end() && iter->second.rules == rules &&
+            iter->second.flags == flags)
+        {
+            ++preflightHits_;
+            return PreflightResult::remembered(
+                tx, rules, flags, iter->second.consequences, j);
+        }
+    }
+
+    auto result = ripple::preflight(app, rules, tx, flags, j);
+    // Failures are cheap to find again, and not worth remembering
+    if (result.ter == tesSUCCESS)
+    {
+        std::lock_guard lock(preflightMutex_);
+        preflights_.insert_or_assign(
+            txID, Preflight{rules, flags, result.consequences});
+    }
+    return result;
+}
+
+std::uint64_t
+TxQ::preflightHits() const
+{
+    std::lock_guard lock(preflightMutex_);
+    return preflightHits_;
+}
+
 std::optional<TxQ::TxQAccount::TxMap::iterator>
 TxQ::removeFromByFee(
     std::optional<TxQAccount::TxMap::iterator> const& replacedTxIter,
@@ -1899,6 +2010,8 @@ setup_TxQ(Config const& config)
 
     set(setup.maximumTxnPerAccount, "maximum_txn_per_account", section);
     set(setup.minimumLastLedgerBuffer, "minimum_last_ledger_buffer", section);
+    set(setup.applyWorkers, "apply_workers", section);
+    setup.applyWorkers = std::max<std::uint32_t>(setup.applyWorkers, 1);
 
     setup.standAlone = config.standalone();
     return setup;
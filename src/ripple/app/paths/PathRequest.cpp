@@ -30,7 +30,9 @@
 #include <ripple/core/Config.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
+#include <ripple/protocol/Serializer.h>
 #include <ripple/protocol/UintTypes.h>
+#include <ripple/resource/Fees.h>
 
 #include <ripple/rpc/impl/Tuning.h>
 #include <boost/algorithm/clamp.hpp>
@@ -191,7 +193,7 @@ PathRequest::isValid(std::shared_ptr<RippleLineCache> const& crCache)
         return false;
     }
 
-    auto const sleDest = lrLedger->read(keylet::account(*raDstAccount));
+    auto const sleDest = lrLedger->readLazy(keylet::account(*raDstAccount));
 
     Json::Value& jvDestCur =
         (jvStatus[jss::destination_currencies] = Json::arrayValue);
@@ -632,7 +634,6 @@ PathRequest::findPaths(
 Json::Value
 PathRequest::doUpdate(std::shared_ptr<RippleLineCache> const& cache, bool fast)
 {
-    using namespace std::chrono;
     JLOG(m_journal.debug())
         << iIdentifier << " update " << (fast ? "fast" : "normal");
 
@@ -712,17 +713,79 @@ PathRequest::doUpdate(std::shared_ptr<RippleLineCache> const& cache, bool fast)
         newStatus = rpcError(rpcINTERNAL);
     }
 
-    if (fast && quick_reply_ == steady_clock::time_point{})
+    reportReply(fast);
+
     {
-        quick_reply_ = steady_clock::now();
-        mOwner.reportFast(duration_cast<milliseconds>(quick_reply_ - created_));
+        std::lock_guard sl(mLock);
+        jvStatus = newStatus;
     }
-    else if (!fast && full_reply_ == steady_clock::time_point{})
+
+    return newStatus;
+}
+
+std::optional<uint256>
+PathRequest::updateKey()
+{
+    std::lock_guard sl(mLock);
+
+    if (hasCompletion() || !raSrcAccount || !raDstAccount)
+        return std::nullopt;
+
+    Serializer s;
+    s.addBitString(*raSrcAccount);
+    s.addBitString(*raDstAccount);
+    saDstAmount.add(s);
+    s.add8(saSendMax ? 1 : 0);
+    if (saSendMax)
+        saSendMax->add(s);
+    s.add8(convert_all_ ? 1 : 0);
+    s.add32(sciSourceCurrencies.size());
+    for (auto const& issue : sciSourceCurrencies)
+    {
+        s.addBitString(issue.currency);
+        s.addBitString(issue.account);
+    }
+    s.add32(iLevel);
+    s.add8(bLastSuccess ? 1 : 0);
+    s.add32(mContext.size());
+    for (auto const& [issue, paths] : mContext)
+    {
+        s.addBitString(issue.currency);
+        s.addBitString(issue.account);
+        paths.add(s);
+    }
+    return s.getSHA512Half();
+}
+
+Json::Value
+PathRequest::doUpdate(PathRequest& leader, bool fast)
+{
+    JLOG(m_journal.debug()) << iIdentifier << " update "
+                            << (fast ? "fast" : "normal") << " from "
+                            << leader.iIdentifier;
+
+    Json::Value newStatus;
     {
-        full_reply_ = steady_clock::now();
-        mOwner.reportFull(duration_cast<milliseconds>(full_reply_ - created_));
+        std::lock_guard sl(leader.mLock);
+        newStatus = leader.jvStatus;
+        iLevel = leader.iLevel;
+        bLastSuccess = leader.bLastSuccess;
+        mContext = leader.mContext;
+    }
+
+    // Errors carry no id
+    if (newStatus.isMember(jss::alternatives))
+    {
+        newStatus[jss::full_reply] = !fast;
+        if (jvId)
+            newStatus[jss::id] = jvId;
+        else
+            newStatus.removeMember(jss::id);
     }
 
+    consumer_.charge(Resource::feePathFindUpdate);
+    reportReply(fast);
+
     {
         std::lock_guard sl(mLock);
         jvStatus = newStatus;
@@ -731,6 +794,22 @@ PathRequest::doUpdate(std::shared_ptr<RippleLineCache> const& cache, bool fast)
     return newStatus;
 }
 
+void
+PathRequest::reportReply(bool fast)
+{
+    using namespace std::chrono;
+    if (fast && quick_reply_ == steady_clock::time_point{})
+    {
+        quick_reply_ = steady_clock::now();
+        mOwner.reportFast(duration_cast<milliseconds>(quick_reply_ - created_));
+    }
+    else if (!fast && full_reply_ == steady_clock::time_point{})
+    {
+        full_reply_ = steady_clock::now();
+        mOwner.reportFull(duration_cast<milliseconds>(full_reply_ - created_));
+    }
+}
+
 InfoSub::pointer
 PathRequest::getSubscriber()
 {
@@ -98,6 +98,21 @@ public:
     // update jvStatus
     Json::Value
     doUpdate(std::shared_ptr<RippleLineCache> const&, bool fast);
+
+    /** Returns what the next update of this request depends on.
+
+        Requests with the same key find the same paths, so that one of them
+        can take its update from another.  Returns nothing for requests
+        which don't share their updates.
+    */
+    std::optional<uint256>
+    updateKey();
+
+    /** Update jvStatus from a request with the same key which was just
+        updated.
+    */
+    Json::Value
+    doUpdate(PathRequest& leader, bool fast);
     InfoSub::pointer
     getSubscriber();
     bool
@@ -124,6 +139,9 @@ private:
     int
     parseJson(Json::Value const&);
 
+    void
+    reportReply(bool fast);
+
     Application& app_;
     beast::Journal m_journal;
 
@@ -22,6 +22,7 @@
 #include <ripple/app/paths/PathRequests.h>
 #include <ripple/basics/Log.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/core/ParallelFor.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
@@ -49,7 +50,10 @@ PathRequests::getLineCache(
          ((lgrSeq + 8) < lineSeq)) ||  // we jumped way back for some reason
         (lgrSeq > (lineSeq + 8)))      // we jumped way forward for some reason
     {
-        mLineCache = std::make_shared<RippleLineCache>(ledger);
+        // Carry the lines which didn't change over from the last ledger
+        mLineCache = mLineCache
+            ? std::make_shared<RippleLineCache>(ledger, *mLineCache)
+            : std::make_shared<RippleLineCache>(ledger);
     }
     return mLineCache;
 }
@@ -73,81 +77,113 @@ PathRequests::updateAll(
     }
 
     bool newRequests = app_.getLedgerMaster().isNewPathRequest();
-    bool mustBreak = false;
+    std::atomic<bool> mustBreak = false;
 
     JLOG(mJournal.trace()) << "updateAll seq=" << cache->getLedger()->seq()
                            << ", " << requests.size() << " requests";
 
-    int processed = 0, removed = 0;
+    std::atomic<int> processed = 0, removed = 0;
+    int deduplicated = 0;
+    auto const start = std::chrono::steady_clock::now();
+    bool reported = false;
+
+    auto forEach = [&](std::size_t n, std::function<bool(std::size_t)> f) {
+        std::make_shared<ParallelFor>(n, std::move(f))
+            ->run(
+                app_.getJobQueue(),
+                jtUPDATE_PF,
+                "PathRequests::update",
+                app_.config().PATH_FIND_WORKERS);
+    };
 
     do
     {
+        mustBreak = false;
+        int const processedBefore = processed;
+        int const deduplicatedBefore = deduplicated;
+
+        std::vector<PathRequest::pointer> live;
+        live.reserve(requests.size());
         for (auto const& wr : requests)
         {
-            if (shouldCancel())
-                break;
-
-            auto request = wr.lock();
-            bool remove = true;
+            if (auto request = wr.lock())
+                live.push_back(std::move(request));
+            else
+                remove(nullptr, removed);
+        }
 
-            if (request)
+        // Requests which find the same paths as an earlier one take its
+        // update instead of searching again.
+        std::vector<PathRequest::pointer> leaders;
+        std::vector<std::pair<PathRequest::pointer, std::size_t>> followers;
+        {
+            hash_map<uint256, std::size_t> byKey;
+            for (auto& request : live)
             {
-                if (!request->needsUpdate(
-                        newRequests, cache->getLedger()->seq()))
-                    remove = false;
-                else
+                auto const key = request->updateKey();
+                if (key)
                 {
-                    if (auto ipSub = request->getSubscriber())
+                    auto const [it, inserted] =
+                        byKey.emplace(*key, leaders.size());
+                    if (!inserted)
                     {
-                        if (!ipSub->getConsumer().warn())
-                        {
-                            Json::Value update =
-                                request->doUpdate(cache, false);
-                            request->updateComplete();
-                            update[jss::type] = "path_find";
-                            ipSub->send(update, false);
-                            remove = false;
-                            ++processed;
-                        }
-                    }
-                    else if (request->hasCompletion())
-                    {
-                        // One-shot request with completion function
-                        request->doUpdate(cache, false);
-                        request->updateComplete();
-                        ++processed;
+                        followers.emplace_back(std::move(request), it->second);
+                        continue;
                     }
                 }
+                leaders.push_back(std::move(request));
             }
+        }
+        std::vector<std::uint8_t> updated(leaders.size(), 0);
 
-            if (remove)
-            {
-                std::lock_guard sl(mLock);
-
-                // Remove any dangling weak pointers or weak
-                // pointers that refer to this path request.
-                auto ret = std::remove_if(
-                    requests_.begin(),
-                    requests_.end(),
-                    [&removed, &request](auto const& wl) {
-                        auto r = wl.lock();
-
-                        if (r && r != request)
-                            return false;
-                        ++removed;
-                        return true;
-                    });
-
-                requests_.erase(ret, requests_.end());
-            }
-
-            mustBreak =
-                !newRequests && app_.getLedgerMaster().isNewPathRequest();
-
+        // Returns false once the pass should stop
+        auto next = [&]() {
             // We weren't handling new requests and then
             // there was a new request
-            if (mustBreak)
-                break;
+            if (!newRequests && app_.getLedgerMaster().isNewPathRequest())
+                mustBreak = true;
+            return !mustBreak;
+        };
+
+        forEach(leaders.size(), [&](std::size_t i) {
+            if (shouldCancel())
+                return false;
+            updated[i] = update(
+                leaders[i], nullptr, cache, newRequests, processed, removed);
+            return next();
+        });
+
+        if (!mustBreak && !followers.empty() && !shouldCancel())
+        {
+            std::atomic<int> followed = 0;
+            forEach(followers.size(), [&](std::size_t i) {
+                if (shouldCancel())
+                    return false;
+                // If the leader wasn't updated, search on our own
+                auto const& [request, index] = followers[i];
+                auto const leader =
+                    updated[index] ? leaders[index].get() : nullptr;
+                bool const done = update(
+                    request, leader, cache, newRequests, processed, removed);
+                if (done && leader)
+                    ++followed;
+                return next();
+            });
+            deduplicated += followed;
+        }
+
+        if (!reported && !newRequests && !mustBreak && !shouldCancel() &&
+            !cache->getLedger()->open())
+        {
+            // Every request has been brought up to this ledger
+            reported = true;
+            std::lock_guard sl(mLock);
+            lastUpdate_ = {
+                cache->getLedger()->seq(),
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start),
+                processed - processedBefore,
+                deduplicated - deduplicatedBefore};
         }
 
         if (mustBreak)
@@ -177,7 +213,87 @@ PathRequests::updateAll(
     } while (!shouldCancel());
 
     JLOG(mJournal.debug()) << "updateAll complete: " << processed
-                           << " processed and " << removed << " removed";
+                           << " processed, " << deduplicated
+                           << " deduplicated and " << removed << " removed";
+}
+
+bool
+PathRequests::update(
+    PathRequest::pointer const& request,
+    PathRequest* leader,
+    std::shared_ptr<RippleLineCache> const& cache,
+    bool newRequests,
+    std::atomic<int>& processed,
+    std::atomic<int>& removed)
+{
+    if (!request->needsUpdate(newRequests, cache->getLedger()->seq()))
+        return false;
+
+    if (auto ipSub = request->getSubscriber())
+    {
+        if (!ipSub->getConsumer().warn())
+        {
+            Json::Value update = leader ? request->doUpdate(*leader, false)
+                                        : request->doUpdate(cache, false);
+            request->updateComplete();
+            update[jss::type] = "path_find";
+            ipSub->send(update, false);
+            ++processed;
+            return true;
+        }
+    }
+    else if (request->hasCompletion())
+    {
+        // One-shot request with completion function
+        request->doUpdate(cache, false);
+        request->updateComplete();
+        ++processed;
+        return true;
+    }
+
+    remove(request, removed);
+    return false;
+}
+
+void
+PathRequests::remove(
+    PathRequest::pointer const& request,
+    std::atomic<int>& removed)
+{
+    std::lock_guard sl(mLock);
+
+    // Remove any dangling weak pointers or weak
+    // pointers that refer to this path request.
+    auto ret = std::remove_if(
+        requests_.begin(),
+        requests_.end(),
+        [&removed, &request](auto const& wl) {
+            auto r = wl.lock();
+
+            if (r && r != request)
+                return false;
+            ++removed;
+            return true;
+        });
+
+    requests_.erase(ret, requests_.end());
+}
+
+Json::Value
+PathRequests::getJson()
+{
+    Json::Value ret(Json::objectValue);
+    std::lock_guard sl(mLock);
+    ret[jss::requests] = Json::UInt(requests_.size());
+    ret[jss::workers] = app_.config().PATH_FIND_WORKERS;
+    if (lastUpdate_.seq != 0)
+    {
+        ret[jss::ledger_index] = lastUpdate_.seq;
+        ret[jss::update_ms] = Json::UInt(lastUpdate_.duration.count());
+        ret[jss::processed] = lastUpdate_.processed;
+        ret[jss::deduplicated] = lastUpdate_.deduplicated;
+    }
+    return ret;
 }
 
 void
@@ -46,6 +46,10 @@ public:
 
     /** Update all of the contained PathRequest instances.
 
+        The requests are shared out among `[path_find_workers]` jobs, which
+        all use the same RippleLineCache.  Of the requests which would find
+        the same paths, only the first searches; the others take its result.
+
         @param ledger Ledger we are pathfinding in.
         @param shouldCancel Invocable that returns whether to cancel.
      */
@@ -98,10 +102,28 @@ public:
         mFull.notify(ms);
     }
 
+    /** Returns how long the requests took to update for the last ledger. */
+    Json::Value
+    getJson();
+
 private:
     void
     insertPathRequest(PathRequest::pointer const&);
 
+    // Returns whether the request was updated, from the leader if there is
+    // one.  Requests which can't be updated any longer are removed.
+    bool
+    update(
+        PathRequest::pointer const& request,
+        PathRequest* leader,
+        std::shared_ptr<RippleLineCache> const& cache,
+        bool newRequests,
+        std::atomic<int>& processed,
+        std::atomic<int>& removed);
+
+    void
+    remove(PathRequest::pointer const& request, std::atomic<int>& removed);
+
     Application& app_;
     beast::Journal mJournal;
 
@@ -116,6 +138,16 @@ private:
 
     std::atomic<int> mLastIdentifier;
 
+    // The last pass which brought every request up to a closed ledger
+    struct Update
+    {
+        LedgerIndex seq = 0;
+        std::chrono::milliseconds duration{0};
+        int processed = 0;
+        int deduplicated = 0;
+    };
+    Update lastUpdate_;
+
     std::recursive_mutex mLock;
 };
 
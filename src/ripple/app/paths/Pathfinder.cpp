@@ -339,6 +339,52 @@ Pathfinder::getPathLiquidity(
                                    //      deliver to be worth keeping.
     STAmount& amountOut,           // OUT: The actual liquidity along the path.
     uint64_t& qualityOut) const    // OUT: The returned initial quality
+{
+    // The result depends only on the ledger, which the line cache is for,
+    // and on these.  Candidate paths repeat between the complete paths and
+    // a request's extra paths, and between the requests and updates in one
+    // ledger, so the line cache keeps the result for all of them.
+    Serializer s;
+    s.addBitString(mSrcAccount);
+    s.addBitString(mDstAccount);
+    mSrcAmount.add(s);
+    mDstAmount.add(s);
+    minDstAmount.add(s);
+    s.add8(convert_all_ ? 1 : 0);
+    STPathSet pathSet;
+    pathSet.push_back(path);
+    pathSet.add(s);
+    auto const key = s.getSHA512Half();
+
+    if (auto const memo = mRLCache->getPathLiquidity(key))
+    {
+        if (memo->result == tesSUCCESS)
+        {
+            amountOut = memo->amount;
+            qualityOut = memo->quality;
+        }
+        return memo->result;
+    }
+
+    auto const result =
+        computePathLiquidity(path, minDstAmount, amountOut, qualityOut);
+    // An exception may come from a ledger node which isn't here yet
+    if (result != tefEXCEPTION)
+    {
+        if (result == tesSUCCESS)
+            mRLCache->setPathLiquidity(key, {result, amountOut, qualityOut});
+        else
+            mRLCache->setPathLiquidity(key, {result, {}, 0});
+    }
+    return result;
+}
+
+TER
+Pathfinder::computePathLiquidity(
+    STPath const& path,
+    STAmount const& minDstAmount,
+    STAmount& amountOut,
+    uint64_t& qualityOut) const
 {
     STPathSet pathSet;
     pathSet.push_back(path);
@@ -702,7 +748,7 @@ Pathfinder::getPathsOut(
     if (!inserted)
         return it->second;
 
-    auto sleAccount = mLedger->read(keylet::account(account));
+    auto sleAccount = mLedger->readLazy(keylet::account(account));
 
     if (!sleAccount)
         return 0;
@@ -924,7 +970,7 @@ Pathfinder::addLink(
         else
         {
             // search for accounts to add
-            auto const sleEnd = mLedger->read(keylet::account(uEndAccount));
+            auto const sleEnd = mLedger->readLazy(keylet::account(uEndAccount));
 
             if (sleEnd)
             {
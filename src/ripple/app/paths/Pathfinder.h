@@ -120,7 +120,8 @@ private:
       computePathRanks:
           rippleCalculate
           getPathLiquidity:
-              rippleCalculate
+              computePathLiquidity:
+                  rippleCalculate
 
       getBestPaths
      */
@@ -162,6 +163,14 @@ private:
         STAmount& amountOut,           // OUT: The actual liquidity on the path.
         uint64_t& qualityOut) const;   // OUT: The returned initial quality
 
+    // getPathLiquidity() without the cache.
+    TER
+    computePathLiquidity(
+        STPath const& path,
+        STAmount const& minDstAmount,
+        STAmount& amountOut,
+        uint64_t& qualityOut) const;
+
     // Does this path end on an account-to-account link whose last account has
     // set the "no ripple" flag on the link?
     bool
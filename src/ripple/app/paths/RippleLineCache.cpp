@@ -19,9 +19,51 @@
 
 #include <ripple/app/paths/RippleLineCache.h>
 #include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/SField.h>
 
 namespace ripple {
 
+// Returns the accounts at either end of the trust lines which the ledger's
+// transactions created, modified or deleted, or nothing if they can't all
+// be determined.
+static std::optional<hash_set<AccountID>>
+changedAccounts(ReadView const& ledger)
+{
+    hash_set<AccountID> accounts;
+    try
+    {
+        for (auto const& [tx, meta] : ledger.txs)
+        {
+            (void)tx;
+            if (!meta)
+                return std::nullopt;
+
+            for (auto const& node : meta->getFieldArray(sfAffectedNodes))
+            {
+                if (node.getFieldU16(sfLedgerEntryType) != ltRIPPLE_STATE)
+                    continue;
+
+                auto const fields = dynamic_cast<STObject const*>(
+                    node.peekAtPField(
+                        node.getFName() == sfCreatedNode ? sfNewFields
+                                                         : sfFinalFields));
+                if (!fields || !fields->isFieldPresent(sfLowLimit) ||
+                    !fields->isFieldPresent(sfHighLimit))
+                    return std::nullopt;
+
+                accounts.insert(fields->getFieldAmount(sfLowLimit).getIssuer());
+                accounts.insert(
+                    fields->getFieldAmount(sfHighLimit).getIssuer());
+            }
+        }
+    }
+    catch (std::exception const&)
+    {
+        return std::nullopt;
+    }
+    return accounts;
+}
+
 RippleLineCache::RippleLineCache(std::shared_ptr<ReadView const> const& ledger)
 {
     // We want the caching that OpenView provides
@@ -30,6 +72,33 @@ RippleLineCache::RippleLineCache(std::shared_ptr<ReadView const> const& ledger)
     mLedger = std::make_shared<OpenView>(&*ledger, ledger);
 }
 
+RippleLineCache::RippleLineCache(
+    std::shared_ptr<ReadView const> const& ledger,
+    RippleLineCache& previous)
+    : RippleLineCache(ledger)
+{
+    auto const& prior = previous.mLedger->info();
+    if (ledger->open() || previous.mLedger->open() ||
+        ledger->info().seq != prior.seq + 1 ||
+        ledger->info().parentHash != prior.hash)
+        return;
+
+    auto const changed = changedAccounts(*ledger);
+    if (!changed)
+        return;
+
+    // The keys hold hashes made by the previous cache's hasher
+    hasher_ = previous.hasher_;
+
+    std::lock_guard sl(previous.mLock);
+    lines_.reserve(previous.lines_.size());
+    for (auto const& [key, lines] : previous.lines_)
+    {
+        if (changed->count(key.account_) == 0)
+            lines_.emplace(key, lines);
+    }
+}
+
 std::vector<RippleState::pointer> const&
 RippleLineCache::getRippleLines(AccountID const& accountID)
 {
@@ -37,13 +106,41 @@ RippleLineCache::getRippleLines(AccountID const& accountID)
 
     std::lock_guard sl(mLock);
 
-    auto [it, inserted] =
-        lines_.emplace(key, std::vector<RippleState::pointer>());
+    auto it = lines_.find(key);
+    if (it == lines_.end())
+    {
+        auto lines = std::make_shared<std::vector<RippleState::pointer> const>(
+            getRippleStateItems(accountID, *mLedger));
+        it = lines_.emplace(key, std::move(lines)).first;
+    }
 
-    if (inserted)
-        it->second = getRippleStateItems(accountID, *mLedger);
+    return *it->second;
+}
+
+std::size_t
+RippleLineCache::size()
+{
+    std::lock_guard sl(mLock);
+    return lines_.size();
+}
 
+std::optional<RippleLineCache::PathLiquidity>
+RippleLineCache::getPathLiquidity(uint256 const& key)
+{
+    std::lock_guard sl(mLock);
+    auto const it = liquidity_.find(key);
+    if (it == liquidity_.end())
+        return std::nullopt;
     return it->second;
 }
 
+void
+RippleLineCache::setPathLiquidity(
+    uint256 const& key,
+    PathLiquidity const& liquidity)
+{
+    std::lock_guard sl(mLock);
+    liquidity_.emplace(key, liquidity);
+}
+
 }  // namespace ripple
@@ -23,9 +23,13 @@
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/app/paths/RippleState.h>
 #include <ripple/basics/hardened_hash.h>
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/TER.h>
 #include <cstddef>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 namespace ripple {
@@ -36,6 +40,17 @@ class RippleLineCache
 public:
     explicit RippleLineCache(std::shared_ptr<ReadView const> const& l);
 
+    /** Create a cache for the ledger which follows that of another cache.
+
+        The lines of the accounts which the ledger's transactions left
+        alone are shared with the other cache instead of being read again.
+        Nothing is shared unless both ledgers are closed and this one
+        directly follows the other's.
+    */
+    RippleLineCache(
+        std::shared_ptr<ReadView const> const& l,
+        RippleLineCache& previous);
+
     std::shared_ptr<ReadView const> const&
     getLedger() const
     {
@@ -45,6 +60,31 @@ public:
     std::vector<RippleState::pointer> const&
     getRippleLines(AccountID const& accountID);
 
+    /** Returns the number of accounts whose lines are cached. */
+    std::size_t
+    size();
+
+    /** The liquidity of a path, as the Pathfinder ranks it. */
+    struct PathLiquidity
+    {
+        TER result;
+        STAmount amount;
+        std::uint64_t quality;
+    };
+
+    /** Returns the path liquidity stored under a key, if any.
+
+        The liquidity of a path depends only on the ledger and on what the
+        Pathfinder puts in the key, so every search in the ledger can reuse
+        it: the candidates of one search, the extra paths of a request and
+        the updates of all requests.
+    */
+    std::optional<PathLiquidity>
+    getPathLiquidity(uint256 const& key);
+
+    void
+    setPathLiquidity(uint256 const& key, PathLiquidity const& liquidity);
+
 private:
     std::mutex mLock;
 
@@ -90,8 +130,13 @@ private:
         };
     };
 
-    hash_map<AccountKey, std::vector<RippleState::pointer>, AccountKey::Hash>
-        lines_;
+    // Once read, the lines of an account don't change, so they can be
+    // shared by the caches of later ledgers.
+    using Lines = std::shared_ptr<std::vector<RippleState::pointer> const>;
+
+    hash_map<AccountKey, Lines, AccountKey::Hash> lines_;
+
+    hash_map<uint256, PathLiquidity> liquidity_;
 };
 
 }  // namespace ripple
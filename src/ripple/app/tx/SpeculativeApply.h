@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_TX_SPECULATIVEAPPLY_H_INCLUDED
+#define RIPPLE_TX_SPECULATIVEAPPLY_H_INCLUDED
+
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/core/JobQueue.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/protocol/TER.h>
+#include <functional>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ripple {
+
+/** Applies transactions to an open view ahead of time, in parallel.
+
+    run() applies each transaction to a view of its own on top of the open
+    view, recording the keys it reads.  The caller then applies the
+    transactions to the open view in its own order with apply().  If
+    nothing the transaction read or changed has been changed in the open
+    view since run(), its changes are merged in as they are, since
+    applying it again would give the same.  Otherwise it is applied again.
+    Either way the open view ends up as if each transaction had been
+    applied to it in turn.
+
+    Every change to the open view between run() and the last apply() must
+    be made through apply().  The open view must not change while run()
+    is running.
+*/
+class SpeculativeApply
+{
+public:
+    /** Applies one transaction to a view.
+
+        Returns the result and whether the transaction was applied, as
+        ripple::apply() does.
+    */
+    using Apply = std::function<std::pair<TER, bool>(OpenView&)>;
+
+    explicit SpeculativeApply(OpenView const& view);
+
+    ~SpeculativeApply();
+
+    SpeculativeApply(SpeculativeApply const&) = delete;
+    SpeculativeApply&
+    operator=(SpeculativeApply const&) = delete;
+
+    /** Apply the transactions ahead of time, on up to `workers` threads.
+
+        @param txs Each transaction's ID and how to apply it.
+    */
+    void
+    run(JobQueue& jobQueue,
+        int workers,
+        std::vector<std::pair<uint256, Apply>> const& txs);
+
+    /** Apply a transaction to the open view. */
+    std::pair<TER, bool>
+    apply(OpenView& view, uint256 const& id, Apply const& f);
+
+    /** Returns the number of transactions merged as they were run. */
+    std::size_t
+    merged() const
+    {
+        return merged_;
+    }
+
+    /** Returns the number of transactions applied again. */
+    std::size_t
+    conflicts() const
+    {
+        return conflicts_;
+    }
+
+private:
+    class FootprintView;
+    class Recorder;
+    struct Speculation;
+
+    // Moves the transactions of `from` by `shift` places in the order
+    // of `view`
+    void
+    merge(OpenView const& from, OpenView& view, std::ptrdiff_t shift);
+
+    OpenView const& view_;
+    hash_map<uint256, std::unique_ptr<Speculation>> speculations_;
+
+    // What apply() changed in the open view
+    std::set<uint256> written_;
+    hash_set<uint256> txs_;
+
+    std::size_t merged_ = 0;
+    std::size_t conflicts_ = 0;
+};
+
+}  // namespace ripple
+
+#endif
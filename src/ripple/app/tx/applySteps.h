@@ -178,10 +178,43 @@ public:
     {
     }
 
+    /** Returns the result of an earlier successful `preflight`.
+
+        The transaction must have passed `preflight` with the same rules
+        and flags, which gave these consequences.  This is for callers
+        which remember results, and must not be used to skip the check.
+    */
+    static PreflightResult
+    remembered(
+        STTx const& tx,
+        Rules const& rules,
+        ApplyFlags flags,
+        TxConsequences const& consequences,
+        beast::Journal j)
+    {
+        return PreflightResult(tx, rules, flags, consequences, j);
+    }
+
     PreflightResult(PreflightResult const&) = default;
     /// Deleted copy assignment operator
     PreflightResult&
     operator=(PreflightResult const&) = delete;
+
+private:
+    PreflightResult(
+        STTx const& tx_,
+        Rules const& rules_,
+        ApplyFlags flags_,
+        TxConsequences const& consequences_,
+        beast::Journal j_)
+        : tx(tx_)
+        , rules(rules_)
+        , consequences(consequences_)
+        , flags(flags_)
+        , j(j_)
+        , ter(tesSUCCESS)
+    {
+    }
 };
 
 /** Describes the results of the `preclaim` check
@@ -0,0 +1,381 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/tx/SpeculativeApply.h>
+#include <ripple/core/ParallelFor.h>
+#include <ripple/protocol/STObject.h>
+#include <optional>
+
+namespace ripple {
+
+// Passes reads through to the open view and records what they depend on
+class SpeculativeApply::FootprintView : public ReadView
+{
+    ReadView const& base_;
+
+public:
+    // A succ() result depends on the keys in (from, to], or (from, to) if
+    // `to` is what bounded the search, or everything after `from`
+    struct Range
+    {
+        uint256 from;
+        std::optional<uint256> to;
+        bool inclusive;
+    };
+
+    std::vector<uint256> mutable keys;
+    std::vector<Range> mutable ranges;
+    std::vector<uint256> mutable txs;
+
+    // Iterating the state or the transactions depends on everything
+    bool mutable opaque = false;
+
+    explicit FootprintView(ReadView const& base) : base_(base)
+    {
+    }
+
+    // Returns `true` if the records depend on any of the keys changed
+    bool
+    dependsOn(
+        std::set<uint256> const& written,
+        hash_set<uint256> const& inserted) const
+    {
+        if (opaque)
+            return !written.empty() || !inserted.empty();
+        for (auto const& key : keys)
+        {
+            if (written.count(key))
+                return true;
+        }
+        for (auto const& r : ranges)
+        {
+            auto const it = written.upper_bound(r.from);
+            if (it != written.end() &&
+                (!r.to || *it < *r.to || (r.inclusive && *it == *r.to)))
+                return true;
+        }
+        for (auto const& tx : txs)
+        {
+            if (inserted.count(tx))
+                return true;
+        }
+        return false;
+    }
+
+    LedgerInfo const&
+    info() const override
+    {
+        return base_.info();
+    }
+
+    bool
+    open() const override
+    {
+        return base_.open();
+    }
+
+    Fees const&
+    fees() const override
+    {
+        return base_.fees();
+    }
+
+    Rules const&
+    rules() const override
+    {
+        return base_.rules();
+    }
+
+    bool
+    exists(Keylet const& k) const override
+    {
+        record(k.key);
+        return base_.exists(k);
+    }
+
+    std::optional<key_type>
+    succ(key_type const& key, std::optional<key_type> const& last)
+        const override
+    {
+        auto const next = base_.succ(key, last);
+        if (next)
+            ranges.push_back({key, next, true});
+        else
+            ranges.push_back({key, last, false});
+        return next;
+    }
+
+    std::shared_ptr<SLE const>
+    read(Keylet const& k) const override
+    {
+        record(k.key);
+        return base_.read(k);
+    }
+
+    std::shared_ptr<SLEView const>
+    readLazy(Keylet const& k) const override
+    {
+        record(k.key);
+        return base_.readLazy(k);
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesBegin() const override
+    {
+        opaque = true;
+        return base_.slesBegin();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesEnd() const override
+    {
+        opaque = true;
+        return base_.slesEnd();
+    }
+
+    std::unique_ptr<sles_type::iter_base>
+    slesUpperBound(key_type const& key) const override
+    {
+        opaque = true;
+        return base_.slesUpperBound(key);
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsBegin() const override
+    {
+        opaque = true;
+        return base_.txsBegin();
+    }
+
+    std::unique_ptr<txs_type::iter_base>
+    txsEnd() const override
+    {
+        opaque = true;
+        return base_.txsEnd();
+    }
+
+    bool
+    txExists(key_type const& key) const override
+    {
+        txs.push_back(key);
+        return base_.txExists(key);
+    }
+
+    tx_type
+    txRead(key_type const& key) const override
+    {
+        txs.push_back(key);
+        return base_.txRead(key);
+    }
+
+private:
+    void
+    record(uint256 const& key) const
+    {
+        keys.push_back(key);
+    }
+};
+
+// Collects the keys a view changes, passing the changes on if given a view
+class SpeculativeApply::Recorder : public TxsRawView
+{
+    TxsRawView* to_;
+
+    // How far the transactions move in the order of the view they're
+    // passed on to
+    std::ptrdiff_t shift_;
+
+public:
+    std::set<uint256>& written;
+    hash_set<uint256>& txs;
+
+    Recorder(
+        TxsRawView* to,
+        std::set<uint256>& written_,
+        hash_set<uint256>& txs_,
+        std::ptrdiff_t shift = 0)
+        : to_(to), shift_(shift), written(written_), txs(txs_)
+    {
+    }
+
+    void
+    rawErase(std::shared_ptr<SLE> const& sle) override
+    {
+        written.insert(sle->key());
+        if (to_)
+            to_->rawErase(sle);
+    }
+
+    void
+    rawInsert(std::shared_ptr<SLE> const& sle) override
+    {
+        written.insert(sle->key());
+        if (to_)
+            to_->rawInsert(sle);
+    }
+
+    void
+    rawReplace(std::shared_ptr<SLE> const& sle) override
+    {
+        written.insert(sle->key());
+        if (to_)
+            to_->rawReplace(sle);
+    }
+
+    void
+    rawDestroyXRP(XRPAmount const& fee) override
+    {
+        if (to_)
+            to_->rawDestroyXRP(fee);
+    }
+
+    void
+    rawTxInsert(
+        ReadView::key_type const& key,
+        std::shared_ptr<Serializer const> const& txn,
+        std::shared_ptr<Serializer const> const& metaData) override
+    {
+        txs.insert(key);
+        if (!to_)
+            return;
+        if (shift_ == 0 || !metaData)
+            return to_->rawTxInsert(key, txn, metaData);
+
+        // The transaction index in the metadata is its place in the view
+        SerialIter sit(metaData->slice());
+        STObject meta(sit, sfMetadata);
+        meta.setFieldU32(
+            sfTransactionIndex,
+            static_cast<std::uint32_t>(
+                meta.getFieldU32(sfTransactionIndex) + shift_));
+        auto s = std::make_shared<Serializer>();
+        meta.add(*s);
+        to_->rawTxInsert(key, txn, s);
+    }
+};
+
+struct SpeculativeApply::Speculation
+{
+    FootprintView footprint;
+    OpenView view;
+    std::pair<TER, bool> result{tefINTERNAL, false};
+
+    // The place the transaction is expected to take in the open view
+    std::size_t txIndex;
+
+    Speculation(ReadView const& base, std::size_t txIndex_)
+        : footprint(base)
+        , view(batch_view, &footprint, txIndex_)
+        , txIndex(txIndex_)
+    {
+    }
+};
+
+//------------------------------------------------------------------------------
+
+SpeculativeApply::SpeculativeApply(OpenView const& view) : view_(view)
+{
+}
+
+SpeculativeApply::~SpeculativeApply() = default;
+
+void
+SpeculativeApply::run(
+    JobQueue& jobQueue,
+    int workers,
+    std::vector<std::pair<uint256, Apply>> const& txs)
+{
+    // Each transaction is expected to follow all those before it
+    auto const txCount = view_.txCount();
+    std::vector<std::unique_ptr<Speculation>> results(txs.size());
+    std::make_shared<ParallelFor>(
+        txs.size(),
+        [&](std::size_t i) {
+            auto s = std::make_unique<Speculation>(view_, txCount + i);
+            try
+            {
+                s->result = txs[i].second(s->view);
+                results[i] = std::move(s);
+            }
+            catch (std::exception const&)
+            {
+                // apply() tries again and reports it
+            }
+            return true;
+        })
+        ->run(jobQueue, jtACCEPT, "SpeculativeApply", workers);
+
+    for (std::size_t i = 0; i < txs.size(); ++i)
+    {
+        if (results[i])
+            speculations_.emplace(txs[i].first, std::move(results[i]));
+    }
+}
+
+std::pair<TER, bool>
+SpeculativeApply::apply(OpenView& view, uint256 const& id, Apply const& f)
+{
+    if (auto const it = speculations_.find(id); it != speculations_.end())
+    {
+        auto const s = std::move(it->second);
+        speculations_.erase(it);
+
+        // Its own changes must not overlap those made since, either
+        std::set<uint256> written;
+        hash_set<uint256> txs;
+        Recorder changes(nullptr, written, txs);
+        s->view.apply(changes);
+        bool overlaps = false;
+        for (auto const& key : written)
+            overlaps = overlaps || written_.count(key);
+        for (auto const& tx : txs)
+            overlaps = overlaps || txs_.count(tx);
+
+        if (!overlaps && !s->footprint.dependsOn(written_, txs_))
+        {
+            // Earlier transactions which weren't applied leave it
+            // further up than expected
+            merge(
+                s->view,
+                view,
+                static_cast<std::ptrdiff_t>(view.txCount()) -
+                    static_cast<std::ptrdiff_t>(s->txIndex));
+            ++merged_;
+            return s->result;
+        }
+        ++conflicts_;
+    }
+
+    OpenView next(batch_view, &view, view.txCount());
+    auto const result = f(next);
+    merge(next, view, 0);
+    return result;
+}
+
+void
+SpeculativeApply::merge(
+    OpenView const& from,
+    OpenView& view,
+    std::ptrdiff_t shift)
+{
+    Recorder to(&view, written_, txs_, shift);
+    from.apply(to);
+}
+
+}  // namespace ripple
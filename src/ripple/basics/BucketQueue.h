@@ -0,0 +1,228 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_BUCKETQUEUE_H_INCLUDED
+#define RIPPLE_BASICS_BUCKETQUEUE_H_INCLUDED
+
+#include <boost/intrusive/list.hpp>
+#include <boost/intrusive/set.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+
+namespace ripple {
+
+/** An intrusive priority queue of elements grouped by level.
+
+    Elements are ordered from the highest level to the lowest, and in the
+    order they were inserted within a level: the order of a
+    `boost::intrusive::multiset` ordered by decreasing level.  But the
+    elements are kept in one list, and only the last element of each level
+    is also kept in a tree.  Inserting an element takes time logarithmic in
+    the number of distinct levels, and removing an element, finding it and
+    walking the queue take constant time.  Nothing is allocated.
+
+    The queue doesn't own its elements, which are linked through a
+    `boost::intrusive::list_member_hook<>` and a
+    `boost::intrusive::set_member_hook<>`, both in the default `safe_link`
+    mode.  An element's level must not change while it is in the queue.
+
+    @tparam T The element type.
+    @tparam Level The type of level, ordered by `std::greater`.
+    @tparam LevelOf A function object returning the level of a `T const&`.
+    @tparam ListHook The `boost::intrusive::member_hook` option of the list
+                     hook.
+    @tparam SetHook The `boost::intrusive::member_hook` option of the set
+                    hook.
+*/
+template <class T, class Level, class LevelOf, class ListHook, class SetHook>
+class BucketQueue
+{
+    using List = boost::intrusive::list<T, ListHook>;
+
+    struct KeyOf
+    {
+        using type = Level;
+
+        Level
+        operator()(T const& value) const
+        {
+            return LevelOf{}(value);
+        }
+    };
+
+    // The last element of each level
+    using Lasts = boost::intrusive::set<
+        T,
+        SetHook,
+        boost::intrusive::key_of_value<KeyOf>,
+        boost::intrusive::compare<std::greater<Level>>,
+        boost::intrusive::constant_time_size<false>>;
+
+public:
+    using value_type = T;
+    using iterator = typename List::iterator;
+    using const_iterator = typename List::const_iterator;
+    using reverse_iterator = typename List::reverse_iterator;
+    using const_reverse_iterator = typename List::const_reverse_iterator;
+
+    BucketQueue() = default;
+    BucketQueue(BucketQueue const&) = delete;
+    BucketQueue&
+    operator=(BucketQueue const&) = delete;
+
+    bool
+    empty() const
+    {
+        return items_.empty();
+    }
+
+    std::size_t
+    size() const
+    {
+        return items_.size();
+    }
+
+    iterator
+    begin()
+    {
+        return items_.begin();
+    }
+
+    const_iterator
+    begin() const
+    {
+        return items_.begin();
+    }
+
+    iterator
+    end()
+    {
+        return items_.end();
+    }
+
+    const_iterator
+    end() const
+    {
+        return items_.end();
+    }
+
+    reverse_iterator
+    rbegin()
+    {
+        return items_.rbegin();
+    }
+
+    const_reverse_iterator
+    rbegin() const
+    {
+        return items_.rbegin();
+    }
+
+    reverse_iterator
+    rend()
+    {
+        return items_.rend();
+    }
+
+    const_reverse_iterator
+    rend() const
+    {
+        return items_.rend();
+    }
+
+    /** Insert after the elements of the same level. */
+    iterator
+    insert(T& value)
+    {
+        typename Lasts::insert_commit_data data;
+        auto const [last, fresh] =
+            lasts_.insert_unique_check(LevelOf{}(value), data);
+        if (!fresh)
+        {
+            auto const pos = std::next(items_.iterator_to(*last));
+            lasts_.replace_node(last, value);
+            return items_.insert(pos, value);
+        }
+        // After the last element of the next higher level
+        auto const added = lasts_.insert_unique_commit(value, data);
+        auto const pos = added == lasts_.begin()
+            ? items_.begin()
+            : std::next(items_.iterator_to(*std::prev(added)));
+        return items_.insert(pos, value);
+    }
+
+    /** Remove an element, returning the one which followed it. */
+    iterator
+    erase(const_iterator pos)
+    {
+        assert(pos != end());
+        // Erasing an empty range makes the iterator mutable
+        auto const item = items_.erase(pos, pos);
+        if (isLast(*item))
+        {
+            // Another element of the level, if any, becomes its last
+            auto const last = lasts_.iterator_to(*item);
+            if (item != begin() &&
+                LevelOf{}(*std::prev(item)) == LevelOf{}(*item))
+                lasts_.replace_node(last, *std::prev(item));
+            else
+                lasts_.erase(last);
+        }
+        return items_.erase(item);
+    }
+
+    iterator
+    iterator_to(T& value)
+    {
+        return items_.iterator_to(value);
+    }
+
+    const_iterator
+    iterator_to(T const& value) const
+    {
+        return items_.iterator_to(value);
+    }
+
+    /** Remove every element. */
+    void
+    clear()
+    {
+        lasts_.clear();
+        items_.clear();
+    }
+
+private:
+    static bool
+    isLast(T const& value)
+    {
+        // Unlinked nodes have no parent
+        return !Lasts::node_algorithms::unique(
+            Lasts::value_traits::to_node_ptr(value));
+    }
+
+    List items_;
+    Lasts lasts_;
+};
+
+}  // namespace ripple
+
+#endif
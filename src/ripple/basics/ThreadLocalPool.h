@@ -0,0 +1,130 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_BASICS_THREADLOCALPOOL_H_INCLUDED
+#define RIPPLE_BASICS_THREADLOCALPOOL_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace ripple {
+
+/** Small block allocation from per-thread caches of freed blocks.
+
+    Requests are rounded up to a size class. When a block is freed it is
+    kept by the freeing thread, up to a limit for each class, and handed
+    out again by that thread's next request of the same class. Blocks
+    always come from the global allocator and go back to it when a cache
+    is full or its thread exits, so a block may be freed by any thread and
+    the pool can be disabled at any time. Requests larger than the largest
+    class bypass the pool.
+*/
+class ThreadLocalPool
+{
+public:
+    /** The largest request served from the caches. */
+    static constexpr std::size_t maxSize = 8192;
+
+    /** Allocation counts for the calling thread. */
+    struct Stats
+    {
+        /** Number of allocation requests. */
+        std::uint64_t requests = 0;
+
+        /** Number of requests passed on to the global allocator. */
+        std::uint64_t allocations = 0;
+    };
+
+    static void*
+    allocate(std::size_t bytes);
+
+    static void
+    deallocate(void* p, std::size_t bytes) noexcept;
+
+    /** Enable or disable caching for all threads.
+
+        While disabled every request is passed on to the global allocator
+        and freed blocks are returned to it immediately.
+    */
+    static void
+    enable(bool enabled);
+
+    static bool
+    enabled();
+
+    static Stats
+    stats();
+};
+
+/** A standard allocator which allocates from the ThreadLocalPool.
+
+    The allocator is stateless, so containers using it can be copied,
+    moved and swapped freely and elements can be destroyed on any thread.
+*/
+template <class T>
+class PoolAllocator
+{
+    static_assert(
+        alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+        "Over-aligned types are not supported");
+
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <class U>
+    PoolAllocator(PoolAllocator<U> const&) noexcept
+    {
+    }
+
+    T*
+    allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T*>(ThreadLocalPool::allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T* p, std::size_t n) noexcept
+    {
+        ThreadLocalPool::deallocate(p, n * sizeof(T));
+    }
+};
+
+template <class T, class U>
+bool
+operator==(PoolAllocator<T> const&, PoolAllocator<U> const&) noexcept
+{
+    return true;
+}
+
+template <class T, class U>
+bool
+operator!=(PoolAllocator<T> const&, PoolAllocator<U> const&) noexcept
+{
+    return false;
+}
+
+}  // namespace ripple
+
+#endif
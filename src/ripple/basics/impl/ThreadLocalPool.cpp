@@ -0,0 +1,228 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/ThreadLocalPool.h>
+#include <array>
+#include <atomic>
+
+namespace ripple {
+
+namespace {
+
+constexpr std::size_t
+log2Floor(std::size_t n)
+{
+    std::size_t result = 0;
+    while (n >>= 1)
+        ++result;
+    return result;
+}
+
+// Small size classes are multiples of the granularity. Above that each
+// power of two is split into four classes, which keeps the rounding waste
+// of the large blocks, such as the field lists of transactions and ledger
+// entries, below a quarter.
+std::size_t constexpr granularity = 16;
+std::size_t constexpr smallSize = 512;
+std::size_t constexpr smallCount = smallSize / granularity;
+std::size_t constexpr smallShift = log2Floor(smallSize);
+std::size_t constexpr classCount =
+    smallCount + 4 * (log2Floor(ThreadLocalPool::maxSize) - smallShift);
+
+// The number of bytes each thread may keep cached for each size class. At
+// least a few blocks of every class are kept, which bounds the cache of a
+// thread at about 330KB.
+std::size_t constexpr cacheBytes = 4096;
+std::size_t constexpr minimumBlocks = 4;
+
+std::atomic<bool> poolEnabled{true};
+
+constexpr std::size_t
+sizeClass(std::size_t bytes)
+{
+    if (bytes <= smallSize)
+        return (bytes + granularity - 1) / granularity - 1;
+    auto const shift = log2Floor(bytes - 1);
+    auto const step = std::size_t{1} << (shift - 2);
+    auto const offset = bytes - (std::size_t{1} << shift);
+    return smallCount + 4 * (shift - smallShift) + (offset + step - 1) / step -
+        1;
+}
+
+constexpr std::size_t
+classSize(std::size_t index)
+{
+    if (index < smallCount)
+        return (index + 1) * granularity;
+    auto const shift = smallShift + (index - smallCount) / 4;
+    return (std::size_t{1} << shift) +
+        ((index - smallCount) % 4 + 1) * (std::size_t{1} << (shift - 2));
+}
+
+static_assert(
+    ThreadLocalPool::maxSize > smallSize &&
+    (ThreadLocalPool::maxSize & (ThreadLocalPool::maxSize - 1)) == 0);
+static_assert(sizeClass(smallSize) == smallCount - 1);
+static_assert(sizeClass(smallSize + 1) == smallCount);
+static_assert(classSize(smallCount) == 640);
+static_assert(sizeClass(ThreadLocalPool::maxSize) == classCount - 1);
+static_assert(classSize(classCount - 1) == ThreadLocalPool::maxSize);
+
+constexpr std::size_t
+classLimit(std::size_t index)
+{
+    return cacheBytes / classSize(index) < minimumBlocks
+        ? minimumBlocks
+        : cacheBytes / classSize(index);
+}
+
+class Cache
+{
+    struct Block
+    {
+        Block* next;
+    };
+
+    std::array<Block*, classCount> heads_{};
+    std::array<std::size_t, classCount> counts_{};
+
+public:
+    ThreadLocalPool::Stats stats;
+
+    ~Cache();
+
+    void*
+    pop(std::size_t index)
+    {
+        auto const block = heads_[index];
+        if (block == nullptr)
+            return nullptr;
+        heads_[index] = block->next;
+        --counts_[index];
+        return block;
+    }
+
+    bool
+    push(void* p, std::size_t index)
+    {
+        if (counts_[index] >= classLimit(index))
+            return false;
+        auto const block = static_cast<Block*>(p);
+        block->next = heads_[index];
+        heads_[index] = block;
+        ++counts_[index];
+        return true;
+    }
+
+    void
+    clear()
+    {
+        for (std::size_t index = 0; index < classCount; ++index)
+        {
+            while (auto const p = pop(index))
+                ::operator delete(p);
+        }
+    }
+};
+
+// Objects may be destroyed by other thread local destructors after the
+// cache of their thread is gone, so that is tracked by a flag which needs
+// no destruction.
+thread_local bool cacheDestroyed = false;
+
+Cache::~Cache()
+{
+    clear();
+    cacheDestroyed = true;
+}
+
+Cache*
+localCache()
+{
+    if (cacheDestroyed)
+        return nullptr;
+    thread_local Cache cache;
+    return &cache;
+}
+
+}  // namespace
+
+void*
+ThreadLocalPool::allocate(std::size_t bytes)
+{
+    if (bytes == 0)
+        bytes = 1;
+
+    auto const cache = localCache();
+    if (cache)
+        ++cache->stats.requests;
+
+    if (bytes <= maxSize)
+    {
+        auto const index = sizeClass(bytes);
+        if (cache && poolEnabled.load(std::memory_order_relaxed))
+        {
+            if (auto const p = cache->pop(index))
+                return p;
+        }
+        bytes = classSize(index);
+    }
+
+    if (cache)
+        ++cache->stats.allocations;
+    return ::operator new(bytes);
+}
+
+void
+ThreadLocalPool::deallocate(void* p, std::size_t bytes) noexcept
+{
+    if (p == nullptr)
+        return;
+
+    if (bytes != 0 && bytes <= maxSize &&
+        poolEnabled.load(std::memory_order_relaxed))
+    {
+        if (auto const cache = localCache();
+            cache && cache->push(p, sizeClass(bytes)))
+            return;
+    }
+    ::operator delete(p);
+}
+
+void
+ThreadLocalPool::enable(bool enabled)
+{
+    poolEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool
+ThreadLocalPool::enabled()
+{
+    return poolEnabled.load(std::memory_order_relaxed);
+}
+
+ThreadLocalPool::Stats
+ThreadLocalPool::stats()
+{
+    if (auto const cache = localCache())
+        return cache->stats;
+    return {};
+}
+
+}  // namespace ripple
@@ -163,6 +163,7 @@ public:
     int PATH_SEARCH = 7;
     int PATH_SEARCH_FAST = 2;
     int PATH_SEARCH_MAX = 10;
+    int PATH_FIND_WORKERS = 1;
 
     // Validation
     std::optional<std::size_t>
@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_CORE_PARALLELFOR_H_INCLUDED
+#define RIPPLE_CORE_PARALLELFOR_H_INCLUDED
+
+#include <ripple/core/JobQueue.h>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+
+/** Runs f(0) ... f(n - 1) on the calling thread and on up to `workers - 1`
+    jobs, until f returns false.
+
+    The caller only waits for the calls which have started, never for a job
+    to be scheduled, so this can't deadlock when the job queue is busy.
+*/
+class ParallelFor : public std::enable_shared_from_this<ParallelFor>
+{
+    std::function<bool(std::size_t)> const f_;
+    std::size_t const n_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::size_t next_ = 0;
+    std::size_t active_ = 0;
+    bool stop_ = false;
+
+public:
+    ParallelFor(std::size_t n, std::function<bool(std::size_t)> f)
+        : f_(std::move(f)), n_(n)
+    {
+    }
+
+    void
+    run(JobQueue& jobQueue,
+        JobType type,
+        std::string const& name,
+        int workers)
+    {
+        for (int i = 1; i < workers && static_cast<std::size_t>(i) < n_; ++i)
+        {
+            if (!jobQueue.addJob(
+                    type, name, [self = shared_from_this()](Job&) {
+                        self->work();
+                    }))
+                break;
+        }
+        work();
+
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this] { return active_ == 0; });
+    }
+
+private:
+    void
+    work()
+    {
+        std::unique_lock lock(mutex_);
+        while (!stop_ && next_ < n_)
+        {
+            auto const i = next_++;
+            ++active_;
+            lock.unlock();
+            bool const go = f_(i);
+            lock.lock();
+            if (!go)
+                stop_ = true;
+            if (--active_ == 0)
+                cv_.notify_all();
+        }
+    }
+};
+
+}  // namespace ripple
+
+#endif
@@ -163,7 +163,7 @@ protected:
     // Writers cannot be null.
     Collection(Collection* parent, Writer*);
     void
-    checkWritable(std::string const& label);
+    checkWritable(char const* label);
 
     Collection* parent_;
     Writer* writer_;
@@ -225,6 +225,13 @@ public:
     Array
     setArray(std::string const& key);
 
+    /** Returns the format of the Writer this Object is written to. */
+    Writer::Format
+    format() const
+    {
+        return writer_->format();
+    }
+
 protected:
     friend class Array;
     Object(Collection* parent, Writer* w) : Collection(parent, w)
@@ -333,8 +340,10 @@ copyFrom(Object& to, Json::Value const& from);
 class WriterObject
 {
 public:
-    WriterObject(Output const& output)
-        : writer_(std::make_unique<Writer>(output))
+    WriterObject(
+        Output const& output,
+        Writer::Format format = Writer::Format::json)
+        : writer_(std::make_unique<Writer>(output, format))
         , object_(std::make_unique<Object::Root>(*writer_))
     {
     }
@@ -26,6 +26,7 @@
 namespace Json {
 
 class Value;
+class Writer;
 
 using Output = std::function<void(boost::beast::string_view const&)>;
 
@@ -45,6 +46,14 @@ stringOutput(std::string& s)
 void
 outputJson(Json::Value const&, Output const&);
 
+/** Writes a Json value to an Output as CBOR (RFC 8949). */
+void
+outputCBOR(Json::Value const&, Output const&);
+
+/** Writes a Json value as the next item of a Writer. */
+void
+outputJson(Json::Value const&, Writer&);
+
 /** Return the minimal string representation of a Json::Value in O(n) time.
 
     This requires a memory allocation for the full size of the output.
@@ -20,11 +20,14 @@
 #ifndef RIPPLE_JSON_WRITER_H_INCLUDED
 #define RIPPLE_JSON_WRITER_H_INCLUDED
 
+#include <ripple/basics/Slice.h>
 #include <ripple/basics/ToString.h>
 #include <ripple/basics/contract.h>
 #include <ripple/json/Output.h>
 #include <ripple/json/json_value.h>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
 
 namespace Json {
 
@@ -121,6 +124,12 @@ namespace Json {
  *  sure that all arrays and objects are closed.  This means that you can throw
  *  an exception, or have a coroutine simply clean up the stack, and be sure
  *  that you do in fact generate a complete JSON object.
+ *
+ *  A Writer can also write the same items as CBOR (RFC 8949) instead of JSON
+ *  text.  Collections are then written with indefinite lengths, so nothing
+ *  needs to be known about them in advance.  CBOR has byte strings, which
+ *  JSON lacks: bytes written with output(Slice) are written as they are in
+ *  CBOR, and as an uppercase hex string in JSON.
  */
 
 class Writer
@@ -128,13 +137,29 @@ class Writer
 public:
     enum CollectionType { array, object };
 
-    explicit Writer(Output const& output);
+    enum class Format { json, cbor };
+
+    /** A decimal number: mantissa * 10^exponent.
+
+        CBOR writes it as a decimal fraction (tag 4), JSON as a number in
+        exponential notation.
+    */
+    struct Decimal
+    {
+        std::int64_t mantissa;
+        int exponent;
+    };
+
+    explicit Writer(Output const& output, Format format = Format::json);
     Writer(Writer&&) noexcept;
     Writer&
     operator=(Writer&&) noexcept;
 
     ~Writer();
 
+    Format
+    format() const;
+
     /** Start a new collection at the root level. */
     void startRoot(CollectionType);
 
@@ -226,12 +251,25 @@ public:
     void
     output(bool);
 
-    /** Output numbers or booleans. */
+    /** Output a byte string. */
+    void
+    output(ripple::Slice);
+
+    /** Output a decimal number. */
+    void
+    output(Decimal const&);
+
+    /** Output numbers. */
     template <typename Type>
     void
     output(Type t)
     {
-        implOutput(std::to_string(t));
+        if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>)
+            outputInteger(static_cast<std::int64_t>(t));
+        else if constexpr (std::is_integral_v<Type>)
+            outputInteger(static_cast<std::uint64_t>(t));
+        else
+            output(static_cast<double>(t));
     }
 
     void
@@ -245,7 +283,10 @@ private:
     std::unique_ptr<Impl> impl_;
 
     void
-    implOutput(std::string const&);
+    outputInteger(std::int64_t);
+
+    void
+    outputInteger(std::uint64_t);
 };
 
 inline void
@@ -255,6 +296,14 @@ check(bool condition, std::string const& message)
         ripple::Throw<std::logic_error>(message);
 }
 
+// Only builds the message's string if the check fails.
+inline void
+check(bool condition, char const* message)
+{
+    if (!condition)
+        ripple::Throw<std::logic_error>(message);
+}
+
 }  // namespace Json
 
 #endif
@@ -62,12 +62,12 @@ Collection::Collection(Collection&& that) noexcept
 }
 
 void
-Collection::checkWritable(std::string const& label)
+Collection::checkWritable(char const* label)
 {
     if (!enabled_)
-        ripple::Throw<std::logic_error>(label + ": not enabled");
+        ripple::Throw<std::logic_error>(std::string(label) + ": not enabled");
     if (!writer_)
-        ripple::Throw<std::logic_error>(label + ": not writable");
+        ripple::Throw<std::logic_error>(std::string(label) + ": not writable");
 }
 
 //------------------------------------------------------------------------------
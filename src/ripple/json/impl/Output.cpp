@@ -22,8 +22,6 @@
 
 namespace Json {
 
-namespace {
-
 void
 outputJson(Json::Value const& value, Writer& writer)
 {
@@ -50,7 +48,9 @@ outputJson(Json::Value const& value, Writer& writer)
         }
 
         case Json::stringValue: {
-            writer.output(value.asString());
+            // Avoid copying the string
+            auto const s = value.asCString();
+            writer.output(s ? s : "");
             break;
         }
 
@@ -72,11 +72,10 @@ outputJson(Json::Value const& value, Writer& writer)
 
         case Json::objectValue: {
             writer.startRoot(Writer::object);
-            auto members = value.getMemberNames();
-            for (auto const& tag : members)
+            for (auto it = value.begin(); it != value.end(); ++it)
             {
-                writer.rawSet(tag);
-                outputJson(value[tag], writer);
+                writer.rawSet(it.memberName());
+                outputJson(*it, writer);
             }
             writer.finish();
             break;
@@ -84,8 +83,6 @@ outputJson(Json::Value const& value, Writer& writer)
     }  // switch
 }
 
-}  // namespace
-
 void
 outputJson(Json::Value const& value, Output const& out)
 {
@@ -93,6 +90,13 @@ outputJson(Json::Value const& value, Output const& out)
     outputJson(value, writer);
 }
 
+void
+outputCBOR(Json::Value const& value, Output const& out)
+{
+    Writer writer(out, Writer::Format::cbor);
+    outputJson(value, writer);
+}
+
 std::string
 jsonAsString(Json::Value const& value)
 {
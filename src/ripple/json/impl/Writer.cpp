@@ -19,6 +19,8 @@
 
 #include <ripple/json/Output.h>
 #include <ripple/json/Writer.h>
+#include <charconv>
+#include <cstring>
 #include <set>
 #include <stack>
 
@@ -26,15 +28,31 @@ namespace Json {
 
 namespace {
 
-std::map<char, const char*> jsonSpecialCharacterEscape = {
-    {'"', "\\\""},
-    {'\\', "\\\\"},
-    {'/', "\\/"},
-    {'\b', "\\b"},
-    {'\f', "\\f"},
-    {'\n', "\\n"},
-    {'\r', "\\r"},
-    {'\t', "\\t"}};
+// The escape sequence for each character that needs one, or nullptr.
+struct EscapeTable
+{
+    char const* escapes[256] = {};
+
+    EscapeTable()
+    {
+        escapes[static_cast<unsigned char>('"')] = "\\\"";
+        escapes[static_cast<unsigned char>('\\')] = "\\\\";
+        escapes[static_cast<unsigned char>('/')] = "\\/";
+        escapes[static_cast<unsigned char>('\b')] = "\\b";
+        escapes[static_cast<unsigned char>('\f')] = "\\f";
+        escapes[static_cast<unsigned char>('\n')] = "\\n";
+        escapes[static_cast<unsigned char>('\r')] = "\\r";
+        escapes[static_cast<unsigned char>('\t')] = "\\t";
+    }
+
+    char const*
+    operator[](char c) const
+    {
+        return escapes[static_cast<unsigned char>(c)];
+    }
+};
+
+EscapeTable const jsonSpecialCharacterEscape;
 
 static size_t const jsonEscapeLength = 2;
 
@@ -49,6 +67,65 @@ const char quote = '"';
 
 const std::string none;
 
+// CBOR major types and the other initial bytes used here.
+enum CBORMajor : std::uint8_t {
+    cborUnsigned = 0,
+    cborNegative = 1,
+    cborBytes = 2,
+    cborText = 3,
+    cborArray = 4,
+    cborTag = 6,
+    cborFloat = 7,
+};
+
+const char cborStartArray = '\x9f';
+const char cborStartMap = '\xbf';
+const char cborBreak = '\xff';
+const char cborFalse = '\xf4';
+const char cborTrue = '\xf5';
+const char cborNull = '\xf6';
+
+// The tag of a decimal fraction, [exponent, mantissa].
+std::uint64_t const cborDecimalFraction = 4;
+
+// Write an initial byte followed by n big-endian bytes of value.  Returns
+// the number of bytes written.
+std::size_t
+cborInitial(char* buf, std::uint8_t byte, std::uint64_t value, std::size_t n)
+{
+    buf[0] = static_cast<char>(byte);
+    for (std::size_t i = 0; i < n; ++i)
+        buf[n - i] = static_cast<char>(value >> (8 * i));
+    return n + 1;
+}
+
+// Write the head of a CBOR data item, its major type and argument, in at
+// most 9 bytes.  Returns the number of bytes written.
+std::size_t
+cborHead(char* buf, std::uint8_t major, std::uint64_t value)
+{
+    major <<= 5;
+    if (value < 24)
+        return cborInitial(buf, major | value, 0, 0);
+    if (value <= 0xff)
+        return cborInitial(buf, major | 24, value, 1);
+    if (value <= 0xffff)
+        return cborInitial(buf, major | 25, value, 2);
+    if (value <= 0xffffffff)
+        return cborInitial(buf, major | 26, value, 4);
+    return cborInitial(buf, major | 27, value, 8);
+}
+
+// Write a CBOR integer.  A negative integer n is written as -1 - n, which
+// is ~n.
+std::size_t
+cborInteger(char* buf, std::int64_t i)
+{
+    if (i < 0)
+        return cborHead(buf, cborNegative, ~static_cast<std::uint64_t>(i));
+    return cborHead(buf, cborUnsigned, static_cast<std::uint64_t>(i));
+}
+
 static auto const integralFloatsBecomeInts = false;
 
 size_t
@@ -75,7 +152,8 @@ lengthWithoutTrailingZeros(std::string const& s)
 class Writer::Impl
 {
 public:
-    explicit Impl(Output const& output) : output_(output)
+    Impl(Output const& output, Format format)
+        : output_(output), format_(format)
     {
     }
     ~Impl() = default;
@@ -90,10 +168,26 @@ public:
         return stack_.empty();
     }
 
+    Format
+    format() const
+    {
+        return format_;
+    }
+
+    bool
+    cbor() const
+    {
+        return format_ == Format::cbor;
+    }
+
     void
     start(CollectionType ct)
     {
-        char ch = (ct == array) ? openBracket : openBrace;
+        char ch;
+        if (cbor())
+            ch = (ct == array) ? cborStartArray : cborStartMap;
+        else
+            ch = (ct == array) ? openBracket : openBrace;
         output({&ch, 1});
         stack_.push(Collection());
         stack_.top().type = ct;
@@ -106,24 +200,46 @@ public:
         output_(bytes);
     }
 
+    // Output the head of a CBOR data item: its major type and argument.
+    void
+    head(std::uint8_t major, std::uint64_t value)
+    {
+        char buf[9];
+        output({buf, cborHead(buf, major, value)});
+    }
+
+    // Output more of the item that was started last.
+    void
+    continueOutput(boost::beast::string_view const& bytes)
+    {
+        output_(bytes);
+    }
+
     void
     stringOutput(boost::beast::string_view const& bytes)
     {
         markStarted();
+        if (cbor())
+        {
+            char buf[9];
+            output_({buf, cborHead(buf, cborText, bytes.size())});
+            output_(bytes);
+            return;
+        }
+
         std::size_t position = 0, writtenUntil = 0;
 
         output_({&quote, 1});
         auto data = bytes.data();
         for (; position < bytes.size(); ++position)
         {
-            auto i = jsonSpecialCharacterEscape.find(data[position]);
-            if (i != jsonSpecialCharacterEscape.end())
+            if (auto escape = jsonSpecialCharacterEscape[data[position]])
             {
                 if (writtenUntil < position)
                 {
                     output_({data + writtenUntil, position - writtenUntil});
                 }
-                output_({i->second, jsonEscapeLength});
+                output_({escape, jsonEscapeLength});
                 writtenUntil = position + 1;
             };
         }
@@ -140,9 +256,10 @@ public:
     }
 
     void
-    nextCollectionEntry(CollectionType type, std::string const& message)
+    nextCollectionEntry(CollectionType type, char const* message)
     {
-        check(!empty(), "empty () in " + message);
+        if (empty())
+            check(false, std::string("empty () in ") + message);
 
         auto t = stack_.top().type;
         if (t != type)
@@ -150,11 +267,12 @@ public:
             check(
                 false,
                 "Not an " +
-                    ((type == array ? "array: " : "object: ") + message));
+                    ((type == array ? "array: " : "object: ") +
+                     std::string(message)));
         }
         if (stack_.top().isFirst)
             stack_.top().isFirst = false;
-        else
+        else if (!cbor())
             output_({&comma, 1});
     }
 
@@ -169,7 +287,8 @@ public:
 #endif
 
         stringOutput(tag);
-        output_({&colon, 1});
+        if (!cbor())
+            output_({&colon, 1});
     }
 
     bool
@@ -183,8 +302,9 @@ public:
     {
         check(!empty(), "Empty stack in finish()");
 
-        auto isArray = stack_.top().type == array;
-        auto ch = isArray ? closeBracket : closeBrace;
+        char ch = cborBreak;
+        if (!cbor())
+            ch = (stack_.top().type == array) ? closeBracket : closeBrace;
         output_({&ch, 1});
         stack_.pop();
     }
@@ -227,12 +347,14 @@ private:
     using Stack = std::stack<Collection, std::vector<Collection>>;
 
     Output output_;
+    Format const format_;
     Stack stack_;
 
     bool isStarted_ = false;
 };
 
-Writer::Writer(Output const& output) : impl_(std::make_unique<Impl>(output))
+Writer::Writer(Output const& output, Format format)
+    : impl_(std::make_unique<Impl>(output, format))
 {
 }
 
@@ -254,6 +376,12 @@ Writer::operator=(Writer&& w) noexcept
     return *this;
 }
 
+Writer::Format
+Writer::format() const
+{
+    return impl_->format();
+}
+
 void
 Writer::output(char const* s)
 {
@@ -270,12 +398,22 @@ void
 Writer::output(Json::Value const& value)
 {
     impl_->markStarted();
-    outputJson(value, impl_->getOutput());
+    outputJson(value, *this);
 }
 
 void
 Writer::output(float f)
 {
+    if (impl_->cbor())
+    {
+        std::uint32_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        char buf[9];
+        auto const n =
+            cborInitial(buf, (cborFloat << 5) | 26, bits, sizeof(bits));
+        impl_->output({buf, n});
+        return;
+    }
     auto s = ripple::to_string(f);
     impl_->output({s.data(), lengthWithoutTrailingZeros(s)});
 }
@@ -283,27 +421,96 @@ Writer::output(float f)
 void
 Writer::output(double f)
 {
+    if (impl_->cbor())
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &f, sizeof(bits));
+        char buf[9];
+        auto const n =
+            cborInitial(buf, (cborFloat << 5) | 27, bits, sizeof(bits));
+        impl_->output({buf, n});
+        return;
+    }
     auto s = ripple::to_string(f);
     impl_->output({s.data(), lengthWithoutTrailingZeros(s)});
 }
 
 void Writer::output(std::nullptr_t)
 {
-    impl_->output("null");
+    if (impl_->cbor())
+        impl_->output({&cborNull, 1});
+    else
+        impl_->output("null");
 }
 
 void
 Writer::output(bool b)
 {
-    impl_->output(b ? "true" : "false");
+    if (impl_->cbor())
+        impl_->output({b ? &cborTrue : &cborFalse, 1});
+    else
+        impl_->output(b ? "true" : "false");
 }
 
 void
-Writer::implOutput(std::string const& s)
+Writer::output(ripple::Slice bytes)
 {
+    if (!impl_->cbor())
+    {
+        impl_->stringOutput(ripple::strHex(bytes));
+        return;
+    }
+    impl_->head(cborBytes, bytes.size());
+    impl_->continueOutput(
+        {reinterpret_cast<char const*>(bytes.data()), bytes.size()});
+}
+
+void
+Writer::output(Decimal const& d)
+{
+    if (impl_->cbor())
+    {
+        char buf[20];
+        auto n = cborHead(buf, cborTag, cborDecimalFraction);
+        n += cborHead(buf + n, cborArray, 2);
+        n += cborInteger(buf + n, d.exponent);
+        n += cborInteger(buf + n, d.mantissa);
+        impl_->output({buf, n});
+        return;
+    }
+    auto s = std::to_string(d.mantissa);
+    if (d.exponent != 0)
+        s += "e" + std::to_string(d.exponent);
     impl_->output(s);
 }
 
+void
+Writer::outputInteger(std::int64_t i)
+{
+    if (impl_->cbor())
+    {
+        char buf[9];
+        impl_->output({buf, cborInteger(buf, i)});
+        return;
+    }
+    char buf[24];
+    auto const end = std::to_chars(buf, buf + sizeof(buf), i).ptr;
+    impl_->output({buf, static_cast<std::size_t>(end - buf)});
+}
+
+void
+Writer::outputInteger(std::uint64_t i)
+{
+    if (impl_->cbor())
+    {
+        impl_->head(cborUnsigned, i);
+        return;
+    }
+    char buf[24];
+    auto const end = std::to_chars(buf, buf + sizeof(buf), i).ptr;
+    impl_->output({buf, static_cast<std::size_t>(end - buf)});
+}
+
 void
 Writer::finishAll()
 {
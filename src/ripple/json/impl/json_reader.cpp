@@ -18,9 +18,8 @@
 //==============================================================================
 
 #include <ripple/basics/contract.h>
+#include <ripple/json/impl/json_scan.h>
 #include <ripple/json/json_reader.h>
-#include <algorithm>
-#include <cctype>
 #include <istream>
 #include <string>
 
@@ -291,15 +290,7 @@ Reader::readToken(Token& token)
 void
 Reader::skipSpaces()
 {
-    while (current_ != end_)
-    {
-        Char c = *current_;
-
-        if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
-            ++current_;
-        else
-            break;
-    }
+    current_ = detail::skipSpaces(current_, end_);
 }
 
 bool
@@ -363,8 +354,6 @@ Reader::readCppStyleComment()
 Reader::TokenType
 Reader::readNumber()
 {
-    static char const extended_tokens[] = {'.', 'e', 'E', '+', '-'};
-
     TokenType type = tokenInteger;
 
     if (current_ != end_)
@@ -374,14 +363,11 @@ Reader::readNumber()
 
         while (current_ != end_)
         {
-            if (!std::isdigit(static_cast<unsigned char>(*current_)))
-            {
-                auto ret = std::find(
-                    std::begin(extended_tokens),
-                    std::end(extended_tokens),
-                    *current_);
+            Char const c = *current_;
 
-                if (ret == std::end(extended_tokens))
+            if (c < '0' || c > '9')
+            {
+                if (c != '.' && c != 'e' && c != 'E' && c != '+' && c != '-')
                     break;
 
                 type = tokenDouble;
@@ -397,19 +383,21 @@ Reader::readNumber()
 bool
 Reader::readString()
 {
-    Char c = 0;
-
     while (current_ != end_)
     {
-        c = getNextChar();
+        current_ = detail::findQuoteOrEscape(current_, end_);
 
-        if (c == '\\')
-            getNextChar();
-        else if (c == '"')
+        if (current_ == end_)
             break;
+
+        if (getNextChar() == '"')
+            return true;
+
+        // Skip the escaped character, which may be a quote
+        getNextChar();
     }
 
-    return c == '"';
+    return false;
 }
 
 bool
@@ -448,11 +436,14 @@ Reader::readObject(Token& tokenStart, unsigned depth)
                 "Missing ':' after object member name", colon, tokenObjectEnd);
         }
 
-        // Reject duplicate names
-        if (currentValue().isMember(name))
+        // Reject duplicate names: a new member makes the object larger
+        Value& object = currentValue();
+        auto const size = object.size();
+        Value& value = object[name];
+
+        if (object.size() == size)
             return addError("Key '" + name + "' appears twice.", tokenName);
 
-        Value& value = currentValue()[name];
         nodes_.push(&value);
         bool ok = readValue(depth + 1);
         nodes_.pop();
@@ -662,12 +653,12 @@ Reader::decodeDouble(Token& token)
 bool
 Reader::decodeString(Token& token)
 {
-    std::string decoded;
+    decoded_.clear();
 
-    if (!decodeString(token, decoded))
+    if (!decodeString(token, decoded_))
         return false;
 
-    currentValue() = decoded;
+    currentValue() = decoded_;
     return true;
 }
 
@@ -680,11 +671,19 @@ Reader::decodeString(Token& token, std::string& decoded)
 
     while (current != end)
     {
+        // Copy the run of characters which need no decoding at once
+        Location const run = detail::findQuoteOrEscape(current, end);
+        decoded.append(current, run);
+        current = run;
+
+        if (current == end)
+            break;
+
         Char c = *current++;
 
         if (c == '"')
             break;
-        else if (c == '\\')
+        else
         {
             if (current == end)
                 return addError(
@@ -741,10 +740,6 @@ Reader::decodeString(Token& token, std::string& decoded)
                         "Bad escape sequence in string", token, current);
             }
         }
-        else
-        {
-            decoded += c;
-        }
     }
 
     return true;
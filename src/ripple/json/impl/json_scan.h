@@ -0,0 +1,173 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_SCAN_H_INCLUDED
+#define RIPPLE_JSON_JSON_SCAN_H_INCLUDED
+
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RIPPLE_JSON_SCAN_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RIPPLE_JSON_SCAN_SSE2 1
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Json {
+namespace detail {
+
+/*  Scanning kernels for the reader.
+
+    Most of the text of a request is the bodies of strings (addresses,
+    hashes, hex blobs) and, in documents that were pretty printed, runs of
+    whitespace.  These functions find the end of such a run sixteen or
+    thirty-two bytes at a time, using the widest of AVX2 or SSE2 that the
+    build targets, and finish with the scalar loop.  Every byte they load
+    lies within [first, last).
+
+    The scalar versions are the reference and are always available, so
+    the two can be compared.
+*/
+
+inline bool
+isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline char const*
+findQuoteOrEscapeScalar(char const* first, char const* last)
+{
+    while (first != last && *first != '"' && *first != '\\')
+        ++first;
+    return first;
+}
+
+inline char const*
+skipSpacesScalar(char const* first, char const* last)
+{
+    while (first != last && isSpace(*first))
+        ++first;
+    return first;
+}
+
+#if RIPPLE_JSON_SCAN_SSE2 || RIPPLE_JSON_SCAN_AVX2
+inline unsigned
+lowestBit(std::uint32_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+/** Returns the first '"' or '\\' in [first, last), or last. */
+inline char const*
+findQuoteOrEscape(char const* first, char const* last)
+{
+#if RIPPLE_JSON_SCAN_AVX2
+    {
+        __m256i const quote = _mm256_set1_epi8('"');
+        __m256i const escape = _mm256_set1_epi8('\\');
+        while (last - first >= 32)
+        {
+            auto const v = _mm256_loadu_si256(
+                reinterpret_cast<__m256i const*>(first));
+            auto const mask = static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_or_si256(
+                    _mm256_cmpeq_epi8(v, quote),
+                    _mm256_cmpeq_epi8(v, escape))));
+            if (mask != 0)
+                return first + lowestBit(mask);
+            first += 32;
+        }
+    }
+#endif
+#if RIPPLE_JSON_SCAN_SSE2
+    {
+        __m128i const quote = _mm_set1_epi8('"');
+        __m128i const escape = _mm_set1_epi8('\\');
+        while (last - first >= 16)
+        {
+            auto const v =
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+            auto const mask = static_cast<std::uint32_t>(_mm_movemask_epi8(
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, escape))));
+            if (mask != 0)
+                return first + lowestBit(mask);
+            first += 16;
+        }
+    }
+#endif
+    return findQuoteOrEscapeScalar(first, last);
+}
+
+/** Returns the first character in [first, last) which isn't whitespace,
+    or last.
+*/
+inline char const*
+skipSpaces(char const* first, char const* last)
+{
+    // Compact documents have little or no whitespace between tokens, so
+    // the first character usually settles it.
+    if (first == last || !isSpace(*first))
+        return first;
+
+#if RIPPLE_JSON_SCAN_SSE2
+    {
+        __m128i const space = _mm_set1_epi8(' ');
+        __m128i const tab = _mm_set1_epi8('\t');
+        __m128i const cr = _mm_set1_epi8('\r');
+        __m128i const lf = _mm_set1_epi8('\n');
+        while (last - first >= 16)
+        {
+            auto const v =
+                _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+            auto const spaces = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+                _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+            auto const mask =
+                ~static_cast<std::uint32_t>(_mm_movemask_epi8(spaces)) &
+                0xffff;
+            if (mask != 0)
+                return first + lowestBit(mask);
+            first += 16;
+        }
+    }
+#endif
+    return skipSpacesScalar(first, last);
+}
+
+}  // namespace detail
+}  // namespace Json
+
+#endif
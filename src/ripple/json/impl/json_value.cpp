@@ -23,6 +23,12 @@
 #include <ripple/json/json_writer.h>
 #include <ripple/json/to_string.h>
 
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <unordered_map>
+
 namespace Json {
 
 const Value Value::null;
@@ -35,16 +41,23 @@ class DefaultValueAllocator : public ValueAllocator
 public:
     virtual ~DefaultValueAllocator() = default;
 
+    // Member names are short and freed often, so they come from the
+    // calling thread's pool. Their size is recovered from the terminator.
     char*
     makeMemberName(const char* memberName) override
     {
-        return duplicateStringValue(memberName);
+        auto const length = strlen(memberName);
+        auto name =
+            static_cast<char*>(ripple::ThreadLocalPool::allocate(length + 1));
+        memcpy(name, memberName, length + 1);
+        return name;
     }
 
     void
     releaseMemberName(char* memberName) override
     {
-        releaseStringValue(memberName);
+        ripple::ThreadLocalPool::deallocate(
+            memberName, strlen(memberName) + 1);
     }
 
     char*
@@ -165,6 +178,302 @@ Value::CZString::isStaticString() const
     return index_ == noDuplication;
 }
 
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// class Value::ObjectValues
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+// //////////////////////////////////////////////////////////////////
+
+struct Value::ObjectValues::Keys
+{
+    struct Hash
+    {
+        std::size_t
+        operator()(CZString const* key) const
+        {
+            if (auto const name = key->c_str())
+                return std::hash<std::string_view>{}(name);
+            return std::hash<int>{}(key->index());
+        }
+    };
+
+    struct Equal
+    {
+        bool
+        operator()(CZString const* x, CZString const* y) const
+        {
+            return *x == *y;
+        }
+    };
+
+    std::unordered_map<
+        CZString const*,
+        Node*,
+        Hash,
+        Equal,
+        ripple::PoolAllocator<std::pair<CZString const* const, Node*>>>
+        map;
+};
+
+namespace {
+
+// Serializes sorting the index of a container with reading it on other
+// threads. Containers are sorted at most once after they are changed, so
+// one lock for all of them is enough.
+std::mutex&
+sortMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+}  // namespace
+
+Value::ObjectValues::ObjectValues(ObjectValues const& other)
+{
+    other.sort();
+    index_.reserve(other.size());
+    for (auto node : other.index_)
+        index_.push_back(construct(node->first, node->second));
+}
+
+Value::ObjectValues::~ObjectValues()
+{
+    clear();
+}
+
+Value::ObjectValues*
+Value::ObjectValues::make()
+{
+    auto p = ripple::ThreadLocalPool::allocate(sizeof(ObjectValues));
+    return new (p) ObjectValues;
+}
+
+Value::ObjectValues*
+Value::ObjectValues::make(ObjectValues const& other)
+{
+    auto p = ripple::ThreadLocalPool::allocate(sizeof(ObjectValues));
+    try
+    {
+        return new (p) ObjectValues(other);
+    }
+    catch (...)
+    {
+        ripple::ThreadLocalPool::deallocate(p, sizeof(ObjectValues));
+        throw;
+    }
+}
+
+void
+Value::ObjectValues::destroy(ObjectValues* p) noexcept
+{
+    if (p)
+    {
+        p->~ObjectValues();
+        ripple::ThreadLocalPool::deallocate(p, sizeof(ObjectValues));
+    }
+}
+
+Value::ObjectValues::Node*
+Value::ObjectValues::construct(CZString const& key, Value const& value)
+{
+    if (auto const slot = free_)
+    {
+        free_ = *reinterpret_cast<Node**>(slot);
+        return new (slot) Node(key, value);
+    }
+
+    if (next_ == end_)
+    {
+        // Each block is twice the size of the last, up to a limit.
+        auto const capacity = std::min(
+            blocks_ ? 2 * blocks_->capacity : 2 * inlineNodes, maxBlockNodes);
+        auto const bytes = sizeof(Block) + capacity * sizeof(Node);
+        auto block =
+            static_cast<Block*>(ripple::ThreadLocalPool::allocate(bytes));
+        block->next = blocks_;
+        block->capacity = capacity;
+        blocks_ = block;
+        next_ = reinterpret_cast<Node*>(block + 1);
+        end_ = next_ + capacity;
+    }
+
+    auto node = new (next_) Node(key, value);
+    ++next_;
+    return node;
+}
+
+Value::ObjectValues::const_iterator
+Value::ObjectValues::lowerBound(CZString const& key) const
+{
+    return std::lower_bound(
+        index_.begin(), index_.end(), key, [](Node const* node, auto& k) {
+            return node->first < k;
+        });
+}
+
+void
+Value::ObjectValues::sortUnsorted() const
+{
+    std::lock_guard lock(sortMutex());
+    auto const unsorted = unsorted_.load(std::memory_order_relaxed);
+    if (unsorted == 0)
+        return;
+
+    auto const less = [](Node const* x, Node const* y) {
+        return x->first < y->first;
+    };
+    auto const middle = index_.end() - unsorted;
+    std::sort(middle, index_.end(), less);
+    std::inplace_merge(index_.begin(), middle, index_.end(), less);
+    unsorted_.store(0, std::memory_order_release);
+}
+
+Value*
+Value::ObjectValues::find(CZString const& key) const
+{
+    if (keys_)
+    {
+        auto const it = keys_->map.find(&key);
+        if (it == keys_->map.end())
+            return nullptr;
+        return &it->second->second;
+    }
+
+    // Array elements are usually stored at their own index
+    if (!key.c_str() && key.index() >= 0 &&
+        std::size_t(key.index()) < index_.size())
+    {
+        auto node = index_[key.index()];
+        if (node->first == key)
+            return &node->second;
+    }
+
+    auto it = lowerBound(key);
+    if (it == index_.end() || !((*it)->first == key))
+        return nullptr;
+    return &(*it)->second;
+}
+
+Value&
+Value::ObjectValues::findOrInsert(CZString const& key)
+{
+    if (index_.empty())
+        index_.reserve(inlineNodes);
+
+    if (keys_)
+    {
+        if (auto const value = find(key))
+            return *value;
+
+        // Appending in key order keeps the index sorted
+        auto const unsorted = unsorted_.load(std::memory_order_relaxed);
+        auto node = construct(key, null);
+        index_.push_back(node);
+        keys_->map.emplace(&node->first, node);
+        if (unsorted != 0 || key < index_[index_.size() - 2]->first)
+            unsorted_.store(unsorted + 1, std::memory_order_relaxed);
+        return node->second;
+    }
+
+    // Appending, as arrays and objects written in key order do
+    if (index_.empty() || index_.back()->first < key)
+    {
+        auto node = construct(key, null);
+        index_.push_back(node);
+        return node->second;
+    }
+
+    auto it = lowerBound(key);
+    if ((*it)->first == key)
+        return (*it)->second;
+
+    auto node = construct(key, null);
+    if (index_.size() < maxSortedInsert)
+    {
+        index_.insert(it, node);
+        return node->second;
+    }
+
+    // The container is large and built out of order: from now on its
+    // members are found by hash and sorted when they are next iterated.
+    keys_ = new Keys;
+    keys_->map.reserve(2 * index_.size());
+    index_.push_back(node);
+    for (auto member : index_)
+        keys_->map.emplace(&member->first, member);
+    unsorted_.store(1, std::memory_order_relaxed);
+    return node->second;
+}
+
+Value
+Value::ObjectValues::erase(CZString const& key)
+{
+    sort();
+
+    auto it = lowerBound(key);
+    if (it == index_.end() || !((*it)->first == key))
+        return null;
+
+    Node* node = *it;
+    if (keys_)
+        keys_->map.erase(&node->first);
+    Value old(std::move(node->second));
+    index_.erase(it);
+    node->~Node();
+    *reinterpret_cast<Node**>(node) = free_;
+    free_ = node;
+    return old;
+}
+
+void
+Value::ObjectValues::clear()
+{
+    delete keys_;
+    keys_ = nullptr;
+    unsorted_.store(0, std::memory_order_relaxed);
+
+    for (auto node : index_)
+        node->~Node();
+    index_.clear();
+
+    while (blocks_)
+    {
+        auto block = blocks_;
+        blocks_ = block->next;
+        ripple::ThreadLocalPool::deallocate(
+            block, sizeof(Block) + block->capacity * sizeof(Node));
+    }
+
+    free_ = nullptr;
+    next_ = reinterpret_cast<Node*>(storage_);
+    end_ = next_ + inlineNodes;
+}
+
+bool
+operator==(Value::ObjectValues const& x, Value::ObjectValues const& y)
+{
+    return std::equal(
+        x.begin(), x.end(), y.begin(), y.end(), [](auto a, auto b) {
+            return a->first == b->first && a->second == b->second;
+        });
+}
+
+bool
+operator<(Value::ObjectValues const& x, Value::ObjectValues const& y)
+{
+    return std::lexicographical_compare(
+        x.begin(), x.end(), y.begin(), y.end(), [](auto a, auto b) {
+            if (a->first < b->first)
+                return true;
+            if (b->first < a->first)
+                return false;
+            return a->second < b->second;
+        });
+}
+
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
 // //////////////////////////////////////////////////////////////////
@@ -199,7 +508,7 @@ Value::Value(ValueType type) : type_(type), allocated_(0)
 
         case arrayValue:
         case objectValue:
-            value_.map_ = new ObjectValues();
+            value_.map_ = ObjectValues::make();
             break;
 
         case booleanValue:
@@ -273,7 +582,7 @@ Value::Value(const Value& other) : type_(other.type_)
 
         case arrayValue:
         case objectValue:
-            value_.map_ = new ObjectValues(*other.value_.map_);
+            value_.map_ = ObjectValues::make(*other.value_.map_);
             break;
 
         default:
@@ -300,8 +609,7 @@ Value::~Value()
 
         case arrayValue:
         case objectValue:
-            if (value_.map_)
-                delete value_.map_;
+            ObjectValues::destroy(value_.map_);
             break;
 
         default:
@@ -717,11 +1025,7 @@ Value::size() const
 
         case arrayValue:  // size of the array is highest index + 1
             if (!value_.map_->empty())
-            {
-                ObjectValues::const_iterator itLast = value_.map_->end();
-                --itLast;
-                return (*itLast).first.index() + 1;
-            }
+                return value_.map_->back().first.index() + 1;
 
             return 0;
 
@@ -775,15 +1079,7 @@ Value::operator[](UInt index)
     if (type_ == nullValue)
         *this = Value(arrayValue);
 
-    CZString key(index);
-    ObjectValues::iterator it = value_.map_->lower_bound(key);
-
-    if (it != value_.map_->end() && (*it).first == key)
-        return (*it).second;
-
-    ObjectValues::value_type defaultValue(key, null);
-    it = value_.map_->insert(it, defaultValue);
-    return (*it).second;
+    return value_.map_->findOrInsert(CZString(index));
 }
 
 const Value&
@@ -794,13 +1090,8 @@ Value::operator[](UInt index) const
     if (type_ == nullValue)
         return null;
 
-    CZString key(index);
-    ObjectValues::const_iterator it = value_.map_->find(key);
-
-    if (it == value_.map_->end())
-        return null;
-
-    return (*it).second;
+    auto const value = value_.map_->find(CZString(index));
+    return value ? *value : null;
 }
 
 Value&
@@ -819,15 +1110,7 @@ Value::resolveReference(const char* key, bool isStatic)
 
     CZString actualKey(
         key, isStatic ? CZString::noDuplication : CZString::duplicateOnCopy);
-    ObjectValues::iterator it = value_.map_->lower_bound(actualKey);
-
-    if (it != value_.map_->end() && (*it).first == actualKey)
-        return (*it).second;
-
-    ObjectValues::value_type defaultValue(actualKey, null);
-    it = value_.map_->insert(it, defaultValue);
-    Value& value = (*it).second;
-    return value;
+    return value_.map_->findOrInsert(actualKey);
 }
 
 Value
@@ -851,13 +1134,9 @@ Value::operator[](const char* key) const
     if (type_ == nullValue)
         return null;
 
-    CZString actualKey(key, CZString::noDuplication);
-    ObjectValues::const_iterator it = value_.map_->find(actualKey);
-
-    if (it == value_.map_->end())
-        return null;
-
-    return (*it).second;
+    auto const value =
+        value_.map_->find(CZString(key, CZString::noDuplication));
+    return value ? *value : null;
 }
 
 Value&
@@ -911,15 +1190,7 @@ Value::removeMember(const char* key)
     if (type_ == nullValue)
         return null;
 
-    CZString actualKey(key, CZString::noDuplication);
-    ObjectValues::iterator it = value_.map_->find(actualKey);
-
-    if (it == value_.map_->end())
-        return null;
-
-    Value old(it->second);
-    value_.map_->erase(it);
-    return old;
+    return value_.map_->erase(CZString(key, CZString::noDuplication));
 }
 
 Value
@@ -954,11 +1225,8 @@ Value::getMemberNames() const
 
     Members members;
     members.reserve(value_.map_->size());
-    ObjectValues::const_iterator it = value_.map_->begin();
-    ObjectValues::const_iterator itEnd = value_.map_->end();
-
-    for (; it != itEnd; ++it)
-        members.push_back(std::string((*it).first.c_str()));
+    for (auto node : *value_.map_)
+        members.push_back(std::string(node->first.c_str()));
 
     return members;
 }
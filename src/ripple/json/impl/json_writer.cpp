@@ -219,7 +219,7 @@ FastWriter::writeValue(const Value& value)
             break;
 
         case stringValue:
-            document_ += valueToQuotedString(value.asCString());
+            appendQuotedString(value.asCString());
             break;
 
         case booleanValue:
@@ -243,21 +243,16 @@ FastWriter::writeValue(const Value& value)
         break;
 
         case objectValue: {
-            Value::Members members(value.getMemberNames());
             document_ += "{";
 
-            for (Value::Members::iterator it = members.begin();
-                 it != members.end();
-                 ++it)
+            for (auto it = value.begin(); it != value.end(); ++it)
             {
-                std::string const& name = *it;
-
-                if (it != members.begin())
+                if (it != value.begin())
                     document_ += ",";
 
-                document_ += valueToQuotedString(name.c_str());
+                appendQuotedString(it.memberName());
                 document_ += ":";
-                writeValue(value[name]);
+                writeValue(*it);
             }
 
             document_ += "}";
@@ -266,6 +261,22 @@ FastWriter::writeValue(const Value& value)
     }
 }
 
+void
+FastWriter::appendQuotedString(const char* value)
+{
+    if (strpbrk(value, "\"\\\b\f\n\r\t") == nullptr &&
+        !containsControlCharacter(value))
+    {
+        document_ += '"';
+        document_ += value;
+        document_ += '"';
+    }
+    else
+    {
+        document_ += valueToQuotedString(value);
+    }
+}
+
 // Class StyledWriter
 // //////////////////////////////////////////////////////////////////
 
@@ -205,6 +205,7 @@ private:
     Location current_;
     Location lastValueEnd_;
     Value* lastValue_;
+    std::string decoded_;
 };
 
 template <class BufferSequence>
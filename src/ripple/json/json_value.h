@@ -20,7 +20,9 @@
 #ifndef RIPPLE_JSON_JSON_VALUE_H_INCLUDED
 #define RIPPLE_JSON_JSON_VALUE_H_INCLUDED
 
+#include <ripple/basics/ThreadLocalPool.h>
 #include <ripple/json/json_forwards.h>
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <string>
@@ -191,7 +193,7 @@ private:
     };
 
 public:
-    using ObjectValues = std::map<CZString, Value>;
+    class ObjectValues;
 
 public:
     /** \brief Create a default Value of the given type.
@@ -433,6 +435,190 @@ private:
     int allocated_ : 1;  // Notes: if declared as bool, bitfield is useless.
 };
 
+/** The members of an object or the elements of an array.
+
+    Members are kept in a flat index of pointers sorted by key, so lookups
+    are binary searches and iteration visits members in key order.  The
+    members themselves are constructed in blocks owned by the container,
+    the first of which is part of the container, and are never moved: a
+    reference to a member stays valid until that member is removed or the
+    container is destroyed, as it would with a node-based map.  The storage
+    of a removed member is reused by the next member added.
+
+    Elements appended to an array, and members added in key order, are
+    added without searching.  Other members are inserted into the index
+    while it is small.  When a larger container gets a member out of
+    order, a hash table of its keys is built.  From then on members are
+    looked up in the table and appended to the end of the index, which is
+    sorted again before it is next iterated, so building a large object
+    from keys in random order takes O(n log n) time rather than O(n^2).
+    Iteration is a read, and may happen on several threads at once, so the
+    sort is serialized by a lock.
+*/
+class Value::ObjectValues
+{
+public:
+    struct Node
+    {
+        Node(CZString const& key, Value const& value)
+            : first(key), second(value)
+        {
+        }
+
+        CZString first;
+        Value second;
+    };
+
+private:
+    // The number of members stored in the container itself
+    static constexpr std::size_t inlineNodes = 4;
+
+    // The most members held in one block
+    static constexpr std::size_t maxBlockNodes = 256;
+
+    // The largest index into which out of order members are inserted
+    static constexpr std::size_t maxSortedInsert = 256;
+
+    struct Keys;
+
+    struct Block
+    {
+        Block* next;
+        std::size_t capacity;
+    };
+
+    using Index = std::vector<Node*, ripple::PoolAllocator<Node*>>;
+
+public:
+    using iterator = Index::iterator;
+    using const_iterator = Index::const_iterator;
+
+    ObjectValues() = default;
+    ObjectValues(ObjectValues const& other);
+    ObjectValues&
+    operator=(ObjectValues const&) = delete;
+    ~ObjectValues();
+
+    /** Allocate an empty container from the calling thread's pool. */
+    static ObjectValues*
+    make();
+
+    static ObjectValues*
+    make(ObjectValues const& other);
+
+    /** Destroy a container returned by make(). */
+    static void
+    destroy(ObjectValues* p) noexcept;
+
+    iterator
+    begin()
+    {
+        sort();
+        return index_.begin();
+    }
+
+    iterator
+    end()
+    {
+        sort();
+        return index_.end();
+    }
+
+    const_iterator
+    begin() const
+    {
+        sort();
+        return index_.begin();
+    }
+
+    const_iterator
+    end() const
+    {
+        sort();
+        return index_.end();
+    }
+
+    std::size_t
+    size() const
+    {
+        return index_.size();
+    }
+
+    bool
+    empty() const
+    {
+        return index_.empty();
+    }
+
+    /** Return the member with the given key, or nullptr. */
+    Value*
+    find(CZString const& key) const;
+
+    /** Return the member with the given key, adding a null one if needed. */
+    Value&
+    findOrInsert(CZString const& key);
+
+    /** Remove and return the member with the given key, or null. */
+    Value
+    erase(CZString const& key);
+
+    void
+    clear();
+
+    /** The last element in key order. */
+    Node const&
+    back() const
+    {
+        sort();
+        return *index_.back();
+    }
+
+    friend bool
+    operator==(ObjectValues const& x, ObjectValues const& y);
+
+    friend bool
+    operator<(ObjectValues const& x, ObjectValues const& y);
+
+private:
+    Node*
+    construct(CZString const& key, Value const& value);
+
+    const_iterator
+    lowerBound(CZString const& key) const;
+
+    void
+    sort() const
+    {
+        if (unsorted_.load(std::memory_order_acquire) != 0)
+            sortUnsorted();
+    }
+
+    void
+    sortUnsorted() const;
+
+    mutable Index index_;
+
+    // The number of members at the end of the index which are not yet
+    // sorted into it.  There are only unsorted members if there are keys_.
+    mutable std::atomic<std::size_t> unsorted_{0};
+
+    // The keys of all the members, once out of order members are no longer
+    // inserted into the index
+    Keys* keys_ = nullptr;
+
+    // The members that did not fit in the inline storage
+    Block* blocks_ = nullptr;
+
+    // The storage of removed members, linked through their first bytes
+    Node* free_ = nullptr;
+
+    // The members are constructed at next_, until end_
+    Node* next_ = reinterpret_cast<Node*>(storage_);
+    Node* end_ = next_ + inlineNodes;
+
+    alignas(Node) unsigned char storage_[inlineNodes * sizeof(Node)];
+};
+
 bool
 operator==(const Value&, const Value&);
 
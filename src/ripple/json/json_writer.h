@@ -65,6 +65,9 @@ private:
     void
     writeValue(const Value& value);
 
+    void
+    appendQuotedString(const char* value);
+
     std::string document_;
 };
 
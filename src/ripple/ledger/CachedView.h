@@ -64,6 +64,9 @@ public:
     std::shared_ptr<SLE const>
     read(Keylet const& k) const override;
 
+    std::shared_ptr<SLEView const>
+    readLazy(Keylet const& k) const override;
+
     bool
     open() const override
     {
@@ -46,6 +46,19 @@ struct open_ledger_t
 
 extern open_ledger_t const open_ledger;
 
+/** Batch view construction tag.
+
+    Views constructed with this tag hold transactions
+    which are to follow those of an open view, such as
+    the ones applied in parallel to an open ledger.
+*/
+struct batch_view_t
+{
+    explicit batch_view_t() = default;
+};
+
+extern batch_view_t const batch_view;
+
 //------------------------------------------------------------------------------
 
 /** Writable ledger view that accumulates state and tx changes.
@@ -98,6 +111,9 @@ private:
     std::shared_ptr<void const> hold_;
     bool open_ = true;
 
+    // The number of tx which come before those of this view
+    std::size_t baseTxCount_ = 0;
+
 public:
     OpenView() = delete;
     OpenView&
@@ -170,6 +186,17 @@ public:
     */
     OpenView(ReadView const* base, std::shared_ptr<void const> hold = nullptr);
 
+    /** Construct a view whose tx follow those of another.
+
+        Effects:
+
+            As for a new last closed ledger, except
+            that tx are counted from `baseTxCount`,
+            so the first tx inserted takes it as its
+            apply ordinal.
+    */
+    OpenView(batch_view_t, ReadView const* base, std::size_t baseTxCount);
+
     /** Returns true if this reflects an open ledger. */
     bool
     open() const override
@@ -177,7 +204,8 @@ public:
         return open_;
     }
 
-    /** Return the number of tx inserted since creation.
+    /** Return the number of tx inserted since creation,
+        plus the count of the base of a batch view.
 
         This is used to set the "apply ordinal"
         when calculating transaction metadata.
@@ -211,6 +239,9 @@ public:
     std::shared_ptr<SLE const>
     read(Keylet const& k) const override;
 
+    std::shared_ptr<SLEView const>
+    readLazy(Keylet const& k) const override;
+
     std::unique_ptr<sles_type::iter_base>
     slesBegin() const override;
 
@@ -31,6 +31,7 @@
 #include <ripple/protocol/Protocol.h>
 #include <ripple/protocol/STAmount.h>
 #include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STLedgerEntryView.h>
 #include <ripple/protocol/STTx.h>
 #include <cassert>
 #include <cstdint>
@@ -311,6 +312,19 @@ public:
     virtual std::shared_ptr<SLE const>
     read(Keylet const& k) const = 0;
 
+    /** Return a lazily decoded view of the state item for a key.
+
+        This is intended for read-only callers which only need a few
+        fields of an entry: views backed by a ledger decode each field
+        on access, directly from the state map. Others fall back to
+        wrapping the result of read().
+
+        @return `nullptr` if the key is not present or
+                if the type does not match.
+    */
+    virtual std::shared_ptr<SLEView const>
+    readLazy(Keylet const& k) const;
+
     // Accounts in a payment are not allowed to use assets acquired during that
     // payment. The PaymentSandbox tracks the debits, credits, and owner count
     // changes that accounts make during a payment. `balanceHook` adjusts
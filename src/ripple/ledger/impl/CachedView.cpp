@@ -65,5 +65,23 @@ CachedViewImpl::read(Keylet const& k) const
     return iter->second;
 }
 
+std::shared_ptr<SLEView const>
+CachedViewImpl::readLazy(Keylet const& k) const
+{
+    {
+        std::lock_guard lock(mutex_);
+        auto const iter = map_.find(k.key);
+        if (iter != map_.end())
+        {
+            if (!iter->second || !k.check(*iter->second))
+                return nullptr;
+            return std::make_shared<SLEView const>(iter->second);
+        }
+    }
+    // Entries which were not already deserialized are not cached, since
+    // the point of a lazy view is to avoid deserializing them.
+    return base_.readLazy(k);
+}
+
 }  // namespace detail
 }  // namespace ripple
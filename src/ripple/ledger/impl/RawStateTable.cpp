@@ -319,6 +319,21 @@ RawStateTable::read(ReadView const& base, Keylet const& k) const
     return sle;
 }
 
+std::shared_ptr<SLEView const>
+RawStateTable::readLazy(ReadView const& base, Keylet const& k) const
+{
+    // Only entries which were not modified can be viewed lazily
+    auto const iter = items_.find(k.key);
+    if (iter == items_.end())
+        return base.readLazy(k);
+    auto const& item = iter->second;
+    if (item.action == Action::erase)
+        return nullptr;
+    if (!k.check(*item.sle))
+        return nullptr;
+    return std::make_shared<SLEView const>(item.sle);
+}
+
 void
 RawStateTable::destroyXRP(XRPAmount const& fee)
 {
@@ -123,6 +123,16 @@ Rules::operator==(Rules const& other) const
 
 //------------------------------------------------------------------------------
 
+std::shared_ptr<SLEView const>
+ReadView::readLazy(Keylet const& k) const
+{
+    if (auto sle = read(k))
+        return std::make_shared<SLEView const>(std::move(sle));
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+
 ReadView::sles_type::sles_type(ReadView const& view) : ReadViewFwdRange(view)
 {
 }
@@ -26,7 +26,9 @@
 #include <ripple/json/json_value.h>
 #include <ripple/protocol/Book.h>
 #include <ripple/resource/Consumer.h>
+#include <memory>
 #include <mutex>
+#include <string>
 
 namespace ripple {
 
@@ -146,6 +148,36 @@ public:
         tryRemoveRpcSub(std::string const& strUrl) = 0;
     };
 
+    /** A message published to many subscribers.
+
+        The compact JSON text of the message is made the first time a
+        subscriber asks for it, and is then shared by every session which
+        sends it.  A Message is used by one thread at a time.
+    */
+    class Message
+    {
+        Json::Value const& json_;
+        mutable std::shared_ptr<std::string const> text_;
+
+    public:
+        explicit Message(Json::Value const& json) : json_(json)
+        {
+        }
+
+        Message(Message const&) = delete;
+        Message&
+        operator=(Message const&) = delete;
+
+        Json::Value const&
+        json() const
+        {
+            return json_;
+        }
+
+        std::shared_ptr<std::string const> const&
+        text() const;
+    };
+
 public:
     InfoSub(Source& source);
     InfoSub(Source& source, Consumer consumer);
@@ -158,6 +190,26 @@ public:
     virtual void
     send(Json::Value const& jvObj, bool broadcast) = 0;
 
+    /** Send a message published to many subscribers.
+
+        By default this sends the JSON value of the message.
+    */
+    virtual void
+    send(Message const& message, bool broadcast)
+    {
+        send(message.json(), broadcast);
+    }
+
+    /** Returns true if the subscriber can take no more messages for now.
+
+        Publishers skip such a subscriber instead of queueing more for it.
+    */
+    virtual bool
+    isBacklogged()
+    {
+        return false;
+    }
+
     std::uint64_t
     getSeq();
 
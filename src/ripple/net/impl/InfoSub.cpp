@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/json/json_writer.h>
 #include <ripple/net/InfoSub.h>
 #include <atomic>
 
@@ -42,6 +43,22 @@ InfoSub::Source::Source(char const* name, Stoppable& parent)
 
 //------------------------------------------------------------------------------
 
+std::shared_ptr<std::string const> const&
+InfoSub::Message::text() const
+{
+    if (!text_)
+    {
+        auto text = std::make_shared<std::string>();
+        Json::stream(json_, [&](void const* data, std::size_t n) {
+            text->append(static_cast<char const*>(data), n);
+        });
+        text_ = std::move(text);
+    }
+    return text_;
+}
+
+//------------------------------------------------------------------------------
+
 InfoSub::InfoSub(Source& source) : m_source(source), mSeq(assign_id())
 {
 }
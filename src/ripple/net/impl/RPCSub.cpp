@@ -73,6 +73,15 @@ public:
 
     ~RPCSubImp() = default;
 
+    using InfoSub::send;
+
+    bool
+    isBacklogged() override
+    {
+        std::lock_guard sl(mLock);
+        return mDeque.size() >= eventQueueMax;
+    }
+
     void
     send(Json::Value const& jvObj, bool broadcast) override
     {
@@ -20,9 +20,12 @@
 #ifndef RIPPLE_NODESTORE_BACKEND_H_INCLUDED
 #define RIPPLE_NODESTORE_BACKEND_H_INCLUDED
 
+#include <ripple/json/json_value.h>
 #include <ripple/nodestore/Types.h>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <optional>
 
 namespace ripple {
 namespace NodeStore {
@@ -120,6 +123,21 @@ public:
     virtual Status
     fetch(void const* key, std::shared_ptr<NodeObject>* pObject) = 0;
 
+    /** Fetch a single object, measuring the time spent decoding it.
+        Backends which decompress and decode objects as part of a read
+        override this so that decoding can be told apart from I/O.
+        @param decodeTime [out] Time spent decoding the object, left unset
+                          if the object was not decoded.
+    */
+    virtual Status
+    fetchMeasured(
+        void const* key,
+        std::shared_ptr<NodeObject>* pObject,
+        std::optional<std::chrono::microseconds>& decodeTime)
+    {
+        return fetch(key, pObject);
+    }
+
     /** Return `true` if batch fetches are optimized. */
     virtual bool
     canFetchBatch() = 0;
@@ -183,6 +201,12 @@ public:
         return std::nullopt;
     }
 
+    /** Add backend specific statistics to a get_counts result. */
+    virtual void
+    getCountsJson(Json::Value& obj)
+    {
+    }
+
     /** Returns true if the backend uses permanent storage. */
     bool
     backed() const
@@ -34,6 +34,10 @@ class Ledger;
 
 namespace NodeStore {
 
+class BloomFilter;
+class FetchSource;
+class FetchStats;
+
 /** Persistency layer for NodeObject
 
     A Node is a ledger object which is uniquely identified by a key, which is
@@ -213,6 +217,14 @@ public:
     void
     getCountsJson(Json::Value& obj);
 
+    /** Returns the read statistics kept for a backend.
+
+        Backends are reported by name under `node_read_stages`. The
+        reference remains valid for the lifetime of the database.
+    */
+    FetchSource&
+    fetchSource(std::string const& name) const;
+
     /** Returns the number of file descriptors the database expects to need */
     int
     fdRequired() const
@@ -242,6 +254,11 @@ protected:
     std::atomic<std::uint32_t> fetchHitCount_{0};
     std::atomic<std::uint32_t> fetchSz_{0};
 
+    // Backend reads avoided because a bloom filter excluded the key, and
+    // reads the filter permitted that found nothing.
+    std::atomic<std::uint64_t> filterSkips_{0};
+    std::atomic<std::uint64_t> filterFalsePositives_{0};
+
     void
     stopReadThreads();
 
@@ -255,11 +272,17 @@ protected:
 
     // Called by the public import function
     void
-    importInternal(Backend& dstBackend, Database& srcDB);
+    importInternal(
+        Backend& dstBackend,
+        Database& srcDB,
+        BloomFilter* dstFilter = nullptr);
 
     // Called by the public storeLedger function
     bool
-    storeLedger(Ledger const& srcLedger, std::shared_ptr<Backend> dstBackend);
+    storeLedger(
+        Ledger const& srcLedger,
+        std::shared_ptr<Backend> dstBackend,
+        BloomFilter* dstFilter = nullptr);
 
     void
     updateFetchMetrics(uint64_t fetches, uint64_t hits, uint64_t duration)
@@ -270,6 +293,8 @@ protected:
     }
 
 private:
+    std::unique_ptr<FetchStats> fetchStats_;
+
     std::atomic<std::uint64_t> storeCount_{0};
     std::atomic<std::uint64_t> storeSz_{0};
     std::atomic<std::uint64_t> fetchTotalCount_{0};
@@ -324,6 +349,12 @@ private:
         return std::nullopt;
     }
 
+    /** Add statistics specific to the backends in use. */
+    virtual void
+    getBackendCountsJson(Json::Value& obj)
+    {
+    }
+
     void
     threadEntry();
 };
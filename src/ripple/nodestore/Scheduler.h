@@ -22,12 +22,15 @@
 
 #include <ripple/nodestore/Task.h>
 #include <chrono>
+#include <optional>
 
 namespace ripple {
 namespace NodeStore {
 
 enum class FetchType { synchronous, async };
 
+class FetchSource;
+
 /** Contains information about a fetch operation. */
 struct FetchReport
 {
@@ -38,6 +41,18 @@ struct FetchReport
     std::chrono::milliseconds elapsed;
     FetchType const fetchType;
     bool wasFound = false;
+
+    // Time spent in each stage of the fetch. Stages which did not take
+    // place are left unset. When several backends are tried, their reads
+    // and decodes accumulate.
+    std::optional<std::chrono::microseconds> cacheLookup;
+    std::optional<std::chrono::microseconds> backendRead;
+    std::optional<std::chrono::microseconds> decode;
+    std::optional<std::chrono::microseconds> canonicalize;
+
+    // The statistics of the last backend read, such as the writable or
+    // archive backend of a rotating database
+    FetchSource* source = nullptr;
 };
 
 /** Contains information about a batch write operation. */
@@ -184,16 +184,31 @@ public:
 
     Status
     fetch(void const* key, std::shared_ptr<NodeObject>* pno) override
+    {
+        std::optional<std::chrono::microseconds> decodeTime;
+        return fetchMeasured(key, pno, decodeTime);
+    }
+
+    Status
+    fetchMeasured(
+        void const* key,
+        std::shared_ptr<NodeObject>* pno,
+        std::optional<std::chrono::microseconds>& decodeTime) override
     {
         Status status;
         pno->reset();
         nudb::error_code ec;
         db_.fetch(
             key,
-            [key, pno, &status](void const* data, std::size_t size) {
+            [key, pno, &status, &decodeTime](
+                void const* data, std::size_t size) {
+                auto const start = std::chrono::steady_clock::now();
                 nudb::detail::buffer bf;
                 auto const result = nodeobject_decompress(data, size, bf);
                 DecodedBlob decoded(key, result.first, result.second);
+                decodeTime =
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start);
                 if (!decoded.wasOk())
                 {
                     status = dataCorrupt;
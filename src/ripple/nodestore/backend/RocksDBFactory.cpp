@@ -256,6 +256,16 @@ public:
 
     Status
     fetch(void const* key, std::shared_ptr<NodeObject>* pObject) override
+    {
+        std::optional<std::chrono::microseconds> decodeTime;
+        return fetchMeasured(key, pObject, decodeTime);
+    }
+
+    Status
+    fetchMeasured(
+        void const* key,
+        std::shared_ptr<NodeObject>* pObject,
+        std::optional<std::chrono::microseconds>& decodeTime) override
     {
         assert(m_db);
         pObject->reset();
@@ -271,6 +281,7 @@ public:
 
         if (getStatus.ok())
         {
+            auto const start = std::chrono::steady_clock::now();
             DecodedBlob decoded(key, string.data(), string.size());
 
             if (decoded.wasOk())
@@ -283,6 +294,9 @@ public:
                 //
                 status = dataCorrupt;
             }
+            decodeTime =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start);
         }
         else
         {
@@ -411,6 +425,12 @@ public:
         return m_batch.getWriteLoad();
     }
 
+    void
+    getCountsJson(Json::Value& obj) override
+    {
+        m_batch.getCountsJson(obj);
+    }
+
     void
     setDeletePath() override
     {
@@ -17,16 +17,28 @@
 */
 //==============================================================================
 
+#include <ripple/basics/contract.h>
 #include <ripple/nodestore/impl/BatchWriter.h>
+#include <ripple/protocol/jss.h>
+
+#include <algorithm>
 
 namespace ripple {
 namespace NodeStore {
 
+namespace {
+
+// Batches are resized to keep each backend write near this duration
+std::chrono::milliseconds constexpr targetWriteLatency{100};
+
+}  // namespace
+
 BatchWriter::BatchWriter(Callback& callback, Scheduler& scheduler)
     : m_callback(callback)
     , m_scheduler(scheduler)
     , mWriteLoad(0)
     , mWritePending(false)
+    , mBatchSize(batchWriteLimitSize)
 {
     mWriteSet.reserve(batchWritePreallocationSize);
 }
@@ -39,21 +51,45 @@ BatchWriter::~BatchWriter()
 void
 BatchWriter::store(std::shared_ptr<NodeObject> const& object)
 {
-    std::unique_lock<decltype(mWriteMutex)> sl(mWriteMutex);
+    ++mStoreCount;
 
-    // If the batch has reached its limit, we wait
-    // until the batch writer is finished
-    while (mWriteSet.size() >= batchWriteLimitSize)
-        mWriteCondition.wait(sl);
+    {
+        std::unique_lock sl(mWriteMutex);
 
-    mWriteSet.push_back(object);
+        // The object is queued or was written recently
+        if (mRecent.count(object->getHash()))
+        {
+            ++mDuplicateCount;
+            return;
+        }
 
-    if (!mWritePending)
-    {
-        mWritePending = true;
+        // If the batch has reached its limit, we wait
+        // until the batch writer is finished
+        while (mWriteSet.size() >= batchWriteLimitSize)
+            mWriteCondition.wait(sl);
+
+        // Another thread may have stored the object while this one waited
+        if (!mRecent.insert(object->getHash()).second)
+        {
+            ++mDuplicateCount;
+            return;
+        }
+        mRecentOrder.push_back(object->getHash());
+        if (mRecentOrder.size() > recentSize)
+        {
+            mRecent.erase(mRecentOrder.front());
+            mRecentOrder.pop_front();
+        }
+        mWriteSet.push_back(object);
 
-        m_scheduler.scheduleTask(*this);
+        if (mWritePending)
+            return;
+        mWritePending = true;
     }
+
+    // The scheduler may run the task on this thread, so the lock
+    // must not be held
+    m_scheduler.scheduleTask(*this);
 }
 
 int
@@ -64,6 +100,23 @@ BatchWriter::getWriteLoad()
     return std::max(mWriteLoad, static_cast<int>(mWriteSet.size()));
 }
 
+void
+BatchWriter::getCountsJson(Json::Value& obj)
+{
+    std::lock_guard sl(mWriteMutex);
+
+    obj[jss::node_write_queue] =
+        std::max(mWriteLoad, static_cast<int>(mWriteSet.size()));
+    obj[jss::node_write_batch_size] = static_cast<int>(mBatchSize);
+
+    // Every store is either written or dropped as a duplicate
+    auto const stores = mStoreCount.load();
+    auto const duplicates = mDuplicateCount.load();
+    obj[jss::node_write_requests] = std::to_string(stores);
+    obj[jss::node_writes_unique] = std::to_string(stores - duplicates);
+    obj[jss::node_writes_deduplicated] = std::to_string(duplicates);
+}
+
 void
 BatchWriter::performScheduledTask()
 {
@@ -75,36 +128,92 @@ BatchWriter::writeBatch()
 {
     for (;;)
     {
-        std::vector<std::shared_ptr<NodeObject>> set;
-
-        set.reserve(batchWritePreallocationSize);
+        Batch set;
 
         {
             std::lock_guard sl(mWriteMutex);
 
-            mWriteSet.swap(set);
-            assert(mWriteSet.empty());
-            mWriteLoad = set.size();
-
-            if (set.empty())
+            if (mWriteSet.empty())
             {
+                mWriteLoad = 0;
                 mWritePending = false;
                 mWriteCondition.notify_all();
 
                 // VFALCO NOTE Fix this function to not return from the middle
                 return;
             }
+
+            if (mWriteSet.size() <= mBatchSize)
+            {
+                set.reserve(batchWritePreallocationSize);
+                mWriteSet.swap(set);
+            }
+            else
+            {
+                auto const last = mWriteSet.begin() + mBatchSize;
+                set.assign(
+                    std::make_move_iterator(mWriteSet.begin()),
+                    std::make_move_iterator(last));
+                mWriteSet.erase(mWriteSet.begin(), last);
+            }
+            mWriteLoad = set.size();
+
+            // Wake any writers waiting for room in the batch
+            mWriteCondition.notify_all();
         }
 
         BatchWriteReport report;
         report.writeCount = set.size();
         auto const before = std::chrono::steady_clock::now();
 
-        m_callback.writeBatch(set);
+        try
+        {
+            m_callback.writeBatch(set);
+        }
+        catch (std::exception const&)
+        {
+            // Forget the keys so that storing them again is not skipped.
+            // Their places in the order go too, or aging one out later
+            // would forget the key once it is stored again.  The next
+            // store schedules writing again.
+            std::lock_guard sl(mWriteMutex);
+            mWritePending = false;
+            mWriteCondition.notify_all();
+            for (auto const& object : set)
+                mRecent.erase(object->getHash());
+            mRecentOrder.erase(
+                std::remove_if(
+                    mRecentOrder.begin(),
+                    mRecentOrder.end(),
+                    [this](uint256 const& key) {
+                        return mRecent.count(key) == 0;
+                    }),
+                mRecentOrder.end());
+            Rethrow();
+        }
 
         report.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - before);
 
+        {
+            // Shrink the batch when the backend is slow, so that writers
+            // blocked on a full batch are released sooner, and grow it
+            // again when the backend keeps up.
+            std::lock_guard sl(mWriteMutex);
+            if (report.elapsed > targetWriteLatency)
+            {
+                mBatchSize = std::max<std::size_t>(
+                    mBatchSize / 2, batchWritePreallocationSize);
+            }
+            else if (
+                report.elapsed < targetWriteLatency / 2 &&
+                set.size() == mBatchSize)
+            {
+                mBatchSize =
+                    std::min<std::size_t>(mBatchSize * 2, batchWriteLimitSize);
+            }
+        }
+
         m_scheduler.onBatchWrite(report);
     }
 }
@@ -112,7 +221,7 @@ BatchWriter::writeBatch()
 void
 BatchWriter::waitForWriting()
 {
-    std::unique_lock<decltype(mWriteMutex)> sl(mWriteMutex);
+    std::unique_lock sl(mWriteMutex);
 
     while (mWritePending)
         mWriteCondition.wait(sl);
@@ -20,10 +20,14 @@
 #ifndef RIPPLE_NODESTORE_BATCHWRITER_H_INCLUDED
 #define RIPPLE_NODESTORE_BATCHWRITER_H_INCLUDED
 
+#include <ripple/basics/UnorderedContainers.h>
+#include <ripple/json/json_value.h>
 #include <ripple/nodestore/Scheduler.h>
 #include <ripple/nodestore/Task.h>
 #include <ripple/nodestore/Types.h>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 
 namespace ripple {
@@ -35,6 +39,11 @@ namespace NodeStore {
     class it not required. A backend can implement its own write batching,
     or skip write batching if doing so yields a performance benefit.
 
+    Node objects are immutable and keyed by the hash of their contents, so
+    an object that is already queued or was recently written is dropped
+    instead of being written again. The number of objects handed to the
+    backend in each write adapts to how long recent writes took.
+
     @see Scheduler
 */
 class BatchWriter : private Task
@@ -74,6 +83,13 @@ public:
     int
     getWriteLoad();
 
+    /** Add write queue statistics to a get_counts result. */
+    void
+    getCountsJson(Json::Value& obj);
+
+    /** The number of recently stored keys remembered to drop duplicates. */
+    static constexpr std::size_t recentSize = 65536;
+
 private:
     void
     performScheduledTask() override;
@@ -83,16 +99,24 @@ private:
     waitForWriting();
 
 private:
-    using LockType = std::recursive_mutex;
-    using CondvarType = std::condition_variable_any;
-
     Callback& m_callback;
     Scheduler& m_scheduler;
-    LockType mWriteMutex;
-    CondvarType mWriteCondition;
+    std::mutex mWriteMutex;
+    std::condition_variable mWriteCondition;
     int mWriteLoad;
     bool mWritePending;
     Batch mWriteSet;
+
+    // Keys of queued and recently written objects, and the order in
+    // which they were stored so the oldest can be forgotten.
+    hash_set<uint256> mRecent;
+    std::deque<uint256> mRecentOrder;
+
+    // The most objects passed to a single Callback::writeBatch
+    std::size_t mBatchSize;
+
+    std::atomic<std::uint64_t> mStoreCount{0};
+    std::atomic<std::uint64_t> mDuplicateCount{0};
 };
 
 }  // namespace NodeStore
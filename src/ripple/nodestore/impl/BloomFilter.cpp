@@ -0,0 +1,248 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Log.h>
+#include <ripple/basics/contract.h>
+#include <ripple/nodestore/impl/BloomFilter.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace ripple {
+namespace NodeStore {
+
+namespace {
+
+// Saved filters start with this header
+struct FileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t hashes;
+    std::uint64_t bits;
+};
+
+char const fileMagic[8] = {'R', 'P', 'L', 'B', 'L', 'O', 'O', 'M'};
+std::uint32_t const fileVersion = 1;
+
+// Name of the file saved in the backend's directory
+char const fileName[] = "bloom.filter";
+
+std::uint64_t
+filterBits(std::uint64_t expectedKeys, std::uint32_t bitsPerKey)
+{
+    // Round up to whole 64-bit words, never less than one
+    auto const bits = std::max<std::uint64_t>(expectedKeys * bitsPerKey, 64);
+    return (bits + 63) & ~std::uint64_t{63};
+}
+
+std::uint32_t
+filterHashes(std::uint32_t bitsPerKey)
+{
+    // The false positive rate is lowest with bitsPerKey * ln(2) hashes
+    auto const k = static_cast<std::uint32_t>(
+        std::lround(bitsPerKey * 0.69314718055994530942));
+    return std::clamp<std::uint32_t>(k, 1, 30);
+}
+
+std::string
+filterPath(Backend& backend)
+{
+    if (!backend.backed())
+        return {};
+
+    boost::system::error_code ec;
+    boost::filesystem::path const dir{backend.getName()};
+    if (!boost::filesystem::is_directory(dir, ec) || ec)
+        return {};
+    return (dir / fileName).string();
+}
+
+}  // namespace
+
+BloomFilter::BloomFilter(std::uint64_t expectedKeys, std::uint32_t bitsPerKey)
+    : bits_(filterBits(expectedKeys, bitsPerKey))
+    , hashes_(filterHashes(bitsPerKey))
+    , words_(bits_ / 64)
+{
+}
+
+// Node object keys are already uniformly distributed hashes, so the probe
+// positions are derived from the key itself by double hashing.
+void
+BloomFilter::insert(uint256 const& key)
+{
+    std::uint64_t h[2];
+    std::memcpy(h, key.data(), sizeof(h));
+    h[1] |= 1;
+
+    for (std::uint32_t i = 0; i < hashes_; ++i)
+    {
+        auto const bit = (h[0] + i * h[1]) % bits_;
+        words_[bit / 64].fetch_or(
+            std::uint64_t{1} << (bit % 64), std::memory_order_relaxed);
+    }
+}
+
+bool
+BloomFilter::mayContain(uint256 const& key) const
+{
+    std::uint64_t h[2];
+    std::memcpy(h, key.data(), sizeof(h));
+    h[1] |= 1;
+
+    for (std::uint32_t i = 0; i < hashes_; ++i)
+    {
+        auto const bit = (h[0] + i * h[1]) % bits_;
+        if (!(words_[bit / 64].load(std::memory_order_relaxed) &
+              (std::uint64_t{1} << (bit % 64))))
+            return false;
+    }
+    return true;
+}
+
+bool
+BloomFilter::load(std::string const& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+
+    bool result = false;
+    FileHeader header;
+    if (in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+        std::memcmp(header.magic, fileMagic, sizeof(fileMagic)) == 0 &&
+        header.version == fileVersion && header.hashes == hashes_ &&
+        header.bits == bits_)
+    {
+        std::vector<std::uint64_t> words(words_.size());
+        if (in.read(
+                reinterpret_cast<char*>(words.data()),
+                words.size() * sizeof(std::uint64_t)))
+        {
+            for (std::size_t i = 0; i < words.size(); ++i)
+                words_[i].store(words[i], std::memory_order_relaxed);
+            result = true;
+        }
+    }
+
+    in.close();
+    boost::system::error_code ec;
+    boost::filesystem::remove(path, ec);
+    return result;
+}
+
+bool
+BloomFilter::save(std::string const& path) const
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return false;
+
+    FileHeader header;
+    std::memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.version = fileVersion;
+    header.hashes = hashes_;
+    header.bits = bits_;
+    out.write(reinterpret_cast<char const*>(&header), sizeof(header));
+
+    for (auto const& word : words_)
+    {
+        auto const w = word.load(std::memory_order_relaxed);
+        out.write(reinterpret_cast<char const*>(&w), sizeof(w));
+    }
+    return static_cast<bool>(out.flush());
+}
+
+//------------------------------------------------------------------------------
+
+std::shared_ptr<BloomFilter>
+makeBloomFilter(
+    Backend& backend,
+    Section const& config,
+    bool populate,
+    beast::Journal j)
+{
+    std::uint64_t expectedKeys = 0;
+    if (!get_if_exists(config, "bloom_filter_keys", expectedKeys) ||
+        expectedKeys == 0)
+    {
+        // Objects stored without the filter would be missing from a filter
+        // saved earlier, so it must not be loaded later
+        if (auto const path = filterPath(backend); !path.empty())
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove(path, ec);
+        }
+        return nullptr;
+    }
+
+    std::uint32_t bitsPerKey = 10;
+    get_if_exists(config, "bloom_filter_bits", bitsPerKey);
+    if (bitsPerKey == 0 || bitsPerKey > 64)
+        Throw<std::runtime_error>("Invalid bloom_filter_bits");
+
+    auto filter = std::make_shared<BloomFilter>(expectedKeys, bitsPerKey);
+    if (!populate)
+        return filter;
+
+    if (auto const path = filterPath(backend);
+        !path.empty() && filter->load(path))
+    {
+        JLOG(j.info()) << "Loaded bloom filter for " << backend.getName();
+        return filter;
+    }
+
+    JLOG(j.warn()) << "Rebuilding bloom filter for " << backend.getName();
+    std::uint64_t count = 0;
+    backend.for_each([&](std::shared_ptr<NodeObject> nodeObject) {
+        filter->insert(nodeObject->getHash());
+        ++count;
+    });
+    JLOG(j.info()) << "Bloom filter for " << backend.getName() << " holds "
+                   << count << " keys";
+    if (count > expectedKeys)
+    {
+        JLOG(j.warn()) << "Backend " << backend.getName() << " holds more "
+                       << "than bloom_filter_keys objects, increase it to "
+                       << "keep the false positive rate low";
+    }
+    return filter;
+}
+
+void
+saveBloomFilter(BloomFilter const& filter, Backend& backend, beast::Journal j)
+{
+    auto const path = filterPath(backend);
+    if (path.empty())
+        return;
+
+    if (!filter.save(path))
+    {
+        JLOG(j.error()) << "Unable to save bloom filter to " << path;
+        boost::system::error_code ec;
+        boost::filesystem::remove(path, ec);
+    }
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
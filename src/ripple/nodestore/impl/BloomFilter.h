@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_BLOOMFILTER_H_INCLUDED
+#define RIPPLE_NODESTORE_BLOOMFILTER_H_INCLUDED
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/nodestore/Backend.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace ripple {
+namespace NodeStore {
+
+/** Probabilistic set of the keys held by a backend.
+
+    The filter answers "definitely not stored" or "possibly stored", which
+    lets a Database skip backend reads for keys it does not have. Keys are
+    never removed, so a filter may only be shared with a backend that is
+    itself append-only (every NodeStore backend is).
+
+    Insertion and lookup are lock free and may be called concurrently.
+*/
+class BloomFilter
+{
+public:
+    /** Create an empty filter.
+
+        @param expectedKeys The number of keys the filter is sized for.
+        @param bitsPerKey The number of filter bits to use per expected key.
+    */
+    BloomFilter(std::uint64_t expectedKeys, std::uint32_t bitsPerKey);
+
+    BloomFilter(BloomFilter const&) = delete;
+    BloomFilter&
+    operator=(BloomFilter const&) = delete;
+
+    /** Add a key to the filter. */
+    void
+    insert(uint256 const& key);
+
+    /** Returns `false` if the key was certainly never inserted. */
+    bool
+    mayContain(uint256 const& key) const;
+
+    /** Replace the filter contents with those saved in a file.
+
+        The file is removed once read so that a crash, which may leave
+        stored keys out of a saved filter, forces the filter to be rebuilt.
+
+        @return `true` if the file existed and matched this filter's geometry.
+    */
+    bool
+    load(std::string const& path);
+
+    /** Write the filter contents to a file. */
+    bool
+    save(std::string const& path) const;
+
+private:
+    std::uint64_t const bits_;
+    std::uint32_t const hashes_;
+    std::vector<std::atomic<std::uint64_t>> words_;
+};
+
+/** Create the negative filter for a backend, if one is configured.
+
+    The filter is enabled by the `bloom_filter_keys` key of the database
+    configuration. It is restored from the file saved by saveBloomFilter
+    when available, and otherwise rebuilt by visiting the backend. When no
+    filter is configured, any saved file is removed, since the backend may
+    then store objects the file doesn't hold.
+
+    @param backend An open backend.
+    @param config The database configuration.
+    @param populate `false` if the backend is known to be empty.
+    @param j Destination for logging output.
+    @return The filter, or `nullptr` if none is configured.
+*/
+std::shared_ptr<BloomFilter>
+makeBloomFilter(
+    Backend& backend,
+    Section const& config,
+    bool populate,
+    beast::Journal j);
+
+/** Persist a backend's filter alongside the backend's files. */
+void
+saveBloomFilter(BloomFilter const& filter, Backend& backend, beast::Journal j);
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
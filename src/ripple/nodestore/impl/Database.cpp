@@ -22,6 +22,8 @@
 #include <ripple/beast/core/CurrentThreadName.h>
 #include <ripple/json/json_value.h>
 #include <ripple/nodestore/Database.h>
+#include <ripple/nodestore/impl/BloomFilter.h>
+#include <ripple/nodestore/impl/FetchStats.h>
 #include <ripple/protocol/HashPrefix.h>
 #include <ripple/protocol/jss.h>
 #include <chrono>
@@ -39,6 +41,7 @@ Database::Database(
     : Stoppable(name, parent.getRoot())
     , j_(journal)
     , scheduler_(scheduler)
+    , fetchStats_(std::make_unique<FetchStats>(config, journal))
     , earliestLedgerSeq_(
           get<std::uint32_t>(config, "earliest_seq", XRP_LEDGER_EARLIEST_SEQ))
 {
@@ -103,11 +106,20 @@ Database::asyncFetch(
 }
 
 void
-Database::importInternal(Backend& dstBackend, Database& srcDB)
+Database::importInternal(
+    Backend& dstBackend,
+    Database& srcDB,
+    BloomFilter* dstFilter)
 {
     Batch batch;
     batch.reserve(batchWritePreallocationSize);
     auto storeBatch = [&]() {
+        if (dstFilter)
+        {
+            for (auto const& nodeObject : batch)
+                dstFilter->insert(nodeObject->getHash());
+        }
+
         try
         {
             dstBackend.storeBatch(batch);
@@ -160,8 +172,10 @@ Database::fetchNodeObject(
     }
     ++fetchTotalCount_;
 
-    fetchReport.elapsed =
-        duration_cast<milliseconds>(steady_clock::now() - begin);
+    auto const elapsed{steady_clock::now() - begin};
+    fetchReport.elapsed = duration_cast<milliseconds>(elapsed);
+    fetchStats_->record(
+        fetchReport, hash, ledgerSeq, duration_cast<microseconds>(elapsed));
     scheduler_.onFetch(fetchReport);
     return nodeObject;
 }
@@ -169,7 +183,8 @@ Database::fetchNodeObject(
 bool
 Database::storeLedger(
     Ledger const& srcLedger,
-    std::shared_ptr<Backend> dstBackend)
+    std::shared_ptr<Backend> dstBackend,
+    BloomFilter* dstFilter)
 {
     auto fail = [&](std::string const& msg) {
         JLOG(j_.error()) << "Source ledger sequence " << srcLedger.info().seq
@@ -191,7 +206,11 @@ Database::storeLedger(
     auto storeBatch = [&]() {
         std::uint64_t sz{0};
         for (auto const& nodeObject : batch)
+        {
             sz += nodeObject->getData().size();
+            if (dstFilter)
+                dstFilter->insert(nodeObject->getHash());
+        }
 
         try
         {
@@ -315,6 +334,12 @@ Database::threadEntry()
     }
 }
 
+FetchSource&
+Database::fetchSource(std::string const& name) const
+{
+    return fetchStats_->source(name);
+}
+
 void
 Database::getCountsJson(Json::Value& obj)
 {
@@ -326,6 +351,16 @@ Database::getCountsJson(Json::Value& obj)
     obj[jss::node_read_bytes] = std::to_string(fetchSz_);
     obj[jss::node_reads_duration_us] = std::to_string(fetchDurationUs_);
 
+    if (filterSkips_ || filterFalsePositives_)
+    {
+        obj[jss::node_reads_filtered] = std::to_string(filterSkips_);
+        obj[jss::node_reads_filter_false_positive] =
+            std::to_string(filterFalsePositives_);
+    }
+
+    fetchStats_->getCountsJson(obj);
+    getBackendCountsJson(obj);
+
     if (auto c = getCounters())
     {
         obj[jss::node_read_errors] = std::to_string(c->readErrors);
@@ -19,6 +19,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/nodestore/impl/DatabaseNodeImp.h>
+#include <ripple/nodestore/impl/FetchStats.h>
 #include <ripple/protocol/HashPrefix.h>
 
 namespace ripple {
@@ -32,6 +33,8 @@ DatabaseNodeImp::store(
     std::uint32_t)
 {
     auto nObj = NodeObject::createObject(type, std::move(data), hash);
+    if (filter_)
+        filter_->insert(hash);
     backend_->store(nObj);
     storeStats(1, nObj->getData().size());
 }
@@ -49,9 +52,20 @@ DatabaseNodeImp::fetchNodeObject(
     std::uint32_t,
     FetchReport& fetchReport)
 {
-    std::shared_ptr<NodeObject> nodeObject{
-        cache_ ? cache_->fetch(hash) : nullptr};
-    if (!nodeObject)
+    std::shared_ptr<NodeObject> nodeObject;
+    if (cache_)
+    {
+        StageTimer timer(fetchReport.cacheLookup);
+        nodeObject = cache_->fetch(hash);
+    }
+
+    if (!nodeObject && filter_ && !filter_->mayContain(hash))
+    {
+        JLOG(j_.trace())
+            << "DatabaseNodeImp::fetchNodeObject - record not in filter";
+        ++filterSkips_;
+    }
+    else if (!nodeObject)
     {
         JLOG(j_.trace())
             << "DatabaseNodeImp::fetchNodeObject - record not in cache";
@@ -59,7 +73,8 @@ DatabaseNodeImp::fetchNodeObject(
 
         try
         {
-            status = backend_->fetch(hash.data(), &nodeObject);
+            status = fetchTimed(
+                *backend_, hash, &nodeObject, fetchReport, fetchSource_);
         }
         catch (std::exception const& e)
         {
@@ -75,10 +90,15 @@ DatabaseNodeImp::fetchNodeObject(
                 {
                     fetchSz_ += nodeObject->getData().size();
                     if (cache_)
+                    {
+                        StageTimer timer(fetchReport.canonicalize);
                         cache_->canonicalize_replace_client(hash, nodeObject);
+                    }
                 }
                 break;
             case notFound:
+                if (filter_)
+                    ++filterFalsePositives_;
                 break;
             case dataCorrupt:
                 JLOG(j_.fatal()) << "Corrupt NodeObject #" << hash;
@@ -116,7 +136,12 @@ DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
         // See if the object already exists in the cache
         auto nObj = cache_ ? cache_->fetch(hash) : nullptr;
         ++fetches;
-        if (!nObj)
+        if (!nObj && filter_ && !filter_->mayContain(hash))
+        {
+            // Certainly not in the database
+            ++filterSkips_;
+        }
+        else if (!nObj)
         {
             // Try the database
             indexMap[&hash] = i;
@@ -150,6 +175,8 @@ DatabaseNodeImp::fetchBatch(std::vector<uint256> const& hashes)
         }
         else
         {
+            if (filter_)
+                ++filterFalsePositives_;
             JLOG(j_.error())
                 << "DatabaseNodeImp::fetchBatch - "
                 << "record not found in db or cache. hash = " << strHex(hash);
@@ -23,6 +23,7 @@
 #include <ripple/basics/TaggedCache.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/nodestore/Database.h>
+#include <ripple/nodestore/impl/BloomFilter.h>
 
 namespace ripple {
 namespace NodeStore {
@@ -46,6 +47,7 @@ public:
         : Database(name, parent, scheduler, readThreads, config, j)
         , cache_(nullptr)
         , backend_(std::move(backend))
+        , fetchSource_(fetchSource("node"))
     {
         std::optional<int> cacheSize, cacheAge;
         if (config.exists("cache_size"))
@@ -80,6 +82,7 @@ public:
                 j);
         }
         assert(backend_);
+        filter_ = makeBloomFilter(*backend_, config, true, j);
         setParent(parent);
     }
 
@@ -87,6 +90,9 @@ public:
     {
         // Stop read threads in base before data members are destroyed
         stopReadThreads();
+
+        if (filter_)
+            saveBloomFilter(*filter_, *backend_, j_);
     }
 
     std::string
@@ -104,7 +110,7 @@ public:
     void
     import(Database& source) override
     {
-        importInternal(*backend_.get(), source);
+        importInternal(*backend_.get(), source, filter_.get());
     }
 
     void
@@ -128,7 +134,7 @@ public:
     bool
     storeLedger(std::shared_ptr<Ledger const> const& srcLedger) override
     {
-        return Database::storeLedger(*srcLedger, backend_);
+        return Database::storeLedger(*srcLedger, backend_, filter_.get());
     }
 
     void
@@ -140,6 +146,10 @@ private:
     std::shared_ptr<TaggedCache<uint256, NodeObject>> cache_;
     // Persistent key/value storage
     std::shared_ptr<Backend> backend_;
+    // Keys possibly present in the backend. This filter is not always
+    // initialized. Check for null before using.
+    std::shared_ptr<BloomFilter> filter_;
+    FetchSource& fetchSource_;
 
     std::shared_ptr<NodeObject>
     fetchNodeObject(
@@ -158,6 +168,12 @@ private:
     {
         return backend_->counters();
     }
+
+    void
+    getBackendCountsJson(Json::Value& obj) override
+    {
+        backend_->getCountsJson(obj);
+    }
 };
 
 }  // namespace NodeStore
@@ -19,6 +19,7 @@
 
 #include <ripple/app/ledger/Ledger.h>
 #include <ripple/nodestore/impl/DatabaseRotatingImp.h>
+#include <ripple/nodestore/impl/FetchStats.h>
 #include <ripple/protocol/HashPrefix.h>
 
 namespace ripple {
@@ -36,14 +37,34 @@ DatabaseRotatingImp::DatabaseRotatingImp(
     : DatabaseRotating(name, parent, scheduler, readThreads, config, j)
     , writableBackend_(std::move(writableBackend))
     , archiveBackend_(std::move(archiveBackend))
+    , config_(config)
+    , writableSource_(fetchSource("writable"))
+    , archiveSource_(fetchSource("archive"))
 {
     if (writableBackend_)
         fdRequired_ += writableBackend_->fdRequired();
     if (archiveBackend_)
         fdRequired_ += archiveBackend_->fdRequired();
+    if (writableBackend_ && archiveBackend_)
+    {
+        writableFilter_ = makeBloomFilter(*writableBackend_, config, true, j);
+        archiveFilter_ = makeBloomFilter(*archiveBackend_, config, true, j);
+    }
     setParent(parent);
 }
 
+DatabaseRotatingImp::~DatabaseRotatingImp()
+{
+    // Stop read threads in base before data members are destroyed
+    stopReadThreads();
+
+    std::lock_guard lock(mutex_);
+    if (writableFilter_)
+        saveBloomFilter(*writableFilter_, *writableBackend_, j_);
+    if (archiveFilter_)
+        saveBloomFilter(*archiveFilter_, *archiveBackend_, j_);
+}
+
 void
 DatabaseRotatingImp::rotateWithLock(
     std::function<std::unique_ptr<NodeStore::Backend>(
@@ -55,6 +76,14 @@ DatabaseRotatingImp::rotateWithLock(
     archiveBackend_->setDeletePath();
     archiveBackend_ = std::move(writableBackend_);
     writableBackend_ = std::move(newBackend);
+
+    if (writableFilter_)
+    {
+        // The new backend starts out empty
+        archiveFilter_ = std::move(writableFilter_);
+        writableFilter_ =
+            makeBloomFilter(*writableBackend_, config_, false, j_);
+    }
 }
 
 std::string
@@ -74,23 +103,23 @@ DatabaseRotatingImp::getWriteLoad() const
 void
 DatabaseRotatingImp::import(Database& source)
 {
-    auto const backend = [&] {
+    auto const [backend, filter] = [&] {
         std::lock_guard lock(mutex_);
-        return writableBackend_;
+        return std::make_pair(writableBackend_, writableFilter_);
     }();
 
-    importInternal(*backend, source);
+    importInternal(*backend, source, filter.get());
 }
 
 bool
 DatabaseRotatingImp::storeLedger(std::shared_ptr<Ledger const> const& srcLedger)
 {
-    auto const backend = [&] {
+    auto const [backend, filter] = [&] {
         std::lock_guard lock(mutex_);
-        return writableBackend_;
+        return std::make_pair(writableBackend_, writableFilter_);
     }();
 
-    return Database::storeLedger(*srcLedger, backend);
+    return Database::storeLedger(*srcLedger, backend, filter.get());
 }
 
 void
@@ -109,11 +138,13 @@ DatabaseRotatingImp::store(
 {
     auto nObj = NodeObject::createObject(type, std::move(data), hash);
 
-    auto const backend = [&] {
+    auto const [backend, filter] = [&] {
         std::lock_guard lock(mutex_);
-        return writableBackend_;
+        return std::make_pair(writableBackend_, writableFilter_);
     }();
 
+    if (filter)
+        filter->insert(hash);
     backend->store(nObj);
     storeStats(1, nObj->getData().size());
 }
@@ -130,12 +161,21 @@ DatabaseRotatingImp::fetchNodeObject(
     std::uint32_t,
     FetchReport& fetchReport)
 {
-    auto fetch = [&](std::shared_ptr<Backend> const& backend) {
+    auto fetch = [&](std::shared_ptr<Backend> const& backend,
+                     std::shared_ptr<BloomFilter> const& filter,
+                     FetchSource& source) {
         Status status;
         std::shared_ptr<NodeObject> nodeObject;
+        if (filter && !filter->mayContain(hash))
+        {
+            ++filterSkips_;
+            return nodeObject;
+        }
+
         try
         {
-            status = backend->fetch(hash.data(), &nodeObject);
+            status =
+                fetchTimed(*backend, hash, &nodeObject, fetchReport, source);
         }
         catch (std::exception const& e)
         {
@@ -151,6 +191,8 @@ DatabaseRotatingImp::fetchNodeObject(
                     fetchSz_ += nodeObject->getData().size();
                 break;
             case notFound:
+                if (filter)
+                    ++filterFalsePositives_;
                 break;
             case dataCorrupt:
                 JLOG(j_.fatal()) << "Corrupt NodeObject #" << hash;
@@ -166,26 +208,30 @@ DatabaseRotatingImp::fetchNodeObject(
     // See if the node object exists in the cache
     std::shared_ptr<NodeObject> nodeObject;
 
-    auto [writable, archive] = [&] {
+    auto [writable, writableFilter, archive, archiveFilter] = [&] {
         std::lock_guard lock(mutex_);
-        return std::make_pair(writableBackend_, archiveBackend_);
+        return std::make_tuple(
+            writableBackend_, writableFilter_, archiveBackend_, archiveFilter_);
     }();
 
     // Try to fetch from the writable backend
-    nodeObject = fetch(writable);
+    nodeObject = fetch(writable, writableFilter, writableSource_);
     if (!nodeObject)
     {
         // Otherwise try to fetch from the archive backend
-        nodeObject = fetch(archive);
+        nodeObject = fetch(archive, archiveFilter, archiveSource_);
         if (nodeObject)
         {
             {
                 // Refresh the writable backend pointer
                 std::lock_guard lock(mutex_);
                 writable = writableBackend_;
+                writableFilter = writableFilter_;
             }
 
             // Update writable backend with data from the archive backend
+            if (writableFilter)
+                writableFilter->insert(hash);
             writable->store(nodeObject);
         }
     }
@@ -212,5 +258,16 @@ DatabaseRotatingImp::for_each(
     archive->for_each(f);
 }
 
+void
+DatabaseRotatingImp::getBackendCountsJson(Json::Value& obj)
+{
+    auto const backend = [&] {
+        std::lock_guard lock(mutex_);
+        return writableBackend_;
+    }();
+
+    backend->getCountsJson(obj);
+}
+
 }  // namespace NodeStore
 }  // namespace ripple
@@ -21,6 +21,7 @@
 #define RIPPLE_NODESTORE_DATABASEROTATINGIMP_H_INCLUDED
 
 #include <ripple/nodestore/DatabaseRotating.h>
+#include <ripple/nodestore/impl/BloomFilter.h>
 
 namespace ripple {
 namespace NodeStore {
@@ -43,11 +44,7 @@ public:
         Section const& config,
         beast::Journal j);
 
-    ~DatabaseRotatingImp() override
-    {
-        // Stop read threads in base before data members are destroyed
-        stopReadThreads();
-    }
+    ~DatabaseRotatingImp() override;
 
     void
     rotateWithLock(
@@ -85,6 +82,14 @@ public:
 private:
     std::shared_ptr<Backend> writableBackend_;
     std::shared_ptr<Backend> archiveBackend_;
+    // Keys possibly present in each backend. Either both filters are
+    // initialized or neither is.
+    std::shared_ptr<BloomFilter> writableFilter_;
+    std::shared_ptr<BloomFilter> archiveFilter_;
+    Section const config_;
+    // Reads are attributed to the role of the backend, not its name
+    FetchSource& writableSource_;
+    FetchSource& archiveSource_;
     mutable std::mutex mutex_;
 
     struct Backends
@@ -101,6 +106,9 @@ private:
 
     void
     for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override;
+
+    void
+    getBackendCountsJson(Json::Value& obj) override;
 };
 
 }  // namespace NodeStore
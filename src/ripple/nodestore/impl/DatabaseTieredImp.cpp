@@ -0,0 +1,553 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/beast/core/CurrentThreadName.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/DatabaseTieredImp.h>
+#include <ripple/nodestore/impl/FetchStats.h>
+#include <ripple/protocol/jss.h>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/container/small_vector.hpp>
+
+namespace ripple {
+namespace NodeStore {
+
+DatabaseTieredImp::DatabaseTieredImp(
+    std::string const& name,
+    Scheduler& scheduler,
+    int readThreads,
+    Stoppable& parent,
+    std::size_t burstSize,
+    Section const& config,
+    beast::Journal j)
+    : Database(name, parent, scheduler, readThreads, config, j)
+    , scheduler_(scheduler)
+    , burstSize_(burstSize)
+    , hotLedgers_(get<std::uint32_t>(config, "hot_ledgers", 4096))
+    , hotPath_(get<std::string>(config, "path"))
+    , hotSource_(fetchSource("hot"))
+    , coldSource_(fetchSource("cold"))
+{
+    if (hotLedgers_ == 0)
+        Throw<std::runtime_error>("Invalid hot_ledgers");
+    if (hotPath_.empty())
+        Throw<std::runtime_error>("Missing path in tiered node database");
+
+    Section coldConfig;
+    for (auto const& [key, value] : config)
+    {
+        if (boost::istarts_with(key, "cold_"))
+            coldConfig.set(key.substr(5), value);
+        else
+            hotConfig_.set(key, value);
+    }
+    if (!coldConfig.exists("path"))
+        Throw<std::runtime_error>("Missing cold_path in tiered node database");
+
+    cold_ = Manager::instance().make_Backend(
+        coldConfig, burstSize_, scheduler_, j_);
+    cold_->open();
+
+    boost::filesystem::create_directories(hotPath_);
+
+    // Each generation is identified by its log of keys
+    std::vector<std::uint32_t> startSeqs;
+    for (auto const& entry : boost::filesystem::directory_iterator(hotPath_))
+    {
+        auto const file = entry.path().filename().string();
+        std::uint32_t seq;
+        if (file.size() > 9 && boost::starts_with(file, "hot.") &&
+            boost::ends_with(file, ".keys") &&
+            beast::lexicalCastChecked(seq, file.substr(4, file.size() - 9)))
+        {
+            startSeqs.push_back(seq);
+        }
+    }
+    std::sort(startSeqs.rbegin(), startSeqs.rend());
+
+    for (auto const seq : startSeqs)
+        hot_.push_back(openGeneration(seq, false));
+
+    if (!hot_.empty())
+    {
+        maxSeq_ = hot_.front()->startSeq;
+
+        // Older generations were left waiting for migration
+        for (auto it = std::next(hot_.begin()); it != hot_.end(); ++it)
+            retire(**it);
+    }
+
+    // Allow for one generation migrating while another is written
+    fdRequired_ = cold_->fdRequired();
+    if (!hot_.empty())
+        fdRequired_ += 2 * hot_.front()->backend->fdRequired();
+    else
+        fdRequired_ += 2 * cold_->fdRequired();
+
+    migrator_ = std::thread(&DatabaseTieredImp::migrateThread, this);
+    setParent(parent);
+}
+
+DatabaseTieredImp::~DatabaseTieredImp()
+{
+    stopMigration();
+
+    // Stop read threads in base before data members are destroyed
+    stopReadThreads();
+
+    std::lock_guard lock(mutex_);
+    for (auto const& generation : hot_)
+    {
+        if (!generation->retired)
+            retire(*generation);
+    }
+}
+
+void
+DatabaseTieredImp::onStop()
+{
+    stopMigration();
+    Database::onStop();
+}
+
+std::string
+DatabaseTieredImp::getName() const
+{
+    return hotPath_.string();
+}
+
+std::int32_t
+DatabaseTieredImp::getWriteLoad() const
+{
+    std::lock_guard lock(mutex_);
+    auto load = cold_->getWriteLoad();
+    if (!hot_.empty())
+        load = std::max(load, hot_.front()->backend->getWriteLoad());
+    return load;
+}
+
+void
+DatabaseTieredImp::import(Database& source)
+{
+    // Imported objects have no ledger sequence, so they are cold
+    importInternal(*cold_, source);
+}
+
+void
+DatabaseTieredImp::store(
+    NodeObjectType type,
+    Blob&& data,
+    uint256 const& hash,
+    std::uint32_t ledgerSeq)
+{
+    auto nObj = NodeObject::createObject(type, std::move(data), hash);
+
+    while (true)
+    {
+        auto const generation = [&] {
+            std::lock_guard lock(mutex_);
+            return generationFor(ledgerSeq);
+        }();
+
+        if (!generation)
+        {
+            cold_->store(nObj);
+            break;
+        }
+
+        std::shared_lock writing(generation->writeMutex);
+        if (generation->retired)
+            continue;
+
+        {
+            std::lock_guard lock(generation->keysMutex);
+            generation->keys.write(
+                reinterpret_cast<char const*>(hash.data()), hash.size());
+        }
+        generation->backend->store(nObj);
+        break;
+    }
+
+    storeStats(1, nObj->getData().size());
+}
+
+void
+DatabaseTieredImp::sync()
+{
+    auto const generation = [&] {
+        std::lock_guard lock(mutex_);
+        return hot_.empty() ? nullptr : hot_.front();
+    }();
+
+    if (generation)
+    {
+        std::shared_lock writing(generation->writeMutex);
+        if (!generation->retired)
+        {
+            std::lock_guard lock(generation->keysMutex);
+            generation->keys.flush();
+        }
+        generation->backend->sync();
+    }
+    cold_->sync();
+}
+
+bool
+DatabaseTieredImp::storeLedger(std::shared_ptr<Ledger const> const& srcLedger)
+{
+    // Ledgers copied from another database are typically history
+    // being filled, so they are written to the tier their age calls for.
+    auto const generation = [&] {
+        std::lock_guard lock(mutex_);
+        return generationFor(srcLedger->info().seq);
+    }();
+
+    if (!generation)
+        return Database::storeLedger(*srcLedger, cold_);
+
+    std::shared_lock writing(generation->writeMutex);
+    if (generation->retired)
+        return Database::storeLedger(*srcLedger, cold_);
+
+    // The objects written are not known in advance, so record them all
+    // in the key log before storing the ledger.
+    std::vector<uint256> keys;
+    keys.push_back(srcLedger->info().hash);
+    auto record = [&](SHAMapTreeNode& node) {
+        keys.push_back(node.getHash().as_uint256());
+        return true;
+    };
+    if (srcLedger->stateMap().getHash().isNonZero())
+        srcLedger->stateMap().snapShot(false)->visitNodes(record);
+    if (srcLedger->info().txHash.isNonZero())
+        srcLedger->txMap().snapShot(false)->visitNodes(record);
+
+    {
+        std::lock_guard lock(generation->keysMutex);
+        for (auto const& key : keys)
+        {
+            generation->keys.write(
+                reinterpret_cast<char const*>(key.data()), key.size());
+        }
+    }
+    return Database::storeLedger(*srcLedger, generation->backend);
+}
+
+std::shared_ptr<NodeObject>
+DatabaseTieredImp::fetchNodeObject(
+    uint256 const& hash,
+    std::uint32_t,
+    FetchReport& fetchReport)
+{
+    // At most the current and one or two retired generations
+    auto const generations = [&] {
+        std::lock_guard lock(mutex_);
+        boost::container::small_vector<std::shared_ptr<Backend>, 4> result;
+        for (auto const& generation : hot_)
+            result.push_back(generation->backend);
+        return result;
+    }();
+
+    std::shared_ptr<NodeObject> nodeObject;
+    for (auto const& backend : generations)
+    {
+        if ((nodeObject = fetchFrom(*backend, hash, fetchReport, hotSource_)))
+        {
+            ++hotHits_;
+            break;
+        }
+    }
+
+    if (!nodeObject &&
+        (nodeObject = fetchFrom(*cold_, hash, fetchReport, coldSource_)))
+        ++coldHits_;
+
+    if (nodeObject)
+        fetchReport.wasFound = true;
+
+    return nodeObject;
+}
+
+void
+DatabaseTieredImp::for_each(std::function<void(std::shared_ptr<NodeObject>)> f)
+{
+    auto const generations = [&] {
+        std::lock_guard lock(mutex_);
+        return hot_;
+    }();
+
+    for (auto const& generation : generations)
+        generation->backend->for_each(f);
+    cold_->for_each(f);
+}
+
+void
+DatabaseTieredImp::getBackendCountsJson(Json::Value& obj)
+{
+    obj[jss::node_reads_hot] = std::to_string(hotHits_);
+    obj[jss::node_reads_cold] = std::to_string(coldHits_);
+    obj[jss::node_migrated] = std::to_string(migrated_);
+
+    std::lock_guard lock(mutex_);
+    obj[jss::node_hot_generations] = static_cast<int>(hot_.size());
+}
+
+std::shared_ptr<NodeObject>
+DatabaseTieredImp::fetchFrom(
+    Backend& backend,
+    uint256 const& hash,
+    FetchReport& fetchReport,
+    FetchSource& source)
+{
+    Status status;
+    std::shared_ptr<NodeObject> nodeObject;
+    try
+    {
+        status = fetchTimed(backend, hash, &nodeObject, fetchReport, source);
+    }
+    catch (std::exception const& e)
+    {
+        JLOG(j_.fatal()) << "Exception, " << e.what();
+        Rethrow();
+    }
+
+    switch (status)
+    {
+        case ok:
+            ++fetchHitCount_;
+            if (nodeObject)
+                fetchSz_ += nodeObject->getData().size();
+            break;
+        case notFound:
+            break;
+        case dataCorrupt:
+            JLOG(j_.fatal()) << "Corrupt NodeObject #" << hash;
+            break;
+        default:
+            JLOG(j_.warn()) << "Unknown status=" << status;
+            break;
+    }
+
+    return nodeObject;
+}
+
+std::shared_ptr<DatabaseTieredImp::Generation>
+DatabaseTieredImp::generationFor(std::uint32_t ledgerSeq)
+{
+    if (ledgerSeq == 0)
+        return hot_.empty() ? nullptr : hot_.front();
+
+    // Below the hot window
+    if (ledgerSeq + hotLedgers_ <= maxSeq_)
+        return nullptr;
+
+    maxSeq_ = std::max(maxSeq_, ledgerSeq);
+    if (!hot_.empty() && ledgerSeq < hot_.front()->startSeq + hotLedgers_)
+        return hot_.front();
+
+    // Start a new generation and hand the previous one to the migrator,
+    // which retires it once the writes in progress are done. Waiting for
+    // them here would stall every reader.
+    auto generation = openGeneration(ledgerSeq, true);
+    hot_.push_front(generation);
+    cond_.notify_all();
+
+    JLOG(j_.info()) << "Started hot generation at ledger " << ledgerSeq;
+    return generation;
+}
+
+std::shared_ptr<DatabaseTieredImp::Generation>
+DatabaseTieredImp::openGeneration(std::uint32_t startSeq, bool create)
+{
+    auto generation = std::make_shared<Generation>();
+    generation->startSeq = startSeq;
+
+    Section section{hotConfig_};
+    section.set(
+        "path", (hotPath_ / ("hot." + std::to_string(startSeq))).string());
+    generation->backend = Manager::instance().make_Backend(
+        section, burstSize_, scheduler_, j_);
+    generation->backend->open();
+
+    auto const clean = cleanPath(startSeq);
+    boost::system::error_code ec;
+    if (!create && !boost::filesystem::exists(clean, ec))
+    {
+        // The key log may be missing keys written before a crash
+        JLOG(j_.warn()) << "Rebuilding key log of hot generation "
+                        << startSeq;
+        std::ofstream keys(
+            keysPath(startSeq), std::ios::binary | std::ios::trunc);
+        generation->backend->for_each([&](std::shared_ptr<NodeObject> obj) {
+            keys.write(
+                reinterpret_cast<char const*>(obj->getHash().data()),
+                obj->getHash().size());
+        });
+    }
+
+    // A generation that may be written is not clean until retired
+    boost::filesystem::remove(clean, ec);
+    generation->keys.open(
+        keysPath(startSeq), std::ios::binary | std::ios::app);
+    if (!generation->keys)
+    {
+        Throw<std::runtime_error>(
+            "Unable to open key log " + keysPath(startSeq));
+    }
+    return generation;
+}
+
+void
+DatabaseTieredImp::retire(Generation& generation)
+{
+    {
+        std::lock_guard lock(generation.keysMutex);
+        generation.keys.close();
+    }
+    generation.retired = true;
+    std::ofstream{cleanPath(generation.startSeq)};
+}
+
+std::string
+DatabaseTieredImp::keysPath(std::uint32_t startSeq) const
+{
+    return (hotPath_ / ("hot." + std::to_string(startSeq) + ".keys")).string();
+}
+
+std::string
+DatabaseTieredImp::cleanPath(std::uint32_t startSeq) const
+{
+    return (hotPath_ / ("hot." + std::to_string(startSeq) + ".clean"))
+        .string();
+}
+
+void
+DatabaseTieredImp::migrateThread()
+{
+    beast::setCurrentThreadName("tiered migrate");
+    while (true)
+    {
+        std::shared_ptr<Generation> generation;
+        {
+            std::unique_lock lock(mutex_);
+            // Every generation but the first is no longer written
+            cond_.wait(
+                lock, [&] { return stopMigration_ || hot_.size() > 1; });
+            if (stopMigration_)
+                return;
+            generation = hot_.back();
+        }
+
+        {
+            // Wait for the writes in progress, such as a ledger being
+            // copied, without holding mutex_
+            std::unique_lock writing(generation->writeMutex);
+            if (!generation->retired)
+                retire(*generation);
+        }
+
+        if (!migrate(*generation))
+            return;
+
+        {
+            std::lock_guard lock(mutex_);
+            hot_.pop_back();
+        }
+
+        // The backend files are removed once no reader holds the backend
+        generation->backend->setDeletePath();
+        boost::system::error_code ec;
+        boost::filesystem::remove(keysPath(generation->startSeq), ec);
+        boost::filesystem::remove(cleanPath(generation->startSeq), ec);
+        JLOG(j_.info()) << "Migrated hot generation " << generation->startSeq
+                        << " to the cold tier";
+    }
+}
+
+bool
+DatabaseTieredImp::migrate(Generation& generation)
+{
+    auto stopping = [&] {
+        std::lock_guard lock(mutex_);
+        return stopMigration_;
+    };
+
+    // Let writes queued before the generation was retired complete
+    while (generation.backend->getWriteLoad() > 0)
+    {
+        if (stopping())
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    std::ifstream keys(keysPath(generation.startSeq), std::ios::binary);
+    Batch batch;
+    batch.reserve(batchWritePreallocationSize);
+    auto storeBatch = [&] {
+        cold_->storeBatch(batch);
+        migrated_ += batch.size();
+        batch.clear();
+    };
+
+    uint256 key;
+    while (keys.read(reinterpret_cast<char*>(key.data()), key.size()))
+    {
+        std::shared_ptr<NodeObject> nodeObject;
+        if (generation.backend->fetch(key.data(), &nodeObject) != ok ||
+            !nodeObject)
+        {
+            JLOG(j_.warn()) << "Hot generation " << generation.startSeq
+                            << " is missing logged object " << key;
+            continue;
+        }
+
+        batch.emplace_back(std::move(nodeObject));
+        if (batch.size() >= batchWritePreallocationSize)
+        {
+            // An interrupted migration starts over when next opened
+            if (stopping())
+                return false;
+            storeBatch();
+        }
+    }
+
+    if (!batch.empty())
+        storeBatch();
+    cold_->sync();
+    return true;
+}
+
+void
+DatabaseTieredImp::stopMigration()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopMigration_ = true;
+        cond_.notify_all();
+    }
+
+    if (migrator_.joinable())
+        migrator_.join();
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -0,0 +1,201 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_DATABASETIEREDIMP_H_INCLUDED
+#define RIPPLE_NODESTORE_DATABASETIEREDIMP_H_INCLUDED
+
+#include <ripple/nodestore/Database.h>
+
+#include <boost/filesystem.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <shared_mutex>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A database split between a fast hot tier and a slower cold tier.
+
+    Objects belonging to recent ledgers are written to the hot tier, which
+    is divided into generations each covering `hot_ledgers` ledgers. When
+    a new generation starts, the previous one is retired and a background
+    thread copies its objects to the cold tier, then deletes it. Objects of
+    ledgers older than the hot window, such as those acquired while filling
+    history, are written to the cold tier directly.
+
+    Each generation keeps a log of the keys written to it, so migration can
+    proceed while the generation continues to serve reads.
+
+    Reads try the hot generations, newest first, and then the cold tier.
+*/
+class DatabaseTieredImp : public Database
+{
+public:
+    DatabaseTieredImp() = delete;
+    DatabaseTieredImp(DatabaseTieredImp const&) = delete;
+    DatabaseTieredImp&
+    operator=(DatabaseTieredImp const&) = delete;
+
+    /** Open the tiers described by a [node_db] section.
+
+        Keys prefixed with `cold_` configure the cold backend, the others
+        configure the hot backends. The hot generations are kept in
+        directories below the hot `path`.
+    */
+    DatabaseTieredImp(
+        std::string const& name,
+        Scheduler& scheduler,
+        int readThreads,
+        Stoppable& parent,
+        std::size_t burstSize,
+        Section const& config,
+        beast::Journal j);
+
+    ~DatabaseTieredImp() override;
+
+    std::string
+    getName() const override;
+
+    std::int32_t
+    getWriteLoad() const override;
+
+    void
+    import(Database& source) override;
+
+    bool isSameDB(std::uint32_t, std::uint32_t) override
+    {
+        // tiered store acts as one logical database
+        return true;
+    }
+
+    void
+    store(
+        NodeObjectType type,
+        Blob&& data,
+        uint256 const& hash,
+        std::uint32_t ledgerSeq) override;
+
+    void
+    sync() override;
+
+    bool
+    storeLedger(std::shared_ptr<Ledger const> const& srcLedger) override;
+
+    void
+    sweep() override
+    {
+        // nothing to do
+    }
+
+    void
+    onStop() override;
+
+private:
+    struct Generation
+    {
+        // The first ledger written to this generation
+        std::uint32_t startSeq;
+        std::shared_ptr<Backend> backend;
+
+        // Held shared while writing, exclusively to retire the generation.
+        // Only the first generation is handed to new writers, and the
+        // migrator retires the others.
+        std::shared_mutex writeMutex;
+        bool retired = false;
+
+        // Keys written to the backend, in order
+        std::mutex keysMutex;
+        std::ofstream keys;
+    };
+
+    Scheduler& scheduler_;
+    std::size_t const burstSize_;
+    std::uint32_t const hotLedgers_;
+    Section hotConfig_;
+    boost::filesystem::path const hotPath_;
+    std::shared_ptr<Backend> cold_;
+    FetchSource& hotSource_;
+    FetchSource& coldSource_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cond_;
+    // The generation receiving writes, followed by generations waiting to
+    // be retired and migrated, newest first
+    std::deque<std::shared_ptr<Generation>> hot_;
+    std::uint32_t maxSeq_{0};
+    bool stopMigration_{false};
+    std::thread migrator_;
+
+    std::atomic<std::uint64_t> hotHits_{0};
+    std::atomic<std::uint64_t> coldHits_{0};
+    std::atomic<std::uint64_t> migrated_{0};
+
+    std::shared_ptr<NodeObject>
+    fetchNodeObject(
+        uint256 const& hash,
+        std::uint32_t,
+        FetchReport& fetchReport) override;
+
+    void
+    for_each(std::function<void(std::shared_ptr<NodeObject>)> f) override;
+
+    void
+    getBackendCountsJson(Json::Value& obj) override;
+
+    std::shared_ptr<NodeObject>
+    fetchFrom(
+        Backend& backend,
+        uint256 const& hash,
+        FetchReport& fetchReport,
+        FetchSource& source);
+
+    // Where an object of the given ledger should be written. Returns
+    // nullptr for the cold tier. Requires mutex_ to be held.
+    std::shared_ptr<Generation>
+    generationFor(std::uint32_t ledgerSeq);
+
+    std::shared_ptr<Generation>
+    openGeneration(std::uint32_t startSeq, bool create);
+
+    void
+    retire(Generation& generation);
+
+    std::string
+    keysPath(std::uint32_t startSeq) const;
+
+    std::string
+    cleanPath(std::uint32_t startSeq) const;
+
+    // Background thread copying retired generations to the cold tier
+    void
+    migrateThread();
+
+    bool
+    migrate(Generation& generation);
+
+    void
+    stopMigration();
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
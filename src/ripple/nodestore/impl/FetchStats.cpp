@@ -0,0 +1,278 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Log.h>
+#include <ripple/basics/contract.h>
+#include <ripple/nodestore/impl/FetchStats.h>
+#include <ripple/protocol/jss.h>
+
+#include <cmath>
+#include <sstream>
+
+namespace ripple {
+namespace NodeStore {
+
+void
+LatencyHistogram::add(std::chrono::microseconds duration)
+{
+    auto const us = static_cast<std::uint64_t>(
+        std::max<std::chrono::microseconds::rep>(duration.count(), 0));
+
+    std::size_t bucket = 0;
+    for (auto v = us; v != 0 && bucket < bucketCount - 1; v >>= 1)
+        ++bucket;
+
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    totalUs_.fetch_add(us, std::memory_order_relaxed);
+}
+
+std::uint64_t
+LatencyHistogram::count() const
+{
+    std::uint64_t result = 0;
+    for (auto const& bucket : buckets_)
+        result += bucket.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::uint64_t
+LatencyHistogram::percentile(double fraction) const
+{
+    std::array<std::uint64_t, bucketCount> counts;
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < bucketCount; ++i)
+        total += counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    if (total == 0)
+        return 0;
+
+    auto const target =
+        static_cast<std::uint64_t>(std::ceil(total * fraction));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucketCount; ++i)
+    {
+        seen += counts[i];
+        if (seen >= target)
+            return std::uint64_t{1} << i;
+    }
+    return std::uint64_t{1} << (bucketCount - 1);
+}
+
+Json::Value
+LatencyHistogram::getJson() const
+{
+    auto const n = count();
+    Json::Value ret{Json::objectValue};
+    ret[jss::count] = std::to_string(n);
+    if (n != 0)
+    {
+        ret[jss::mean_us] = static_cast<Json::UInt>(totalUs_.load() / n);
+        ret[jss::p50_us] = static_cast<Json::UInt>(percentile(0.50));
+        ret[jss::p90_us] = static_cast<Json::UInt>(percentile(0.90));
+        ret[jss::p99_us] = static_cast<Json::UInt>(percentile(0.99));
+    }
+    return ret;
+}
+
+//------------------------------------------------------------------------------
+
+Status
+fetchTimed(
+    Backend& backend,
+    uint256 const& hash,
+    std::shared_ptr<NodeObject>* pObject,
+    FetchReport& fetchReport,
+    FetchSource& source)
+{
+    using namespace std::chrono;
+    auto const start = steady_clock::now();
+    std::optional<microseconds> decodeTime;
+
+    auto const status =
+        backend.fetchMeasured(hash.data(), pObject, decodeTime);
+
+    auto const elapsed =
+        duration_cast<microseconds>(steady_clock::now() - start);
+    auto const read = elapsed - decodeTime.value_or(microseconds{0});
+    fetchReport.backendRead =
+        fetchReport.backendRead.value_or(microseconds{0}) +
+        std::max(read, microseconds{0});
+    if (decodeTime)
+    {
+        fetchReport.decode =
+            fetchReport.decode.value_or(microseconds{0}) + *decodeTime;
+    }
+    fetchReport.source = &source;
+    return status;
+}
+
+//------------------------------------------------------------------------------
+
+FetchStats::FetchStats(Section const& config, beast::Journal j)
+    : j_(j)
+    , slowThreshold_(std::chrono::milliseconds{
+          get<std::uint32_t>(config, "slow_fetch_ms", 0)})
+    , slowSample_(get<std::uint32_t>(config, "slow_fetch_sample", 1))
+{
+    if (slowSample_ == 0)
+        Throw<std::runtime_error>("Invalid slow_fetch_sample");
+}
+
+FetchSource&
+FetchStats::source(std::string const& name)
+{
+    std::lock_guard lock(mutex_);
+    auto& source = sources_[name];
+    if (!source)
+        source = std::make_unique<FetchSource>(name);
+    return *source;
+}
+
+void
+FetchStats::record(
+    FetchReport const& fetchReport,
+    uint256 const& hash,
+    std::uint32_t ledgerSeq,
+    std::chrono::microseconds elapsed)
+{
+    auto const type = static_cast<std::size_t>(fetchReport.fetchType);
+    auto& stages = all_[type];
+
+    if (fetchReport.cacheLookup)
+        stages[cacheLookup].add(*fetchReport.cacheLookup);
+    if (fetchReport.backendRead)
+        stages[backendRead].add(*fetchReport.backendRead);
+    if (fetchReport.decode)
+        stages[decode].add(*fetchReport.decode);
+    if (fetchReport.canonicalize)
+        stages[canonicalize].add(*fetchReport.canonicalize);
+    stages[total].add(elapsed);
+
+    if (fetchReport.source && fetchReport.backendRead)
+    {
+        auto& backendStages = fetchReport.source->histograms_[type];
+        backendStages[backendRead].add(*fetchReport.backendRead);
+        if (fetchReport.decode)
+            backendStages[decode].add(*fetchReport.decode);
+        backendStages[total].add(elapsed);
+    }
+
+    if (slowThreshold_.count() == 0 || elapsed < slowThreshold_)
+        return;
+
+    if (++slowCount_ % slowSample_ != 0)
+        return;
+
+    std::ostringstream breakdown;
+    auto stage = [&](Stage s,
+                     std::optional<std::chrono::microseconds> const& d) {
+        if (d)
+            breakdown << " " << stageName(s) << "=" << d->count() << "us";
+    };
+    stage(cacheLookup, fetchReport.cacheLookup);
+    stage(backendRead, fetchReport.backendRead);
+    if (fetchReport.source)
+        breakdown << " backend=" << fetchReport.source->name();
+    stage(decode, fetchReport.decode);
+    stage(canonicalize, fetchReport.canonicalize);
+
+    JLOG(j_.warn()) << "Slow "
+                    << (fetchReport.fetchType == FetchType::async
+                            ? "async"
+                            : "synchronous")
+                    << " fetch of " << hash << " for ledger " << ledgerSeq
+                    << " took " << elapsed.count() << "us ("
+                    << (fetchReport.wasFound ? "found" : "not found")
+                    << "):" << breakdown.str();
+}
+
+void
+FetchStats::getCountsJson(Json::Value& obj) const
+{
+    if (slowThreshold_.count() != 0)
+        obj[jss::node_reads_slow] = std::to_string(slowCount_);
+
+    auto stages = getJson(all_);
+    if (stages.size() == 0)
+        return;
+
+    Json::Value backends{Json::objectValue};
+    {
+        std::lock_guard lock(mutex_);
+        for (auto const& [name, source] : sources_)
+        {
+            // Sources which were never read are left out
+            if (auto json = getJson(source->histograms_); json.size() != 0)
+                backends[name] = std::move(json);
+        }
+    }
+    if (backends.size() != 0)
+        stages[jss::backends] = std::move(backends);
+    obj[jss::node_read_stages] = std::move(stages);
+}
+
+char const*
+FetchStats::stageName(Stage stage)
+{
+    switch (stage)
+    {
+        case cacheLookup:
+            return "cache_lookup";
+        case backendRead:
+            return "backend_read";
+        case decode:
+            return "decode";
+        case canonicalize:
+            return "canonicalize";
+        case total:
+            return "total";
+        default:
+            break;
+    }
+    return "unknown";
+}
+
+Json::Value
+FetchStats::getJson(Histograms const& histograms)
+{
+    Json::Value ret{Json::objectValue};
+    for (std::size_t type = 0; type < histograms.size(); ++type)
+    {
+        Json::Value stages{Json::objectValue};
+        for (std::size_t stage = 0; stage < stageCount; ++stage)
+        {
+            auto const& histogram = histograms[type][stage];
+            if (histogram.count() != 0)
+            {
+                stages[stageName(static_cast<Stage>(stage))] =
+                    histogram.getJson();
+            }
+        }
+
+        if (stages.size() != 0)
+        {
+            ret[static_cast<FetchType>(type) == FetchType::async
+                    ? "async"
+                    : "synchronous"] = std::move(stages);
+        }
+    }
+    return ret;
+}
+
+}  // namespace NodeStore
+}  // namespace ripple
@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_NODESTORE_FETCHSTATS_H_INCLUDED
+#define RIPPLE_NODESTORE_FETCHSTATS_H_INCLUDED
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/base_uint.h>
+#include <ripple/beast/utility/Journal.h>
+#include <ripple/json/json_value.h>
+#include <ripple/nodestore/Backend.h>
+#include <ripple/nodestore/Scheduler.h>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+namespace NodeStore {
+
+/** A histogram of durations, in power of two microsecond buckets.
+
+    Bucket 0 counts durations below one microsecond and bucket `i` counts
+    those in [2^(i-1), 2^i) microseconds. The last bucket also counts all
+    longer durations. Adding a sample is lock free.
+*/
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t bucketCount = 24;
+
+    void
+    add(std::chrono::microseconds duration);
+
+    std::uint64_t
+    count() const;
+
+    /** Returns the upper bound, in microseconds, of the bucket holding the
+        given fraction of the samples.
+    */
+    std::uint64_t
+    percentile(double fraction) const;
+
+    /** Returns the sample count, mean and percentiles. */
+    Json::Value
+    getJson() const;
+
+private:
+    std::array<std::atomic<std::uint64_t>, bucketCount> buckets_{};
+    std::atomic<std::uint64_t> totalUs_{0};
+};
+
+/** Adds the time until destruction to a stage of a fetch report. */
+class StageTimer
+{
+public:
+    explicit StageTimer(std::optional<std::chrono::microseconds>& stage)
+        : stage_(stage), start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    StageTimer(StageTimer const&) = delete;
+    StageTimer&
+    operator=(StageTimer const&) = delete;
+
+    ~StageTimer()
+    {
+        using namespace std::chrono;
+        stage_ = stage_.value_or(microseconds{0}) +
+            duration_cast<microseconds>(steady_clock::now() - start_);
+    }
+
+private:
+    std::optional<std::chrono::microseconds>& stage_;
+    std::chrono::steady_clock::time_point const start_;
+};
+
+/** Read an object from a backend, timing the read and decode stages.
+
+    @param backend The backend to read.
+    @param hash The key of the object.
+    @param pObject [out] The object, if found.
+    @param fetchReport Report to add the stage timings to.
+    @param source The statistics of the backend.
+    @return The backend status.
+*/
+Status
+fetchTimed(
+    Backend& backend,
+    uint256 const& hash,
+    std::shared_ptr<NodeObject>* pObject,
+    FetchReport& fetchReport,
+    FetchSource& source);
+
+/** Per stage latency statistics of the fetches made by a Database.
+
+    Each stage of a fetch is tracked by fetch type, and the backend read
+    and decode stages also by backend. Fetches slower than the configured
+    `slow_fetch_ms` are counted and, one in `slow_fetch_sample` of them,
+    logged with the timing of each stage.
+*/
+class FetchStats
+{
+public:
+    FetchStats(Section const& config, beast::Journal j);
+
+    FetchStats(FetchStats const&) = delete;
+    FetchStats&
+    operator=(FetchStats const&) = delete;
+
+    /** Returns the statistics of the backend with the given name.
+
+        The source is created on first use.
+    */
+    FetchSource&
+    source(std::string const& name);
+
+    void
+    record(
+        FetchReport const& fetchReport,
+        uint256 const& hash,
+        std::uint32_t ledgerSeq,
+        std::chrono::microseconds elapsed);
+
+    void
+    getCountsJson(Json::Value& obj) const;
+
+private:
+    friend class FetchSource;
+
+    enum Stage {
+        cacheLookup,
+        backendRead,
+        decode,
+        canonicalize,
+        total,
+        stageCount
+    };
+
+    // Indexed by fetch type
+    using Histograms = std::array<
+        std::array<LatencyHistogram, stageCount>,
+        static_cast<std::size_t>(FetchType::async) + 1>;
+
+    static char const*
+    stageName(Stage stage);
+
+    static Json::Value
+    getJson(Histograms const& histograms);
+
+    beast::Journal const j_;
+    std::chrono::microseconds const slowThreshold_;
+    std::uint64_t const slowSample_;
+    std::atomic<std::uint64_t> slowCount_{0};
+
+    Histograms all_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<FetchSource>> sources_;
+};
+
+/** The read statistics of one backend of a Database.
+
+    Sources are created by FetchStats::source and live as long as the
+    FetchStats, so a backend resolves its source once and its fetches are
+    recorded without any lookup or lock.
+*/
+class FetchSource
+{
+public:
+    explicit FetchSource(std::string name) : name_(std::move(name))
+    {
+    }
+
+    FetchSource(FetchSource const&) = delete;
+    FetchSource&
+    operator=(FetchSource const&) = delete;
+
+    std::string const&
+    name() const
+    {
+        return name_;
+    }
+
+private:
+    friend class FetchStats;
+
+    std::string const name_;
+    FetchStats::Histograms histograms_;
+};
+
+}  // namespace NodeStore
+}  // namespace ripple
+
+#endif
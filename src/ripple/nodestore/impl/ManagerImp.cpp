@@ -18,6 +18,7 @@
 //==============================================================================
 
 #include <ripple/nodestore/impl/DatabaseNodeImp.h>
+#include <ripple/nodestore/impl/DatabaseTieredImp.h>
 #include <ripple/nodestore/impl/ManagerImp.h>
 
 #include <boost/algorithm/string/predicate.hpp>
@@ -78,6 +79,12 @@ ManagerImp::make_Database(
     Section const& config,
     beast::Journal journal)
 {
+    if (config.exists("cold_type"))
+    {
+        return std::make_unique<DatabaseTieredImp>(
+            name, scheduler, readThreads, parent, burstSize, config, journal);
+    }
+
     auto backend{make_Backend(config, burstSize, scheduler, journal)};
     backend->open();
     return std::make_unique<DatabaseNodeImp>(
@@ -23,6 +23,7 @@
 #include <ripple/core/ConfigSections.h>
 #include <ripple/nodestore/Manager.h>
 #include <ripple/nodestore/impl/DeterministicShard.h>
+#include <ripple/nodestore/impl/FetchStats.h>
 #include <ripple/nodestore/impl/Shard.h>
 #include <ripple/protocol/digest.h>
 
@@ -58,6 +59,7 @@ Shard::Shard(
           index == db.earliestShardIndex() ? lastSeq_ - firstSeq_ + 1
                                            : db.ledgersPerShard())
     , dir_((dir.empty() ? db.getRootDir() : dir) / std::to_string(index_))
+    , fetchSource_(db.fetchSource("shard." + std::to_string(index_)))
 {
 }
 
@@ -253,7 +255,8 @@ Shard::fetchNodeObject(uint256 const& hash, FetchReport& fetchReport)
     Status status;
     try
     {
-        status = backend_->fetch(hash.data(), &nodeObject);
+        status = fetchTimed(
+            *backend_, hash, &nodeObject, fetchReport, fetchSource_);
     }
     catch (std::exception const& e)
     {
@@ -281,6 +281,9 @@ private:
 
     std::atomic<std::uint32_t> backendCount_{0};
 
+    // Read statistics of this shard, kept by the shard database
+    FetchSource& fetchSource_;
+
     // Ledger SQLite database used for indexes
     std::unique_ptr<DatabaseCon> lgrSQLiteDB_;
 
@@ -22,6 +22,7 @@
 
 #include <ripple/basics/safe_cast.h>
 #include <ripple/json/json_value.h>
+#include <array>
 #include <cstdint>
 #include <map>
 #include <utility>
@@ -273,7 +274,20 @@ public:
 
 private:
     static int num;
+
+    // Fields with a serialized type and a value below 256, which are all
+    // the fields that appear on the wire, indexed by type and value so that
+    // getField(int) is a single load.  Every field is also kept in the map.
+    static constexpr int denseTypes = STI_VECTOR256 + 1;
+    static constexpr int denseValues = 256;
+    static std::array<SField const*, denseTypes * denseValues> denseCodeToField;
     static std::map<int, SField const*> knownCodeToField;
+
+    static int
+    denseIndex(int code);
+
+    void
+    registerField() const;
 };
 
 /** A field with a type known at compile time. */
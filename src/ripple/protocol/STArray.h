@@ -21,6 +21,7 @@
 #define RIPPLE_PROTOCOL_STARRAY_H_INCLUDED
 
 #include <ripple/basics/CountedObject.h>
+#include <ripple/basics/ThreadLocalPool.h>
 #include <ripple/protocol/STObject.h>
 
 namespace ripple {
@@ -28,7 +29,7 @@ namespace ripple {
 class STArray final : public STBase, public CountedObject<STArray>
 {
 private:
-    using list_type = std::vector<STObject>;
+    using list_type = std::vector<STObject, PoolAllocator<STObject>>;
 
     list_type v_;
 
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_STJSONWRITER_H_INCLUDED
+#define RIPPLE_PROTOCOL_STJSONWRITER_H_INCLUDED
+
+#include <ripple/json/Object.h>
+#include <ripple/protocol/STBase.h>
+
+namespace ripple {
+
+class STLedgerEntry;
+class STObject;
+class STTx;
+
+/** Write the fields of an object into a JSON object as they are visited.
+
+    The members written are those of object.getJson(options), but inner
+    objects and arrays are streamed to the underlying Json::Writer instead
+    of being collected into a Json::Value tree first.  Only the value of
+    each leaf field is converted to a Json::Value, one at a time.
+
+    Fields are written in the object's order, so the members may appear in
+    a different order than when the result of getJson is written.
+
+    When the writer writes CBOR, hashes, blobs and account IDs are written
+    as byte strings, 64-bit integers and XRP amounts as integers, and
+    other amounts as maps with the currency and issuer as byte strings and
+    the value as a decimal fraction.
+*/
+void
+writeJson(
+    Json::Object& json,
+    STObject const& object,
+    JsonOptions options = JsonOptions::none);
+
+/** Write a transaction, with the members of STTx::getJson. */
+void
+writeJson(Json::Object& json, STTx const& tx);
+
+/** Write a ledger entry, with the members of STLedgerEntry::getJson. */
+void
+writeJson(
+    Json::Object& json,
+    STLedgerEntry const& sle,
+    JsonOptions options = JsonOptions::none);
+
+}  // namespace ripple
+
+#endif
@@ -0,0 +1,244 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_PROTOCOL_STLEDGERENTRYVIEW_H_INCLUDED
+#define RIPPLE_PROTOCOL_STLEDGERENTRYVIEW_H_INCLUDED
+
+#include <ripple/basics/Slice.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STBitString.h>
+#include <ripple/protocol/STBlob.h>
+#include <ripple/protocol/STInteger.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STVector256.h>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace ripple {
+
+/** A read-only, lazily decoded ledger entry.
+
+    A view refers either to the serialized form of an entry, such as the
+    data held by a SHAMap leaf, or to an entry which was already
+    deserialized. In the first case nothing is decoded when the view is
+    created: the offsets of the top-level fields are indexed on the first
+    access and each accessor decodes only the field it was asked for. The
+    serialized data is shared with its owner rather than copied.
+
+    The accessors mirror those of STObject, including the treatment of
+    absent fields, so that code reading a handful of fields can use either.
+*/
+class STLedgerEntryView
+{
+public:
+    /** Create a view of a serialized ledger entry.
+
+        @param owner An object which keeps the memory at `data` alive.
+        @param data The serialized entry.
+        @param key The key of the entry.
+    */
+    STLedgerEntryView(
+        std::shared_ptr<void const> owner,
+        Slice data,
+        uint256 const& key);
+
+    /** Create a view of a deserialized ledger entry. */
+    explicit STLedgerEntryView(std::shared_ptr<STLedgerEntry const> sle);
+
+    STLedgerEntryView(STLedgerEntryView const&) = delete;
+    STLedgerEntryView&
+    operator=(STLedgerEntryView const&) = delete;
+
+    uint256 const&
+    key() const
+    {
+        return key_;
+    }
+
+    LedgerEntryType
+    getType() const;
+
+    /** Returns the fully deserialized entry.
+
+        Views of serialized data deserialize the entire entry on every call.
+    */
+    std::shared_ptr<STLedgerEntry const>
+    sle() const;
+
+    bool
+    isFieldPresent(SField const& field) const;
+
+    std::uint32_t
+    getFlags() const;
+
+    bool
+    isFlag(std::uint32_t flags) const
+    {
+        return (getFlags() & flags) == flags;
+    }
+
+    unsigned char
+    getFieldU8(SField const& field) const;
+    std::uint16_t
+    getFieldU16(SField const& field) const;
+    std::uint32_t
+    getFieldU32(SField const& field) const;
+    std::uint64_t
+    getFieldU64(SField const& field) const;
+    uint128
+    getFieldH128(SField const& field) const;
+    uint160
+    getFieldH160(SField const& field) const;
+    uint256
+    getFieldH256(SField const& field) const;
+    AccountID
+    getAccountID(SField const& field) const;
+    Blob
+    getFieldVL(SField const& field) const;
+    STAmount
+    getFieldAmount(SField const& field) const;
+    STVector256
+    getFieldV256(SField const& field) const;
+
+    /** Get the value of a field.
+
+        Variable length fields are returned as a Slice which refers to the
+        data underlying the view, so the view must outlive it.
+
+        @throws STObject::FieldErr if the field is absent.
+    */
+    template <class T>
+    std::decay_t<typename T::value_type>
+    operator[](TypedField<T> const& f) const;
+
+    /** Get the value of a field, or std::nullopt if it is absent. */
+    template <class T>
+    std::optional<std::decay_t<typename T::value_type>>
+    operator[](OptionaledField<T> const& of) const;
+
+private:
+    // The position of a top-level field within data_. The offset is that
+    // of the field's value, just past its header.
+    struct Field
+    {
+        int code;
+        std::uint32_t offset;
+        std::uint32_t size;
+    };
+
+    void
+    index() const;
+
+    Field const*
+    find(SField const& field) const;
+
+    // The style of a field in this entry's format, or soeINVALID if the
+    // format does not include it.
+    SOEStyle
+    style(SField const& field) const;
+
+    template <class T>
+    T
+    decode(Field const& f, SField const& field) const
+    {
+        SerialIter sit(data_.data() + f.offset, f.size);
+        return T(sit, field);
+    }
+
+    template <class T, class V>
+    V
+    getFieldByValue(SField const& field) const;
+
+    Slice
+    getBlob(Field const& f) const;
+
+    std::shared_ptr<STLedgerEntry const> sle_;
+    std::shared_ptr<void const> owner_;
+    Slice data_;
+    uint256 key_;
+
+    mutable std::once_flag indexed_;
+    mutable std::vector<Field> fields_;
+    mutable SOTemplate const* format_ = nullptr;
+    mutable LedgerEntryType type_ = ltINVALID;
+};
+
+using SLEView = STLedgerEntryView;
+
+//------------------------------------------------------------------------------
+
+template <class T, class V>
+V
+STLedgerEntryView::getFieldByValue(SField const& field) const
+{
+    if (auto const f = find(field))
+        return decode<T>(*f, field).value();
+
+    if (style(field) == soeINVALID)
+        throwFieldNotFound(field);
+    return V();
+}
+
+template <class T>
+std::decay_t<typename T::value_type>
+STLedgerEntryView::operator[](TypedField<T> const& f) const
+{
+    if (sle_)
+        return (*sle_)[f];
+
+    if (auto const field = find(f))
+    {
+        if constexpr (std::is_same_v<T, STBlob>)
+            return getBlob(*field);
+        else
+            return decode<T>(*field, f).value();
+    }
+
+    if (style(f) != soeDEFAULT)
+        Throw<STObject::FieldErr>("Missing field '" + f.getName() + "'");
+    return {};
+}
+
+template <class T>
+std::optional<std::decay_t<typename T::value_type>>
+STLedgerEntryView::operator[](OptionaledField<T> const& of) const
+{
+    if (sle_)
+        return (*sle_)[of];
+
+    if (auto const field = find(*of.f))
+    {
+        if constexpr (std::is_same_v<T, STBlob>)
+            return getBlob(*field);
+        else
+            return decode<T>(*field, *of.f).value();
+    }
+
+    if (style(*of.f) == soeDEFAULT)
+        return typename T::value_type{};
+    return std::nullopt;
+}
+
+}  // namespace ripple
+
+#endif
@@ -23,6 +23,7 @@
 #include <ripple/basics/CountedObject.h>
 #include <ripple/basics/FeeUnits.h>
 #include <ripple/basics/Slice.h>
+#include <ripple/basics/ThreadLocalPool.h>
 #include <ripple/basics/chrono.h>
 #include <ripple/basics/contract.h>
 #include <ripple/protocol/HashPrefix.h>
@@ -31,6 +32,7 @@
 #include <ripple/protocol/STPathSet.h>
 #include <ripple/protocol/STVector256.h>
 #include <ripple/protocol/impl/STVar.h>
+#include <boost/container/small_vector.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <cassert>
 #include <optional>
@@ -40,7 +42,57 @@
 
 namespace ripple {
 
+class STAccount;
 class STArray;
+class STBlob;
+
+namespace detail {
+
+// The serialized type of each field class, used by the typed accessors to
+// check a field's type without a dynamic_cast.  Classes which are not
+// listed here are checked with a dynamic_cast.
+template <class T>
+struct STypeOf : std::integral_constant<SerializedTypeID, STI_UNKNOWN>
+{
+};
+
+// clang-format off
+template <> struct STypeOf<STUInt8>     : std::integral_constant<SerializedTypeID, STI_UINT8> {};
+template <> struct STypeOf<STUInt16>    : std::integral_constant<SerializedTypeID, STI_UINT16> {};
+template <> struct STypeOf<STUInt32>    : std::integral_constant<SerializedTypeID, STI_UINT32> {};
+template <> struct STypeOf<STUInt64>    : std::integral_constant<SerializedTypeID, STI_UINT64> {};
+template <> struct STypeOf<STHash128>   : std::integral_constant<SerializedTypeID, STI_HASH128> {};
+template <> struct STypeOf<STHash160>   : std::integral_constant<SerializedTypeID, STI_HASH160> {};
+template <> struct STypeOf<STHash256>   : std::integral_constant<SerializedTypeID, STI_HASH256> {};
+template <> struct STypeOf<STAmount>    : std::integral_constant<SerializedTypeID, STI_AMOUNT> {};
+template <> struct STypeOf<STBlob>      : std::integral_constant<SerializedTypeID, STI_VL> {};
+template <> struct STypeOf<STAccount>   : std::integral_constant<SerializedTypeID, STI_ACCOUNT> {};
+template <> struct STypeOf<STArray>     : std::integral_constant<SerializedTypeID, STI_ARRAY> {};
+template <> struct STypeOf<STPathSet>   : std::integral_constant<SerializedTypeID, STI_PATHSET> {};
+template <> struct STypeOf<STVector256> : std::integral_constant<SerializedTypeID, STI_VECTOR256> {};
+// clang-format on
+
+/** Returns the field as a T, or nullptr if it is absent or not a T. */
+template <class T, class Base>
+auto
+fieldCast(Base* b) -> std::conditional_t<std::is_const_v<Base>, T const*, T*>
+{
+    static_assert(std::is_base_of_v<STBase, std::remove_const_t<Base>>);
+    using Result = std::conditional_t<std::is_const_v<Base>, T const*, T*>;
+
+    if constexpr (STypeOf<T>::value == STI_UNKNOWN)
+    {
+        return dynamic_cast<Result>(b);
+    }
+    else
+    {
+        if (b == nullptr || b->getSType() != STypeOf<T>::value)
+            return nullptr;
+        return static_cast<Result>(b);
+    }
+}
+
+}  // namespace detail
 
 inline void
 throwFieldNotFound(SField const& field)
@@ -246,7 +298,9 @@ private:
         }
     };
 
-    using list_type = std::vector<detail::STVar>;
+    // Fields are allocated from the thread local pool, since objects are
+    // created and destroyed at a high rate as transactions are processed.
+    using list_type = std::vector<detail::STVar, PoolAllocator<detail::STVar>>;
 
     list_type v_;
     SOTemplate const* mType;
@@ -616,7 +670,7 @@ public:
             rf = makeFieldPresent(field);
 
         using Bits = STBitString<160>;
-        if (auto cf = dynamic_cast<Bits*>(rf))
+        if (auto cf = detail::fieldCast<Bits>(rf))
             cf->setValue(v);
         else
             Throw<std::runtime_error>("Wrong field type");
@@ -660,10 +714,16 @@ private:
     void
     add(Serializer& s, WhichFields whichFields) const;
 
+    uint256
+    hashSerialized(HashPrefix prefix, WhichFields whichFields) const;
+
     // Sort the entries in an STObject into the order that they will be
     // serialized.  Note: they are not sorted into pointer value order, they
-    // are sorted by SField::fieldCode.
-    static std::vector<STBase const*>
+    // are sorted by SField::fieldCode.  Most objects have few enough fields
+    // that this needs no allocation.
+    using SortedFields = boost::container::small_vector<STBase const*, 32>;
+
+    static SortedFields
     getSortedFields(STObject const& objToSort, WhichFields whichFields);
 
     // Implementation for getting (most) fields that return by value.
@@ -688,7 +748,7 @@ private:
         if (id == STI_NOTPRESENT)
             return V();  // optional field not present
 
-        const T* cf = dynamic_cast<const T*>(rf);
+        const T* cf = detail::fieldCast<T>(rf);
 
         if (!cf)
             Throw<std::runtime_error>("Wrong field type");
@@ -715,7 +775,7 @@ private:
         if (id == STI_NOTPRESENT)
             return empty;  // optional field not present
 
-        const T* cf = dynamic_cast<const T*>(rf);
+        const T* cf = detail::fieldCast<T>(rf);
 
         if (!cf)
             Throw<std::runtime_error>("Wrong field type");
@@ -738,7 +798,7 @@ private:
         if (rf->getSType() == STI_NOTPRESENT)
             rf = makeFieldPresent(field);
 
-        T* cf = dynamic_cast<T*>(rf);
+        T* cf = detail::fieldCast<T>(rf);
 
         if (!cf)
             Throw<std::runtime_error>("Wrong field type");
@@ -759,7 +819,7 @@ private:
         if (rf->getSType() == STI_NOTPRESENT)
             rf = makeFieldPresent(field);
 
-        T* cf = dynamic_cast<T*>(rf);
+        T* cf = detail::fieldCast<T>(rf);
 
         if (!cf)
             Throw<std::runtime_error>("Wrong field type");
@@ -780,7 +840,7 @@ private:
         if (rf->getSType() == STI_NOTPRESENT)
             rf = makeFieldPresent(field);
 
-        T* cf = dynamic_cast<T*>(rf);
+        T* cf = detail::fieldCast<T>(rf);
 
         if (!cf)
             Throw<std::runtime_error>("Wrong field type");
@@ -825,7 +885,7 @@ template <class T>
 inline T const*
 STObject::Proxy<T>::find() const
 {
-    return dynamic_cast<T const*>(st_->peekAtPField(*f_));
+    return detail::fieldCast<T>(st_->peekAtPField(*f_));
 }
 
 template <class T>
@@ -840,9 +900,9 @@ STObject::Proxy<T>::assign(U&& u)
     }
     T* t;
     if (style_ == soeINVALID)
-        t = dynamic_cast<T*>(st_->getPField(*f_, true));
+        t = detail::fieldCast<T>(st_->getPField(*f_, true));
     else
-        t = dynamic_cast<T*>(st_->makeFieldPresent(*f_));
+        t = detail::fieldCast<T>(st_->makeFieldPresent(*f_));
     assert(t);
     *t = std::forward<U>(u);
 }
@@ -1012,7 +1072,7 @@ STObject::at(TypedField<T> const& f) const
         // This is a free object (no constraints)
         // with no template
         Throw<STObject::FieldErr>("Missing field '" + f.getName() + "'");
-    auto const u = dynamic_cast<T const*>(b);
+    auto const u = detail::fieldCast<T>(b);
     if (!u)
     {
         assert(mType);
@@ -1036,7 +1096,7 @@ STObject::at(OptionaledField<T> const& of) const
     auto const b = peekAtPField(*of.f);
     if (!b)
         return std::nullopt;
-    auto const u = dynamic_cast<T const*>(b);
+    auto const u = detail::fieldCast<T>(b);
     if (!u)
     {
         assert(mType);
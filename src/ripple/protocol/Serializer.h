@@ -285,8 +285,31 @@ private:
     encodeLengthLength(int length);  // length to encode length
     int
     addEncoded(int length);
+
+    // Append an integer in big-endian order with a single insertion
+    template <class Integer>
+    int
+    addBigEndian(Integer i);
 };
 
+template <class Integer>
+int
+Serializer::addBigEndian(Integer i)
+{
+    static_assert(std::is_unsigned_v<Integer>);
+
+    std::uint8_t bytes[sizeof(Integer)];
+    for (std::size_t n = sizeof(Integer); n != 0; --n)
+    {
+        bytes[n - 1] = static_cast<std::uint8_t>(i & 0xff);
+        i >>= 8;
+    }
+
+    int ret = mData.size();
+    mData.insert(mData.end(), bytes, bytes + sizeof(Integer));
+    return ret;
+}
+
 template <class Iter>
 int
 Serializer::addVL(Iter begin, Iter end, int len)
@@ -345,16 +368,28 @@ public:
 
     // get functions throw on error
     unsigned char
-    get8();
+    get8()
+    {
+        return getBigEndian<unsigned char>("invalid SerialIter get8");
+    }
 
     std::uint16_t
-    get16();
+    get16()
+    {
+        return getBigEndian<std::uint16_t>("invalid SerialIter get16");
+    }
 
     std::uint32_t
-    get32();
+    get32()
+    {
+        return getBigEndian<std::uint32_t>("invalid SerialIter get32");
+    }
 
     std::uint64_t
-    get64();
+    get64()
+    {
+        return getBigEndian<std::uint64_t>("invalid SerialIter get64");
+    }
 
     template <std::size_t Bits, class Tag = void>
     base_uint<Bits, Tag>
@@ -407,6 +442,27 @@ public:
     template <class T>
     T
     getRawHelper(int size);
+
+private:
+    // Read an integer stored in big-endian order. These are defined here,
+    // rather than out of line, so that the reads of fixed size fields
+    // compile to a bounds check and a single load.
+    template <class Integer>
+    Integer
+    getBigEndian(char const* error)
+    {
+        if (remain_ < sizeof(Integer))
+            Throw<std::runtime_error>(error);
+
+        Integer result = 0;
+        for (std::size_t n = 0; n < sizeof(Integer); ++n)
+            result = static_cast<Integer>((result << 8) | p_[n]);
+
+        p_ += sizeof(Integer);
+        used_ += sizeof(Integer);
+        remain_ -= sizeof(Integer);
+        return result;
+    }
 };
 
 template <std::size_t Bits, class Tag>
@@ -19,11 +19,12 @@
 
 #include <ripple/protocol/Keylet.h>
 #include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STLedgerEntryView.h>
 
 namespace ripple {
 
-bool
-Keylet::check(SLE const& sle) const
+static bool
+matches(LedgerEntryType type, LedgerEntryType actual)
 {
     if (type == ltANY)
         return true;
@@ -31,10 +32,22 @@ Keylet::check(SLE const& sle) const
         return false;
     if (type == ltCHILD)
     {
-        assert(sle.getType() != ltDIR_NODE);
-        return sle.getType() != ltDIR_NODE;
+        assert(actual != ltDIR_NODE);
+        return actual != ltDIR_NODE;
     }
-    return sle.getType() == type;
+    return actual == type;
+}
+
+bool
+Keylet::check(SLE const& sle) const
+{
+    return matches(type, sle.getType());
+}
+
+bool
+Keylet::check(SLEView const& view) const
+{
+    return matches(type, view.getType());
 }
 
 }  // namespace ripple
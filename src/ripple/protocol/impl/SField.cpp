@@ -28,6 +28,8 @@ namespace ripple {
 // Storage for static const members.
 SField::IsSigning const SField::notSigning;
 int SField::num = 0;
+std::array<SField const*, SField::denseTypes * SField::denseValues>
+    SField::denseCodeToField;
 std::map<int, SField const*> SField::knownCodeToField;
 
 // Give only this translation unit permission to construct SFields
@@ -302,7 +304,7 @@ SField::SField(
     , signingField(signing)
     , jsonName(fieldName.c_str())
 {
-    knownCodeToField[fieldCode] = this;
+    registerField();
 }
 
 SField::SField(private_access_tag_t, int fc)
@@ -313,13 +315,38 @@ SField::SField(private_access_tag_t, int fc)
     , fieldNum(++num)
     , signingField(IsSigning::yes)
     , jsonName(fieldName.c_str())
+{
+    registerField();
+}
+
+int
+SField::denseIndex(int code)
+{
+    int const type = code >> 16;
+    int const value = code & 0xffff;
+    if (code < 0 || type >= denseTypes || value >= denseValues)
+        return -1;
+    return type * denseValues + value;
+}
+
+void
+SField::registerField() const
 {
     knownCodeToField[fieldCode] = this;
+    if (auto const index = denseIndex(fieldCode); index >= 0)
+        denseCodeToField[index] = this;
 }
 
 SField const&
 SField::getField(int code)
 {
+    if (auto const index = denseIndex(code); index >= 0)
+    {
+        if (auto const field = denseCodeToField[index])
+            return *field;
+        return sfInvalid;
+    }
+
     auto it = knownCodeToField.find(code);
 
     if (it != knownCodeToField.end())
@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STAmount.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STBitString.h>
+#include <ripple/protocol/STBlob.h>
+#include <ripple/protocol/STInteger.h>
+#include <ripple/protocol/STJsonWriter.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/STVector256.h>
+#include <ripple/protocol/jss.h>
+
+namespace ripple {
+
+namespace {
+
+template <std::size_t Bits>
+Slice
+bytes(STBase const& field)
+{
+    auto const& value = static_cast<STBitString<Bits> const&>(field).value();
+    return {value.data(), value.size()};
+}
+
+// Amounts in CBOR: drops as an integer, or a map of the currency and issuer
+// as bytes and the value as a decimal fraction.
+void
+writeAmount(Json::Object& json, std::string const& key, STAmount const& amount)
+{
+    if (amount.native())
+    {
+        json.set(key, amount.xrp().drops());
+        return;
+    }
+
+    auto object = json.setObject(key);
+    auto const& issue = amount.issue();
+    object[jss::currency] = Slice{issue.currency.data(), issue.currency.size()};
+    object[jss::issuer] = Slice{issue.account.data(), issue.account.size()};
+
+    Json::Writer::Decimal value{0, 0};
+    if (amount != beast::zero)
+    {
+        value.mantissa = static_cast<std::int64_t>(amount.mantissa());
+        if (amount.negative())
+            value.mantissa = -value.mantissa;
+        value.exponent = amount.exponent();
+    }
+    object[jss::value] = value;
+}
+
+// Write the fields which CBOR can hold natively.  Returns false for the
+// fields which are written as their JSON value.
+bool
+writeCBOR(Json::Object& json, std::string const& key, STBase const& field)
+{
+    switch (field.getSType())
+    {
+        case STI_UINT64:
+            json.set(key, static_cast<STUInt64 const&>(field).value());
+            return true;
+
+        case STI_ACCOUNT: {
+            auto const& id = static_cast<STAccount const&>(field).value();
+            json.set(key, Slice{id.data(), id.size()});
+            return true;
+        }
+
+        case STI_AMOUNT:
+            writeAmount(json, key, static_cast<STAmount const&>(field));
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+void
+writeField(
+    Json::Object& json,
+    std::string const& key,
+    STBase const& field,
+    JsonOptions options)
+{
+    switch (field.getSType())
+    {
+        case STI_OBJECT: {
+            auto inner = json.setObject(key);
+            writeJson(inner, static_cast<STObject const&>(field), options);
+            break;
+        }
+
+        case STI_ARRAY: {
+            // Each element is an object with a single member, named for
+            // the element's field.
+            auto array = json.setArray(key);
+            for (auto const& element : static_cast<STArray const&>(field))
+            {
+                if (element.getSType() == STI_NOTPRESENT)
+                    continue;
+
+                auto wrapper = array.appendObject();
+                auto inner = wrapper.setObject(element.getFName().getName());
+                writeJson(inner, element, options);
+            }
+            break;
+        }
+
+        // Bytes are written as uppercase hex in JSON, as getJson does
+        case STI_HASH128:
+            json.set(key, bytes<128>(field));
+            break;
+
+        case STI_HASH160:
+            json.set(key, bytes<160>(field));
+            break;
+
+        case STI_HASH256:
+            json.set(key, bytes<256>(field));
+            break;
+
+        case STI_VL:
+            json.set(key, static_cast<STBlob const&>(field).value());
+            break;
+
+        case STI_VECTOR256: {
+            auto array = json.setArray(key);
+            for (auto const& hash : static_cast<STVector256 const&>(field))
+                array.append(Slice{hash.data(), hash.size()});
+            break;
+        }
+
+        default:
+            if (json.format() != Json::Writer::Format::cbor ||
+                !writeCBOR(json, key, field))
+                json.set(key, field.getJson(options));
+            break;
+    }
+}
+
+}  // namespace
+
+void
+writeJson(Json::Object& json, STObject const& object, JsonOptions options)
+{
+    for (auto const& field : object)
+    {
+        if (field.getSType() != STI_NOTPRESENT)
+            writeField(json, field.getFName().getName(), field, options);
+    }
+}
+
+void
+writeJson(Json::Object& json, STTx const& tx)
+{
+    // As in STTx::getJson, the options don't apply to transactions
+    writeJson(json, static_cast<STObject const&>(tx), JsonOptions::none);
+    auto const& id = tx.getTransactionID();
+    json[jss::hash] = Slice{id.data(), id.size()};
+}
+
+void
+writeJson(Json::Object& json, STLedgerEntry const& sle, JsonOptions options)
+{
+    writeJson(json, static_cast<STObject const&>(sle), options);
+    json[jss::index] = Slice{sle.key().data(), sle.key().size()};
+}
+
+}  // namespace ripple
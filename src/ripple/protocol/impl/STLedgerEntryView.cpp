@@ -0,0 +1,355 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/contract.h>
+#include <ripple/basics/safe_cast.h>
+#include <ripple/protocol/STLedgerEntryView.h>
+#include <algorithm>
+
+namespace ripple {
+
+namespace {
+
+void
+skipField(SerialIter& sit, int type);
+
+// Skips the fields of an inner object up to and including its
+// end-of-object marker.
+void
+skipObject(SerialIter& sit)
+{
+    for (;;)
+    {
+        int type;
+        int field;
+        sit.getFieldID(type, field);
+
+        if (type == STI_OBJECT && field == 1)
+            return;
+
+        if (type == STI_ARRAY && field == 1)
+            Throw<std::runtime_error>("Illegal end-of-array marker in object");
+
+        skipField(sit, type);
+    }
+}
+
+void
+skipField(SerialIter& sit, int type)
+{
+    switch (type)
+    {
+        case STI_UINT8:
+            sit.skip(1);
+            break;
+        case STI_UINT16:
+            sit.skip(2);
+            break;
+        case STI_UINT32:
+            sit.skip(4);
+            break;
+        case STI_UINT64:
+            sit.skip(8);
+            break;
+        case STI_HASH128:
+            sit.skip(16);
+            break;
+        case STI_HASH160:
+            sit.skip(20);
+            break;
+        case STI_HASH256:
+            sit.skip(32);
+            break;
+        case STI_AMOUNT: {
+            // The top bit of the first byte distinguishes native amounts
+            // (8 bytes) from issued currency amounts (48 bytes).
+            SerialIter peek = sit;
+            sit.skip((peek.get8() & 0x80) ? 48 : 8);
+            break;
+        }
+        case STI_VL:
+        case STI_ACCOUNT:
+        case STI_VECTOR256:
+            sit.skip(sit.getVLDataLength());
+            break;
+        case STI_OBJECT:
+            skipObject(sit);
+            break;
+        case STI_ARRAY:
+            for (;;)
+            {
+                int elementType;
+                int elementField;
+                sit.getFieldID(elementType, elementField);
+
+                if (elementType == STI_ARRAY && elementField == 1)
+                    break;
+
+                if (elementType != STI_OBJECT)
+                    Throw<std::runtime_error>("Non-object in array");
+
+                skipObject(sit);
+            }
+            break;
+        case STI_PATHSET:
+            for (;;)
+            {
+                auto const elementType = sit.get8();
+
+                if (elementType == STPathElement::typeNone)
+                    break;
+
+                if (elementType == STPathElement::typeBoundary)
+                    continue;
+
+                if (elementType & ~STPathElement::typeAll)
+                    Throw<std::runtime_error>("bad path element");
+
+                if (elementType & STPathElement::typeAccount)
+                    sit.skip(20);
+                if (elementType & STPathElement::typeCurrency)
+                    sit.skip(20);
+                if (elementType & STPathElement::typeIssuer)
+                    sit.skip(20);
+            }
+            break;
+        default:
+            Throw<std::runtime_error>("Unknown field type");
+    }
+}
+
+}  // namespace
+
+STLedgerEntryView::STLedgerEntryView(
+    std::shared_ptr<void const> owner,
+    Slice data,
+    uint256 const& key)
+    : owner_(std::move(owner)), data_(data), key_(key)
+{
+}
+
+STLedgerEntryView::STLedgerEntryView(std::shared_ptr<STLedgerEntry const> sle)
+    : sle_(std::move(sle)), key_(sle_->key())
+{
+}
+
+void
+STLedgerEntryView::index() const
+{
+    std::call_once(indexed_, [this]() {
+        SerialIter sit(data_);
+        fields_.reserve(24);
+
+        while (!sit.empty())
+        {
+            int type;
+            int field;
+            sit.getFieldID(type, field);
+
+            auto const offset = data_.size() - sit.getBytesLeft();
+            skipField(sit, type);
+            fields_.push_back(
+                {field_code(safe_cast<SerializedTypeID>(type), field),
+                 static_cast<std::uint32_t>(offset),
+                 static_cast<std::uint32_t>(
+                     data_.size() - sit.getBytesLeft() - offset)});
+        }
+
+        auto const iter = std::find_if(
+            fields_.begin(), fields_.end(), [](Field const& f) {
+                return f.code == sfLedgerEntryType.fieldCode;
+            });
+        if (iter == fields_.end())
+            Throw<std::runtime_error>("invalid ledger entry type");
+
+        SerialIter typeIter(data_.data() + iter->offset, iter->size);
+        auto const format = LedgerFormats::getInstance().findByType(
+            safe_cast<LedgerEntryType>(typeIter.get16()));
+        if (format == nullptr)
+            Throw<std::runtime_error>("invalid ledger entry type");
+
+        type_ = format->getType();
+        format_ = &format->getSOTemplate();
+    });
+}
+
+auto
+STLedgerEntryView::find(SField const& field) const -> Field const*
+{
+    index();
+    for (auto const& f : fields_)
+    {
+        if (f.code == field.fieldCode)
+            return &f;
+    }
+    return nullptr;
+}
+
+SOEStyle
+STLedgerEntryView::style(SField const& field) const
+{
+    index();
+    if (format_->getIndex(field) == -1)
+        return soeINVALID;
+    return format_->style(field);
+}
+
+Slice
+STLedgerEntryView::getBlob(Field const& f) const
+{
+    SerialIter sit(data_.data() + f.offset, f.size);
+    auto const size = sit.getVLDataLength();
+    return sit.getSlice(size);
+}
+
+LedgerEntryType
+STLedgerEntryView::getType() const
+{
+    if (sle_)
+        return sle_->getType();
+    index();
+    return type_;
+}
+
+std::shared_ptr<STLedgerEntry const>
+STLedgerEntryView::sle() const
+{
+    if (sle_)
+        return sle_;
+    return std::make_shared<STLedgerEntry const>(SerialIter{data_}, key_);
+}
+
+bool
+STLedgerEntryView::isFieldPresent(SField const& field) const
+{
+    if (sle_)
+        return sle_->isFieldPresent(field);
+    return find(field) != nullptr;
+}
+
+std::uint32_t
+STLedgerEntryView::getFlags() const
+{
+    if (sle_)
+        return sle_->getFlags();
+    if (auto const f = find(sfFlags))
+        return decode<STUInt32>(*f, sfFlags).value();
+    return 0;
+}
+
+unsigned char
+STLedgerEntryView::getFieldU8(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldU8(field);
+    return getFieldByValue<STUInt8, unsigned char>(field);
+}
+
+std::uint16_t
+STLedgerEntryView::getFieldU16(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldU16(field);
+    return getFieldByValue<STUInt16, std::uint16_t>(field);
+}
+
+std::uint32_t
+STLedgerEntryView::getFieldU32(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldU32(field);
+    return getFieldByValue<STUInt32, std::uint32_t>(field);
+}
+
+std::uint64_t
+STLedgerEntryView::getFieldU64(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldU64(field);
+    return getFieldByValue<STUInt64, std::uint64_t>(field);
+}
+
+uint128
+STLedgerEntryView::getFieldH128(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldH128(field);
+    return getFieldByValue<STHash128, uint128>(field);
+}
+
+uint160
+STLedgerEntryView::getFieldH160(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldH160(field);
+    return getFieldByValue<STHash160, uint160>(field);
+}
+
+uint256
+STLedgerEntryView::getFieldH256(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldH256(field);
+    return getFieldByValue<STHash256, uint256>(field);
+}
+
+AccountID
+STLedgerEntryView::getAccountID(SField const& field) const
+{
+    if (sle_)
+        return sle_->getAccountID(field);
+    return getFieldByValue<STAccount, AccountID>(field);
+}
+
+Blob
+STLedgerEntryView::getFieldVL(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldVL(field);
+    if (auto const f = find(field))
+    {
+        auto const blob = getBlob(*f);
+        return Blob(blob.begin(), blob.end());
+    }
+    if (style(field) == soeINVALID)
+        throwFieldNotFound(field);
+    return {};
+}
+
+STAmount
+STLedgerEntryView::getFieldAmount(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldAmount(field);
+    return getFieldByValue<STAmount, STAmount>(field);
+}
+
+STVector256
+STLedgerEntryView::getFieldV256(SField const& field) const
+{
+    if (sle_)
+        return sle_->getFieldV256(field);
+    if (auto const f = find(field))
+        return decode<STVector256>(*f, field);
+    if (style(field) == soeINVALID)
+        throwFieldNotFound(field);
+    return {};
+}
+
+}  // namespace ripple
@@ -311,19 +311,32 @@ STObject::isEquivalent(const STBase& t) const
 uint256
 STObject::getHash(HashPrefix prefix) const
 {
-    Serializer s;
-    s.add32(prefix);
-    add(s, withAllFields);
-    return s.getSHA512Half();
+    return hashSerialized(prefix, withAllFields);
 }
 
 uint256
 STObject::getSigningHash(HashPrefix prefix) const
 {
-    Serializer s;
+    return hashSerialized(prefix, omitSigningFields);
+}
+
+uint256
+STObject::hashSerialized(HashPrefix prefix, WhichFields whichFields) const
+{
+    // Serialize into a buffer owned by the thread, which keeps its capacity
+    // from one hash to the next.  Buffers which grew unusually large are
+    // released rather than kept for the life of the thread.
+    static constexpr std::size_t maxRetained = 64 * 1024;
+    thread_local Serializer s;
+
+    s.erase();
     s.add32(prefix);
-    add(s, omitSigningFields);
-    return s.getSHA512Half();
+    add(s, whichFields);
+    auto const hash = s.getSHA512Half();
+
+    if (s.capacity() > maxRetained)
+        s = Serializer{};
+    return hash;
 }
 
 int
@@ -423,7 +436,7 @@ STObject::peekFieldArray(SField const& field)
 bool
 STObject::setFlag(std::uint32_t f)
 {
-    STUInt32* t = dynamic_cast<STUInt32*>(getPField(sfFlags, true));
+    STUInt32* t = detail::fieldCast<STUInt32>(getPField(sfFlags, true));
 
     if (!t)
         return false;
@@ -435,7 +448,7 @@ STObject::setFlag(std::uint32_t f)
 bool
 STObject::clearFlag(std::uint32_t f)
 {
-    STUInt32* t = dynamic_cast<STUInt32*>(getPField(sfFlags));
+    STUInt32* t = detail::fieldCast<STUInt32>(getPField(sfFlags));
 
     if (!t)
         return false;
@@ -453,7 +466,7 @@ STObject::isFlag(std::uint32_t f) const
 std::uint32_t
 STObject::getFlags(void) const
 {
-    const STUInt32* t = dynamic_cast<const STUInt32*>(peekAtPField(sfFlags));
+    const STUInt32* t = detail::fieldCast<STUInt32>(peekAtPField(sfFlags));
 
     if (!t)
         return 0;
@@ -755,8 +768,7 @@ STObject::add(Serializer& s, WhichFields whichFields) const
 {
     // Depending on whichFields, signing fields are either serialized or
     // not.  Then fields are added to the Serializer sorted by fieldCode.
-    std::vector<STBase const*> const fields{
-        getSortedFields(*this, whichFields)};
+    auto const fields = getSortedFields(*this, whichFields);
 
     // insert sorted
     for (STBase const* const field : fields)
@@ -775,10 +787,10 @@ STObject::add(Serializer& s, WhichFields whichFields) const
     }
 }
 
-std::vector<STBase const*>
+STObject::SortedFields
 STObject::getSortedFields(STObject const& objToSort, WhichFields whichFields)
 {
-    std::vector<STBase const*> sf;
+    SortedFields sf;
     sf.reserve(objToSort.getCount());
 
     // Choose the fields that we need to sort.
@@ -28,21 +28,13 @@ namespace ripple {
 int
 Serializer::add16(std::uint16_t i)
 {
-    int ret = mData.size();
-    mData.push_back(static_cast<unsigned char>(i >> 8));
-    mData.push_back(static_cast<unsigned char>(i & 0xff));
-    return ret;
+    return addBigEndian(i);
 }
 
 int
 Serializer::add32(std::uint32_t i)
 {
-    int ret = mData.size();
-    mData.push_back(static_cast<unsigned char>(i >> 24));
-    mData.push_back(static_cast<unsigned char>((i >> 16) & 0xff));
-    mData.push_back(static_cast<unsigned char>((i >> 8) & 0xff));
-    mData.push_back(static_cast<unsigned char>(i & 0xff));
-    return ret;
+    return addBigEndian(i);
 }
 
 int
@@ -59,16 +51,7 @@ Serializer::add32(HashPrefix p)
 int
 Serializer::add64(std::uint64_t i)
 {
-    int ret = mData.size();
-    mData.push_back(static_cast<unsigned char>(i >> 56));
-    mData.push_back(static_cast<unsigned char>((i >> 48) & 0xff));
-    mData.push_back(static_cast<unsigned char>((i >> 40) & 0xff));
-    mData.push_back(static_cast<unsigned char>((i >> 32) & 0xff));
-    mData.push_back(static_cast<unsigned char>((i >> 24) & 0xff));
-    mData.push_back(static_cast<unsigned char>((i >> 16) & 0xff));
-    mData.push_back(static_cast<unsigned char>((i >> 8) & 0xff));
-    mData.push_back(static_cast<unsigned char>(i & 0xff));
-    return ret;
+    return addBigEndian(i);
 }
 
 template <>
@@ -131,35 +114,37 @@ Serializer::addRaw(const void* ptr, int len)
 int
 Serializer::addFieldID(int type, int name)
 {
-    int ret = mData.size();
     assert((type > 0) && (type < 256) && (name > 0) && (name < 256));
 
+    std::uint8_t bytes[3];
+    int numBytes = 0;
+
     if (type < 16)
     {
         if (name < 16)  // common type, common name
-            mData.push_back(static_cast<unsigned char>((type << 4) | name));
+            bytes[numBytes++] = static_cast<std::uint8_t>((type << 4) | name);
         else
         {
             // common type, uncommon name
-            mData.push_back(static_cast<unsigned char>(type << 4));
-            mData.push_back(static_cast<unsigned char>(name));
+            bytes[numBytes++] = static_cast<std::uint8_t>(type << 4);
+            bytes[numBytes++] = static_cast<std::uint8_t>(name);
         }
     }
     else if (name < 16)
     {
         // uncommon type, common name
-        mData.push_back(static_cast<unsigned char>(name));
-        mData.push_back(static_cast<unsigned char>(type));
+        bytes[numBytes++] = static_cast<std::uint8_t>(name);
+        bytes[numBytes++] = static_cast<std::uint8_t>(type);
     }
     else
     {
         // uncommon type, uncommon name
-        mData.push_back(static_cast<unsigned char>(0));
-        mData.push_back(static_cast<unsigned char>(type));
-        mData.push_back(static_cast<unsigned char>(name));
+        bytes[numBytes++] = 0;
+        bytes[numBytes++] = static_cast<std::uint8_t>(type);
+        bytes[numBytes++] = static_cast<std::uint8_t>(name);
     }
 
-    return ret;
+    return addRaw(bytes, numBytes);
 }
 
 int
@@ -358,58 +343,6 @@ SerialIter::skip(int length)
     remain_ -= length;
 }
 
-unsigned char
-SerialIter::get8()
-{
-    if (remain_ < 1)
-        Throw<std::runtime_error>("invalid SerialIter get8");
-    unsigned char t = *p_;
-    ++p_;
-    ++used_;
-    --remain_;
-    return t;
-}
-
-std::uint16_t
-SerialIter::get16()
-{
-    if (remain_ < 2)
-        Throw<std::runtime_error>("invalid SerialIter get16");
-    auto t = p_;
-    p_ += 2;
-    used_ += 2;
-    remain_ -= 2;
-    return (std::uint64_t(t[0]) << 8) + std::uint64_t(t[1]);
-}
-
-std::uint32_t
-SerialIter::get32()
-{
-    if (remain_ < 4)
-        Throw<std::runtime_error>("invalid SerialIter get32");
-    auto t = p_;
-    p_ += 4;
-    used_ += 4;
-    remain_ -= 4;
-    return (std::uint64_t(t[0]) << 24) + (std::uint64_t(t[1]) << 16) +
-        (std::uint64_t(t[2]) << 8) + std::uint64_t(t[3]);
-}
-
-std::uint64_t
-SerialIter::get64()
-{
-    if (remain_ < 8)
-        Throw<std::runtime_error>("invalid SerialIter get64");
-    auto t = p_;
-    p_ += 8;
-    used_ += 8;
-    remain_ -= 8;
-    return (std::uint64_t(t[0]) << 56) + (std::uint64_t(t[1]) << 48) +
-        (std::uint64_t(t[2]) << 40) + (std::uint64_t(t[3]) << 32) +
-        (std::uint64_t(t[4]) << 24) + (std::uint64_t(t[5]) << 16) +
-        (std::uint64_t(t[6]) << 8) + std::uint64_t(t[7]);
-}
-
 void
 SerialIter::getFieldID(int& type, int& name)
 {
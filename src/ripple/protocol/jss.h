@@ -132,8 +132,10 @@ JSS(authorized);             // out: AccountLines
 JSS(auth_change);            // out: AccountInfo
 JSS(auth_change_queued);     // out: AccountInfo
 JSS(available);              // out: ValidatorList
+JSS(average_duration_us);    // out: OpenLedger
 JSS(avg_bps_recv);           // out: Peers
 JSS(avg_bps_sent);           // out: Peers
+JSS(backends);               // out: GetCounts
 JSS(balance);                // out: AccountLines
 JSS(balances);               // out: GatewayBalances
 JSS(base);                   // out: LogLevel
@@ -192,6 +194,7 @@ JSS(dbKBLedger);              // out: getCounts
 JSS(dbKBTotal);               // out: getCounts
 JSS(dbKBTransaction);         // out: getCounts
 JSS(debug_signing);           // in: TransactionSign
+JSS(deduplicated);            // out: PathRequests
 JSS(deletion_blockers_only);  // in: AccountObjects
 JSS(delivered_amount);        // out: insertDeliveredAmount
 JSS(deposit_authorized);      // out: deposit_authorized
@@ -254,6 +257,7 @@ JSS(freeze);                // out: AccountLines
 JSS(freeze_peer);           // out: AccountLines
 JSS(frozen_balances);       // out: GatewayBalances
 JSS(full);                  // in: LedgerClearer, handlers/Ledger
+JSS(full_rebuilds);         // out: OrderBookDB
 JSS(full_reply);            // out: PathFind
 JSS(fullbelow_size);        // out: GetCounts
 JSS(good);                  // out: RPCVersion
@@ -293,6 +297,8 @@ JSS(jq_trans_overflow);           // JobQueue transaction limit overflow.
 JSS(kept);                        // out: SubmitTransaction
 JSS(key);                         // out
 JSS(key_type);                    // in/out: WalletPropose, TransactionSign
+JSS(lag_ledgers);                 // out: NetworkOPs
+JSS(lag_ms);                      // out: NetworkOPs
 JSS(latency);                     // out: PeerImp
 JSS(last);                        // out: RPCVersion
 JSS(last_close);                  // out: NetworkOPs
@@ -358,6 +364,7 @@ JSS(max_ledger);                  // in/out: LedgerCleaner
 JSS(max_queue_size);              // out: TxQ
 JSS(max_spend_drops);             // out: AccountInfo
 JSS(max_spend_drops_total);       // out: AccountInfo
+JSS(mean_us);                     // out: GetCounts
 JSS(median_fee);                  // out: TxQ
 JSS(median_level);                // out: TxQ
 JSS(message);                     // error.
@@ -382,14 +389,27 @@ JSS(no_ripple);                  // out: AccountLines
 JSS(no_ripple_peer);             // out: AccountLines
 JSS(node);                       // out: LedgerEntry
 JSS(node_binary);                // out: LedgerEntry
+JSS(node_hot_generations);       // out: GetCounts
+JSS(node_migrated);              // out: GetCounts
 JSS(node_read_bytes);            // out: GetCounts
 JSS(node_read_errors);           // out: GetCounts
 JSS(node_read_retries);          // out: GetCounts
+JSS(node_read_stages);           // out: GetCounts
+JSS(node_reads_cold);            // out: GetCounts
+JSS(node_reads_filtered);        // out: GetCounts
+JSS(node_reads_filter_false_positive);  // out: GetCounts
 JSS(node_reads_hit);             // out: GetCounts
+JSS(node_reads_hot);             // out: GetCounts
+JSS(node_reads_slow);            // out: GetCounts
 JSS(node_reads_total);           // out: GetCounts
 JSS(node_reads_duration_us);     // out: GetCounts
 JSS(nodestore);                  // out: GetCounts
+JSS(node_write_batch_size);      // out: GetCounts
+JSS(node_write_queue);           // out: GetCounts
+JSS(node_write_requests);        // out: GetCounts
 JSS(node_writes);                // out: GetCounts
+JSS(node_writes_deduplicated);   // out: GetCounts
+JSS(node_writes_unique);         // out: GetCounts
 JSS(node_written_bytes);         // out: GetCounts
 JSS(node_writes_duration_us);    // out: GetCounts
 JSS(node_write_retries);         // out: GetCounts
@@ -403,14 +423,20 @@ JSS(open);                       // out: handlers/Ledger
 JSS(open_ledger_cost);           // out: SubmitTransaction
 JSS(open_ledger_fee);            // out: TxQ
 JSS(open_ledger_level);          // out: TxQ
+JSS(open_ledger_rebuild);        // out: NetworkOPs
+JSS(order_book_index);           // out: NetworkOPs
 JSS(owner);                      // in: LedgerEntry, out: NetworkOPs
 JSS(owner_funds);                // in/out: Ledger, NetworkOPs, AcceptedLedgerTx
+JSS(p50_us);                     // out: GetCounts
+JSS(p90_us);                     // out: GetCounts
+JSS(p99_us);                     // out: GetCounts
 JSS(params);                     // RPC
 JSS(parent_close_time);          // out: LedgerToJson
 JSS(parent_hash);                // out: LedgerToJson
 JSS(partition);                  // in: LogLevel
 JSS(passphrase);                 // in: WalletPropose
 JSS(password);                   // in: Subscribe
+JSS(path_requests);              // out: NetworkOPs
 JSS(paths);                      // in: RipplePathFind
 JSS(paths_canonical);            // out: RipplePathFind
 JSS(paths_computed);             // out: PathRequest, RipplePathFind
@@ -423,8 +449,10 @@ JSS(peer_disconnects);           // Severed peer connection counter.
 JSS(peer_disconnects_resources);  // Severed peer connections because of
                                   // excess resource consumption.
 JSS(port);                        // in: Connect
+JSS(preflights_cached);           // out: OpenLedger
 JSS(previous);                    // out: Reservations
 JSS(previous_ledger);             // out: LedgerPropose
+JSS(processed);                   // out: PathRequests
 JSS(proof);                       // in: BookOffers
 JSS(propose_seq);                 // out: LedgerPropose
 JSS(proposers);                   // out: NetworkOPs, LedgerConsensus
@@ -437,6 +465,7 @@ JSS(public_key);                  // out: OverlayImpl, PeerImp, WalletPropose,
                                   //      ValidatorInfo
                                   // in/out: Manifest
 JSS(public_key_hex);              // out: WalletPropose
+JSS(publish_queue);               // out: NetworkOPs
 JSS(published_ledger);            // out: NetworkOPs
 JSS(publisher_lists);             // out: ValidatorList
 JSS(quality);                     // out: NetworkOPs
@@ -446,6 +475,7 @@ JSS(queue);                       // in: AccountInfo
 JSS(queue_data);                  // out: AccountInfo
 JSS(queued);                      // out: SubmitTransaction
 JSS(queued_duration_us);
+JSS(queued_ledgers);              // out: NetworkOPs
 JSS(random);                // out: Random
 JSS(raw_meta);              // out: AcceptedLedgerTx
 JSS(receive_currencies);    // out: AccountCurrencies
@@ -457,13 +487,16 @@ JSS(remaining);             // out: ValidatorList
 JSS(remote);                // out: Logic.h
 JSS(request);               // RPC
 JSS(requested);             // out: Manifest
+JSS(requests);              // out: PathRequests
 JSS(reservations);          // out: Reservations
 JSS(reserve_base);          // out: NetworkOPs
 JSS(reserve_base_xrp);      // out: NetworkOPs
 JSS(reserve_inc);           // out: NetworkOPs
 JSS(reserve_inc_xrp);       // out: NetworkOPs
 JSS(response);              // websocket
+JSS(response_format);       // in: websocket
 JSS(result);                // RPC
+JSS(retries_skipped);       // out: OpenLedger
 JSS(ripple_lines);          // out: NetworkOPs
 JSS(ripple_state);          // in: LedgerEntr
 JSS(ripplerpc);             // ripple RPC version
@@ -500,6 +533,7 @@ JSS(signing_keys);              // out: ValidatorList
 JSS(signing_time);              // out: NetworkOPs
 JSS(signer_list);               // in: AccountObjects
 JSS(signer_lists);              // in/out: AccountInfo
+JSS(skipped_ledgers);           // out: NetworkOPs
 JSS(snapshot);                  // in: Subscribe
 JSS(source_account);            // in: PathRequest, RipplePathFind
 JSS(source_amount);             // in: PathRequest, RipplePathFind
@@ -566,6 +600,7 @@ JSS(type);                    // in: AccountObjects
 JSS(type_hex);                // out: STPathSet
 JSS(unl);                     // out: UnlList
 JSS(unlimited);               // out: Connection.h
+JSS(update_ms);               // out: PathRequests
 JSS(uptime);                  // out: GetCounts
 JSS(uri);                     // out: ValidatorSites
 JSS(url);                     // in/out: Subscribe, Unsubscribe
@@ -25,6 +25,10 @@
 #include <ripple/rpc/Context.h>
 #include <ripple/rpc/Status.h>
 
+namespace Json {
+class Object;
+}
+
 namespace ripple {
 namespace RPC {
 
@@ -34,6 +38,18 @@ struct JsonContext;
 Status
 doCommand(RPC::JsonContext&, Json::Value&);
 
+/** Return true if the command's result can be written to a Json::Object. */
+bool
+canWriteObject(RPC::JsonContext const&);
+
+/** Execute an RPC command, writing the results to a Json::Object as they
+    are produced.
+
+    @note The command must satisfy canWriteObject.
+*/
+Status
+doCommand(RPC::JsonContext&, Json::Object&);
+
 Role
 roleRequired(unsigned int version, std::string const& method);
 
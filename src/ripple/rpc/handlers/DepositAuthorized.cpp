@@ -85,7 +85,7 @@ doDepositAuthorized(RPC::JsonContext& context)
     }
 
     // If destination account is not in the ledger you can't deposit to it, eh?
-    auto const sleDest = ledger->read(keylet::account(dstAcct));
+    auto const sleDest = ledger->readLazy(keylet::account(dstAcct));
     if (!sleDest)
     {
         RPC::inject_error(rpcDST_ACT_NOT_FOUND, result);
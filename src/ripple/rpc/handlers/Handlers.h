@@ -20,6 +20,7 @@
 #ifndef RIPPLE_RPC_HANDLERS_HANDLERS_H_INCLUDED
 #define RIPPLE_RPC_HANDLERS_HANDLERS_H_INCLUDED
 
+#include <ripple/rpc/handlers/LedgerData.h>
 #include <ripple/rpc/handlers/LedgerHandler.h>
 
 namespace ripple {
@@ -75,8 +76,6 @@ doLedgerClosed(RPC::JsonContext&);
 Json::Value
 doLedgerCurrent(RPC::JsonContext&);
 Json::Value
-doLedgerData(RPC::JsonContext&);
-Json::Value
 doLedgerEntry(RPC::JsonContext&);
 Json::Value
 doLedgerHeader(RPC::JsonContext&);
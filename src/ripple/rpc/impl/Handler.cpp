@@ -100,7 +100,6 @@ Handler const handlerArray[]{
      byRef(&doLedgerCurrent),
      Role::USER,
      NEEDS_CURRENT_LEDGER},
-    {"ledger_data", byRef(&doLedgerData), Role::USER, NO_CONDITION},
     {"ledger_entry", byRef(&doLedgerEntry), Role::USER, NO_CONDITION},
     {"ledger_header", byRef(&doLedgerHeader), Role::USER, NO_CONDITION},
     {"ledger_request", byRef(&doLedgerRequest), Role::ADMIN, NO_CONDITION},
@@ -181,6 +180,7 @@ private:
             // This is where the new-style handlers are added.
             // This is also where different versions of handlers are added.
             addHandler<LedgerHandler>(v);
+            addHandler<LedgerDataHandler>(v);
             addHandler<VersionHandler>(v);
         }
     }
@@ -235,6 +235,7 @@ private:
         Handler h;
         h.name_ = HandlerImpl::name();
         h.valueMethod_ = &handle<Json::Value, HandlerImpl>;
+        h.objectMethod_ = &handle<Json::Object, HandlerImpl>;
         h.role_ = HandlerImpl::role();
         h.condition_ = HandlerImpl::condition();
 
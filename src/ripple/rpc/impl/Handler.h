@@ -52,6 +52,10 @@ struct Handler
     Method<Json::Value> valueMethod_;
     Role role_;
     RPC::Condition condition_;
+
+    // Set for handlers that can write their result directly to a
+    // Json::Writer, otherwise empty.
+    Method<Json::Object> objectMethod_;
 };
 
 Handler const*
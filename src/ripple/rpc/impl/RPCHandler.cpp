@@ -37,6 +37,7 @@
 #include <ripple/rpc/impl/Handler.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <atomic>
+#include <cassert>
 #include <chrono>
 
 namespace ripple {
@@ -203,8 +204,16 @@ callMethod(
     }
     catch (ReportingShouldProxy&)
     {
-        result = forwardToP2p(context);
-        return rpcSUCCESS;
+        // Only Json::Value results are produced in reporting mode.
+        if constexpr (std::is_same_v<Object, Json::Value>)
+        {
+            result = forwardToP2p(context);
+            return rpcSUCCESS;
+        }
+        else
+        {
+            Rethrow();
+        }
     }
     catch (std::exception& e)
     {
@@ -288,6 +297,55 @@ doCommand(RPC::JsonContext& context, Json::Value& result)
     return rpcUNKNOWN_COMMAND;
 }
 
+bool
+canWriteObject(RPC::JsonContext const& context)
+{
+    if (context.app.config().reporting())
+        return false;
+
+    auto const& params = context.params;
+    auto const& command = params.isMember(jss::command)
+        ? params[jss::command]
+        : params[jss::method];
+    if (!command.isString())
+        return false;
+
+    auto const handler = getHandler(context.apiVersion, command.asString());
+    return handler && handler->objectMethod_;
+}
+
+Status
+doCommand(RPC::JsonContext& context, Json::Object& result)
+{
+    assert(canWriteObject(context));
+
+    Handler const* handler = nullptr;
+    if (auto error = fillHandler(context, handler))
+    {
+        inject_error(error, result);
+        return error;
+    }
+
+    if (auto method = handler->objectMethod_)
+    {
+        JLOG(context.j.debug())
+            << "start command: " << handler->name_
+            << ", user: " << context.headers.user
+            << ", forwarded for: " << context.headers.forwardedFor;
+
+        auto ret = callMethod(context, method, handler->name_, result);
+
+        JLOG(context.j.debug())
+            << "finish command: " << handler->name_
+            << ", user: " << context.headers.user
+            << ", forwarded for: " << context.headers.forwardedFor;
+
+        return ret;
+    }
+
+    return rpcUNKNOWN_COMMAND;
+}
+
 Role
 roleRequired(unsigned int version, std::string const& method)
 {
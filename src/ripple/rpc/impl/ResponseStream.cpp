@@ -0,0 +1,337 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/rpc/impl/ResponseStream.h>
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <limits>
+
+namespace ripple {
+
+class ResponseStream::HTTPWriter : public Writer
+{
+    std::shared_ptr<ResponseStream> const stream_;
+
+public:
+    explicit HTTPWriter(std::shared_ptr<ResponseStream> stream)
+        : stream_(std::move(stream))
+    {
+    }
+
+    ~HTTPWriter() override
+    {
+        stream_->abandon();
+    }
+
+    bool
+    complete() override
+    {
+        std::lock_guard lock(stream_->mutex_);
+        return stream_->finished_ && stream_->queue_.empty();
+    }
+
+    void
+    consume(std::size_t bytes) override
+    {
+        stream_->consume(bytes);
+    }
+
+    bool
+    prepare(std::size_t, std::function<void(void)> resume) override
+    {
+        std::lock_guard lock(stream_->mutex_);
+        if (!stream_->queue_.empty() || stream_->finished_)
+            return true;
+        stream_->resume_ = std::move(resume);
+        return false;
+    }
+
+    std::vector<boost::asio::const_buffer>
+    data() override
+    {
+        std::lock_guard lock(stream_->mutex_);
+        std::size_t n;
+        return stream_->buffers(std::numeric_limits<std::size_t>::max(), n);
+    }
+};
+
+class ResponseStream::WSMessage : public WSMsg
+{
+    std::shared_ptr<ResponseStream> const stream_;
+    std::size_t n_ = 0;
+    bool const binary_;
+
+public:
+    WSMessage(std::shared_ptr<ResponseStream> stream, bool binary)
+        : stream_(std::move(stream)), binary_(binary)
+    {
+    }
+
+    ~WSMessage() override
+    {
+        stream_->abandon();
+    }
+
+    bool
+    binary() const override
+    {
+        return binary_;
+    }
+
+    std::pair<boost::tribool, std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes, std::function<void(void)> resume) override
+    {
+        // The previous call's bytes have been sent
+        stream_->consume(n_);
+        n_ = 0;
+
+        std::lock_guard lock(stream_->mutex_);
+        if (stream_->queue_.empty())
+        {
+            if (stream_->finished_)
+                return {true, {}};
+            stream_->resume_ = std::move(resume);
+            return {boost::indeterminate, {}};
+        }
+        auto buffers = stream_->buffers(bytes, n_);
+        boost::tribool const done =
+            stream_->finished_ && n_ == stream_->queued_;
+        return {done, std::move(buffers)};
+    }
+};
+
+//------------------------------------------------------------------------------
+
+ResponseStream::ResponseStream(
+    std::shared_ptr<JobQueue::Coro> coro,
+    Framing framing,
+    std::size_t limit,
+    std::size_t chunkSize)
+    : coro_(std::move(coro))
+    , framing_(framing)
+    , limit_(limit)
+    , chunkSize_(chunkSize)
+{
+}
+
+void
+ResponseStream::onOverflow(OverflowHandler handler)
+{
+    overflow_ = std::move(handler);
+}
+
+Json::Output
+ResponseStream::output()
+{
+    return [this](boost::beast::string_view const& s) { write(s); };
+}
+
+void
+ResponseStream::write(boost::beast::string_view s)
+{
+    size_ += s.size();
+    pending_.append(s.data(), s.size());
+    if (!started_)
+    {
+        if (pending_.size() > limit_ && overflow_)
+        {
+            auto const handler = std::move(overflow_);
+            overflow_ = nullptr;
+            handler(*this);
+        }
+    }
+    else if (pending_.size() >= chunkSize_ && push(true, false))
+    {
+        coro_->yield();
+    }
+}
+
+void
+ResponseStream::start(std::string preamble)
+{
+    assert(!started_);
+    started_ = true;
+    if (!preamble.empty())
+    {
+        std::lock_guard lock(mutex_);
+        queued_ += preamble.size();
+        queue_.push_back(std::move(preamble));
+    }
+    // The session hasn't been given the stream yet, so it can't wait here
+    push(false, false);
+}
+
+bool
+ResponseStream::abandoned() const
+{
+    std::lock_guard lock(mutex_);
+    return abandoned_;
+}
+
+void
+ResponseStream::finish()
+{
+    if (started_)
+        push(false, true);
+}
+
+std::shared_ptr<Writer>
+ResponseStream::writer()
+{
+    return std::make_shared<HTTPWriter>(shared_from_this());
+}
+
+std::shared_ptr<WSMsg>
+ResponseStream::message(bool binary)
+{
+    return std::make_shared<WSMessage>(shared_from_this(), binary);
+}
+
+bool
+ResponseStream::push(bool wait, bool last)
+{
+    std::string chunk;
+    if (framing_ == Framing::chunked)
+    {
+        if (!pending_.empty())
+        {
+            char size[2 * sizeof(std::size_t) + 2];
+            auto const end =
+                std::to_chars(size, size + sizeof(size), pending_.size(), 16)
+                    .ptr;
+            chunk.reserve((end - size) + pending_.size() + 9);
+            chunk.append(size, end);
+            chunk.append("\r\n");
+            chunk.append(pending_);
+            chunk.append("\r\n");
+            pending_.clear();
+        }
+        if (last)
+            chunk.append("0\r\n\r\n");
+    }
+    else
+    {
+        chunk = std::move(pending_);
+        pending_.clear();
+    }
+
+    std::function<void(void)> resume;
+    bool suspend = false;
+    {
+        std::lock_guard lock(mutex_);
+        if (abandoned_)
+            return false;
+        if (!chunk.empty())
+        {
+            queued_ += chunk.size();
+            queue_.push_back(std::move(chunk));
+        }
+        finished_ = last;
+        resume = std::move(resume_);
+        resume_ = nullptr;
+        if (wait && queued_ > limit_)
+            suspend = waiting_ = true;
+    }
+    if (resume)
+        resume();
+    return suspend;
+}
+
+void
+ResponseStream::consume(std::size_t bytes)
+{
+    bool post = false;
+    {
+        std::lock_guard lock(mutex_);
+        assert(bytes <= queued_);
+        queued_ -= bytes;
+        while (bytes != 0)
+        {
+            auto const& front = queue_.front();
+            auto const n = std::min(bytes, front.size() - offset_);
+            offset_ += n;
+            bytes -= n;
+            if (offset_ == front.size())
+            {
+                queue_.pop_front();
+                offset_ = 0;
+            }
+        }
+        if (waiting_ && queued_ <= limit_ / 2)
+        {
+            waiting_ = false;
+            post = true;
+        }
+    }
+    if (post)
+        resumeCoro();
+}
+
+std::vector<boost::asio::const_buffer>
+ResponseStream::buffers(std::size_t bytes, std::size_t& n) const
+{
+    std::vector<boost::asio::const_buffer> result;
+    n = 0;
+    std::size_t offset = offset_;
+    for (auto const& chunk : queue_)
+    {
+        if (n == bytes)
+            break;
+        auto const size = std::min(bytes - n, chunk.size() - offset);
+        result.emplace_back(chunk.data() + offset, size);
+        n += size;
+        offset = 0;
+    }
+    return result;
+}
+
+void
+ResponseStream::abandon()
+{
+    std::function<void(void)> resume;
+    bool post;
+    {
+        std::lock_guard lock(mutex_);
+        abandoned_ = true;
+        queue_.clear();
+        offset_ = 0;
+        queued_ = 0;
+        resume = std::move(resume_);
+        resume_ = nullptr;
+        post = waiting_;
+        waiting_ = false;
+    }
+    if (post)
+        resumeCoro();
+}
+
+void
+ResponseStream::resumeCoro()
+{
+    if (!coro_->post())
+    {
+        // The JobQueue is stopping.  Let the producer go on on this thread,
+        // as RipplePathFind does, so that shutdown isn't held up.
+        coro_->resume();
+    }
+}
+
+}  // namespace ripple
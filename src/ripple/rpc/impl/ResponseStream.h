@@ -0,0 +1,197 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_RPC_RESPONSESTREAM_H_INCLUDED
+#define RIPPLE_RPC_RESPONSESTREAM_H_INCLUDED
+
+#include <ripple/core/JobQueue.h>
+#include <ripple/json/Output.h>
+#include <ripple/server/WSSession.h>
+#include <ripple/server/Writer.h>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ripple {
+
+/** The body of a response which can be sent while it is produced.
+
+    A handler running on a JobQueue coroutine writes the body through
+    output().  Until the body grows beyond `limit` bytes it is only
+    buffered, and the caller sends it in the usual way when the handler is
+    done.  Once it grows beyond the limit the overflow handler is called,
+    which must start() the stream and hand writer() or message() to the
+    session.  From then on the body is queued in pieces of `chunkSize`
+    bytes, which the session takes as the connection can accept them.
+
+    No more than `limit` bytes wait in the queue: when the session falls
+    behind, output() suspends the coroutine until the session has sent
+    half of them.  If the session goes away instead, the rest of the body
+    is discarded.
+
+    The producer must not hold any lock while it writes, since it may be
+    suspended and resumed on another thread.
+*/
+class ResponseStream : public std::enable_shared_from_this<ResponseStream>
+{
+public:
+    /** How the queued body is framed. */
+    enum class Framing {
+        /** As is, for WebSocket messages. */
+        none,
+
+        /** With the HTTP/1.1 chunked transfer coding. */
+        chunked
+    };
+
+    using OverflowHandler = std::function<void(ResponseStream&)>;
+
+    ResponseStream(
+        std::shared_ptr<JobQueue::Coro> coro,
+        Framing framing,
+        std::size_t limit,
+        std::size_t chunkSize);
+
+    ResponseStream(ResponseStream const&) = delete;
+    ResponseStream&
+    operator=(ResponseStream const&) = delete;
+
+    /** Set the function called when the body outgrows the buffer.
+
+        Without one the whole body is buffered.
+    */
+    void
+    onOverflow(OverflowHandler handler);
+
+    //--------------------------------------------------------------------------
+    //
+    // Producer side, called from the coroutine.
+    //
+
+    /** Returns an Output which appends to the body. */
+    Json::Output
+    output();
+
+    void
+    write(boost::beast::string_view s);
+
+    /** Start sending.
+
+        The preamble, such as the header of an HTTP reply, is sent ahead of
+        the body as is.
+    */
+    void
+    start(std::string preamble = {});
+
+    /** Returns `true` once the stream has started. */
+    bool
+    started() const
+    {
+        return started_;
+    }
+
+    /** Returns `true` if the session went away. */
+    bool
+    abandoned() const;
+
+    /** Returns the number of bytes written to the body. */
+    std::size_t
+    size() const
+    {
+        return size_;
+    }
+
+    /** Returns the buffered body of a stream which has not started. */
+    std::string&
+    buffer()
+    {
+        return pending_;
+    }
+
+    /** Send the remainder of the body and mark the end of it.
+
+        This does not wait for the body to be sent.
+    */
+    void
+    finish();
+
+    //--------------------------------------------------------------------------
+    //
+    // Session side.  Each adapter owns a reference to the stream; when it is
+    // destroyed the stream is abandoned.
+    //
+
+    /** Returns a Writer for BaseHTTPPeer. */
+    std::shared_ptr<Writer>
+    writer();
+
+    /** Returns a message for BaseWSPeer, sent as one or more frames.
+
+        @param binary Whether the frames are binary rather than text.
+    */
+    std::shared_ptr<WSMsg>
+    message(bool binary = false);
+
+private:
+    class HTTPWriter;
+    class WSMessage;
+
+    bool
+    push(bool wait, bool last);
+
+    void
+    consume(std::size_t bytes);
+
+    // Requires mutex_
+    std::vector<boost::asio::const_buffer>
+    buffers(std::size_t bytes, std::size_t& n) const;
+
+    void
+    abandon();
+
+    void
+    resumeCoro();
+
+    std::shared_ptr<JobQueue::Coro> const coro_;
+    Framing const framing_;
+    std::size_t const limit_;
+    std::size_t const chunkSize_;
+    OverflowHandler overflow_;
+
+    // Used only by the producer
+    std::string pending_;
+    std::size_t size_ = 0;
+    bool started_ = false;
+
+    mutable std::mutex mutex_;
+    std::deque<std::string> queue_;
+    std::size_t offset_ = 0;  // sent bytes of queue_.front()
+    std::size_t queued_ = 0;  // unsent bytes of queue_
+    std::function<void(void)> resume_;
+    bool finished_ = false;
+    bool abandoned_ = false;
+    bool waiting_ = false;  // the coroutine is suspended
+};
+
+}  // namespace ripple
+
+#endif
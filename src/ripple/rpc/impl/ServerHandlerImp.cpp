@@ -26,7 +26,9 @@
 #include <ripple/beast/net/IPAddressConversion.h>
 #include <ripple/beast/rfc2616.h>
 #include <ripple/core/JobQueue.h>
+#include <ripple/json/Object.h>
 #include <ripple/json/json_reader.h>
+#include <ripple/json/json_writer.h>
 #include <ripple/json/to_string.h>
 #include <ripple/net/RPCErr.h>
 #include <ripple/overlay/Overlay.h>
@@ -36,6 +38,7 @@
 #include <ripple/rpc/Role.h>
 #include <ripple/rpc/ServerHandler.h>
 #include <ripple/rpc/impl/RPCHelpers.h>
+#include <ripple/rpc/impl/ResponseStream.h>
 #include <ripple/rpc/impl/ServerHandlerImp.h>
 #include <ripple/rpc/impl/Tuning.h>
 #include <ripple/rpc/json_body.h>
@@ -48,6 +51,7 @@
 #include <boost/regex.hpp>
 #include <boost/type_traits.hpp>
 #include <algorithm>
+#include <optional>
 #include <stdexcept>
 
 namespace ripple {
@@ -235,6 +239,26 @@ makeOutput(Session& session)
     };
 }
 
+// Replies are CBOR if the client prefers it, otherwise JSON.
+static Json::Writer::Format
+replyFormat(http_request_type const& request)
+{
+    auto const iter = request.find(boost::beast::http::field::accept);
+    if (iter == request.end())
+        return Json::Writer::Format::json;
+    return acceptedFormat(iter->value());
+}
+
+// Responses are CBOR if the request asks for it, otherwise JSON.
+static Json::Writer::Format
+responseFormat(Json::Value const& jv)
+{
+    auto const& format = jv[jss::response_format];
+    if (format.isString() && format.asString() == "cbor")
+        return Json::Writer::Format::cbor;
+    return Json::Writer::Format::json;
+}
+
 static std::map<std::string, std::string>
 build_map(boost::beast::http::fields const& h)
 {
@@ -331,19 +355,27 @@ ServerHandlerImp::onWSMessage(
 
     JLOG(m_journal.trace()) << "Websocket received '" << jv << "'";
 
+    auto const format = responseFormat(jv);
     auto const postResult = m_jobQueue.postCoro(
         jtCLIENT,
         "WS-Client",
-        [this, session, jv = std::move(jv)](
+        [this, session, format, jv = std::move(jv)](
             std::shared_ptr<JobQueue::Coro> const& coro) {
-            auto const jr = this->processSession(session, coro, jv);
-            auto const s = to_string(jr);
-            auto const n = s.length();
-            boost::beast::multi_buffer sb(n);
-            sb.commit(boost::asio::buffer_copy(
-                sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
-            session->send(
-                std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb)));
+            if (auto const jr =
+                    this->processSession(session, coro, jv, format))
+            {
+                std::string s;
+                if (format == Json::Writer::Format::cbor)
+                    Json::outputCBOR(*jr, Json::stringOutput(s));
+                else
+                    s = to_string(*jr);
+                auto const n = s.length();
+                boost::beast::multi_buffer sb(n);
+                sb.commit(boost::asio::buffer_copy(
+                    sb.prepare(n), boost::asio::buffer(s.c_str(), n)));
+                session->send(std::make_shared<StreambufWSMsg<decltype(sb)>>(
+                    std::move(sb), format == Json::Writer::Format::cbor));
+            }
             session->complete();
         });
     if (postResult == nullptr)
@@ -368,11 +400,30 @@ ServerHandlerImp::onStopped(Server&)
 
 //------------------------------------------------------------------------------
 
-Json::Value
+// Return the request with potentially sensitive information masked.
+static Json::Value
+maskedRequest(Json::Value rq)
+{
+    if (rq.isObject())
+    {
+        if (rq.isMember(jss::passphrase.c_str()))
+            rq[jss::passphrase.c_str()] = "<masked>";
+        if (rq.isMember(jss::secret.c_str()))
+            rq[jss::secret.c_str()] = "<masked>";
+        if (rq.isMember(jss::seed.c_str()))
+            rq[jss::seed.c_str()] = "<masked>";
+        if (rq.isMember(jss::seed_hex.c_str()))
+            rq[jss::seed_hex.c_str()] = "<masked>";
+    }
+    return rq;
+}
+
+std::optional<Json::Value>
 ServerHandlerImp::processSession(
     std::shared_ptr<WSSession> const& session,
     std::shared_ptr<JobQueue::Coro> const& coro,
-    Json::Value const& jv)
+    Json::Value const& jv,
+    Json::Writer::Format format)
 {
     auto is = std::static_pointer_cast<WSInfoSub>(session->appDefined);
     if (is->getConsumer().disconnect())
@@ -387,6 +438,7 @@ ServerHandlerImp::processSession(
     // Requests without "command" are invalid.
     Json::Value jr(Json::objectValue);
     Resource::Charge loadType = Resource::feeReferenceRPC;
+    std::shared_ptr<ResponseStream> stream;
     try
     {
         auto apiVersion = RPC::getAPIVersionNumber(jv);
@@ -447,7 +499,77 @@ ServerHandlerImp::processSession(
                 jv,
                 {is->user(), is->forwarded_for()}};
 
-            RPC::doCommand(context, jr[jss::result]);
+            if (!RPC::canWriteObject(context))
+            {
+                RPC::doCommand(context, jr[jss::result]);
+            }
+            else
+            {
+                // Write the response as the result is produced.  If it
+                // outgrows the buffer, send it in fragments as it is
+                // produced.
+                stream = std::make_shared<ResponseStream>(
+                    coro,
+                    ResponseStream::Framing::none,
+                    RPC::Tuning::maxBufferedReplySize,
+                    RPC::Tuning::replyChunkSize);
+                bool const binary = format == Json::Writer::Format::cbor;
+                stream->onOverflow([&session, binary](ResponseStream& s) {
+                    s.start();
+                    session->send(s.message(binary));
+                });
+
+                RPC::Status status;
+                {
+                    auto root =
+                        Json::WriterObject(stream->output(), format);
+                    {
+                        auto result = Json::addObject(*root, jss::result);
+                        status = RPC::doCommand(context, result);
+                    }
+
+                    // An error in a response which hasn't been sent yet is
+                    // reported below in the usual way.  Errors can't be
+                    // moved to the top level of one which has been.
+                    if (!status || stream->started())
+                    {
+                        is->getConsumer().charge(loadType);
+                        if (is->getConsumer().warn())
+                            (*root)[jss::warning] = jss::load;
+                        if (status)
+                        {
+                            (*root)[jss::status] = jss::error;
+                            (*root)[jss::request] = maskedRequest(jv);
+                        }
+                        else
+                        {
+                            (*root)[jss::status] = jss::success;
+                        }
+                        if (jv.isMember(jss::id))
+                            (*root)[jss::id] = jv[jss::id];
+                        if (jv.isMember(jss::jsonrpc))
+                            (*root)[jss::jsonrpc] = jv[jss::jsonrpc];
+                        if (jv.isMember(jss::ripplerpc))
+                            (*root)[jss::ripplerpc] = jv[jss::ripplerpc];
+                        if (jv.isMember(jss::api_version))
+                            (*root)[jss::api_version] = jv[jss::api_version];
+                        (*root)[jss::type] = jss::response;
+                    }
+                }
+
+                if (!status || stream->started())
+                {
+                    if (!stream->started())
+                    {
+                        stream->start();
+                        session->send(stream->message(binary));
+                    }
+                    stream->finish();
+                    return std::nullopt;
+                }
+                jr[jss::result] = Json::objectValue;
+                status.inject(jr[jss::result]);
+            }
         }
     }
     catch (std::exception const& ex)
@@ -456,6 +578,13 @@ ServerHandlerImp::processSession(
         JLOG(m_journal.error())
             << "Exception while processing WS: " << ex.what() << "\n"
             << "Input JSON: " << Json::Compact{Json::Value{jv}};
+
+        if (stream && stream->started())
+        {
+            // Part of the response was sent.  End the message there.
+            stream->finish();
+            return std::nullopt;
+        }
     }
 
     is->getConsumer().charge(loadType);
@@ -515,6 +644,24 @@ ServerHandlerImp::processSession(
     std::shared_ptr<Session> const& session,
     std::shared_ptr<JobQueue::Coro> coro)
 {
+    auto const keepAlive = beast::rfc2616::is_keep_alive(session->request());
+    auto const format = replyFormat(session->request());
+
+    // HTTP/1.0 clients don't understand chunked replies
+    bool chunked = false;
+    std::function<void(ResponseStream&)> sendChunked;
+    if (session->request().version() >= 11)
+    {
+        sendChunked = [&](ResponseStream& stream) {
+            std::string header;
+            HTTPChunkedReplyHeader(
+                Json::stringOutput(header), keepAlive, format);
+            stream.start(std::move(header));
+            chunked = true;
+            session->write(stream.writer(), keepAlive);
+        };
+    }
+
     processRequest(
         session->port(),
         buffers_to_string(session->request().body().data()),
@@ -527,9 +674,15 @@ ServerHandlerImp::processSession(
             if (iter != session->request().end())
                 return iter->value();
             return boost::beast::string_view{};
-        }());
+        }(),
+        format,
+        sendChunked);
+
+    // The session finishes a chunked reply itself
+    if (chunked)
+        return;
 
-    if (beast::rfc2616::is_keep_alive(session->request()))
+    if (keepAlive)
         session->complete();
     else
         session->close(true);
@@ -559,7 +712,9 @@ ServerHandlerImp::processRequest(
     Output&& output,
     std::shared_ptr<JobQueue::Coro> coro,
     boost::string_view forwardedFor,
-    boost::string_view user)
+    boost::string_view user,
+    Json::Writer::Format format,
+    std::function<void(ResponseStream&)> const& sendChunked)
 {
     auto rpcJ = app_.journal("RPC");
 
@@ -593,6 +748,7 @@ ServerHandlerImp::processRequest(
     }
 
     Json::Value reply(batch ? Json::arrayValue : Json::objectValue);
+    std::shared_ptr<ResponseStream> streamed;
     auto const start(std::chrono::high_resolution_clock::now());
     for (unsigned i = 0; i < size; ++i)
     {
@@ -835,6 +991,51 @@ ServerHandlerImp::processRequest(
              apiVersion},
             params,
             {user, forwardedFor}};
+
+        if (!batch && ripplerpc < "2.0" && RPC::canWriteObject(context))
+        {
+            // Write the reply as the result is produced instead of building
+            // a Json::Value and then converting it to a string.  If it
+            // outgrows the buffer, send it in chunks as it is produced.
+            streamed = std::make_shared<ResponseStream>(
+                coro,
+                ResponseStream::Framing::chunked,
+                RPC::Tuning::maxBufferedReplySize,
+                RPC::Tuning::replyChunkSize);
+            if (sendChunked)
+                streamed->onOverflow(sendChunked);
+            auto root = Json::WriterObject(streamed->output(), format);
+            {
+                auto result = Json::addObject(*root, jss::result);
+                auto const status = RPC::doCommand(context, result);
+                usage.charge(loadType);
+                if (usage.warn())
+                    result[jss::warning] = jss::load;
+
+                // Always report "status".  On an error report the request as
+                // received.
+                if (status)
+                {
+                    result[jss::status] = jss::error;
+                    result[jss::request] = maskedRequest(params);
+                    JLOG(m_journal.debug())
+                        << "rpcError: " << status.toString();
+                }
+                else
+                {
+                    result[jss::status] = jss::success;
+                }
+            }
+
+            if (params.isMember(jss::jsonrpc))
+                (*root)[jss::jsonrpc] = params[jss::jsonrpc];
+            if (params.isMember(jss::ripplerpc))
+                (*root)[jss::ripplerpc] = params[jss::ripplerpc];
+            if (params.isMember(jss::id))
+                (*root)[jss::id] = params[jss::id];
+            continue;
+        }
+
         Json::Value result;
         RPC::doCommand(context, result);
         usage.charge(loadType);
@@ -866,22 +1067,8 @@ ServerHandlerImp::processRequest(
             // received.
             if (result.isMember(jss::error))
             {
-                auto rq = params;
-
-                if (rq.isObject())
-                {  // But mask potentially sensitive information.
-                    if (rq.isMember(jss::passphrase.c_str()))
-                        rq[jss::passphrase.c_str()] = "<masked>";
-                    if (rq.isMember(jss::secret.c_str()))
-                        rq[jss::secret.c_str()] = "<masked>";
-                    if (rq.isMember(jss::seed.c_str()))
-                        rq[jss::seed.c_str()] = "<masked>";
-                    if (rq.isMember(jss::seed_hex.c_str()))
-                        rq[jss::seed_hex.c_str()] = "<masked>";
-                }
-
                 result[jss::status] = jss::error;
-                result[jss::request] = rq;
+                result[jss::request] = maskedRequest(params);
 
                 JLOG(m_journal.debug()) << "rpcError: " << result[jss::error]
                                         << ": " << result[jss::error_message];
@@ -907,13 +1094,43 @@ ServerHandlerImp::processRequest(
 	if(reply.isMember(jss::result) && reply[jss::result].isMember(jss::result))
 		reply = reply[jss::result];
     }
-    auto response = to_string(reply);
+    if (streamed && streamed->started())
+    {
+        rpc_time_.notify(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::high_resolution_clock::now() - start));
+        ++rpc_requests_;
+        rpc_size_.notify(beast::insight::Event::value_type{streamed->size()});
+
+        JLOG(m_journal.debug()) << "Reply: " << streamed->size()
+                                << " bytes, sent in chunks";
+
+        if (format == Json::Writer::Format::json)
+            streamed->write("\n");
+        streamed->finish();
+        return;
+    }
+
+    std::string response;
+    if (streamed)
+        response = std::move(streamed->buffer());
+    else if (format == Json::Writer::Format::cbor)
+        Json::outputCBOR(reply, Json::stringOutput(response));
+    else
+        response = to_string(reply);
 
     rpc_time_.notify(std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::high_resolution_clock::now() - start));
     ++rpc_requests_;
     rpc_size_.notify(beast::insight::Event::value_type{response.size()});
 
+    if (format == Json::Writer::Format::cbor)
+    {
+        JLOG(m_journal.debug()) << "Reply: " << response.size()
+                                << " bytes of CBOR";
+        HTTPReply(200, response, output, rpcJ, format);
+        return;
+    }
+
     response += '\n';
 
     if (auto stream = m_journal.debug())
@@ -1033,6 +1250,7 @@ to_Port(ParsedPort const& parsed, std::ostream& log)
     p.ssl_ciphers = parsed.ssl_ciphers;
     p.pmd_options = parsed.pmd_options;
     p.ws_queue_limit = parsed.ws_queue_limit;
+    p.ws_batch_limit = parsed.ws_batch_limit;
     p.limit = parsed.limit;
 
     return p;
@@ -23,6 +23,7 @@
 #include <ripple/app/main/CollectorManager.h>
 #include <ripple/core/JobQueue.h>
 #include <ripple/json/Output.h>
+#include <ripple/json/Writer.h>
 #include <ripple/rpc/RPCHandler.h>
 #include <ripple/rpc/impl/WSInfoSub.h>
 #include <ripple/server/Server.h>
@@ -31,12 +32,16 @@
 #include <boost/beast/core/tcp_stream.hpp>
 #include <boost/beast/ssl/ssl_stream.hpp>
 #include <boost/utility/string_view.hpp>
+#include <functional>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <vector>
 
 namespace ripple {
 
+class ResponseStream;
+
 inline bool
 operator<(Port const& lhs, Port const& rhs)
 {
@@ -173,17 +178,24 @@ public:
     onStopped(Server&);
 
 private:
-    Json::Value
+    // Returns the response, or nothing if it was already sent in the
+    // given format.
+    std::optional<Json::Value>
     processSession(
         std::shared_ptr<WSSession> const& session,
         std::shared_ptr<JobQueue::Coro> const& coro,
-        Json::Value const& jv);
+        Json::Value const& jv,
+        Json::Writer::Format format);
 
     void
     processSession(
         std::shared_ptr<Session> const&,
         std::shared_ptr<JobQueue::Coro> coro);
 
+    // The reply is written in the given format.  If sendChunked is set, a
+    // reply too large to buffer is handed to it, to start the stream with
+    // the header of a chunked reply and give its Writer to the session,
+    // which sends the reply in chunks and then finishes the request.
     void
     processRequest(
         Port const& port,
@@ -192,7 +204,9 @@ private:
         Output&&,
         std::shared_ptr<JobQueue::Coro> coro,
         boost::string_view forwardedFor,
-        boost::string_view user);
+        boost::string_view user,
+        Json::Writer::Format format,
+        std::function<void(ResponseStream&)> const& sendChunked);
 
     Handoff
     statusResponse(http_request_type const& request) const;
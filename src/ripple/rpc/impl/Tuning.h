@@ -71,6 +71,13 @@ inline int constexpr pageLength(bool isBinary)
     return isBinary ? binaryPageLength : jsonPageLength;
 }
 
+/** Replies which grow larger than this are sent while they are produced, and
+    no more than this much of one may wait to be sent. */
+static int constexpr maxBufferedReplySize = 1024 * 1024;
+
+/** Size of the pieces in which a streamed reply is sent. */
+static int constexpr replyChunkSize = 64 * 1024;
+
 /** Maximum number of source currencies allowed in a path find request. */
 static int constexpr max_src_cur = 18;
 
@@ -21,7 +21,6 @@
 #define RIPPLE_RPC_WSINFOSUB_H
 
 #include <ripple/beast/net/IPAddressConversion.h>
-#include <ripple/json/json_writer.h>
 #include <ripple/net/InfoSub.h>
 #include <ripple/rpc/Role.h>
 #include <ripple/server/WSSession.h>
@@ -67,18 +66,18 @@ public:
     }
 
     void
-    send(Json::Value const& jv, bool) override
+    send(Json::Value const& jv, bool broadcast) override
+    {
+        send(Message(jv), broadcast);
+    }
+
+    void
+    send(Message const& message, bool) override
     {
         auto sp = ws_.lock();
         if (!sp)
             return;
-        boost::beast::multi_buffer sb;
-        Json::stream(jv, [&](void const* data, std::size_t n) {
-            sb.commit(boost::asio::buffer_copy(
-                sb.prepare(n), boost::asio::buffer(data, n)));
-        });
-        auto m = std::make_shared<StreambufWSMsg<decltype(sb)>>(std::move(sb));
-        sp->send(m);
+        sp->send(std::make_shared<StreamWSMsg>(message.text()));
     }
 };
 
@@ -70,6 +70,10 @@ struct Port
     // Websocket disconnects if send queue exceeds this limit
     std::uint16_t ws_queue_limit;
 
+    // Most stream messages a Websocket sends together, or 0 to send each
+    // on its own
+    std::uint16_t ws_batch_limit = 0;
+
     // Returns `true` if any websocket protocols are specified
     bool
     websockets() const;
@@ -105,6 +109,7 @@ struct ParsedPort
     boost::beast::websocket::permessage_deflate pmd_options;
     int limit = 0;
     std::uint16_t ws_queue_limit;
+    std::uint16_t ws_batch_limit = 0;
 
     std::optional<boost::asio::ip::address> ip;
     std::optional<std::uint16_t> port;
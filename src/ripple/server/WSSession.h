@@ -33,6 +33,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -66,6 +67,16 @@ public:
     */
     virtual std::pair<boost::tribool, std::vector<boost::asio::const_buffer>>
     prepare(std::size_t bytes, std::function<void(void)> resume) = 0;
+
+    /** Returns `true` if the message is sent in binary frames.
+
+        Otherwise it is sent in text frames.
+    */
+    virtual bool
+    binary() const
+    {
+        return false;
+    }
 };
 
 template <class Streambuf>
@@ -73,12 +84,20 @@ class StreambufWSMsg : public WSMsg
 {
     Streambuf sb_;
     std::size_t n_ = 0;
+    bool binary_;
 
 public:
-    StreambufWSMsg(Streambuf&& sb) : sb_(std::move(sb))
+    StreambufWSMsg(Streambuf&& sb, bool binary = false)
+        : sb_(std::move(sb)), binary_(binary)
     {
     }
 
+    bool
+    binary() const override
+    {
+        return binary_;
+    }
+
     std::pair<boost::tribool, std::vector<boost::asio::const_buffer>>
     prepare(std::size_t bytes, std::function<void(void)>) override
     {
@@ -104,6 +123,64 @@ public:
     }
 };
 
+/** A message of a subscription stream.
+
+    The message is complete when it is queued, so a session may send the
+    stream messages waiting in its queue together, as one JSON array.
+*/
+class StreamWSMsg : public WSMsg
+{
+    std::shared_ptr<std::string const> text_;
+    std::size_t pos_ = 0;
+    std::size_t n_ = 0;
+
+public:
+    explicit StreamWSMsg(std::string text)
+        : text_(std::make_shared<std::string const>(std::move(text)))
+    {
+    }
+
+    /** Create a message whose text is shared with other messages. */
+    explicit StreamWSMsg(std::shared_ptr<std::string const> text)
+        : text_(std::move(text))
+    {
+    }
+
+    /** Returns the text of the message. */
+    std::string const&
+    text() const
+    {
+        return *text_;
+    }
+
+    /** Returns a message holding the texts of messages as an array. */
+    static std::shared_ptr<StreamWSMsg>
+    batch(std::vector<StreamWSMsg const*> const& messages)
+    {
+        std::size_t size = 1;
+        for (auto const m : messages)
+            size += m->text().size() + 1;
+        std::string text;
+        text.reserve(size);
+        for (auto const m : messages)
+        {
+            text.push_back(text.empty() ? '[' : ',');
+            text.append(m->text());
+        }
+        text.push_back(']');
+        return std::make_shared<StreamWSMsg>(std::move(text));
+    }
+
+    std::pair<boost::tribool, std::vector<boost::asio::const_buffer>>
+    prepare(std::size_t bytes, std::function<void(void)>) override
+    {
+        pos_ += n_;
+        n_ = std::min(bytes, text_->size() - pos_);
+        boost::tribool const done = pos_ + n_ == text_->size();
+        return {done, {boost::asio::const_buffer(text_->data() + pos_, n_)}};
+    }
+};
+
 struct WSSession
 {
     std::shared_ptr<void> appDefined;
@@ -390,11 +390,15 @@ BaseHTTPPeer<Handler, Impl>::do_writer(
         if (!writer->prepare(bufferSize, resume))
             return;
         error_code ec;
+        start_timer();
         auto const bytes_transferred = boost::asio::async_write(
             impl().stream_,
             writer->data(),
             boost::asio::transfer_at_least(1),
             do_yield[ec]);
+        cancel_timer();
+        if (ec == boost::beast::error::timeout)
+            return on_timer();
         if (ec)
             return fail(ec, "writer");
         writer->consume(bytes_transferred);
@@ -405,6 +409,9 @@ BaseHTTPPeer<Handler, Impl>::do_writer(
     if (!keep_alive)
         return do_close();
 
+    // As in complete(), the next request is read into an empty message
+    message_ = {};
+
     boost::asio::spawn(
         strand_,
         std::bind(
@@ -121,6 +121,9 @@ protected:
     void
     on_ws_handshake(error_code const& ec);
 
+    void
+    batch();
+
     void
     do_write();
 
@@ -237,7 +240,10 @@ BaseWSPeer<Handler, Impl>::send(std::shared_ptr<WSMsg> w)
     }
     wq_.emplace_back(std::move(w));
     if (wq_.size() == 1)
+    {
+        batch();
         on_write({});
+    }
 }
 
 template <class Handler, class Impl>
@@ -295,6 +301,37 @@ BaseWSPeer<Handler, Impl>::on_ws_handshake(error_code const& ec)
     do_read();
 }
 
+// Replace the stream messages at the front of the queue with one message
+// holding them all.  This is only called when the front message has not
+// been started.
+template <class Handler, class Impl>
+void
+BaseWSPeer<Handler, Impl>::batch()
+{
+    // Keeps a batch of large messages from growing without bound
+    static constexpr std::size_t maxBytes = 256 * 1024;
+
+    auto const limit = port().ws_batch_limit;
+    if (limit == 0)
+        return;
+    std::vector<StreamWSMsg const*> messages;
+    std::size_t bytes = 0;
+    auto last = wq_.begin();
+    for (; last != wq_.end() && messages.size() < limit; ++last)
+    {
+        auto const m = dynamic_cast<StreamWSMsg const*>(last->get());
+        if (!m || (!messages.empty() && bytes + m->text().size() > maxBytes))
+            break;
+        bytes += m->text().size();
+        messages.push_back(m);
+    }
+    if (messages.empty())
+        return;
+    auto w = StreamWSMsg::batch(messages);
+    wq_.erase(wq_.begin(), last);
+    wq_.emplace_front(std::move(w));
+}
+
 template <class Handler, class Impl>
 void
 BaseWSPeer<Handler, Impl>::do_write()
@@ -311,13 +348,23 @@ void
 BaseWSPeer<Handler, Impl>::on_write(error_code const& ec)
 {
     if (ec)
+    {
+        // Release the messages, so that one which is still being produced
+        // learns that it won't be sent.
+        wq_.clear();
         return fail(ec, "write");
+    }
     auto& w = *wq_.front();
     auto const result = w.prepare(
         65536, std::bind(&BaseWSPeer::do_write, impl().shared_from_this()));
     if (boost::indeterminate(result.first))
+    {
+        // Nothing is being written while the message is produced
+        cancel_timer();
         return;
+    }
     start_timer();
+    impl().ws_.binary(w.binary());
     if (!result.first)
         impl().ws_.async_write_some(
             static_cast<bool>(result.first),
@@ -345,7 +392,10 @@ void
 BaseWSPeer<Handler, Impl>::on_write_fin(error_code const& ec)
 {
     if (ec)
+    {
+        wq_.clear();
         return fail(ec, "write_fin");
+    }
     wq_.pop_front();
     if (do_close_)
         impl().ws_.async_close(
@@ -357,7 +407,10 @@ BaseWSPeer<Handler, Impl>::on_write_fin(error_code const& ec)
                     impl().shared_from_this(),
                     std::placeholders::_1)));
     else if (!wq_.empty())
+    {
+        batch();
         on_write({});
+    }
 }
 
 template <class Handler, class Impl>
@@ -18,15 +18,88 @@
 //==============================================================================
 
 #include <ripple/basics/Log.h>
+#include <ripple/beast/rfc2616.h>
 #include <ripple/json/to_string.h>
 #include <ripple/protocol/BuildInfo.h>
 #include <ripple/protocol/SystemParameters.h>
 #include <ripple/protocol/jss.h>
 #include <ripple/server/impl/JSONRPCUtil.h>
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
 
 namespace ripple {
 
+static char const*
+contentType(Json::Writer::Format format)
+{
+    if (format == Json::Writer::Format::cbor)
+        return "Content-Type: application/cbor\r\n";
+    return "Content-Type: application/json; charset=UTF-8\r\n";
+}
+
+// The quality of a media range, from its parameters.
+static double
+quality(std::string const& params)
+{
+    for (auto const& param : beast::rfc2616::split(
+             params.begin(), params.end(), ';'))
+    {
+        if (param.size() < 2 || std::tolower(param[0]) != 'q' ||
+            param[1] != '=')
+            continue;
+        char* end;
+        auto const q = std::strtod(param.c_str() + 2, &end);
+        if (end == param.c_str() + 2 || *end != 0)
+            return 1;
+        return std::clamp(q, 0.0, 1.0);
+    }
+    return 1;
+}
+
+Json::Writer::Format
+acceptedFormat(boost::beast::string_view accept)
+{
+    // Each format takes the quality of the most specific media range
+    // which matches it (RFC 7231, section 5.3.2).
+    struct Match
+    {
+        int specificity = -1;
+        double quality = 0;
+    };
+    Match cbor, json;
+
+    for (auto const& range : beast::rfc2616::split_commas(accept))
+    {
+        auto const semi = range.find(';');
+        auto const type = range.substr(0, semi);
+        auto const q =
+            semi == std::string::npos ? 1 : quality(range.substr(semi + 1));
+
+        auto const match = [&](Match& m, char const* mediaType) {
+            int specificity;
+            if (beast::rfc2616::ci_equal(type, mediaType))
+                specificity = 2;
+            else if (beast::rfc2616::ci_equal(type, "application/*"))
+                specificity = 1;
+            else if (type == "*/*")
+                specificity = 0;
+            else
+                return;
+            if (specificity > m.specificity)
+                m = {specificity, q};
+        };
+        match(cbor, "application/cbor");
+        match(json, "application/json");
+    }
+
+    if (cbor.specificity == 2 && cbor.quality > 0 &&
+        cbor.quality >= json.quality)
+        return Json::Writer::Format::cbor;
+    return Json::Writer::Format::json;
+}
+
 std::string
 getHTTPHeaderTimestamp()
 {
@@ -57,7 +130,8 @@ HTTPReply(
     int nStatus,
     std::string const& content,
     Json::Output const& output,
-    beast::Journal j)
+    beast::Journal j,
+    Json::Writer::Format format)
 {
     JLOG(j.trace()) << "HTTP Reply " << nStatus << " " << content;
 
@@ -127,18 +201,39 @@ HTTPReply(
     // if (context.app.config().RPC_ALLOW_REMOTE)
     //    output ("Access-Control-Allow-Origin: *\r\n");
 
-    output(std::to_string(content.size() + 2));
+    // JSON content is followed by a line break.  Other content is sent as
+    // it is, since CBOR decoders reject trailing bytes.
+    bool const cbor = nStatus == 200 && format == Json::Writer::Format::cbor;
+    output(std::to_string(content.size() + (cbor ? 0 : 2)));
+    output("\r\n");
+    output(contentType(cbor ? format : Json::Writer::Format::json));
+
+    output("Server: " + systemName() + "-json-rpc/");
+    output(BuildInfo::getFullVersionString());
     output(
         "\r\n"
-        "Content-Type: application/json; charset=UTF-8\r\n");
+        "\r\n");
+    output(content);
+    if (!cbor)
+        output("\r\n");
+}
 
+void
+HTTPChunkedReplyHeader(
+    Json::Output const& output,
+    bool keepAlive,
+    Json::Writer::Format format)
+{
+    output("HTTP/1.1 200 OK\r\n");
+    output(getHTTPHeaderTimestamp());
+    output(keepAlive ? "Connection: Keep-Alive\r\n" : "Connection: close\r\n");
+    output("Transfer-Encoding: chunked\r\n");
+    output(contentType(format));
     output("Server: " + systemName() + "-json-rpc/");
     output(BuildInfo::getFullVersionString());
     output(
         "\r\n"
         "\r\n");
-    output(content);
-    output("\r\n");
 }
 
 }  // namespace ripple
@@ -21,16 +21,43 @@
 #define RIPPLE_SERVER_JSONRPCUTIL_H_INCLUDED
 
 #include <ripple/json/Output.h>
+#include <ripple/json/Writer.h>
 #include <ripple/json/json_value.h>
 
 namespace ripple {
 
+/** Return the format of the replies a client accepts.
+
+    The value is that of an HTTP Accept header.  Replies are CBOR only if
+    the client names application/cbor, with a quality above zero and no
+    lower than that of JSON.  Otherwise they are JSON, the default.
+*/
+Json::Writer::Format
+acceptedFormat(boost::beast::string_view accept);
+
+/** Write a reply.
+
+    The content of a "200 OK" reply is in the given format.  Other replies
+    are JSON.
+*/
 void
 HTTPReply(
     int nStatus,
     std::string const& strMsg,
     Json::Output const&,
-    beast::Journal j);
+    beast::Journal j,
+    Json::Writer::Format format = Json::Writer::Format::json);
+
+/** Write the header of a "200 OK" reply whose content follows in the
+    chunked transfer coding.
+
+    @param keepAlive Whether the connection stays open after the reply.
+*/
+void
+HTTPChunkedReplyHeader(
+    Json::Output const&,
+    bool keepAlive,
+    Json::Writer::Format format = Json::Writer::Format::json);
 
 }  // namespace ripple
 
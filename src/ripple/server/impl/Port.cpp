@@ -233,6 +233,24 @@ parse_Port(ParsedPort& port, Section const& section, std::ostream& log)
         }
     }
 
+    {
+        auto const result = section.find("send_batch_limit");
+        if (result.second)
+        {
+            try
+            {
+                port.ws_batch_limit =
+                    beast::lexicalCastThrow<std::uint16_t>(result.first);
+            }
+            catch (std::exception const&)
+            {
+                log << "Invalid value '" << result.first << "' for key "
+                    << "'send_batch_limit' in [" << section.name() << "]";
+                Rethrow();
+            }
+        }
+    }
+
     populate(section, "admin", log, port.admin_ip, true, {});
     populate(
         section,
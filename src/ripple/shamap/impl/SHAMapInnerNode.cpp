@@ -137,12 +137,10 @@ SHAMapInnerNode::makeFullInner(
 
     auto ret = std::make_shared<SHAMapInnerNode>(0, branchFactor);
 
-    Serializer s(data.data(), data.size());
-
     auto retHashes = ret->hashesAndChildren_.getHashes();
     for (int i = 0; i < branchFactor; ++i)
     {
-        s.getBitString(retHashes[i].as_uint256(), i * 32);
+        retHashes[i].as_uint256() = uint256::fromVoid(data.data() + i * 32);
 
         if (retHashes[i].isNonZero())
             ret->isBranch_ |= (1 << i);
@@ -160,24 +158,21 @@ SHAMapInnerNode::makeFullInner(
 std::shared_ptr<SHAMapTreeNode>
 SHAMapInnerNode::makeCompressedInner(Slice data)
 {
-    Serializer s(data.data(), data.size());
-
-    int len = s.getLength();
+    int len = data.size();
 
     auto ret = std::make_shared<SHAMapInnerNode>(0, branchFactor);
 
     auto retHashes = ret->hashesAndChildren_.getHashes();
     for (int i = 0; i < (len / 33); ++i)
     {
-        int pos;
-
-        if (!s.get8(pos, 32 + (i * 33)))
-            Throw<std::runtime_error>("short CI node");
+        // Each entry is a hash followed by its branch number
+        auto const entry = data.data() + (i * 33);
+        int const pos = entry[32];
 
-        if ((pos < 0) || (pos >= branchFactor))
+        if (pos >= branchFactor)
             Throw<std::runtime_error>("invalid CI node");
 
-        s.getBitString(retHashes[pos].as_uint256(), i * 33);
+        retHashes[pos].as_uint256() = uint256::fromVoid(entry);
 
         if (retHashes[pos].isNonZero())
             ret->isBranch_ |= (1 << pos);
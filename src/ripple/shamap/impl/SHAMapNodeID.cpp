@@ -23,6 +23,7 @@
 #include <ripple/shamap/SHAMap.h>
 #include <ripple/shamap/SHAMapNodeID.h>
 #include <cassert>
+#include <cstring>
 
 namespace ripple {
 
@@ -64,10 +65,10 @@ SHAMapNodeID::SHAMapNodeID(unsigned int depth, uint256 const& hash)
 std::string
 SHAMapNodeID::getRawString() const
 {
-    Serializer s(33);
-    s.addBitString(id_);
-    s.add8(depth_);
-    return s.getString();
+    std::string s(id_.size() + 1, '\0');
+    std::memcpy(s.data(), id_.data(), id_.size());
+    s.back() = static_cast<char>(depth_);
+    return s;
 }
 
 SHAMapNodeID
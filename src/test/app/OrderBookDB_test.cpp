@@ -0,0 +1,164 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/OrderBookDB.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+
+#include <chrono>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class OrderBookDB_test : public beast::unit_test::suite
+{
+    // Wait for the index to catch up with the last closed ledger, which is
+    // published on a job.
+    bool
+    caughtUp(jtx::Env& env)
+    {
+        auto const seq = env.closed()->info().seq;
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto const info = env.app().getOrderBookDB().getJson();
+            if (info[jss::ledger_index].asUInt() == seq)
+                return true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    void
+    testIncremental()
+    {
+        testcase("Incremental");
+
+        using namespace jtx;
+        Env env(*this);
+        auto& db = env.app().getOrderBookDB();
+
+        Account const gw("gw");
+        Account const alice("alice");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+        env.trust(USD(1000), alice);
+        env(pay(gw, alice, USD(100)));
+        env.close();
+        BEAST_EXPECT(caughtUp(env));
+        auto const rebuilds = db.getJson()[jss::full_rebuilds].asUInt();
+        BEAST_EXPECT(rebuilds != 0);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+
+        // Two qualities of the XRP/USD book, and the USD/XRP book
+        auto const seq1 = env.seq(alice);
+        env(offer(alice, XRP(10), USD(10)));
+        auto const seq2 = env.seq(alice);
+        env(offer(alice, XRP(20), USD(10)));
+        auto const seq3 = env.seq(alice);
+        env(offer(alice, USD(10), XRP(10)));
+        env.close();
+        BEAST_EXPECT(caughtUp(env));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+        BEAST_EXPECT(db.getJson()[jss::books].asUInt() == 2);
+
+        // The book stays while one of its qualities does
+        env(offer_cancel(alice, seq1));
+        env.close();
+        BEAST_EXPECT(caughtUp(env));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        env(offer_cancel(alice, seq2));
+        env(offer_cancel(alice, seq3));
+        env.close();
+        BEAST_EXPECT(caughtUp(env));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(!db.isBookToXRP(USD.issue()));
+        BEAST_EXPECT(db.getJson()[jss::books].asUInt() == 0);
+
+        // None of that took a full rebuild
+        BEAST_EXPECT(db.getJson()[jss::full_rebuilds].asUInt() == rebuilds);
+
+        // An offer found unfunded by another account's offer is removed,
+        // and its book with it.
+        env(offer(alice, XRP(10), USD(100)));
+        env.close();
+        BEAST_EXPECT(caughtUp(env));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+        env(pay(alice, gw, USD(100)));
+        env(offer(gw, USD(10), XRP(10)));
+        env.close();
+        BEAST_EXPECT(caughtUp(env));
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 0);
+        BEAST_EXPECT(db.isBookToXRP(USD.issue()));
+    }
+
+    void
+    testGap()
+    {
+        testcase("Gap");
+
+        using namespace jtx;
+        Env env(*this);
+        auto& db = env.app().getOrderBookDB();
+
+        Account const gw("gw");
+        Account const alice("alice");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), gw, alice);
+        env.close();
+        env.trust(USD(1000), alice);
+        env(pay(gw, alice, USD(100)));
+        env(offer(alice, XRP(10), USD(10)));
+        env.close();
+        BEAST_EXPECT(caughtUp(env));
+        auto const rebuilds = db.getJson()[jss::full_rebuilds].asUInt();
+
+        // A ledger which doesn't follow the index's rebuilds it
+        db.invalidate();
+        env.close();
+        BEAST_EXPECT(caughtUp(env));
+        BEAST_EXPECT(db.getJson()[jss::full_rebuilds].asUInt() == rebuilds + 1);
+        BEAST_EXPECT(db.getBookSize(xrpIssue()) == 1);
+
+        // And server_info shows how current it is
+        auto const info = env.rpc("server_info");
+        auto const& index = info[jss::result][jss::info][jss::order_book_index];
+        BEAST_EXPECT(index[jss::ledger_index] == env.closed()->info().seq);
+        BEAST_EXPECT(index[jss::lag_ledgers] == 0);
+        BEAST_EXPECT(index[jss::books] == 1);
+    }
+
+public:
+    void
+    run() override
+    {
+        testIncremental();
+        testGap();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(OrderBookDB, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -35,6 +35,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <test/jtx.h>
+#include <test/jtx/WSClient.h>
 #include <thread>
 
 namespace ripple {
@@ -462,6 +463,91 @@ public:
         BEAST_EXPECT(equal(sa, Account("alice")["USD"](5)));
     }
 
+    void
+    path_find_workers()
+    {
+        testcase("path find workers");
+        using namespace jtx;
+        using namespace std::chrono_literals;
+        Env env(*this, envconfig([](std::unique_ptr<Config> cfg) {
+            cfg->PATH_FIND_WORKERS = 4;
+            return cfg;
+        }));
+        auto const gw = Account("gateway");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), "alice", "bob", "carol", gw);
+        env.trust(USD(600), "alice");
+        env.trust(USD(700), "bob", "carol");
+        env(pay(gw, "alice", USD(70)));
+        env(pay(gw, "bob", USD(50)));
+        env.close();
+
+        // Three clients ask for the same paths and one for others
+        std::vector<std::unique_ptr<WSClient>> clients;
+        for (int i = 0; i < 4; ++i)
+        {
+            clients.push_back(makeWSClient(env.app().config(), true, 1));
+            Json::Value params;
+            params[jss::subcommand] = "create";
+            params[jss::id] = i;
+            params[jss::source_account] = Account("alice").human();
+            params[jss::destination_account] =
+                Account(i < 3 ? "bob" : "carol").human();
+            params[jss::destination_amount] =
+                Account(i < 3 ? "bob" : "carol")["USD"](5).value().getJson(
+                    JsonOptions::none);
+            auto const jv = clients.back()->invoke("path_find", params);
+            BEAST_EXPECT(jv[jss::status] == "success");
+        }
+
+        auto fullReply = [](WSClient& client) {
+            return client.findMsg(5s, [](Json::Value const& jv) {
+                return jv[jss::type] == "path_find" &&
+                    jv[jss::full_reply].asBool();
+            });
+        };
+        for (auto const& client : clients)
+            BEAST_EXPECT(fullReply(*client));
+
+        // Every request is updated for the next ledger, and the same
+        // requests get the same paths.
+        env.close();
+        auto const seq = env.closed()->info().seq;
+        Json::Value info;
+        for (int i = 0; i < 500; ++i)
+        {
+            info = env.rpc("server_info")[jss::result][jss::info]
+                                          [jss::path_requests];
+            if (info[jss::ledger_index] == seq)
+                break;
+            std::this_thread::sleep_for(10ms);
+        }
+        BEAST_EXPECT(info[jss::ledger_index] == seq);
+        BEAST_EXPECT(info[jss::requests] == 4);
+        BEAST_EXPECT(info[jss::workers] == 4);
+        BEAST_EXPECT(info[jss::processed] == 4);
+        BEAST_EXPECT(info[jss::deduplicated] == 2);
+
+        std::vector<Json::Value> replies;
+        for (auto const& client : clients)
+        {
+            auto const jv = fullReply(*client);
+            if (!BEAST_EXPECT(jv))
+                return;
+            replies.push_back(*jv);
+        }
+        BEAST_EXPECT(replies[0][jss::alternatives].size() == 1);
+        for (int i = 1; i < 3; ++i)
+        {
+            BEAST_EXPECT(
+                replies[i][jss::alternatives] == replies[0][jss::alternatives]);
+        }
+        for (int i = 0; i < 4; ++i)
+            BEAST_EXPECT(replies[i][jss::id] == i);
+        BEAST_EXPECT(
+            replies[3][jss::destination_account] == Account("carol").human());
+    }
+
     void
     xrp_to_xrp()
     {
@@ -1370,6 +1456,7 @@ public:
         direct_path_no_intermediary();
         payment_auto_path_find();
         path_find();
+        path_find_workers();
         path_find_consume_all();
         alternative_path_consume_both();
         alternative_paths_consume_best_transfer();
@@ -0,0 +1,381 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/paths/Pathfinder.h>
+#include <ripple/app/paths/RippleLineCache.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+
+#include <array>
+#include <chrono>
+
+namespace ripple {
+namespace test {
+
+namespace {
+
+// Gateways of four currencies and market makers with offers between each
+// pair of them and XRP, so that a payment from one currency to another has
+// many multi-hop paths.
+struct Market
+{
+    std::vector<jtx::IOU> ious;
+    jtx::Account const alice{"alice"};
+    jtx::Account const bob{"bob"};
+
+    Market(jtx::Env& env, std::size_t makers)
+    {
+        using namespace jtx;
+        for (auto const name : {"USD", "EUR", "GBP", "JPY"})
+        {
+            Account const gw(std::string("gw") + name);
+            env.fund(XRP(1000000), gw);
+            ious.push_back(gw[name]);
+        }
+        std::vector<Account> mms;
+        for (std::size_t i = 0; i < makers; ++i)
+            mms.emplace_back("mm" + std::to_string(i));
+        env.fund(XRP(1000000), alice, bob);
+        for (auto const& mm : mms)
+            env.fund(XRP(1000000), mm);
+        env.close();
+
+        env(trust(alice, ious.front()(1000000)));
+        env(trust(bob, ious.back()(1000000)));
+        for (auto const& mm : mms)
+        {
+            for (auto const& iou : ious)
+                env(trust(mm, iou(1000000)));
+        }
+        env.close();
+
+        env(pay(ious.front().account, alice, ious.front()(10000)));
+        for (auto const& mm : mms)
+        {
+            for (auto const& iou : ious)
+                env(pay(iou.account, mm, iou(100000)));
+        }
+        env.close();
+
+        for (std::size_t m = 0; m < makers; ++m)
+        {
+            auto const& mm = mms[m];
+            for (auto const& in : ious)
+            {
+                env(offer(mm, in(100), XRP(95 + m)));
+                env(offer(mm, XRP(100), in(95 + m)));
+                for (auto const& out : ious)
+                {
+                    if (in.currency != out.currency)
+                        env(offer(mm, in(100), out(95 + m)));
+                }
+            }
+            env.close();
+        }
+    }
+
+    // The best paths from alice's USD to bob's JPY, as a path_find update
+    // with the previous best paths looks for them
+    STPathSet
+    search(
+        jtx::Env& env,
+        std::shared_ptr<RippleLineCache> const& cache,
+        std::uint32_t amount,
+        STPathSet const& previous = {}) const
+    {
+        auto const& src = ious.front();
+        Pathfinder pf(
+            cache,
+            alice,
+            bob,
+            src.currency,
+            src.account.id(),
+            ious.back()(amount),
+            std::nullopt,
+            env.app());
+        if (!pf.findPaths(env.app().config().PATH_SEARCH))
+            return {};
+        STPath fullLiquidityPath;
+        pf.computePathRanks(4);
+        return pf.getBestPaths(
+            4, fullLiquidityPath, previous, src.account.id());
+    }
+};
+
+}  // namespace
+
+class RippleLineCache_test : public beast::unit_test::suite
+{
+    void
+    testSharing()
+    {
+        testcase("Sharing");
+
+        using namespace jtx;
+        Env env(*this);
+        Account const gw("gw");
+        Account const alice("alice");
+        Account const bob("bob");
+        Account const carol("carol");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000), gw, alice, bob, carol);
+        env.close();
+        env.trust(USD(1000), alice, bob, carol);
+        env(pay(gw, bob, USD(50)));
+        env.close();
+
+        auto const first = std::make_shared<RippleLineCache>(env.closed());
+        auto const& aliceLines = first->getRippleLines(alice);
+        auto const& bobLines = first->getRippleLines(bob);
+        auto const& carolLines = first->getRippleLines(carol);
+        BEAST_EXPECT(aliceLines.size() == 1);
+        BEAST_EXPECT(first->size() == 3);
+
+        // Only the lines of the accounts the payment touched are read again
+        env(pay(gw, alice, USD(10)));
+        env.close();
+        auto const second =
+            std::make_shared<RippleLineCache>(env.closed(), *first);
+        BEAST_EXPECT(second->size() == 2);
+        BEAST_EXPECT(&second->getRippleLines(bob) == &bobLines);
+        BEAST_EXPECT(&second->getRippleLines(carol) == &carolLines);
+        auto const& lines = second->getRippleLines(alice);
+        BEAST_EXPECT(&lines != &aliceLines);
+        BEAST_EXPECT(
+            lines.size() == 1 && lines.front()->getBalance() == USD(10));
+        BEAST_EXPECT(aliceLines.front()->getBalance() == USD(0));
+
+        // A new line changes the lines of both of its accounts
+        env(trust(bob, alice["EUR"](100)));
+        env.close();
+        auto const third =
+            std::make_shared<RippleLineCache>(env.closed(), *second);
+        BEAST_EXPECT(third->size() == 1);
+        BEAST_EXPECT(&third->getRippleLines(carol) == &carolLines);
+        BEAST_EXPECT(third->getRippleLines(bob).size() == 2);
+        BEAST_EXPECT(third->getRippleLines(alice).size() == 2);
+
+        // Nothing is shared with a ledger which isn't the parent
+        env.close();
+        env.close();
+        auto const fourth =
+            std::make_shared<RippleLineCache>(env.closed(), *third);
+        BEAST_EXPECT(fourth->size() == 0);
+
+        // Nor with an open ledger
+        auto const open =
+            std::make_shared<RippleLineCache>(env.current(), *fourth);
+        BEAST_EXPECT(open->size() == 0);
+    }
+
+    void
+    testPathLiquidity()
+    {
+        testcase("PathLiquidity");
+
+        using namespace jtx;
+        Env env(*this);
+        Market const market(env, 2);
+        auto const json = [](STPathSet const& paths) {
+            return paths.getJson(JsonOptions::none);
+        };
+
+        auto const cache = std::make_shared<RippleLineCache>(env.closed());
+        uint256 const key{1};
+        BEAST_EXPECT(!cache->getPathLiquidity(key));
+        cache->setPathLiquidity(key, {tecPATH_DRY, {}, 0});
+        auto const memo = cache->getPathLiquidity(key);
+        BEAST_EXPECT(memo && memo->result == tecPATH_DRY);
+
+        // A search with the remembered liquidity finds what a search
+        // without it finds, and updates find it again
+        auto const cold = market.search(env, cache, 100);
+        BEAST_EXPECT(!cold.empty());
+        auto const warm = market.search(env, cache, 100, cold);
+        auto const fresh = market.search(
+            env, std::make_shared<RippleLineCache>(env.closed()), 100, cold);
+        BEAST_EXPECT(json(warm) == json(fresh));
+        auto const again = market.search(env, cache, 100, warm);
+        BEAST_EXPECT(json(again) == json(warm));
+
+        // Searches for another amount aren't mixed up with these
+        auto const other = market.search(env, cache, 5000, cold);
+        auto const otherFresh = market.search(
+            env, std::make_shared<RippleLineCache>(env.closed()), 5000, cold);
+        BEAST_EXPECT(json(other) == json(otherFresh));
+    }
+
+public:
+    void
+    run() override
+    {
+        testSharing();
+        testPathLiquidity();
+    }
+};
+
+// Path finding on a dense trust graph over a run of ledgers, each with a
+// few payments, with a new cache per ledger and with a cache which carries
+// the lines over from the previous ledger.
+class RippleLineCacheBenchmark_test : public beast::unit_test::suite
+{
+    void
+    measure(bool carryOver)
+    {
+        using namespace jtx;
+        using clock = std::chrono::steady_clock;
+
+        std::size_t const gateways = 10;
+        std::size_t const users = 200;
+        std::size_t const ledgers = 20;
+        std::size_t const requests = 50;
+
+        Env env(*this);
+        std::vector<Account> gws;
+        for (std::size_t i = 0; i < gateways; ++i)
+            gws.emplace_back("gw" + std::to_string(i));
+        std::vector<Account> us;
+        for (std::size_t i = 0; i < users; ++i)
+            us.emplace_back("u" + std::to_string(i));
+        for (auto const& a : gws)
+            env.fund(XRP(100000), a);
+        for (auto const& a : us)
+            env.fund(XRP(10000), a);
+        env.close();
+
+        // Every user trusts every gateway and holds some of its USD
+        for (std::size_t i = 0; i < users; ++i)
+        {
+            for (auto const& g : gws)
+                env(trust(us[i], g["USD"](10000)));
+            if (i % 20 == 19)
+                env.close();
+        }
+        for (std::size_t i = 0; i < users; ++i)
+            env(pay(gws[i % gateways], us[i], gws[i % gateways]["USD"](1000)));
+        env.close();
+
+        auto const currency = gws[0]["USD"].currency;
+        std::shared_ptr<RippleLineCache> cache;
+        clock::duration elapsed{};
+        std::size_t found = 0;
+        for (std::size_t l = 0; l < ledgers; ++l)
+        {
+            for (std::size_t i = l * 5; i < l * 5 + 5; ++i)
+            {
+                auto const& gw = gws[i % users % gateways];
+                env(pay(us[i % users], us[(i + 1) % users], gw["USD"](1)));
+            }
+            env.close();
+
+            auto const start = clock::now();
+            cache = carryOver && cache
+                ? std::make_shared<RippleLineCache>(env.closed(), *cache)
+                : std::make_shared<RippleLineCache>(env.closed());
+            for (std::size_t r = 0; r < requests; ++r)
+            {
+                auto const& src = us[(r * 7) % users];
+                auto const& dst = us[(r * 13 + 1) % users];
+                Pathfinder pf(
+                    cache,
+                    src,
+                    dst,
+                    currency,
+                    std::nullopt,
+                    STAmount(Issue{currency, dst.id()}, 10),
+                    std::nullopt,
+                    env.app());
+                if (!pf.findPaths(env.app().config().PATH_SEARCH))
+                    continue;
+                STPath fullLiquidityPath;
+                pf.computePathRanks(4);
+                found += pf.getBestPaths(4, fullLiquidityPath, {}, src.id())
+                             .size();
+            }
+            elapsed += clock::now() - start;
+        }
+
+        auto const seconds =
+            std::chrono::duration_cast<std::chrono::duration<double>>(elapsed)
+                .count();
+        log << (carryOver ? "carried over" : "new per ledger") << ": "
+            << static_cast<std::size_t>(ledgers * requests / seconds)
+            << " path requests/s, " << found << " paths found" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        measure(false);
+        measure(true);
+        pass();
+    }
+};
+
+// Cross-currency path finding over deep books: the first search for an
+// amount in a ledger, which ranks every candidate path, and the updates of
+// the same search, which find the liquidity of the candidates remembered.
+// The trust lines are read before either is timed.
+class PathLiquidityBenchmark_test : public beast::unit_test::suite
+{
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        using clock = std::chrono::steady_clock;
+
+        std::size_t const updates = 10;
+        Env env(*this);
+        Market const market(env, 20);
+
+        auto const cache = std::make_shared<RippleLineCache>(env.closed());
+        market.search(env, cache, 1);
+
+        clock::duration cold{};
+        clock::duration warm{};
+        std::size_t found = 0;
+        for (std::uint32_t amount : {100, 1000, 10000})
+        {
+            auto start = clock::now();
+            auto best = market.search(env, cache, amount);
+            cold += clock::now() - start;
+
+            start = clock::now();
+            for (std::size_t i = 0; i < updates; ++i)
+                best = market.search(env, cache, amount, best);
+            warm += clock::now() - start;
+            found += best.size();
+        }
+
+        using ms = std::chrono::duration<double, std::milli>;
+        log << "first search: " << ms(cold).count() / 3 << " ms, update: "
+            << ms(warm).count() / (3 * updates) << " ms, " << found
+            << " paths found" << std::endl;
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(RippleLineCache, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(RippleLineCacheBenchmark, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(PathLiquidityBenchmark, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
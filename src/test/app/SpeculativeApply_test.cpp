@@ -0,0 +1,304 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/TxQ.h>
+#include <ripple/app/tx/SpeculativeApply.h>
+#include <ripple/app/tx/apply.h>
+#include <ripple/beast/unit_test.h>
+#include <test/jtx.h>
+#include <test/jtx/envconfig.h>
+
+#include <chrono>
+#include <map>
+#include <set>
+
+namespace ripple {
+namespace test {
+
+class SpeculativeApply_test : public beast::unit_test::suite
+{
+protected:
+    struct Accounts
+    {
+        std::vector<jtx::Account> payers;
+        std::vector<jtx::Account> makers;
+        jtx::IOU USD{jtx::Account("gw"), to_currency("USD")};
+    };
+
+    // Accounts which pay one another, and market makers which trade USD.
+    // No more than `batch` accounts are funded in one ledger, so that none
+    // of it is queued.
+    static Accounts
+    fund(jtx::Env& env,
+        std::size_t payers,
+        std::size_t makers,
+        std::size_t batch)
+    {
+        using namespace jtx;
+        Accounts accounts;
+        auto const& gw = accounts.USD.account;
+        env.fund(XRP(1000000), gw);
+        env.close();
+        for (std::size_t i = 0; i < payers; ++i)
+            accounts.payers.emplace_back("p" + std::to_string(i));
+        for (std::size_t i = 0; i < makers; ++i)
+            accounts.makers.emplace_back("m" + std::to_string(i));
+
+        std::size_t n = 0;
+        auto const next = [&] {
+            if (++n % batch == 0)
+                env.close();
+        };
+        for (auto const& a : accounts.payers)
+        {
+            env.fund(XRP(10000), a);
+            next();
+        }
+        for (auto const& a : accounts.makers)
+        {
+            env.fund(XRP(100000), a);
+            next();
+        }
+        env.close();
+        for (auto const& a : accounts.makers)
+        {
+            env(trust(a, accounts.USD(100000)));
+            env(pay(gw, a, accounts.USD(10000)));
+            next();
+        }
+        env.close();
+        return accounts;
+    }
+
+    // Payments between pairs of payers, which are independent of one
+    // another, and offers which cross each other
+    static std::vector<std::shared_ptr<STTx const>>
+    transactions(jtx::Env& env, Accounts const& accounts)
+    {
+        using namespace jtx;
+        std::vector<std::shared_ptr<STTx const>> txs;
+        auto const& payers = accounts.payers;
+        auto const& makers = accounts.makers;
+        auto const& USD = accounts.USD;
+        for (std::size_t i = 0; i < payers.size(); ++i)
+        {
+            if (i % 2 == 0 && i + 1 < payers.size())
+                txs.push_back(
+                    env.jt(pay(payers[i], payers[i + 1], XRP(1))).stx);
+            if (i < makers.size())
+            {
+                auto const& m = makers[i];
+                txs.push_back(
+                    i % 2 ? env.jt(offer(m, XRP(100), USD(10 + i))).stx
+                          : env.jt(offer(m, USD(10 + i), XRP(100))).stx);
+            }
+        }
+        return txs;
+    }
+
+    // Each entry of the view's state, serialized
+    static std::map<uint256, Blob>
+    state(ReadView const& view)
+    {
+        std::map<uint256, Blob> result;
+        for (auto const& sle : view.sles)
+            result.emplace(sle->key(), sle->getSerializer().peekData());
+        return result;
+    }
+
+    // The metadata of each transaction of the view, serialized
+    static std::map<uint256, Blob>
+    metadata(ReadView const& view)
+    {
+        std::map<uint256, Blob> result;
+        for (auto const& [tx, meta] : view.txs)
+        {
+            Serializer s;
+            meta->add(s);
+            result.emplace(tx->getTransactionID(), s.peekData());
+        }
+        return result;
+    }
+
+    static std::unique_ptr<Config>
+    config(std::size_t perLedger, int workers)
+    {
+        auto cfg = jtx::envconfig();
+        auto& section = cfg->section("transaction_queue");
+        section.set(
+            "minimum_txn_in_ledger_standalone", std::to_string(perLedger));
+        section.set("normal_consensus_increase_percent", "0");
+        section.set("apply_workers", std::to_string(workers));
+        return cfg;
+    }
+
+    // Fill the open ledger and queue the rest
+    static std::size_t
+    submit(jtx::Env& env, Accounts const& accounts)
+    {
+        for (auto const& tx : transactions(env, accounts))
+        {
+            env.app().openLedger().modify(
+                [&](OpenView& view, beast::Journal j) {
+                    return env.app()
+                        .getTxQ()
+                        .apply(env.app(), view, tx, tapNONE, j)
+                        .second;
+                });
+        }
+        return env.app().getTxQ().getMetrics(*env.current()).txCount;
+    }
+
+private:
+    void
+    testDeterminism()
+    {
+        testcase("Determinism");
+
+        using namespace jtx;
+        Env env(*this);
+        auto const accounts = fund(env, 40, 20, 100);
+        auto txs = transactions(env, accounts);
+        // The second transaction of an account depends on the first
+        auto const& p0 = accounts.payers.front();
+        auto const& p1 = accounts.payers.back();
+        auto const next = seq(env.seq(p0) + 1);
+        txs.push_back(env.jt(pay(p0, p1, XRP(2)), next).stx);
+        // And a transaction applies only once
+        txs.push_back(txs.front());
+        // One which isn't applied moves all those after it up a place
+        txs.insert(txs.begin(), env.jt(pay(p1, p0, XRP(1)), seq(1)).stx);
+
+        OpenView serial(*env.current());
+        std::vector<std::pair<TER, bool>> expected;
+        for (auto const& tx : txs)
+            expected.push_back(
+                ripple::apply(env.app(), serial, *tx, tapNONE, env.journal));
+
+        auto const applier = [&env](std::shared_ptr<STTx const> const& tx) {
+            return [&env, tx](OpenView& view) {
+                return ripple::apply(
+                    env.app(), view, *tx, tapNONE, env.journal);
+            };
+        };
+        std::vector<std::pair<uint256, SpeculativeApply::Apply>> work;
+        for (auto const& tx : txs)
+            work.emplace_back(tx->getTransactionID(), applier(tx));
+
+        OpenView parallel(*env.current());
+        SpeculativeApply speculation(parallel);
+        speculation.run(env.app().getJobQueue(), 4, work);
+        std::vector<std::pair<TER, bool>> results;
+        for (auto const& tx : txs)
+            results.push_back(speculation.apply(
+                parallel, tx->getTransactionID(), applier(tx)));
+
+        BEAST_EXPECT(results == expected);
+        BEAST_EXPECT(parallel.txCount() == serial.txCount());
+        BEAST_EXPECT(state(parallel) == state(serial));
+        BEAST_EXPECT(parallel.info().drops == serial.info().drops);
+
+        // Including the place of each transaction in its metadata
+        auto const expectedMeta = metadata(serial);
+        BEAST_EXPECT(expectedMeta.size() == serial.txCount());
+        BEAST_EXPECT(metadata(parallel) == expectedMeta);
+        std::set<std::uint32_t> indexes;
+        for (auto const& [tx, meta] : parallel.txs)
+            indexes.insert(meta->getFieldU32(sfTransactionIndex));
+        BEAST_EXPECT(indexes.size() == parallel.txCount());
+        BEAST_EXPECT(
+            !indexes.empty() && *indexes.rbegin() + 1 == indexes.size());
+
+        // The payments were merged.  The offers in one book, and the
+        // transactions which follow others, were applied again.
+        BEAST_EXPECT(speculation.merged() >= 19);
+        BEAST_EXPECT(speculation.conflicts() >= 2);
+        BEAST_EXPECT(
+            speculation.merged() + speculation.conflicts() ==
+            txs.size() - 1);
+    }
+
+    void
+    testQueue()
+    {
+        testcase("Queue");
+
+        using namespace jtx;
+        auto const close = [&](int workers) {
+            Env env(*this, config(20, workers));
+            auto const accounts = fund(env, 40, 20, 9);
+            BEAST_EXPECT(submit(env, accounts) > 0);
+            env.close();
+            env.close();
+            return std::make_pair(
+                env.closed()->info().accountHash,
+                env.app().getTxQ().getMetrics(*env.current()).txCount);
+        };
+        BEAST_EXPECT(close(1) == close(4));
+    }
+
+public:
+    void
+    run() override
+    {
+        testDeterminism();
+        testQueue();
+    }
+};
+
+// Filling new open ledgers from a large queue of independent payments and
+// crossing offers, one transaction after another and in parallel.
+class SpeculativeApplyBenchmark_test : public SpeculativeApply_test
+{
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        using clock = std::chrono::steady_clock;
+        using ms = std::chrono::duration<double, std::milli>;
+
+        for (int workers : {1, 2, 4, 8})
+        {
+            Env env(*this, config(200, workers));
+            auto const accounts = fund(env, 2000, 200, 99);
+            auto const queued = submit(env, accounts);
+
+            ms elapsed{};
+            std::size_t applied = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                auto const start = clock::now();
+                env.close();
+                elapsed += clock::now() - start;
+                applied += env.current()->txCount();
+            }
+            log << workers << " workers: " << applied << " of " << queued
+                << " queued transactions in " << elapsed.count() << " ms"
+                << std::endl;
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(SpeculativeApply, app, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(SpeculativeApplyBenchmark, app, ripple);
+
+}  // namespace test
+}  // namespace ripple
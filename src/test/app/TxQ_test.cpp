@@ -17,7 +17,10 @@
 */
 //==============================================================================
 
+#include <ripple/app/ledger/LedgerMaster.h>
+#include <ripple/app/ledger/OpenLedger.h>
 #include <ripple/app/main/Application.h>
+#include <ripple/app/misc/CanonicalTXSet.h>
 #include <ripple/app/misc/LoadFeeTrack.h>
 #include <ripple/app/misc/TxQ.h>
 #include <ripple/app/tx/apply.h>
@@ -32,6 +35,8 @@
 #include <test/jtx/envconfig.h>
 #include <test/jtx/ticket.h>
 
+#include <chrono>
+
 namespace ripple {
 
 namespace test {
@@ -4630,6 +4635,84 @@ public:
         }
     }
 
+    void
+    testOpenLedgerRebuild()
+    {
+        using namespace jtx;
+        testcase("open ledger rebuild");
+
+        Env env(*this, makeConfig({{"minimum_txn_in_ledger_standalone", "3"}}));
+
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        env.fund(XRP(1000000), noripple(alice, bob));
+        env.close();
+        auto const rebuilds =
+            env.app().openLedger().getJson()[jss::count].asUInt();
+
+        // Fill the open ledger, and queue a transaction behind it
+        fillQueue(env, alice);
+        env(noop(bob), ter(terQUEUED));
+        checkMetrics(env, 1, 6, 4, 3, 256);
+        auto const hits = env.app().getTxQ().preflightHits();
+
+        // The local transactions are applied again to the new open ledger,
+        // without preflight.  The queued one is applied as before.
+        env.close();
+        BEAST_EXPECT(env.app().getTxQ().preflightHits() > hits);
+        BEAST_EXPECT(
+            env.app().getTxQ().getMetrics(*env.current()).txCount == 0);
+        BEAST_EXPECT(env.current()->txCount() == 1);
+
+        auto const server_info = env.rpc("server_info");
+        auto const& info = server_info[jss::result][jss::info];
+        if (!BEAST_EXPECT(info.isMember(jss::open_ledger_rebuild)))
+            return;
+        auto const& rebuild = info[jss::open_ledger_rebuild];
+        BEAST_EXPECT(rebuild[jss::count].asUInt() > rebuilds);
+        BEAST_EXPECT(rebuild[jss::ledger_index] == env.closed()->seq());
+        BEAST_EXPECT(rebuild[jss::transactions] == 1);
+        BEAST_EXPECT(rebuild[jss::preflights_cached].asUInt() > 0);
+        BEAST_EXPECT(rebuild.isMember(jss::duration_us));
+        BEAST_EXPECT(rebuild.isMember(jss::average_duration_us));
+        BEAST_EXPECT(rebuild[jss::retries_skipped] == 0);
+
+        // A transaction to retry is skipped by a retry pass if nothing was
+        // applied since it last failed.  With a zero salt, the retries are
+        // in the order of their accounts.
+        auto const [first, second] = alice.id() < bob.id()
+            ? std::make_pair(alice, bob)
+            : std::make_pair(bob, alice);
+        env.close();
+        BEAST_EXPECT(env.current()->txCount() == 0);
+        auto const succeeds = env.jt(noop(first)).stx;
+        auto const early =
+            env.jt(noop(second), seq(env.seq(second) + 1)).stx;
+        CanonicalTXSet retries(uint256{});
+        retries.insert(early);
+        retries.insert(succeeds);
+
+        auto const closed = env.app().getLedgerMaster().getClosedLedger();
+        env.app().openLedger().accept(
+            env.app(),
+            env.current()->rules(),
+            closed,
+            CanonicalTXSet(uint256{}),
+            true,
+            retries,
+            tapNONE);
+
+        // The first pass applied one and left the other to retry.  The
+        // next, with tapRETRY, skipped it.  The final pass, without
+        // tapRETRY, tried it again.
+        auto const skipped = env.app().openLedger().getJson();
+        BEAST_EXPECT(skipped[jss::ledger_index] == closed->seq());
+        BEAST_EXPECT(skipped[jss::retries_skipped] == 1);
+        BEAST_EXPECT(env.current()->txExists(succeeds->getTransactionID()));
+        BEAST_EXPECT(!env.current()->txExists(early->getTransactionID()));
+        BEAST_EXPECT(retries.size() == 1);
+    }
+
     void
     run() override
     {
@@ -4670,6 +4753,7 @@ public:
         testReexecutePreflight();
         testQueueFullDropPenalty();
         testCancelQueuedOffers();
+        testOpenLedgerRebuild();
     }
 };
 
@@ -4682,8 +4766,146 @@ class TxQ2_test : public TxQ1_test
     }
 };
 
+// Queueing, evicting and accepting transactions with tens of thousands of
+// them in the queue, spread over a few fee levels.
+class TxQBenchmark_test : public beast::unit_test::suite
+{
+    using clock = std::chrono::steady_clock;
+    using ms = std::chrono::duration<double, std::milli>;
+
+    static constexpr std::size_t perLedger = 500;
+    static constexpr std::size_t perAccount = 10;
+
+    // Signed transactions whose signatures the server takes as checked,
+    // so that the queue's own work is what is timed
+    static std::vector<std::shared_ptr<STTx const>>
+    transactions(
+        jtx::Env& env,
+        std::vector<jtx::Account> const& accounts,
+        std::uint64_t extraFee,
+        std::uint64_t feeLevels)
+    {
+        using namespace jtx;
+        std::vector<std::shared_ptr<STTx const>> txs;
+        for (std::size_t n = 0; n < perAccount; ++n)
+        {
+            for (std::size_t i = 0; i < accounts.size(); ++i)
+            {
+                auto const& account = accounts[i];
+                auto const drops =
+                    10 + extraFee + (i * perAccount + n) % feeLevels;
+                auto const tx =
+                    env.jt(noop(account),
+                           seq(env.seq(account) + n),
+                           fee(drops))
+                        .stx;
+                forceValidity(
+                    env.app().getHashRouter(),
+                    tx->getTransactionID(),
+                    Validity::Valid);
+                txs.push_back(tx);
+            }
+        }
+        return txs;
+    }
+
+    static std::size_t
+    submit(jtx::Env& env, std::vector<std::shared_ptr<STTx const>> const& txs)
+    {
+        std::size_t queued = 0;
+        for (auto const& tx : txs)
+        {
+            env.app().openLedger().modify(
+                [&](OpenView& view, beast::Journal j) {
+                    auto const result = env.app().getTxQ().apply(
+                        env.app(), view, tx, tapNONE, j);
+                    if (result.first == terQUEUED)
+                        ++queued;
+                    return result.second;
+                });
+        }
+        return queued;
+    }
+
+    static std::vector<jtx::Account>
+    fund(jtx::Env& env, std::string const& prefix, std::size_t count)
+    {
+        using namespace jtx;
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            accounts.emplace_back(prefix + std::to_string(i));
+            env.fund(XRP(100000), noripple(accounts.back()));
+            if (accounts.size() % (perLedger / 2) == 0)
+                env.close();
+        }
+        env.close();
+        return accounts;
+    }
+
+    void
+    measure(std::size_t queueSize, std::uint64_t feeLevels)
+    {
+        using namespace jtx;
+
+        auto cfg = envconfig();
+        auto& section = cfg->section("transaction_queue");
+        section.set(
+            "minimum_txn_in_ledger_standalone", std::to_string(perLedger));
+        section.set("minimum_queue_size", std::to_string(queueSize));
+        section.set("ledgers_in_queue", "1");
+        section.set("maximum_txn_per_account", std::to_string(perAccount));
+        section.set("normal_consensus_increase_percent", "0");
+        Env env(*this, std::move(cfg));
+
+        auto const low = fund(env, "low", queueSize / perAccount);
+        auto const high = fund(env, "high", queueSize / perAccount / 4);
+        auto const lowTxs = transactions(env, low, 0, feeLevels);
+        auto const highTxs = transactions(env, high, feeLevels, feeLevels);
+
+        // Fill the open ledger, so that the rest is queued
+        auto const metrics = env.app().getTxQ().getMetrics(*env.current());
+        for (auto i = metrics.txInLedger; i <= metrics.txPerLedger; ++i)
+            env(noop(Account::master));
+
+        auto start = clock::now();
+        auto const queued = submit(env, lowTxs);
+        ms const queueing = clock::now() - start;
+
+        // The queue is full, so these push the cheapest ones out
+        start = clock::now();
+        auto const evicting = submit(env, highTxs);
+        ms const eviction = clock::now() - start;
+
+        start = clock::now();
+        env.close();
+        ms const accept = clock::now() - start;
+
+        log << queueSize << " at " << feeLevels
+            << " fee levels queued: " << queued << " in " << queueing.count()
+            << " ms, " << evicting << " evicting others in "
+            << eviction.count() << " ms, close with "
+            << env.current()->txCount() << " accepted in " << accept.count()
+            << " ms" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        for (std::size_t queueSize : {2000, 20000, 50000})
+        {
+            measure(queueSize, 16);
+            // Every transaction at a fee level of its own
+            measure(queueSize, queueSize);
+        }
+        pass();
+    }
+};
+
 BEAST_DEFINE_TESTSUITE_PRIO(TxQ1, app, ripple, 1);
 BEAST_DEFINE_TESTSUITE_PRIO(TxQ2, app, ripple, 1);
+BEAST_DEFINE_TESTSUITE_MANUAL(TxQBenchmark, app, ripple);
 
 }  // namespace test
 }  // namespace ripple
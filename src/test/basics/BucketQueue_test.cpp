@@ -0,0 +1,284 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/BucketQueue.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/intrusive/set.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+namespace {
+
+struct Item
+{
+    int level;
+    int id;
+    boost::intrusive::list_member_hook<> listHook;
+    boost::intrusive::set_member_hook<> lastHook;
+    boost::intrusive::set_member_hook<> setHook;
+};
+
+struct LevelOf
+{
+    int
+    operator()(Item const& item) const
+    {
+        return item.level;
+    }
+};
+
+struct Greater
+{
+    bool
+    operator()(Item const& lhs, Item const& rhs) const
+    {
+        return lhs.level > rhs.level;
+    }
+};
+
+using Queue = BucketQueue<
+    Item,
+    int,
+    LevelOf,
+    boost::intrusive::member_hook<
+        Item,
+        boost::intrusive::list_member_hook<>,
+        &Item::listHook>,
+    boost::intrusive::member_hook<
+        Item,
+        boost::intrusive::set_member_hook<>,
+        &Item::lastHook>>;
+
+// The order BucketQueue keeps
+using MultiSet = boost::intrusive::multiset<
+    Item,
+    boost::intrusive::member_hook<
+        Item,
+        boost::intrusive::set_member_hook<>,
+        &Item::setHook>,
+    boost::intrusive::compare<Greater>>;
+
+}  // namespace
+
+class BucketQueue_test : public beast::unit_test::suite
+{
+    static std::vector<int>
+    ids(Queue const& queue)
+    {
+        std::vector<int> result;
+        for (auto const& item : queue)
+            result.push_back(item.id);
+        return result;
+    }
+
+    static std::vector<int>
+    ids(MultiSet const& set)
+    {
+        std::vector<int> result;
+        for (auto const& item : set)
+            result.push_back(item.id);
+        return result;
+    }
+
+    void
+    testOrder()
+    {
+        testcase("Order");
+
+        std::list<Item> items;
+        Queue queue;
+        BEAST_EXPECT(queue.empty());
+        BEAST_EXPECT(queue.begin() == queue.end());
+        for (auto [level, id] : {std::pair{1, 0}, {3, 1}, {1, 2}, {2, 3}})
+        {
+            items.push_back({level, id, {}, {}, {}});
+            queue.insert(items.back());
+        }
+        BEAST_EXPECT(queue.size() == 4);
+        BEAST_EXPECT((ids(queue) == std::vector<int>{1, 3, 0, 2}));
+        BEAST_EXPECT(queue.rbegin()->id == 2);
+        BEAST_EXPECT(std::prev(queue.end())->id == 2);
+
+        // Removing the only item of a level moves on to the next level
+        auto next = queue.erase(queue.iterator_to(*std::next(items.begin())));
+        BEAST_EXPECT(next->id == 3);
+        next = queue.erase(next);
+        BEAST_EXPECT(next->id == 0);
+        Queue const& constQueue = queue;
+        BEAST_EXPECT(constQueue.begin() == next);
+        BEAST_EXPECT(next == constQueue.iterator_to(items.front()));
+        next = queue.erase(std::next(next));
+        BEAST_EXPECT(next == queue.end());
+        BEAST_EXPECT((ids(queue) == std::vector<int>{0}));
+
+        // Removing the last item of a level leaves the one before it last
+        items.push_back({1, 4, {}, {}, {}});
+        BEAST_EXPECT(queue.insert(items.back())->id == 4);
+        items.push_back({2, 5, {}, {}, {}});
+        queue.insert(items.back());
+        BEAST_EXPECT((ids(queue) == std::vector<int>{5, 0, 4}));
+
+        queue.clear();
+        BEAST_EXPECT(queue.empty());
+        BEAST_EXPECT(queue.begin() == queue.end());
+    }
+
+    void
+    testRandom(unsigned int levels)
+    {
+        testcase("Random, " + std::to_string(levels) + " levels");
+
+        std::mt19937 gen(42);
+        std::list<Item> items;
+        Queue queue;
+        MultiSet set;
+        int id = 0;
+        for (int i = 0; i < 10000; ++i)
+        {
+            if (items.empty() || gen() % 3 != 0)
+            {
+                items.push_back(
+                    {static_cast<int>(gen() % levels), id++, {}, {}, {}});
+                queue.insert(items.back());
+                set.insert(items.back());
+            }
+            else
+            {
+                auto iter = items.begin();
+                std::advance(iter, gen() % items.size());
+                auto const q = queue.erase(queue.iterator_to(*iter));
+                auto const s = set.erase(set.iterator_to(*iter));
+                BEAST_EXPECT((q == queue.end()) == (s == set.end()));
+                if (q != queue.end() && s != set.end())
+                    BEAST_EXPECT(q->id == s->id);
+                items.erase(iter);
+            }
+
+            if (i % 500 == 0)
+            {
+                BEAST_EXPECT(queue.size() == set.size());
+                BEAST_EXPECT(ids(queue) == ids(set));
+                std::vector<int> reversed;
+                for (auto r = queue.rbegin(); r != queue.rend(); ++r)
+                    reversed.push_back(r->id);
+                auto expected = ids(set);
+                std::reverse(expected.begin(), expected.end());
+                BEAST_EXPECT(reversed == expected);
+            }
+        }
+        queue.clear();
+        set.clear();
+    }
+
+public:
+    void
+    run() override
+    {
+        testOrder();
+        testRandom(20);
+        // Nearly every level distinct
+        testRandom(1u << 30);
+    }
+};
+
+// Times what TxQ does with its queue by fee level, against the multiset
+// it replaced: queueing transactions, evicting the cheapest for better
+// ones, and taking the best into the next open ledger
+class BucketQueueBenchmark_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class Container>
+    static std::chrono::microseconds
+    measure(std::vector<int> const& levels)
+    {
+        std::size_t const queued = levels.size() * 4 / 5;
+        std::vector<Item> items(levels.size());
+        for (std::size_t i = 0; i < items.size(); ++i)
+            items[i].level = levels[i];
+
+        Container container;
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < queued; ++i)
+            container.insert(items[i]);
+        for (std::size_t i = queued; i < items.size(); ++i)
+        {
+            container.erase(container.iterator_to(*container.rbegin()));
+            container.insert(items[i]);
+        }
+        for (auto iter = container.begin();
+             container.size() > queued / 2 && iter != container.end();)
+            iter = container.erase(container.iterator_to(*iter));
+        auto const elapsed =
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                clock_type::now() - start);
+        container.clear();
+        return elapsed;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 50000;
+        if (!arg().empty())
+            count = beast::lexicalCastThrow<std::size_t>(arg());
+        std::size_t const repeat = 10;
+
+        for (unsigned int const spread : {16u, 1000u, 1u << 30})
+        {
+            std::mt19937 gen(spread);
+            std::vector<int> levels(count);
+            for (auto& level : levels)
+                level = gen() % spread;
+            // The evicting ones pay more
+            for (auto i = levels.size() * 4 / 5; i < levels.size(); ++i)
+                levels[i] += spread;
+
+            auto queue = std::chrono::microseconds::max();
+            auto set = std::chrono::microseconds::max();
+            for (std::size_t i = 0; i < repeat; ++i)
+            {
+                queue = std::min(queue, measure<Queue>(levels));
+                set = std::min(set, measure<MultiSet>(levels));
+            }
+            log << std::left << std::setw(12)
+                << (spread < count ? std::to_string(spread) : "distinct")
+                << std::right << "  BucketQueue " << std::setw(7)
+                << queue.count() << " us  multiset " << std::setw(7)
+                << set.count() << " us" << std::endl;
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BucketQueue, basics, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(BucketQueueBenchmark, basics, ripple);
+
+}  // namespace test
+}  // namespace ripple
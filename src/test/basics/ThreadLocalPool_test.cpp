@@ -0,0 +1,179 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/ThreadLocalPool.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace ripple {
+namespace test {
+
+class ThreadLocalPool_test : public beast::unit_test::suite
+{
+    void
+    testReuse()
+    {
+        testcase("Reuse");
+
+        auto const before = ThreadLocalPool::stats();
+
+        // Requests of the same size class share blocks
+        auto const p = ThreadLocalPool::allocate(40);
+        std::memset(p, 0xAB, 40);
+        ThreadLocalPool::deallocate(p, 40);
+        auto const q = ThreadLocalPool::allocate(48);
+        BEAST_EXPECT(q == p);
+
+        // Others don't
+        auto const r = ThreadLocalPool::allocate(100);
+        BEAST_EXPECT(r != p);
+        ThreadLocalPool::deallocate(q, 48);
+        ThreadLocalPool::deallocate(r, 100);
+
+        // Large requests bypass the caches
+        auto const large = ThreadLocalPool::maxSize + 1;
+        ThreadLocalPool::deallocate(ThreadLocalPool::allocate(large), large);
+
+        auto const after = ThreadLocalPool::stats();
+        BEAST_EXPECT(after.requests - before.requests == 4);
+        BEAST_EXPECT(after.allocations - before.allocations <= 3);
+    }
+
+    void
+    testLargeClasses()
+    {
+        testcase("Large classes");
+
+        // Large size classes are a quarter of a power of two apart, so
+        // nearby sizes, like the field lists of a transaction, share blocks.
+        for (std::size_t const size : {1900, 2000, 5000})
+        {
+            auto const p = ThreadLocalPool::allocate(size);
+            std::memset(p, 0xAB, size);
+            ThreadLocalPool::deallocate(p, size);
+            auto const q = ThreadLocalPool::allocate(size - 100);
+            BEAST_EXPECT(q == p);
+            ThreadLocalPool::deallocate(q, size - 100);
+        }
+
+        auto const p = ThreadLocalPool::allocate(1100);
+        ThreadLocalPool::deallocate(p, 1100);
+        auto const q = ThreadLocalPool::allocate(1300);
+        BEAST_EXPECT(q != p);
+        ThreadLocalPool::deallocate(q, 1300);
+
+        // The largest class is still served from the cache
+        auto const before = ThreadLocalPool::stats();
+        for (int i = 0; i < 10; ++i)
+        {
+            auto const r = ThreadLocalPool::allocate(ThreadLocalPool::maxSize);
+            ThreadLocalPool::deallocate(r, ThreadLocalPool::maxSize);
+        }
+        auto const after = ThreadLocalPool::stats();
+        BEAST_EXPECT(after.requests - before.requests == 10);
+        BEAST_EXPECT(after.allocations - before.allocations <= 1);
+    }
+
+    void
+    testDisabled()
+    {
+        testcase("Disabled");
+
+        ThreadLocalPool::enable(false);
+        BEAST_EXPECT(!ThreadLocalPool::enabled());
+
+        auto const before = ThreadLocalPool::stats();
+        for (int i = 0; i < 10; ++i)
+        {
+            auto const p = ThreadLocalPool::allocate(64);
+            ThreadLocalPool::deallocate(p, 64);
+        }
+        auto const after = ThreadLocalPool::stats();
+        BEAST_EXPECT(after.requests - before.requests == 10);
+        BEAST_EXPECT(after.allocations - before.allocations == 10);
+
+        ThreadLocalPool::enable(true);
+        BEAST_EXPECT(ThreadLocalPool::enabled());
+    }
+
+    void
+    testThreads()
+    {
+        testcase("Threads");
+
+        // Blocks allocated by one thread can be freed by another, which
+        // then reuses them.
+        std::vector<void*> blocks;
+        std::thread([&]() {
+            for (int i = 0; i < 16; ++i)
+                blocks.push_back(ThreadLocalPool::allocate(32));
+        }).join();
+
+        std::vector<void*> reused;
+        std::thread([&]() {
+            for (auto p : blocks)
+                ThreadLocalPool::deallocate(p, 32);
+            for (int i = 0; i < 16; ++i)
+                reused.push_back(ThreadLocalPool::allocate(32));
+            for (auto p : reused)
+                ThreadLocalPool::deallocate(p, 32);
+        }).join();
+
+        std::sort(blocks.begin(), blocks.end());
+        std::sort(reused.begin(), reused.end());
+        BEAST_EXPECT(blocks == reused);
+    }
+
+    void
+    testAllocator()
+    {
+        testcase("Allocator");
+
+        std::vector<std::uint64_t, PoolAllocator<std::uint64_t>> v;
+        for (std::uint64_t i = 0; i < 40; ++i)
+            v.push_back(i);
+        auto copy = v;
+        BEAST_EXPECT(copy == v);
+        BEAST_EXPECT(PoolAllocator<int>{} == PoolAllocator<char>{});
+
+        // Freed by a thread which did not allocate it
+        std::thread([v = std::move(v)]() mutable { decltype(v){}.swap(v); })
+            .join();
+        BEAST_EXPECT(copy.size() == 40);
+    }
+
+public:
+    void
+    run() override
+    {
+        testReuse();
+        testLargeClasses();
+        testDisabled();
+        testThreads();
+        testAllocator();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ThreadLocalPool, basics, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -34,11 +34,14 @@ protected:
     std::unique_ptr<Json::Writer> writer_;
 
     void
-    setup(std::string const& testName)
+    setup(
+        std::string const& testName,
+        Json::Writer::Format format = Json::Writer::Format::json)
     {
         testcase(testName);
         output_.clear();
-        writer_ = std::make_unique<Json::Writer>(Json::stringOutput(output_));
+        writer_ = std::make_unique<Json::Writer>(
+            Json::stringOutput(output_), format);
     }
 
     // Test the result and report values.
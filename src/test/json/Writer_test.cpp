@@ -21,6 +21,7 @@
 #include <ripple/json/Writer.h>
 #include <ripple/json/json_writer.h>
 #include <test/json/TestOutputSuite.h>
+#include <limits>
 
 namespace Json {
 
@@ -195,6 +196,137 @@ public:
         expectResult("{\"hello\":{\"foo\":23}}");
     }
 
+    void
+    testBytes()
+    {
+        setup("bytes");
+        std::uint8_t const bytes[] = {0x01, 0x02, 0xab};
+        writer_->output(ripple::Slice(bytes, sizeof(bytes)));
+        expectResult("\"0102AB\"");
+
+        setup("decimal");
+        writer_->output(Writer::Decimal{27315, -2});
+        expectResult("27315e-2");
+
+        setup("integral decimal");
+        writer_->output(Writer::Decimal{-7, 0});
+        expectResult("-7");
+    }
+
+    // Test the CBOR output, as hex.
+    void
+    expectCBOR(std::string const& expected, std::string const& message = "")
+    {
+        writer_.reset();
+        expectEquals(ripple::strHex(output_), expected, message);
+    }
+
+    // The examples of RFC 8949, Appendix A.
+    void
+    testCBORPrimitives()
+    {
+        auto const cbor = Writer::Format::cbor;
+
+        setup("CBOR integers", cbor);
+        writer_->startRoot(Writer::array);
+        writer_->append(0);
+        writer_->append(23);
+        writer_->append(24);
+        writer_->append(100);
+        writer_->append(1000);
+        writer_->append(1000000);
+        writer_->append(std::uint64_t(1000000000000));
+        writer_->append(std::numeric_limits<std::uint64_t>::max());
+        writer_->append(-1);
+        writer_->append(-100);
+        writer_->append(-1000);
+        writer_->append(std::numeric_limits<std::int64_t>::min());
+        writer_->finish();
+        expectCBOR(
+            "9F0017181818641903E81A000F42401B000000E8D4A51000"
+            "1BFFFFFFFFFFFFFFFF2038633903E73B7FFFFFFFFFFFFFFFFF");
+
+        setup("CBOR simple values", cbor);
+        writer_->startRoot(Writer::array);
+        writer_->append(false);
+        writer_->append(true);
+        writer_->append(nullptr);
+        writer_->append(1.5);
+        writer_->append(1.5f);
+        writer_->finish();
+        expectCBOR("9FF4F5F6FB3FF8000000000000FA3FC00000FF");
+
+        setup("CBOR strings", cbor);
+        writer_->startRoot(Writer::array);
+        writer_->append("");
+        writer_->append("IETF");
+        writer_->append(std::string("\"\\"));
+        writer_->append(std::string(24, 'f'));
+        writer_->finish();
+        expectCBOR("9F60644945544662225C7818" + std::string(48, '6') + "FF");
+
+        // A string is a complete root, as in JSON
+        setup("CBOR root string", cbor);
+        writer_->output("a string");
+        try
+        {
+            writer_->output("another");
+            fail("output after a complete root");
+        }
+        catch (std::logic_error const&)
+        {
+            pass();
+        }
+        expectCBOR("686120737472696E67");
+    }
+
+    void
+    testCBORBytes()
+    {
+        auto const cbor = Writer::Format::cbor;
+
+        setup("CBOR bytes", cbor);
+        std::uint8_t const bytes[] = {0x01, 0x02, 0x03, 0x04};
+        writer_->output(ripple::Slice(bytes, sizeof(bytes)));
+        expectCBOR("4401020304");
+
+        setup("CBOR decimal", cbor);
+        writer_->output(Writer::Decimal{27315, -2});
+        expectCBOR("C48221196AB3");
+    }
+
+    void
+    testCBORCollections()
+    {
+        auto const cbor = Writer::Format::cbor;
+
+        setup("CBOR empty collections", cbor);
+        writer_->startRoot(Writer::array);
+        writer_->startAppend(Writer::array);
+        writer_->finish();
+        writer_->startAppend(Writer::object);
+        writer_->finishAll();
+        expectCBOR("9F9FFFBFFFFF");
+
+        setup("CBOR object", cbor);
+        writer_->startRoot(Writer::object);
+        writer_->set("a", 1);
+        writer_->startSet(Writer::array, "b");
+        writer_->append(2);
+        writer_->append(3);
+        writer_->finishAll();
+        expectCBOR("BF61610161629F0203FFFF");
+
+        setup("CBOR Json::Value", cbor);
+        Json::Value value(Json::objectValue);
+        value["foo"] = 23;
+        value["bar"][0u] = "baz";
+        writer_->startRoot(Writer::object);
+        writer_->set("hello", value);
+        writer_->finish();
+        expectCBOR("BF6568656C6C6FBF63626172" "9F6362617AFF" "63666F6F17FFFF");
+    }
+
     void
     run() override
     {
@@ -209,6 +341,10 @@ public:
         testObject();
         testComplexObject();
         testJson();
+        testBytes();
+        testCBORPrimitives();
+        testCBORBytes();
+        testCBORCollections();
     }
 };
 
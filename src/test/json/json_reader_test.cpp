@@ -0,0 +1,338 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/impl/json_scan.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/json_writer.h>
+
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+namespace ripple {
+
+namespace {
+
+// Requests as received by the servers, with the secrets replaced.
+char const* const submitRequest =
+    R"({"method":"submit","params":[{"secret":"snoPBrXtMeMyMHUVTgbuqAfg1SUTb",)"
+    R"("fee_mult_max":1000,"tx_json":{"TransactionType":"Payment",)"
+    R"("Account":"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh",)"
+    R"("Destination":"rPEPPER7kfTD9w2To4CQk6UCfuHM9c6GDY",)"
+    R"("Amount":{"currency":"USD","value":"1.5",)"
+    R"("issuer":"rvYAfWj5gh67oV6fW32ZzP3Aw4Eubs59B"},"Fee":"12",)"
+    R"("Flags":2147483648,"Sequence":42,"LastLedgerSequence":65000123,)"
+    R"("Memos":[{"Memo":{"MemoType":"687474703A2F2F6578616D706C652E636F6D)"
+    R"(2F6D656D6F2F67656E65726963","MemoData":"72656E74"}}]}}]})";
+
+char const* const submitBlobRequest =
+    R"({"id":7,"command":"submit","tx_blob":"1200002280000000240000002A201B03)"
+    R"(DFE1BB61D4838D7EA4C6800000000000000000000000000055534400000000004B4E)"
+    R"(9C06F24296074F7BC48F92A97916C6DC5EA968400000000000000C732103AB40A0490)"
+    R"(F9B7ED8DF29D246BF2D6269820A0EE7742ACDD457BEA7C7D0931EDB74473045022100)"
+    R"(D184EB4AE5956FF600E7536EE459345C7BBCF097A84CC61A93B9AF7197EDB98702201)"
+    R"(CEA8009B7BEEBAA2AACC0359B41C427C1C5B550A4CA4B80CF2174AF2D6D5DCE8114B5)"
+    R"(F762798A53D543A014CAF8B297CFF8F2F937E883146AF9F9A9CD2B5A4A51B21AAD08)"
+    R"(F59A11EBB3C57F9EA7C1F9EA0A3F94"})";
+
+char const* const accountLinesRequest =
+    R"({"id":2,"command":"account_lines",)"
+    R"("account":"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh",)"
+    R"("ledger_index":"validated","limit":200,"marker":)"
+    R"("9CF2C9B5CF1D2BB9A3E8BD8D6A9EAE47B30B1DB6DB0D8D39C5A5E9E2F5A1B7C2,0"})";
+
+char const* const pathFindRequest = R"({
+    "id": 8,
+    "command": "path_find",
+    "subcommand": "create",
+    "source_account": "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh",
+    "destination_account": "rPEPPER7kfTD9w2To4CQk6UCfuHM9c6GDY",
+    "destination_amount": {
+        "value": "0.001",
+        "currency": "USD",
+        "issuer": "rvYAfWj5gh67oV6fW32ZzP3Aw4Eubs59B"
+    },
+    "source_currencies": [
+        { "currency": "XRP" },
+        { "currency": "USD", "issuer": "rvYAfWj5gh67oV6fW32ZzP3Aw4Eubs59B" },
+        { "currency": "EUR", "issuer": "rhub8VRN55s94qWKDv6jmDy1pUykJzF3wq" }
+    ]
+})";
+
+}  // namespace
+
+class json_reader_test : public beast::unit_test::suite
+{
+    // The kernels must agree with the scalar loops for every length and
+    // every position of the character they stop at.  Each text is copied
+    // into a buffer of exactly its size, so that a sanitizer will notice a
+    // read past the end.
+    void
+    testKernels()
+    {
+        testcase("Scanning kernels");
+
+        auto check = [this](std::string const& text) {
+            std::unique_ptr<char[]> const buffer(new char[text.size() + 1]);
+            std::copy(text.begin(), text.end(), buffer.get());
+            char const* const first = buffer.get();
+            char const* const last = first + text.size();
+            for (auto p = first; p <= last; ++p)
+            {
+                BEAST_EXPECT(
+                    Json::detail::findQuoteOrEscape(p, last) ==
+                    Json::detail::findQuoteOrEscapeScalar(p, last));
+                BEAST_EXPECT(
+                    Json::detail::skipSpaces(p, last) ==
+                    Json::detail::skipSpacesScalar(p, last));
+            }
+        };
+
+        for (std::size_t size = 0; size <= 80; ++size)
+        {
+            check(std::string(size, 'a'));
+            check(std::string(size, ' '));
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                for (char const c : {'"', '\\'})
+                {
+                    std::string text(size, 'a');
+                    text[i] = c;
+                    check(text);
+                }
+                for (char const c : {'a', '\0', '\x80', '\x0b'})
+                {
+                    std::string text(size, "\t\n\r "[i % 4]);
+                    text[i] = c;
+                    check(text);
+                }
+            }
+        }
+    }
+
+    void
+    testStrings()
+    {
+        testcase("Strings");
+
+        // Escapes on either side of each vector boundary
+        for (std::size_t i = 0; i < 70; ++i)
+        {
+            std::string const prefix(i, 'x');
+            std::string const text = "[\"" + prefix + "\\\"\\\\\\n\\u00e9" +
+                prefix + "\", \"" + prefix + "\"]";
+            Json::Value parsed;
+            BEAST_EXPECT(Json::Reader().parse(text, parsed));
+            BEAST_EXPECT(
+                parsed[0u].asString() == prefix + "\"\\\n\xc3\xa9" + prefix);
+            BEAST_EXPECT(parsed[1u].asString() == prefix);
+        }
+
+        // Strings which don't end
+        for (std::string const text : {"[\"abc", "[\"abc\\", "[\"abc\\\""})
+        {
+            Json::Value parsed;
+            BEAST_EXPECT(!Json::Reader().parse(text, parsed));
+        }
+
+        // A zero inside a string doesn't end the string
+        {
+            std::string const text("[\"a\0b\",\"c\"]", 11);
+            Json::Value parsed;
+            BEAST_EXPECT(Json::Reader().parse(text, parsed));
+            BEAST_EXPECT(parsed.size() == 2);
+            BEAST_EXPECT(parsed[1u] == "c");
+        }
+
+        // Whitespace and comments between tokens
+        {
+            std::string const text = std::string(40, ' ') + "{\n\t\t\"a\"" +
+                std::string(33, '\t') + ": [ 1 , /* one */ 2 ]\r\n// end\n}" +
+                std::string(17, '\n');
+            Json::Value parsed;
+            BEAST_EXPECT(Json::Reader().parse(text, parsed));
+            BEAST_EXPECT(Json::FastWriter().write(parsed) == "{\"a\":[1,2]}");
+        }
+    }
+
+    void
+    testErrors()
+    {
+        testcase("Errors");
+
+        auto expectError = [this](std::string const& text,
+                                  std::string const& message) {
+            Json::Value parsed;
+            Json::Reader reader;
+            BEAST_EXPECT(!reader.parse(text, parsed));
+            BEAST_EXPECTS(
+                reader.getFormatedErrorMessages() == message,
+                reader.getFormatedErrorMessages());
+        };
+
+        expectError(
+            R"({"a":1,"a":2})",
+            "* Line 1, Column 8\n  Key 'a' appears twice.\n");
+        expectError(
+            "{\"a\":\"abc\\u12\"}",
+            "* Line 1, Column 6\n  Bad unicode escape sequence in string: "
+            "four digits expected.\nSee Line 1, Column 12 for detail.\n");
+        expectError(
+            "{\"a\":\n\"b\\q\"}",
+            "* Line 2, Column 1\n  Bad escape sequence in string\n"
+            "See Line 2, Column 5 for detail.\n");
+        expectError(
+            R"({"a":"abc)",
+            "* Line 1, Column 6\n"
+            "  Syntax error: value, object or array expected.\n");
+        expectError(
+            "[1,\n  2 3]",
+            "* Line 2, Column 5\n  Missing ',' or ']' in array declaration\n");
+
+        // A duplicate doesn't change the member already read
+        Json::Value parsed;
+        Json::Reader().parse(R"({"a":1,"b":2,"a":3})", parsed);
+        BEAST_EXPECT(parsed.size() == 2);
+        BEAST_EXPECT(parsed["a"] == 1);
+    }
+
+    void
+    testRequests()
+    {
+        testcase("Requests");
+
+        for (auto const request :
+             {submitRequest,
+              submitBlobRequest,
+              accountLinesRequest,
+              pathFindRequest})
+        {
+            Json::Value parsed;
+            BEAST_EXPECT(Json::Reader().parse(request, parsed));
+            BEAST_EXPECT(parsed.isObject());
+
+            // Writing and reading again gives the same value
+            Json::Value again;
+            BEAST_EXPECT(
+                Json::Reader().parse(Json::FastWriter().write(parsed), again));
+            BEAST_EXPECT(again == parsed);
+        }
+
+        Json::Value parsed;
+        Json::Reader().parse(submitRequest, parsed);
+        auto const& tx = parsed["params"][0u]["tx_json"];
+        BEAST_EXPECT(tx["Account"] == "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh");
+        BEAST_EXPECT(tx["Amount"]["value"] == "1.5");
+        BEAST_EXPECT(tx["Flags"].asUInt() == 2147483648u);
+        BEAST_EXPECT(tx["Memos"][0u]["Memo"]["MemoData"] == "72656E74");
+    }
+
+public:
+    void
+    run() override
+    {
+        testKernels();
+        testStrings();
+        testErrors();
+        testRequests();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_reader, json, ripple);
+
+//------------------------------------------------------------------------------
+
+/*  Measures parsing recorded requests, and the scanning kernels against
+    their scalar loops.
+
+    Usage:
+        rippled --unittest=JsonReaderBenchmark --unittest-arg=<count>
+*/
+class JsonReaderBenchmark_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    void
+    measure(std::string const& name, std::size_t count, F&& f)
+    {
+        std::uint64_t bytes = 0;
+        for (std::size_t i = 0; i < 100; ++i)
+            bytes += f();
+
+        bytes = 0;
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < count; ++i)
+            bytes += f();
+        auto const elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_type::now() - start);
+
+        std::ostringstream ss;
+        ss << std::left << std::setw(20) << name << std::right << std::fixed
+           << std::setprecision(1) << std::setw(10)
+           << double(elapsed.count()) / count << " ns/op" << std::setw(10)
+           << (elapsed.count() ? bytes * 1000.0 / elapsed.count() : 0.0)
+           << " MB/s";
+        log << ss.str() << std::endl;
+        BEAST_EXPECT(bytes != 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 100000;
+        if (!arg().empty())
+            count = beast::lexicalCastThrow<std::size_t>(arg());
+
+        std::pair<char const*, std::string> const requests[] = {
+            {"submit tx_json", submitRequest},
+            {"submit tx_blob", submitBlobRequest},
+            {"account_lines", accountLinesRequest},
+            {"path_find", pathFindRequest}};
+
+        Json::Reader reader;
+        for (auto const& [name, text] : requests)
+        {
+            measure(name, count, [&, &text = text]() {
+                Json::Value parsed;
+                reader.parse(text, parsed);
+                return text.size();
+            });
+        }
+
+        std::string const body(4096, 'A');
+        char const* const first = body.data();
+        char const* const last = first + body.size();
+        measure("string scalar", count / 10, [&]() {
+            return Json::detail::findQuoteOrEscapeScalar(first, last) - first;
+        });
+        measure("string vector", count / 10, [&]() {
+            return Json::detail::findQuoteOrEscape(first, last) - first;
+        });
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(JsonReaderBenchmark, json, ripple);
+
+}  // namespace ripple
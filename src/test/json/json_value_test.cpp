@@ -17,6 +17,7 @@
 */
 //==============================================================================
 
+#include <ripple/basics/ThreadLocalPool.h>
 #include <ripple/beast/core/LexicalCast.h>
 #include <ripple/beast/type_name.h>
 #include <ripple/beast/unit_test.h>
@@ -25,7 +26,12 @@
 #include <ripple/json/json_writer.h>
 
 #include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <random>
 #include <regex>
+#include <sstream>
+#include <thread>
 
 namespace ripple {
 
@@ -1372,6 +1378,195 @@ struct json_value_test : beast::unit_test::suite
         }
     }
 
+    void
+    test_storage()
+    {
+        {
+            // References stay valid while members are added and removed
+            Json::Value v;
+            auto& first = v["m"];
+            first = 1;
+            std::vector<Json::Value*> refs;
+            for (int i = 0; i < 100; ++i)
+            {
+                auto const key = std::to_string(i);
+                auto& member = v[key];
+                member = key;
+                refs.push_back(&member);
+            }
+            v.removeMember("50");
+            v["a"] = "added before the others";
+            BEAST_EXPECT(first == 1);
+            BEAST_EXPECT(&v["m"] == &first);
+            for (int i = 0; i < 100; ++i)
+            {
+                if (i != 50)
+                    BEAST_EXPECT(*refs[i] == std::to_string(i));
+            }
+            BEAST_EXPECT(v.size() == 101);
+            BEAST_EXPECT(!v.isMember("50"));
+
+            // Members are visited in key order, however they were added
+            auto const names = v.getMemberNames();
+            BEAST_EXPECT(std::is_sorted(names.begin(), names.end()));
+            BEAST_EXPECT(names.front() == "0" && names.back() == "m");
+            std::size_t count = 0;
+            for (auto it = v.begin(); it != v.end(); ++it)
+                BEAST_EXPECT(it.memberName() == names[count++]);
+            BEAST_EXPECT(count == names.size());
+
+            // Removed members can be added again
+            v["50"] = 50;
+            BEAST_EXPECT(v["50"] == 50);
+            BEAST_EXPECT(v.size() == 102);
+        }
+        {
+            // Arrays, including sparse ones
+            Json::Value a;
+            a[3u] = 3;
+            a[1u] = 1;
+            BEAST_EXPECT(a.size() == 4);
+            BEAST_EXPECT(a[0u].isNull());
+            BEAST_EXPECT(a[1u] == 1);
+            BEAST_EXPECT(a[3u] == 3);
+            BEAST_EXPECT(Json::FastWriter().write(a) == "[null,1,null,3]");
+
+            Json::Value b(Json::arrayValue);
+            for (int i = 0; i < 1000; ++i)
+                b.append(i);
+            BEAST_EXPECT(b.size() == 1000);
+            for (Json::UInt i = 0; i < 1000; ++i)
+                BEAST_EXPECT(b[i] == int(i));
+            int n = 0;
+            for (auto const& element : b)
+                BEAST_EXPECT(element == n++);
+            BEAST_EXPECT(n == 1000);
+
+            // Copies are independent and compare equal
+            Json::Value c = b;
+            BEAST_EXPECT(c == b);
+            c[999u] = "changed";
+            BEAST_EXPECT(c != b);
+            BEAST_EXPECT(b[999u] == 999);
+
+            b.clear();
+            BEAST_EXPECT(b.size() == 0);
+            BEAST_EXPECT(b.isArray());
+            b.append("again");
+            BEAST_EXPECT(b[0u] == "again");
+        }
+        {
+            // Member names which are not static strings are copied
+            Json::Value v;
+            {
+                std::string key = "a member name that will be overwritten";
+                v[key] = 1;
+                key.assign(key.size(), 'x');
+            }
+            BEAST_EXPECT(v["a member name that will be overwritten"] == 1);
+
+            Json::Value const copy = v;
+            v.clear();
+            BEAST_EXPECT(copy["a member name that will be overwritten"] == 1);
+        }
+    }
+
+    void
+    test_random_order()
+    {
+        // Enough members that most are not inserted into the index
+        std::vector<std::string> keys;
+        for (int i = 0; i < 5000; ++i)
+            keys.push_back(std::to_string(i * 7919 % 100003));
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+        Json::Value v(Json::objectValue);
+        Json::Value* first = nullptr;
+        for (auto const& key : keys)
+        {
+            BEAST_EXPECT(!v.isMember(key));
+            auto& member = v[key];
+            member = key;
+            if (!first)
+                first = &member;
+            BEAST_EXPECT(v.isMember(key));
+            BEAST_EXPECT(&v[key] == &member);
+        }
+        BEAST_EXPECT(v.size() == keys.size());
+        BEAST_EXPECT(*first == keys.front());
+        for (auto const& key : keys)
+            BEAST_EXPECT(v[key] == key);
+
+        // Iteration visits every member once, in key order
+        auto sorted = keys;
+        std::sort(sorted.begin(), sorted.end());
+        BEAST_EXPECT(v.getMemberNames() == sorted);
+        std::size_t count = 0;
+        for (auto it = v.begin(); it != v.end(); ++it)
+            BEAST_EXPECT(it.memberName() == sorted[count++]);
+        BEAST_EXPECT(count == sorted.size());
+
+        // The same members added in key order make an equal object
+        Json::Value ordered(Json::objectValue);
+        for (auto const& key : sorted)
+            ordered[key] = key;
+        BEAST_EXPECT(v == ordered);
+        BEAST_EXPECT(
+            Json::FastWriter().write(v) == Json::FastWriter().write(ordered));
+
+        // Members added and removed after iterating
+        v.removeMember(keys[10]);
+        BEAST_EXPECT(!v.isMember(keys[10]));
+        v["!added"] = 0;
+        v["zz added"] = 0;
+        BEAST_EXPECT(v.size() == keys.size() + 1);
+        auto names = v.getMemberNames();
+        BEAST_EXPECT(std::is_sorted(names.begin(), names.end()));
+        BEAST_EXPECT(names.front() == "!added" && names.back() == "zz added");
+
+        // Copies are sorted and independent
+        Json::Value copy = v;
+        copy.removeMember("zz added");
+        BEAST_EXPECT(v.isMember("zz added"));
+        BEAST_EXPECT(copy.size() == keys.size());
+
+        v.clear();
+        BEAST_EXPECT(v.size() == 0);
+        v["again"] = 1;
+        BEAST_EXPECT(v.getMemberNames().size() == 1);
+
+        // Array elements in random order
+        std::vector<Json::UInt> indexes(1000);
+        for (Json::UInt i = 0; i < indexes.size(); ++i)
+            indexes[i] = i;
+        std::shuffle(indexes.begin(), indexes.end(), std::mt19937(7));
+        Json::Value a;
+        for (auto i : indexes)
+            a[i] = i;
+        BEAST_EXPECT(a.size() == indexes.size());
+        Json::UInt n = 0;
+        for (auto const& element : a)
+            BEAST_EXPECT(element == n++);
+
+        // The first iteration may happen on several threads at once
+        Json::Value shared(Json::objectValue);
+        for (auto const& key : keys)
+            shared[key] = key;
+        std::vector<std::thread> threads;
+        std::vector<int> matched(4);
+        for (auto& result : matched)
+        {
+            threads.emplace_back([&shared, &sorted, &result]() {
+                Json::Value const& value = shared;
+                result = value.getMemberNames() == sorted &&
+                    value[sorted.back()] == sorted.back();
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        BEAST_EXPECT(std::count(matched.begin(), matched.end(), 1) == 4);
+    }
+
     void
     run() override
     {
@@ -1391,9 +1586,149 @@ struct json_value_test : beast::unit_test::suite
         test_iterator();
         test_nest_limits();
         test_leak();
+        test_storage();
+        test_random_order();
     }
 };
 
 BEAST_DEFINE_TESTSUITE(json_value, json, ripple);
 
+//------------------------------------------------------------------------------
+
+/*  Measures building, copying, parsing and serializing large responses.
+
+    The responses are shaped like those of account_lines, with member
+    names which are static strings, and ledger_data, whose member names
+    are copied from the parsed text. An object keyed by hashes, whose
+    members are added in random order, is built and written as well. Each
+    step is timed with the thread local pool disabled and then enabled.
+
+    Usage:
+        rippled --unittest=JsonValueBenchmark --unittest-arg=<entries>
+*/
+class JsonValueBenchmark_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    static Json::Value
+    accountLines(std::size_t count)
+    {
+        static Json::StaticString const account("account");
+        static Json::StaticString const balance("balance");
+        static Json::StaticString const currency("currency");
+        static Json::StaticString const limit("limit");
+        static Json::StaticString const limitPeer("limit_peer");
+        static Json::StaticString const lines("lines");
+        static Json::StaticString const noRipple("no_ripple");
+        static Json::StaticString const qualityIn("quality_in");
+        static Json::StaticString const qualityOut("quality_out");
+
+        Json::Value result(Json::objectValue);
+        result[account] = "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh";
+        auto& array = result[lines];
+        array = Json::Value(Json::arrayValue);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto& line = array.append(Json::objectValue);
+            line[account] = "rPEPPER7kfTD9w2To4CQk6UCfuHM9c6GDY";
+            line[balance] = std::to_string(i * 17);
+            line[currency] = "USD";
+            line[limit] = "1000000";
+            line[limitPeer] = "0";
+            line[qualityIn] = 0u;
+            line[qualityOut] = 0u;
+            line[noRipple] = (i % 2) == 0;
+        }
+        return result;
+    }
+
+    template <class F>
+    void
+    measure(std::string const& name, std::size_t repeat, F&& f)
+    {
+        bool const wasEnabled = ThreadLocalPool::enabled();
+
+        std::ostringstream ss;
+        ss << std::left << std::setw(24) << name << std::right;
+        for (bool const pooled : {false, true})
+        {
+            ThreadLocalPool::enable(pooled);
+            f();
+
+            auto const start = clock_type::now();
+            for (std::size_t i = 0; i < repeat; ++i)
+                f();
+            auto const elapsed =
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    clock_type::now() - start);
+
+            ss << (pooled ? "  pooled " : "  global ") << std::setw(9)
+               << elapsed.count() / repeat << " us";
+        }
+        ThreadLocalPool::enable(wasEnabled);
+        log << ss.str() << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 10000;
+        if (!arg().empty())
+            count = beast::lexicalCastThrow<std::size_t>(arg());
+        std::size_t const repeat = 20;
+
+        auto const lines = accountLines(count);
+        auto const text = Json::FastWriter().write(lines);
+
+        measure("account_lines build", repeat, [&]() {
+            auto const result = accountLines(count);
+            BEAST_EXPECT(result.size() == 2);
+        });
+        measure("account_lines copy", repeat, [&]() {
+            auto const copy = lines;
+            BEAST_EXPECT(copy.size() == 2);
+        });
+        measure("account_lines write", repeat, [&]() {
+            BEAST_EXPECT(Json::FastWriter().write(lines).size() == text.size());
+        });
+        measure("ledger_data parse", repeat, [&]() {
+            Json::Value parsed;
+            BEAST_EXPECT(Json::Reader().parse(text, parsed));
+        });
+
+        Json::Value parsed;
+        Json::Reader().parse(text, parsed);
+        BEAST_EXPECT(parsed == lines);
+        measure("ledger_data write", repeat, [&]() {
+            BEAST_EXPECT(
+                Json::FastWriter().write(parsed).size() == text.size());
+        });
+
+        std::vector<std::string> hashes;
+        std::mt19937_64 rng(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::ostringstream ss;
+            ss << std::hex << std::setfill('0') << std::setw(16) << rng()
+               << std::setw(16) << rng();
+            hashes.push_back(ss.str());
+        }
+        measure("random keys build", repeat, [&]() {
+            Json::Value object(Json::objectValue);
+            for (auto const& hash : hashes)
+                object[hash] = 1;
+            BEAST_EXPECT(object.size() == hashes.size());
+        });
+        measure("random keys write", repeat, [&]() {
+            Json::Value object(Json::objectValue);
+            for (auto const& hash : hashes)
+                object[hash] = 1;
+            BEAST_EXPECT(!Json::FastWriter().write(object).empty());
+        });
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(JsonValueBenchmark, json, ripple);
+
 }  // namespace ripple
@@ -274,10 +274,18 @@ private:
         Json::Reader jr;
         jr.parse(buffer_string(rb_.data()), jv);
         rb_.consume(rb_.size());
-        auto m = std::make_shared<msg>(std::move(jv));
         {
             std::lock_guard lock(m_);
-            msgs_.push_front(m);
+            // A batch of stream messages is an array of them
+            if (jv.isArray())
+            {
+                for (auto& item : jv)
+                    msgs_.push_front(std::make_shared<msg>(std::move(item)));
+            }
+            else
+            {
+                msgs_.push_front(std::make_shared<msg>(std::move(jv)));
+            }
             cv_.notify_all();
         }
         ws_.async_read(
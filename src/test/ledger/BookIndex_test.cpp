@@ -0,0 +1,338 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/ledger/Ledger.h>
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/app/tx/impl/BookTip.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/ledger/BookDirs.h>
+#include <ripple/ledger/OpenView.h>
+#include <ripple/ledger/Sandbox.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/shamap/SHAMapLeafNode.h>
+#include <test/jtx.h>
+#include <test/shamap/common.h>
+
+#include <chrono>
+
+namespace ripple {
+namespace test {
+
+class BookIndex_test : public beast::unit_test::suite
+{
+protected:
+    // Makers with offers to sell USD for XRP at `qualities` qualities, some
+    // of them short of funds.  Returns the book.
+    static Book
+    makeBook(jtx::Env& env, std::size_t makers, std::size_t qualities)
+    {
+        using namespace jtx;
+        Account const gw("gw");
+        auto const USD = gw["USD"];
+        env.fund(XRP(10000000), gw);
+        env(rate(gw, 1.1));
+        std::vector<Account> mms;
+        for (std::size_t i = 0; i < makers; ++i)
+            mms.emplace_back("mm" + std::to_string(i));
+        for (auto const& mm : mms)
+            env.fund(XRP(1000000), mm);
+        env.close();
+        for (auto const& mm : mms)
+            env(trust(mm, USD(1000000)));
+        env.close();
+        for (std::size_t i = 0; i < makers; ++i)
+            env(pay(gw, mms[i], USD(i % 3 == 0 ? 5 : 100000)));
+        env.close();
+
+        for (std::size_t q = 0; q < qualities; ++q)
+        {
+            for (auto const& mm : mms)
+                env(offer(mm, XRP(100 + q), USD(10)));
+            env.close();
+        }
+        env(offer(gw, XRP(1000), USD(10)));
+        env.close();
+        return Book(xrpIssue(), USD.issue());
+    }
+
+    // The closed ledger and a mutable ledger with the same state, which
+    // isn't indexed
+    static std::pair<
+        std::shared_ptr<Ledger const>,
+        std::shared_ptr<Ledger const>>
+    ledgers(jtx::Env& env)
+    {
+        auto const closed =
+            std::dynamic_pointer_cast<Ledger const>(env.closed());
+        auto const copy = std::make_shared<Ledger const>(
+            *closed, env.app().timeKeeper().closeTime());
+        return {closed, copy};
+    }
+
+private:
+    void
+    testSucc()
+    {
+        testcase("Succ");
+
+        using namespace jtx;
+        Env env(*this);
+        auto const book = makeBook(env, 3, 5);
+        auto const [closed, copy] = ledgers(env);
+        BEAST_EXPECT(closed->isImmutable() && !copy->isImmutable());
+
+        auto const walk = [&](ReadView const& view) {
+            std::vector<uint256> keys;
+            for (auto const& sle : BookDirs(view, book))
+                keys.push_back(sle->key());
+            return keys;
+        };
+        auto const offers = walk(*closed);
+        BEAST_EXPECT(offers.size() == 16);
+        BEAST_EXPECT(offers == walk(*copy));
+        BEAST_EXPECT(closed->bookIndex().size() == 1);
+
+        // From anywhere in the book, and through the views of the open
+        // ledger
+        auto const base = getBookBase(book);
+        auto const end = getQualityNext(base);
+        for (auto key = base; auto const next = copy->succ(key, end);
+             key = *next)
+        {
+            BEAST_EXPECT(closed->succ(key, end) == next);
+            auto before = *next;
+            --before;
+            BEAST_EXPECT(closed->succ(before, end) == next);
+        }
+        BEAST_EXPECT(!closed->succ(base, base));
+        OpenView const open(open_ledger, &*closed, closed->rules());
+        BEAST_EXPECT(walk(open) == offers);
+        BEAST_EXPECT(closed->bookIndex().size() == 1);
+
+        // And as payments take offers
+        for (auto const& view : {closed, copy})
+        {
+            OpenView open(open_ledger, &*view, view->rules());
+            Sandbox sb(&open, tapNONE);
+            BookTip tip(sb, book);
+            std::vector<uint256> taken;
+            while (tip.step(env.journal))
+                taken.push_back(tip.index());
+            BEAST_EXPECT(taken == offers);
+        }
+    }
+
+    void
+    testMissingNode()
+    {
+        testcase("Missing node");
+
+        using namespace jtx;
+        Env env(*this);
+        auto const book = makeBook(env, 3, 5);
+        auto const [closed, copy] = ledgers(env);
+        auto const base = getBookBase(book);
+        auto const end = getQualityNext(base);
+        std::vector<uint256> dirs;
+        for (auto key = base; auto const next = copy->succ(key, end);
+             key = *next)
+            dirs.push_back(*next);
+        if (!BEAST_EXPECT(dirs.size() > 2))
+            return;
+
+        // The same ledger, without the last directory of the book
+        tests::TestNodeFamily family(env.journal);
+        closed->stateMap().snapShot(false)->visitNodes(
+            [&](SHAMapTreeNode& node) {
+                if (node.isLeaf() &&
+                    static_cast<SHAMapLeafNode&>(node).peekItem()->key() ==
+                        dirs.back())
+                    return true;
+                Serializer s;
+                node.serializeWithPrefix(s);
+                family.db().store(
+                    hotACCOUNT_NODE,
+                    std::move(s.modData()),
+                    node.getHash().as_uint256(),
+                    closed->info().seq);
+                return true;
+            });
+        bool loaded = false;
+        auto const partial = std::make_shared<Ledger>(
+            closed->info(),
+            loaded,
+            false,
+            env.app().config(),
+            family,
+            env.journal);
+        BEAST_EXPECT(partial->isImmutable());
+
+        // The book is scanned once, and then left to the state map
+        BEAST_EXPECT(partial->succ(base, end) == dirs.front());
+        BEAST_EXPECT(partial->bookIndex().size() == 1);
+        for (std::size_t i = 0; i + 2 < dirs.size(); ++i)
+            BEAST_EXPECT(partial->succ(dirs[i], end) == dirs[i + 1]);
+        BEAST_EXPECT(!partial->bookIndex().offers(book, 10, env.journal));
+        BEAST_EXPECT(partial->bookIndex().size() == 1);
+    }
+
+    void
+    testOffers()
+    {
+        testcase("Offers");
+
+        using namespace jtx;
+        Env env(*this);
+        auto const book = makeBook(env, 3, 5);
+        auto const [closed, copy] = ledgers(env);
+
+        std::vector<BookIndex::Offer> walked;
+        for (auto const& sle : BookDirs(*copy, book))
+        {
+            auto const owner = sle->getAccountID(sfAccount);
+            auto const held = accountHolds(
+                *copy,
+                owner,
+                book.out.currency,
+                book.out.account,
+                fhZERO_IF_FROZEN,
+                env.journal);
+            walked.push_back({sle, 0, held});
+        }
+        BEAST_EXPECT(walked.size() == 16);
+
+        auto const check = [&](std::size_t limit) {
+            auto const offers =
+                closed->bookIndex().offers(book, limit, env.journal);
+            if (!BEAST_EXPECT(offers))
+                return;
+            BEAST_EXPECT(offers->size() == std::min(limit, walked.size()));
+            for (std::size_t i = 0; i < offers->size(); ++i)
+            {
+                BEAST_EXPECT((*offers)[i].sle->key() == walked[i].sle->key());
+                BEAST_EXPECT((*offers)[i].ownerFunds == walked[i].ownerFunds);
+            }
+        };
+
+        // Reading resumes where it stopped, in and across directories,
+        // and goes back over what was read
+        for (std::size_t limit : {1, 2, 5, 3, 12, 16, 0, 100, 7})
+            check(limit);
+
+        // Deeper than what is kept
+        BEAST_EXPECT(!closed->bookIndex().offers(
+            book, BookIndex::maxOffers + 1, env.journal));
+    }
+
+    void
+    testBookOffers()
+    {
+        testcase("book_offers");
+
+        using namespace jtx;
+        Env env(*this);
+        auto const book = makeBook(env, 3, 5);
+        auto const [closed, copy] = ledgers(env);
+
+        Account const taker("taker");
+        unsigned int const deep = BookIndex::maxOffers + 1;
+        for (unsigned int limit : {1u, 5u, 16u, 100u, deep})
+        {
+            Json::Value indexed;
+            Json::Value walked;
+            std::shared_ptr<ReadView const> view = closed;
+            env.app().getOPs().getBookPage(
+                view, book, taker, false, limit, Json::nullValue, indexed);
+            view = copy;
+            env.app().getOPs().getBookPage(
+                view, book, taker, false, limit, Json::nullValue, walked);
+            BEAST_EXPECT(indexed[jss::offers].size() == std::min(limit, 16u));
+            BEAST_EXPECT(indexed == walked);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testSucc();
+        testMissingNode();
+        testOffers();
+        testBookOffers();
+    }
+};
+
+// book_offers and taking all the offers of a deep book, repeated on one
+// ledger, with the book indexed and with it walked in the state map.
+class BookIndexBenchmark_test : public BookIndex_test
+{
+public:
+    void
+    run() override
+    {
+        using namespace jtx;
+        using clock = std::chrono::steady_clock;
+        using ms = std::chrono::duration<double, std::milli>;
+
+        std::size_t const repeat = 50;
+        Env env(*this);
+        auto const book = makeBook(env, 20, 100);
+        auto const [closed, copy] = ledgers(env);
+
+        for (auto const& ledger : {closed, copy})
+        {
+            auto start = clock::now();
+            std::size_t offers = 0;
+            for (std::size_t i = 0; i < repeat; ++i)
+            {
+                Json::Value jv;
+                std::shared_ptr<ReadView const> view = ledger;
+                env.app().getOPs().getBookPage(
+                    view, book, {}, false, 300, Json::nullValue, jv);
+                offers += jv[jss::offers].size();
+            }
+            auto const bookOffers = clock::now() - start;
+
+            start = clock::now();
+            std::size_t taken = 0;
+            for (std::size_t i = 0; i < repeat; ++i)
+            {
+                OpenView open(open_ledger, &*ledger, ledger->rules());
+                Sandbox sb(&open, tapNONE);
+                BookTip tip(sb, book);
+                while (tip.step(env.journal))
+                    ++taken;
+            }
+            auto const steps = clock::now() - start;
+
+            log << (ledger->isImmutable() ? "indexed" : "walked")
+                << ": book_offers " << ms(bookOffers).count() / repeat
+                << " ms for " << offers / repeat << " offers, taking "
+                << ms(steps).count() / repeat << " ms for " << taken / repeat
+                << " offers" << std::endl;
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(BookIndex, ledger, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(BookIndexBenchmark, ledger, ripple);
+
+}  // namespace test
+}  // namespace ripple
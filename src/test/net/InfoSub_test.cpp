@@ -0,0 +1,190 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/app/misc/NetworkOPs.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/json_writer.h>
+#include <ripple/json/to_string.h>
+#include <ripple/net/InfoSub.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/server/WSSession.h>
+#include <test/jtx.h>
+
+#include <chrono>
+
+namespace ripple {
+namespace test {
+
+namespace {
+
+// Queues messages the way a WebSocket session does
+class TestSub : public InfoSub
+{
+public:
+    std::shared_ptr<StreamWSMsg> last;
+
+    explicit TestSub(Source& source) : InfoSub(source)
+    {
+    }
+
+    // Serializes the message for this subscriber alone
+    void
+    send(Json::Value const& jv, bool) override
+    {
+        std::string text;
+        Json::stream(jv, [&](void const* data, std::size_t n) {
+            text.append(static_cast<char const*>(data), n);
+        });
+        last = std::make_shared<StreamWSMsg>(std::move(text));
+    }
+
+    void
+    send(Message const& message, bool) override
+    {
+        last = std::make_shared<StreamWSMsg>(message.text());
+    }
+};
+
+// A validated payment, as the transactions stream publishes it
+Json::Value
+paymentJson(jtx::Env& env)
+{
+    using namespace jtx;
+    Account const alice("alice");
+    Account const bob("bob");
+    env.fund(XRP(10000), alice, bob);
+    env.close();
+    env(pay(alice, bob, XRP(100)));
+    auto const tx = env.tx();
+    auto const meta = env.meta();
+    env.close();
+
+    Json::Value jv(Json::objectValue);
+    jv[jss::type] = "transaction";
+    jv[jss::transaction] = tx->getJson(JsonOptions::none);
+    jv[jss::meta] = meta->getJson(JsonOptions::none);
+    jv[jss::ledger_index] = env.closed()->info().seq;
+    jv[jss::ledger_hash] = to_string(env.closed()->info().hash);
+    jv[jss::validated] = true;
+    jv[jss::status] = "closed";
+    jv[jss::engine_result] = "tesSUCCESS";
+    jv[jss::engine_result_code] = 0;
+    jv[jss::engine_result_message] =
+        "The transaction was applied. Only final in a validated ledger.";
+    return jv;
+}
+
+}  // namespace
+
+class InfoSub_test : public beast::unit_test::suite
+{
+    void
+    testMessage()
+    {
+        testcase("Message");
+
+        jtx::Env env(*this);
+        auto const jv = paymentJson(env);
+
+        TestSub a(env.app().getOPs());
+        TestSub b(env.app().getOPs());
+        InfoSub::Message const message(jv);
+        a.send(message, true);
+        b.send(message, true);
+
+        // Both sessions share one text, which is the value's
+        BEAST_EXPECT(&a.last->text() == &b.last->text());
+        BEAST_EXPECT(a.last->text() == *message.text());
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader().parse(a.last->text(), parsed));
+        BEAST_EXPECT(to_string(parsed) == to_string(jv));
+
+        // And it is the text the subscriber would have made itself
+        a.send(jv, true);
+        BEAST_EXPECT(a.last->text() == b.last->text());
+    }
+
+public:
+    void
+    run() override
+    {
+        testMessage();
+    }
+};
+
+// Publishing the transactions of a ledger to many subscribers, with each
+// subscriber serializing the message and with it serialized once.
+class InfoSubBenchmark_test : public beast::unit_test::suite
+{
+    template <class Publish>
+    std::chrono::duration<double>
+    time(Publish&& publish)
+    {
+        using clock = std::chrono::steady_clock;
+        auto const start = clock::now();
+        publish();
+        return clock::now() - start;
+    }
+
+public:
+    void
+    run() override
+    {
+        jtx::Env env(*this);
+        auto const jv = paymentJson(env);
+        std::size_t const transactions = 200;
+
+        for (std::size_t subscribers : {1, 10, 100, 1000})
+        {
+            std::vector<std::unique_ptr<TestSub>> subs;
+            for (std::size_t i = 0; i < subscribers; ++i)
+                subs.emplace_back(
+                    std::make_unique<TestSub>(env.app().getOPs()));
+
+            auto const each = time([&] {
+                for (std::size_t t = 0; t < transactions; ++t)
+                {
+                    for (auto const& s : subs)
+                        s->send(jv, true);
+                }
+            });
+            auto const once = time([&] {
+                for (std::size_t t = 0; t < transactions; ++t)
+                {
+                    InfoSub::Message const message(jv);
+                    for (auto const& s : subs)
+                        s->send(message, true);
+                }
+            });
+
+            log << subscribers << " subscribers, " << transactions
+                << " transactions: " << each.count() * 1000
+                << " ms serialized per subscriber, " << once.count() * 1000
+                << " ms serialized once" << std::endl;
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(InfoSub, net, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(InfoSubBenchmark, net, ripple);
+
+}  // namespace test
+}  // namespace ripple
@@ -19,10 +19,15 @@
 
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/BatchWriter.h>
 #include <ripple/nodestore/impl/DecodedBlob.h>
 #include <ripple/nodestore/impl/EncodedBlob.h>
+#include <ripple/protocol/jss.h>
 #include <test/nodestore/TestBase.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace ripple {
 namespace NodeStore {
 
@@ -30,6 +35,37 @@ namespace NodeStore {
 //
 class NodeStoreBasic_test : public TestBase
 {
+    // Runs the write task only when asked to
+    struct ManualScheduler : Scheduler
+    {
+        std::vector<Task*> tasks;
+
+        void
+        scheduleTask(Task& task) override
+        {
+            tasks.push_back(&task);
+        }
+
+        void
+        onFetch(FetchReport const&) override
+        {
+        }
+
+        void
+        onBatchWrite(BatchWriteReport const&) override
+        {
+        }
+
+        void
+        run()
+        {
+            auto const pending = std::move(tasks);
+            tasks.clear();
+            for (auto const task : pending)
+                task->performScheduledTask();
+        }
+    };
+
 public:
     // Make sure predictable object generation works!
     void
@@ -76,6 +112,221 @@ public:
         }
     }
 
+    // Checks that repeated stores are written once
+    void
+    testBatchWriter(std::uint64_t const seedValue)
+    {
+        testcase("batch writer");
+
+        struct Recorder : BatchWriter::Callback
+        {
+            Batch written;
+
+            void
+            writeBatch(Batch const& batch) override
+            {
+                written.insert(written.end(), batch.begin(), batch.end());
+            }
+        };
+
+        auto batch = createPredictableBatch(numObjectsToTest, seedValue);
+
+        DummyScheduler scheduler;
+        Recorder recorder;
+        {
+            BatchWriter writer(recorder, scheduler);
+            for (int i = 0; i < 3; ++i)
+            {
+                for (auto const& object : batch)
+                    writer.store(object);
+            }
+
+            Json::Value counts{Json::objectValue};
+            writer.getCountsJson(counts);
+            BEAST_EXPECT(
+                counts[jss::node_writes_deduplicated].asString() ==
+                std::to_string(2 * batch.size()));
+            BEAST_EXPECT(counts[jss::node_write_queue].asInt() == 0);
+            BEAST_EXPECT(
+                counts[jss::node_write_requests].asString() ==
+                std::to_string(3 * batch.size()));
+            BEAST_EXPECT(
+                counts[jss::node_writes_unique].asString() ==
+                std::to_string(batch.size()));
+        }
+
+        std::sort(batch.begin(), batch.end(), LessThan{});
+        std::sort(recorder.written.begin(), recorder.written.end(), LessThan{});
+        BEAST_EXPECT(areBatchesEqual(batch, recorder.written));
+    }
+
+    // Checks that an object stored by two threads waiting for room in the
+    // batch is written once
+    void
+    testBatchWriterRace(std::uint64_t const seedValue)
+    {
+        testcase("batch writer race");
+
+        struct Recorder : BatchWriter::Callback
+        {
+            Batch written;
+
+            void
+            writeBatch(Batch const& batch) override
+            {
+                written.insert(written.end(), batch.begin(), batch.end());
+            }
+        };
+
+        auto const batch =
+            createPredictableBatch(batchWriteLimitSize + 1, seedValue);
+        ManualScheduler scheduler;
+        Recorder recorder;
+        BatchWriter writer(recorder, scheduler);
+
+        // Fill the batch, so that the next stores wait for room
+        for (std::size_t i = 0; i < batchWriteLimitSize; ++i)
+            writer.store(batch[i]);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 2; ++i)
+            threads.emplace_back([&] { writer.store(batch.back()); });
+
+        using namespace std::chrono_literals;
+        std::this_thread::sleep_for(100ms);
+        scheduler.run();
+        for (auto& thread : threads)
+            thread.join();
+        scheduler.run();
+
+        BEAST_EXPECT(
+            std::count(
+                recorder.written.begin(),
+                recorder.written.end(),
+                batch.back()) == 1);
+        Json::Value counts{Json::objectValue};
+        writer.getCountsJson(counts);
+        BEAST_EXPECT(counts[jss::node_writes_deduplicated].asString() == "1");
+    }
+
+    // Checks that the keys of a failed write are stored again, and are
+    // then remembered as long as any other
+    void
+    testBatchWriterFailure(std::uint64_t const seedValue)
+    {
+        testcase("batch writer failure");
+
+        struct Recorder : BatchWriter::Callback
+        {
+            bool fail = false;
+            Batch written;
+
+            void
+            writeBatch(Batch const& batch) override
+            {
+                if (fail)
+                    throw std::runtime_error("write failed");
+                written.insert(written.end(), batch.begin(), batch.end());
+            }
+        };
+
+        auto const batch =
+            createPredictableBatch(BatchWriter::recentSize, seedValue);
+        auto const& first = batch.front();
+        ManualScheduler scheduler;
+        Recorder recorder;
+        BatchWriter writer(recorder, scheduler);
+
+        recorder.fail = true;
+        writer.store(first);
+        bool threw = false;
+        try
+        {
+            scheduler.run();
+        }
+        catch (std::runtime_error const&)
+        {
+            threw = true;
+        }
+        BEAST_EXPECT(threw);
+        BEAST_EXPECT(recorder.written.empty());
+
+        // Storing it again writes it, and it is remembered until as many
+        // keys as are remembered follow it
+        recorder.fail = false;
+        writer.store(first);
+        scheduler.run();
+        BEAST_EXPECT(recorder.written.size() == 1);
+        for (std::size_t i = 1; i < batch.size(); ++i)
+            writer.store(batch[i]);
+        scheduler.run();
+        writer.store(first);
+        scheduler.run();
+
+        BEAST_EXPECT(recorder.written.size() == batch.size());
+        BEAST_EXPECT(
+            std::count(
+                recorder.written.begin(), recorder.written.end(), first) == 1);
+    }
+
+    // Checks that slow writes shrink batches and fast ones grow them again
+    void
+    testBatchWriterSizing(std::uint64_t const seedValue)
+    {
+        testcase("batch writer sizing");
+
+        struct Recorder : BatchWriter::Callback
+        {
+            std::chrono::milliseconds delay{0};
+            std::vector<std::size_t> sizes;
+
+            void
+            writeBatch(Batch const& batch) override
+            {
+                sizes.push_back(batch.size());
+                std::this_thread::sleep_for(delay);
+            }
+        };
+
+        auto const batch = createPredictableBatch(30000, seedValue);
+        auto next = batch.begin();
+        auto store = [&](BatchWriter& writer, std::size_t n) {
+            for (auto const end = next + n; next != end; ++next)
+                writer.store(*next);
+        };
+
+        ManualScheduler scheduler;
+        Recorder recorder;
+        BatchWriter writer(recorder, scheduler);
+        auto batchSize = [&] {
+            Json::Value counts{Json::objectValue};
+            writer.getCountsJson(counts);
+            return counts[jss::node_write_batch_size].asUInt();
+        };
+        BEAST_EXPECT(batchSize() == batchWriteLimitSize);
+
+        // Every write slower than the target halves the batch
+        using namespace std::chrono_literals;
+        recorder.delay = 150ms;
+        for (int i = 0; i < 3; ++i)
+        {
+            store(writer, 3);
+            scheduler.run();
+        }
+        BEAST_EXPECT(batchSize() == batchWriteLimitSize / 8);
+
+        // A backlog is written in pieces no larger than the batch, and
+        // each fast write of a full batch doubles it
+        recorder.delay = 0ms;
+        recorder.sizes.clear();
+        store(writer, batchWriteLimitSize / 8 + batchWriteLimitSize / 4 + 1);
+        scheduler.run();
+        BEAST_EXPECT(
+            recorder.sizes ==
+            std::vector<std::size_t>(
+                {batchWriteLimitSize / 8, batchWriteLimitSize / 4, 1}));
+        BEAST_EXPECT(batchSize() == batchWriteLimitSize / 2);
+    }
+
     void
     run() override
     {
@@ -84,6 +335,14 @@ public:
         testBatches(seedValue);
 
         testBlobs(seedValue);
+
+        testBatchWriter(seedValue);
+
+        testBatchWriterRace(seedValue);
+
+        testBatchWriterFailure(seedValue);
+
+        testBatchWriterSizing(seedValue);
     }
 };
 
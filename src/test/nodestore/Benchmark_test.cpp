@@ -0,0 +1,659 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/BasicConfig.h>
+#include <ripple/basics/ByteUtilities.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/beast/utility/temp_dir.h>
+#include <ripple/beast/xor_shift_engine.h>
+#include <ripple/json/json_value.h>
+#include <ripple/json/to_string.h>
+#include <ripple/nodestore/DummyScheduler.h>
+#include <ripple/nodestore/Manager.h>
+#include <ripple/protocol/HashPrefix.h>
+#include <boost/algorithm/string.hpp>
+#include <beast/unit_test/thread.hpp>
+#include <test/unit_test/SuiteJournal.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <set>
+
+namespace ripple {
+namespace NodeStore {
+
+/*  Benchmark of NodeStore backends under ledger-like workloads.
+
+    Unlike the Timing test, which uses uniform random blobs, the objects
+    written here follow the shape of a live node store: mostly SHAMap
+    inner nodes of varying fullness, state and transaction leaves with
+    realistic sizes, and a few ledger headers. Objects can instead be
+    read from an existing node store.
+
+    Each result is printed as one line of JSON.
+
+    Usage:
+        rippled --unittest=Benchmark --unittest-arg="<config>[;<config>...]"
+
+    Each config is a comma separated list of backend settings, as they
+    would appear in [node_db], plus these benchmark settings:
+
+        items           Number of objects to write (default 100000)
+        threads         Number of reading threads (default 4)
+        workloads       '|' separated workloads to run, from
+                        burst, read, range and rotate (default all)
+        burst_size      Objects written per ledger close (default 1000)
+        missing_percent Percent of random reads for absent keys (default 10)
+        range_length    Objects read per historical range scan (default 256)
+        source          Path of an existing node store to take objects from
+        source_type     Backend type of the source (default nudb)
+        output          File to append the results to
+
+    For example:
+        type=nudb;type=rocksdb,cache_mb=256,items=1000000,threads=8
+*/
+class Benchmark_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    // Produces a deterministic sequence of objects shaped like those
+    // written by a server tracking the network. Keys may be generated
+    // concurrently, objects may not.
+    class Generator
+    {
+        // The share of each kind of object, per mille
+        enum Kind { stateInner, stateLeaf, txInner, txLeaf, ledger };
+        std::discrete_distribution<int> kind_{{520, 290, 50, 130, 10}};
+
+        // Populated branches of inner nodes. Nodes near the root are full,
+        // most of the others have few children.
+        std::discrete_distribution<int> branches_{
+            {0, 310, 180, 110, 70, 50, 35, 25, 20, 15, 15, 10, 10, 10, 10, 10,
+             120}};
+
+        // Serialized ledger entry sizes, by entry type: account roots,
+        // trust lines, offers and directories.
+        std::discrete_distribution<int> entry_{{55, 25, 10, 10}};
+
+        // Transaction and metadata size, median about 600 bytes
+        std::lognormal_distribution<double> txSize_{6.4, 0.5};
+
+        beast::xor_shift_engine gen_;
+
+        int
+        rand(int lo, int hi)
+        {
+            return std::uniform_int_distribution<int>(lo, hi)(gen_);
+        }
+
+        static void
+        fill(
+            std::uint8_t* p,
+            std::size_t n,
+            bool sparse,
+            beast::xor_shift_engine& gen)
+        {
+            // Serialized objects are far from random. Leave a share of
+            // the bytes zero so that compression behaves realistically.
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                auto const v = gen();
+                p[i] = sparse && (v & 0x300) == 0 ? 0 : v & 0xff;
+            }
+        }
+
+        Blob
+        make(HashPrefix prefix, std::size_t size)
+        {
+            Blob blob(size);
+            auto const p = static_cast<std::uint32_t>(prefix);
+            blob[0] = p >> 24;
+            blob[1] = (p >> 16) & 0xff;
+            blob[2] = (p >> 8) & 0xff;
+            blob[3] = p & 0xff;
+            return blob;
+        }
+
+        Blob
+        innerNode()
+        {
+            // Prefix followed by 16 child hashes, absent ones zero
+            auto blob = make(HashPrefix::innerNode, 4 + 16 * 32);
+            std::array<int, 16> slots;
+            std::iota(slots.begin(), slots.end(), 0);
+            std::shuffle(slots.begin(), slots.end(), gen_);
+            for (int i = 0, n = branches_(gen_); i < n; ++i)
+                fill(blob.data() + 4 + slots[i] * 32, 32, false, gen_);
+            return blob;
+        }
+
+        Blob
+        leaf(HashPrefix prefix, std::size_t size)
+        {
+            // Prefix, serialized item, then the item's key
+            auto blob = make(prefix, 4 + size + 32);
+            fill(blob.data() + 4, size, true, gen_);
+            fill(blob.data() + 4 + size, 32, false, gen_);
+            return blob;
+        }
+
+    public:
+        // The n-th key of a sequence
+        static uint256
+        key(std::size_t n, std::uint8_t sequence)
+        {
+            beast::xor_shift_engine gen((n << 8) + sequence + 1);
+            uint256 result;
+            fill(result.data(), result.size(), false, gen);
+            return result;
+        }
+
+        // The n-th object, whose key is the n-th of sequence 0
+        std::shared_ptr<NodeObject>
+        obj(std::size_t n)
+        {
+            auto const hash = key(n, 0);
+            gen_.seed(n + 1);
+            txSize_.reset();
+            NodeObjectType type = hotACCOUNT_NODE;
+            Blob data;
+            switch (kind_(gen_))
+            {
+                case stateInner:
+                    data = innerNode();
+                    break;
+                case stateLeaf: {
+                    static std::array<std::pair<int, int>, 4> const sizes{
+                        {{120, 140}, {200, 240}, {150, 190}, {90, 600}}};
+                    auto const [lo, hi] = sizes[entry_(gen_)];
+                    data = leaf(HashPrefix::leafNode, rand(lo, hi));
+                    break;
+                }
+                case txInner:
+                    type = hotTRANSACTION_NODE;
+                    data = innerNode();
+                    break;
+                case txLeaf:
+                    type = hotTRANSACTION_NODE;
+                    data = leaf(
+                        HashPrefix::txNode,
+                        std::clamp(
+                            static_cast<std::size_t>(txSize_(gen_)),
+                            std::size_t{200},
+                            std::size_t{16384}));
+                    break;
+                default:
+                    type = hotLEDGER;
+                    data = make(HashPrefix::ledgerMaster, 4 + 118);
+                    fill(data.data() + 4, 118, true, gen_);
+                    break;
+            }
+            return NodeObject::createObject(type, std::move(data), hash);
+        }
+    };
+
+    // The objects written, either generated or copied from a node store
+    class Objects
+    {
+        std::vector<std::shared_ptr<NodeObject>> copied_;
+        Generator gen_;
+
+    public:
+        explicit Objects(std::vector<std::shared_ptr<NodeObject>> copied)
+            : copied_(std::move(copied))
+        {
+        }
+
+        std::shared_ptr<NodeObject>
+        operator[](std::size_t n)
+        {
+            if (!copied_.empty())
+                return copied_[n % copied_.size()];
+            return gen_.obj(n);
+        }
+
+        uint256
+        key(std::size_t n) const
+        {
+            if (!copied_.empty())
+                return copied_[n % copied_.size()]->getHash();
+            return Generator::key(n, 0);
+        }
+
+        // A key which was never written
+        static uint256
+        missing(std::size_t n)
+        {
+            return Generator::key(n, 1);
+        }
+    };
+
+    struct Params
+    {
+        std::size_t items;
+        std::size_t threads;
+        std::size_t burstSize;
+        std::size_t missingPercent;
+        std::size_t rangeLength;
+    };
+
+    // Latencies of the operations of one workload, in nanoseconds
+    class Latencies
+    {
+        std::mutex mutex_;
+        std::vector<std::uint64_t> samples_;
+
+    public:
+        void
+        merge(std::vector<std::uint64_t> const& samples)
+        {
+            std::lock_guard lock(mutex_);
+            samples_.insert(samples_.end(), samples.begin(), samples.end());
+        }
+
+        Json::Value
+        getJson()
+        {
+            std::lock_guard lock(mutex_);
+            Json::Value ret{Json::objectValue};
+            if (samples_.empty())
+                return ret;
+
+            std::sort(samples_.begin(), samples_.end());
+            auto at = [&](double fraction) {
+                auto const i = static_cast<std::size_t>(
+                    fraction * (samples_.size() - 1));
+                return samples_[i] / 1000.0;
+            };
+            ret["p50_us"] = at(0.50);
+            ret["p90_us"] = at(0.90);
+            ret["p99_us"] = at(0.99);
+            ret["p999_us"] = at(0.999);
+            ret["max_us"] = at(1.0);
+            return ret;
+        }
+    };
+
+    template <class F>
+    static std::uint64_t
+    timed(std::vector<std::uint64_t>& samples, F&& f)
+    {
+        auto const start = clock_type::now();
+        f();
+        auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            clock_type::now() - start)
+                            .count();
+        samples.push_back(ns);
+        return ns;
+    }
+
+    // Run body(thread, i) for i in [0, n) on the given number of threads.
+    // Each thread records latencies in a vector of its own.
+    template <class Body>
+    void
+    parallel_for(
+        std::size_t n,
+        std::size_t threads,
+        Latencies& latencies,
+        Body&& body)
+    {
+        std::vector<std::vector<std::uint64_t>> samples(threads);
+        std::atomic<std::size_t> next{0};
+        std::vector<beast::unit_test::thread> t;
+        t.reserve(threads);
+        for (std::size_t id = 0; id < threads; ++id)
+        {
+            t.emplace_back(*this, [&, id] {
+                for (std::size_t i; (i = next++) < n;)
+                    body(samples[id], i);
+            });
+        }
+        for (auto& thread : t)
+            thread.join();
+        for (auto const& s : samples)
+            latencies.merge(s);
+    }
+
+    //--------------------------------------------------------------------------
+
+    // Ledger closes: bursts of writes from a single thread, each followed
+    // by a sync, as the ledger's nodes are flushed.
+    std::size_t
+    burst(Backend& backend, Objects& objects, Params const& p, Latencies& l)
+    {
+        std::vector<std::uint64_t> samples;
+        samples.reserve(p.items);
+        for (std::size_t n = 0; n < p.items;)
+        {
+            auto const end = std::min(n + p.burstSize, p.items);
+            for (; n < end; ++n)
+            {
+                auto const obj = objects[n];
+                timed(samples, [&] { backend.store(obj); });
+            }
+            backend.sync();
+        }
+        l.merge(samples);
+        return p.items;
+    }
+
+    // Random reads, as made while acquiring or serving ledgers, including
+    // reads of objects the store does not have.
+    std::size_t
+    read(
+        Backend& backend,
+        Objects const& objects,
+        Params const& p,
+        Latencies& l)
+    {
+        parallel_for(p.items, p.threads, l, [&](auto& samples, std::size_t i) {
+            beast::xor_shift_engine gen(i + 1);
+            auto const missing =
+                std::uniform_int_distribution<std::size_t>(0, 99)(gen) <
+                p.missingPercent;
+            auto const key = missing
+                ? Objects::missing(i)
+                : objects.key(std::uniform_int_distribution<std::size_t>(
+                      0, p.items - 1)(gen));
+
+            std::shared_ptr<NodeObject> result;
+            timed(samples, [&] { backend.fetch(key.data(), &result); });
+            if (!missing && !result)
+                fail("object not found");
+        });
+        return p.items;
+    }
+
+    // Historical requests: runs of objects written together, as the nodes
+    // of one ledger are.
+    std::size_t
+    range(
+        Backend& backend,
+        Objects const& objects,
+        Params const& p,
+        Latencies& l)
+    {
+        auto const ranges = std::max<std::size_t>(p.items / p.rangeLength, 1);
+        parallel_for(ranges, p.threads, l, [&](auto& samples, std::size_t i) {
+            beast::xor_shift_engine gen(i + 1);
+            auto const start =
+                std::uniform_int_distribution<std::size_t>(0, p.items - 1)(gen);
+            for (std::size_t n = 0; n < p.rangeLength; ++n)
+            {
+                auto const key = objects.key((start + n) % p.items);
+                std::shared_ptr<NodeObject> result;
+                timed(samples, [&] { backend.fetch(key.data(), &result); });
+                if (!result)
+                    fail("object not found");
+            }
+        });
+        return ranges * p.rangeLength;
+    }
+
+    // Online delete: copy every object into a fresh backend
+    std::size_t
+    rotate(
+        Backend& backend,
+        Section config,
+        Scheduler& scheduler,
+        beast::Journal journal,
+        Latencies& l)
+    {
+        beast::temp_dir dir;
+        config.set("path", dir.path());
+        auto dest = Manager::instance().make_Backend(
+            config, megabytes(4), scheduler, journal);
+        dest->open();
+
+        std::vector<std::uint64_t> samples;
+        std::size_t copied = 0;
+        Batch batch;
+        batch.reserve(batchWritePreallocationSize);
+        auto flush = [&] {
+            timed(samples, [&] { dest->storeBatch(batch); });
+            copied += batch.size();
+            batch.clear();
+        };
+        backend.for_each([&](std::shared_ptr<NodeObject> obj) {
+            batch.emplace_back(std::move(obj));
+            if (batch.size() >= batchWritePreallocationSize)
+                flush();
+        });
+        if (!batch.empty())
+            flush();
+        dest->sync();
+        dest->close();
+
+        l.merge(samples);
+        return copied;
+    }
+
+    //--------------------------------------------------------------------------
+
+    std::vector<std::shared_ptr<NodeObject>>
+    ingest(Section const& config, std::size_t items, beast::Journal journal)
+    {
+        std::vector<std::shared_ptr<NodeObject>> result;
+        std::string path;
+        if (!get_if_exists(config, "source", path))
+            return result;
+
+        Section source;
+        source.set("type", get(config, "source_type", std::string("nudb")));
+        source.set("path", path);
+        DummyScheduler scheduler;
+        auto backend = Manager::instance().make_Backend(
+            source, megabytes(4), scheduler, journal);
+        backend->open(false);
+
+        // Stop visiting the source once enough objects are read
+        struct Enough
+        {
+        };
+        result.reserve(items);
+        try
+        {
+            backend->for_each([&](std::shared_ptr<NodeObject> obj) {
+                if (result.size() >= items)
+                    throw Enough{};
+                result.emplace_back(std::move(obj));
+            });
+        }
+        catch (Enough const&)
+        {
+        }
+        backend->close();
+
+        log << "Read " << result.size() << " objects from " << path
+            << std::endl;
+        return result;
+    }
+
+    void
+    runConfig(std::string const& configString, std::ostream* output)
+    {
+        test::SuiteJournal journal("Benchmark_test", *this);
+
+        // Separate the benchmark settings from the backend's
+        static std::set<std::string> const settings{
+            "items",
+            "threads",
+            "workloads",
+            "burst_size",
+            "missing_percent",
+            "range_length",
+            "source",
+            "source_type",
+            "output"};
+        Section all;
+        {
+            std::vector<std::string> v;
+            boost::split(v, configString, boost::algorithm::is_any_of(","));
+            all.append(v);
+        }
+        Section config;
+        for (auto const& [key, value] : all)
+        {
+            if (settings.count(key) == 0)
+                config.set(key, value);
+        }
+
+        Params p;
+        p.items = get<std::size_t>(all, "items", 100000);
+        p.threads =
+            std::max<std::size_t>(get<std::size_t>(all, "threads", 4), 1);
+        p.burstSize = get<std::size_t>(all, "burst_size", 1000);
+        p.missingPercent = get<std::size_t>(all, "missing_percent", 10);
+        p.rangeLength = get<std::size_t>(all, "range_length", 256);
+        if (p.items == 0 || p.burstSize == 0 || p.rangeLength == 0)
+        {
+            fail("invalid settings: " + configString);
+            return;
+        }
+
+        std::vector<std::string> workloads;
+        boost::split(
+            workloads,
+            get(all, "workloads", std::string("burst|read|range|rotate")),
+            boost::algorithm::is_any_of("|"));
+
+        Objects objects{ingest(all, p.items, journal)};
+
+        beast::temp_dir dir;
+        config.set("path", dir.path());
+        DummyScheduler scheduler;
+        auto backend = Manager::instance().make_Backend(
+            config, megabytes(4), scheduler, journal);
+        backend->open();
+
+        auto report = [&](std::string const& workload,
+                          std::size_t threads,
+                          auto&& f) {
+            Latencies latencies;
+            auto const start = clock_type::now();
+            auto const ops = f(latencies);
+            std::chrono::duration<double> const elapsed =
+                clock_type::now() - start;
+
+            Json::Value result{Json::objectValue};
+            result["backend"] = get(config, "type", std::string());
+            result["config"] = configString;
+            result["workload"] = workload;
+            result["threads"] = static_cast<Json::UInt>(threads);
+            result["ops"] = static_cast<Json::UInt>(ops);
+            result["seconds"] = elapsed.count();
+            result["ops_per_sec"] = ops / elapsed.count();
+            result["latency"] = latencies.getJson();
+
+            auto const line = Json::to_string(result);
+            log << line << std::endl;
+            if (output)
+                *output << line << std::endl;
+        };
+
+        auto const has = [&](char const* workload) {
+            return std::find(workloads.begin(), workloads.end(), workload) !=
+                workloads.end();
+        };
+
+        // Every other workload needs the objects in place
+        if (has("burst"))
+        {
+            report("burst", 1, [&](Latencies& l) {
+                return burst(*backend, objects, p, l);
+            });
+        }
+        else
+        {
+            Latencies ignored;
+            burst(*backend, objects, p, ignored);
+        }
+
+        if (has("read"))
+        {
+            report("read", p.threads, [&](Latencies& l) {
+                return read(*backend, objects, p, l);
+            });
+        }
+        if (has("range"))
+        {
+            report("range", p.threads, [&](Latencies& l) {
+                return range(*backend, objects, p, l);
+            });
+        }
+        if (has("rotate"))
+        {
+            report("rotate", 1, [&](Latencies& l) {
+                return rotate(*backend, config, scheduler, journal, l);
+            });
+        }
+
+        backend->close();
+    }
+
+public:
+    void
+    run() override
+    {
+        testcase("Benchmark", beast::unit_test::abort_on_fail);
+
+        std::string const defaultArgs =
+            "type=nudb"
+#if RIPPLE_ROCKSDB_AVAILABLE
+            ";type=rocksdb,open_files=2000,filter_bits=12,cache_mb=256,"
+            "file_size_mb=8,file_size_mult=2"
+#endif
+            ";type=memory";
+
+        std::vector<std::string> configs;
+        auto const args = arg().empty() ? defaultArgs : arg();
+        boost::split(configs, args, boost::algorithm::is_any_of(";"));
+
+        for (auto const& config : configs)
+        {
+            if (config.empty())
+                continue;
+
+            std::unique_ptr<std::ofstream> output;
+            {
+                Section section;
+                std::vector<std::string> v;
+                boost::split(v, config, boost::algorithm::is_any_of(","));
+                section.append(v);
+                std::string path;
+                if (get_if_exists(section, "output", path))
+                    output = std::make_unique<std::ofstream>(
+                        path, std::ios::app);
+            }
+            runConfig(config, output.get());
+        }
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(Benchmark, NodeStore, ripple);
+
+}  // namespace NodeStore
+}  // namespace ripple
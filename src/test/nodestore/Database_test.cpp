@@ -21,6 +21,9 @@
 #include <ripple/core/DatabaseCon.h>
 #include <ripple/nodestore/DummyScheduler.h>
 #include <ripple/nodestore/Manager.h>
+#include <ripple/nodestore/impl/DatabaseRotatingImp.h>
+#include <ripple/nodestore/impl/FetchStats.h>
+#include <ripple/protocol/jss.h>
 #include <test/jtx.h>
 #include <test/jtx/CheckMessageLogs.h>
 #include <test/jtx/envconfig.h>
@@ -678,6 +681,397 @@ public:
 
     //--------------------------------------------------------------------------
 
+    void
+    testBloomFilter(std::string const& type, std::int64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+        RootStoppable parent("TestRootStoppable");
+
+        testcase("bloom filter '" + type + "'");
+
+        beast::temp_dir node_db;
+        Section nodeParams;
+        nodeParams.set("type", type);
+        nodeParams.set("path", node_db.path());
+        nodeParams.set("bloom_filter_keys", std::to_string(numObjectsToTest));
+
+        auto const batch = createPredictableBatch(numObjectsToTest, seedValue);
+        auto const missing =
+            createPredictableBatch(numObjectsToTest, seedValue + 1);
+
+        auto check = [&](Database& db) {
+            Batch copy;
+            fetchCopyOfBatch(db, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+
+            fetchCopyOfBatch(db, &copy, missing);
+            BEAST_EXPECT(copy.empty());
+
+            // Most reads of missing objects never reach the backend
+            Json::Value counts{Json::objectValue};
+            db.getCountsJson(counts);
+            auto const filtered =
+                std::stoull(counts[jss::node_reads_filtered].asString());
+            auto const falsePositives = std::stoull(
+                counts[jss::node_reads_filter_false_positive].asString());
+            BEAST_EXPECT(filtered + falsePositives == missing.size());
+            BEAST_EXPECT(falsePositives < missing.size() / 20);
+        };
+
+        {
+            std::unique_ptr<Database> db = Manager::instance().make_Database(
+                "test",
+                megabytes(4),
+                scheduler,
+                2,
+                parent,
+                nodeParams,
+                journal_);
+            storeBatch(*db, batch);
+            check(*db);
+        }
+
+        {
+            // Re-open the database, restoring or rebuilding the filter
+            std::unique_ptr<Database> db = Manager::instance().make_Database(
+                "test",
+                megabytes(4),
+                scheduler,
+                2,
+                parent,
+                nodeParams,
+                journal_);
+            check(*db);
+        }
+
+        // Objects stored while the filter is off are found once it is on
+        // again, rather than being hidden by the filter saved before
+        auto const unfiltered =
+            createPredictableBatch(numObjectsToTest, seedValue + 2);
+        {
+            Section plainParams;
+            plainParams.set("type", type);
+            plainParams.set("path", node_db.path());
+            std::unique_ptr<Database> db = Manager::instance().make_Database(
+                "test",
+                megabytes(4),
+                scheduler,
+                2,
+                parent,
+                plainParams,
+                journal_);
+            storeBatch(*db, unfiltered);
+        }
+
+        {
+            std::unique_ptr<Database> db = Manager::instance().make_Database(
+                "test",
+                megabytes(4),
+                scheduler,
+                2,
+                parent,
+                nodeParams,
+                journal_);
+            Batch copy;
+            fetchCopyOfBatch(*db, &copy, unfiltered);
+            BEAST_EXPECT(areBatchesEqual(unfiltered, copy));
+            fetchCopyOfBatch(*db, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void
+    testBloomFilterRotating(std::int64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+        RootStoppable parent("TestRootStoppable");
+
+        testcase("bloom filter rotating");
+
+        beast::temp_dir node_db;
+        auto makeBackend = [&](std::string const& name) {
+            Section params;
+            params.set("type", "memory");
+            params.set("path", node_db.path() + "/" + name);
+            auto backend = Manager::instance().make_Backend(
+                params, megabytes(4), scheduler, journal_);
+            backend->open();
+            return backend;
+        };
+
+        // Reads from the archive copy objects to the writable backend, which
+        // ends up holding three batches
+        Section nodeParams;
+        nodeParams.set(
+            "bloom_filter_keys", std::to_string(4 * numObjectsToTest));
+        DatabaseRotatingImp db(
+            "test",
+            scheduler,
+            2,
+            parent,
+            makeBackend("a"),
+            makeBackend("b"),
+            nodeParams,
+            journal_);
+
+        auto const first = createPredictableBatch(numObjectsToTest, seedValue);
+        auto const second =
+            createPredictableBatch(numObjectsToTest, seedValue + 1);
+        auto const third =
+            createPredictableBatch(numObjectsToTest, seedValue + 2);
+        auto const missing =
+            createPredictableBatch(numObjectsToTest, seedValue + 3);
+
+        auto counter = [&](Json::StaticString const& key) -> std::uint64_t {
+            Json::Value counts{Json::objectValue};
+            db.getCountsJson(counts);
+            if (!counts.isMember(key))
+                return 0;
+            return std::stoull(counts[key].asString());
+        };
+
+        // Every stored object is found, and missing ones are looked for in
+        // both backends, mostly without reading either
+        auto check = [&](std::vector<Batch const*> const& stored) {
+            for (auto const batch : stored)
+            {
+                Batch copy;
+                fetchCopyOfBatch(db, &copy, *batch);
+                BEAST_EXPECT(areBatchesEqual(*batch, copy));
+            }
+
+            auto const filtered = counter(jss::node_reads_filtered);
+            auto const falsePositives =
+                counter(jss::node_reads_filter_false_positive);
+            Batch copy;
+            fetchCopyOfBatch(db, &copy, missing);
+            BEAST_EXPECT(copy.empty());
+            auto const newFiltered =
+                counter(jss::node_reads_filtered) - filtered;
+            auto const newFalsePositives =
+                counter(jss::node_reads_filter_false_positive) -
+                falsePositives;
+            BEAST_EXPECT(
+                newFiltered + newFalsePositives == 2 * missing.size());
+            BEAST_EXPECT(newFalsePositives < missing.size() / 10);
+        };
+
+        int backends = 0;
+        auto rotate = [&] {
+            db.rotateWithLock([&](std::string const&) {
+                return makeBackend("rotated" + std::to_string(++backends));
+            });
+        };
+
+        storeBatch(db, first);
+        check({&first});
+
+        // The first batch is now only in the archive backend
+        rotate();
+        storeBatch(db, second);
+        check({&first, &second});
+
+        // Reading the first batch above copied it to the writable backend,
+        // which becomes the archive, so nothing is lost
+        rotate();
+        storeBatch(db, third);
+        check({&first, &second, &third});
+    }
+
+    //--------------------------------------------------------------------------
+
+    void
+    testTiered(std::int64_t const seedValue)
+    {
+        DummyScheduler scheduler;
+        RootStoppable parent("TestRootStoppable");
+
+        testcase("tiered");
+
+        std::uint32_t const hotLedgers = 256;
+        beast::temp_dir hot_db;
+        beast::temp_dir cold_db;
+        Section nodeParams;
+        nodeParams.set("type", "nudb");
+        nodeParams.set("path", hot_db.path());
+        nodeParams.set("cold_type", "nudb");
+        nodeParams.set("cold_path", cold_db.path());
+        nodeParams.set("hot_ledgers", std::to_string(hotLedgers));
+
+        auto const first = createPredictableBatch(numObjectsToTest, seedValue);
+        auto const second =
+            createPredictableBatch(numObjectsToTest, seedValue + 1);
+        auto const old =
+            createPredictableBatch(numObjectsToTest, seedValue + 2);
+
+        auto store = [](Database& db, Batch const& batch, std::uint32_t seq) {
+            for (auto const& object : batch)
+            {
+                db.store(
+                    object->getType(),
+                    Blob(object->getData()),
+                    object->getHash(),
+                    seq);
+            }
+        };
+        auto counts = [](Database& db) {
+            Json::Value obj{Json::objectValue};
+            db.getCountsJson(obj);
+            return obj;
+        };
+        auto check = [&](Database& db, Batch const& batch) {
+            Batch copy;
+            fetchCopyOfBatch(db, &copy, batch);
+            BEAST_EXPECT(areBatchesEqual(batch, copy));
+        };
+
+        {
+            std::unique_ptr<Database> db = Manager::instance().make_Database(
+                "test",
+                megabytes(4),
+                scheduler,
+                2,
+                parent,
+                nodeParams,
+                journal_);
+
+            store(*db, first, 100);
+            check(*db, first);
+            BEAST_EXPECT(
+                counts(*db)[jss::node_reads_hot].asString() ==
+                std::to_string(first.size()));
+
+            // Starting a new generation retires and migrates the first
+            store(*db, second, 100 + hotLedgers);
+            using namespace std::chrono_literals;
+            for (int i = 0; i < 100 &&
+                 counts(*db)[jss::node_hot_generations].asInt() > 1;
+                 ++i)
+            {
+                std::this_thread::sleep_for(100ms);
+            }
+            auto const migrated = counts(*db);
+            BEAST_EXPECT(migrated[jss::node_hot_generations].asInt() == 1);
+            BEAST_EXPECT(
+                migrated[jss::node_migrated].asString() ==
+                std::to_string(first.size()));
+
+            // Objects of ledgers outside the hot window go to the cold tier
+            store(*db, old, 100);
+
+            check(*db, first);
+            check(*db, second);
+            check(*db, old);
+            BEAST_EXPECT(
+                counts(*db)[jss::node_reads_cold].asString() ==
+                std::to_string(first.size() + old.size()));
+        }
+
+        // The migrated generation has been removed from the hot tier
+        BEAST_EXPECT(!boost::filesystem::exists(
+            boost::filesystem::path(hot_db.path()) / "hot.100"));
+
+        {
+            // Re-open the database
+            std::unique_ptr<Database> db = Manager::instance().make_Database(
+                "test",
+                megabytes(4),
+                scheduler,
+                2,
+                parent,
+                nodeParams,
+                journal_);
+            check(*db, first);
+            check(*db, second);
+            check(*db, old);
+            BEAST_EXPECT(
+                counts(*db)[jss::node_reads_hot].asString() ==
+                std::to_string(second.size()));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void
+    testFetchStats(std::int64_t const seedValue)
+    {
+        testcase("fetch stats");
+
+        {
+            LatencyHistogram histogram;
+            BEAST_EXPECT(histogram.percentile(0.5) == 0);
+            for (int i = 0; i < 98; ++i)
+                histogram.add(std::chrono::microseconds{3});
+            histogram.add(std::chrono::microseconds{100});
+            histogram.add(std::chrono::seconds{100});
+            BEAST_EXPECT(histogram.count() == 100);
+            BEAST_EXPECT(histogram.percentile(0.5) == 4);
+            BEAST_EXPECT(histogram.percentile(0.99) == 128);
+            BEAST_EXPECT(
+                histogram.percentile(1.0) ==
+                std::uint64_t{1} << (LatencyHistogram::bucketCount - 1));
+        }
+
+        DummyScheduler scheduler;
+        RootStoppable parent("TestRootStoppable");
+
+        beast::temp_dir node_db;
+        Section nodeParams;
+        nodeParams.set("type", "nudb");
+        nodeParams.set("path", node_db.path());
+        nodeParams.set("cache_size", "1000");
+        nodeParams.set("cache_age", "10");
+        nodeParams.set("slow_fetch_ms", "60000");
+
+        auto const batch = createPredictableBatch(numObjectsToTest, seedValue);
+
+        std::unique_ptr<Database> db = Manager::instance().make_Database(
+            "test", megabytes(4), scheduler, 2, parent, nodeParams, journal_);
+        storeBatch(*db, batch);
+
+        Json::Value counts{Json::objectValue};
+        db->getCountsJson(counts);
+        BEAST_EXPECT(!counts.isMember(jss::node_read_stages));
+        BEAST_EXPECT(counts[jss::node_reads_slow].asString() == "0");
+
+        // Reads from the backend, then from the cache
+        Batch copy;
+        fetchCopyOfBatch(*db, &copy, batch);
+        fetchCopyOfBatch(*db, &copy, batch);
+        BEAST_EXPECT(areBatchesEqual(batch, copy));
+
+        counts = Json::objectValue;
+        db->getCountsJson(counts);
+        auto const& stages = counts[jss::node_read_stages];
+        auto const checkCount = [&](Json::Value const& stage, std::size_t n) {
+            BEAST_EXPECT(stage[jss::count].asString() == std::to_string(n));
+        };
+        auto const& sync = stages["synchronous"];
+        checkCount(sync["cache_lookup"], 2 * batch.size());
+        checkCount(sync["backend_read"], batch.size());
+        checkCount(sync["decode"], batch.size());
+        checkCount(sync["canonicalize"], batch.size());
+        checkCount(sync["total"], 2 * batch.size());
+        BEAST_EXPECT(!stages.isMember("async"));
+        checkCount(
+            stages[jss::backends]["node"]["synchronous"]["backend_read"],
+            batch.size());
+        BEAST_EXPECT(counts[jss::node_reads_slow].asString() == "0");
+
+        // A backend's statistics are resolved once, and those of backends
+        // which were never read are left out
+        BEAST_EXPECT(&db->fetchSource("node") == &db->fetchSource("node"));
+        db->fetchSource("unread");
+        counts = Json::objectValue;
+        db->getCountsJson(counts);
+        auto const& backends = counts[jss::node_read_stages][jss::backends];
+        BEAST_EXPECT(backends.size() == 1 && backends.isMember("node"));
+    }
+
+    //--------------------------------------------------------------------------
+
     void
     run() override
     {
@@ -708,6 +1102,14 @@ public:
             testImport("sqlite", "sqlite", seedValue);
 #endif
         }
+
+        testBloomFilter("memory", seedValue);
+        testBloomFilter("nudb", seedValue);
+        testBloomFilterRotating(seedValue);
+
+        testTiered(seedValue);
+
+        testFetchStats(seedValue);
     }
 };
 
@@ -0,0 +1,632 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/Output.h>
+#include <ripple/json/json_reader.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STJsonWriter.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/jss.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace ripple {
+
+namespace {
+
+AccountID const alice{1};
+AccountID const gw{2};
+
+STTx
+makePayment()
+{
+    Currency const usd = to_currency("USD");
+    return STTx(ttPAYMENT, [&](STObject& obj) {
+        obj.setAccountID(sfAccount, alice);
+        obj.setAccountID(sfDestination, gw);
+        obj.setFieldAmount(sfAmount, STAmount{Issue{usd, gw}, 100});
+        obj.setFieldAmount(sfFee, XRPAmount{12});
+        obj.setFieldU32(sfSequence, 42);
+        obj.setFieldVL(sfSigningPubKey, Blob(33, 0x02));
+        obj.setFieldVL(sfTxnSignature, Blob(71, 0x30));
+
+        STArray memos(sfMemos, 2);
+        memos.emplace_back(sfMemo);
+        memos.back().setFieldVL(sfMemoType, Blob(4, 0x74));
+        memos.back().setFieldVL(sfMemoData, Blob(32, 0x41));
+        memos.emplace_back(sfMemo);
+        memos.back().setFieldVL(sfMemoData, Blob(1, 0x42));
+        obj.setFieldArray(sfMemos, memos);
+    });
+}
+
+// Metadata in the shape of a payment's, with nested arrays and objects.
+STObject
+makeMeta()
+{
+    Currency const usd = to_currency("USD");
+    STObject meta(sfTransactionMetaData);
+    meta.setFieldU32(sfTransactionIndex, 3);
+    meta.setFieldU8(sfTransactionResult, 0);
+
+    STArray nodes(sfAffectedNodes, 2);
+    nodes.emplace_back(sfModifiedNode);
+    {
+        auto& node = nodes.back();
+        node.setFieldU16(sfLedgerEntryType, ltRIPPLE_STATE);
+        node.setFieldH256(sfLedgerIndex, keylet::line(alice, gw, usd).key);
+
+        STObject final(sfFinalFields);
+        final.setFieldAmount(sfBalance, STAmount{Issue{usd, noAccount()}, 5});
+        final.setFieldU32(sfFlags, 0x10000);
+        node.emplace_back(std::move(final));
+
+        STObject previous(sfPreviousFields);
+        previous.setFieldAmount(
+            sfBalance, STAmount{Issue{usd, noAccount()}, 105});
+        node.emplace_back(std::move(previous));
+    }
+    nodes.emplace_back(sfDeletedNode);
+    {
+        auto& node = nodes.back();
+        node.setFieldU16(sfLedgerEntryType, ltOFFER);
+        node.setFieldH256(sfLedgerIndex, keylet::offer(alice, 7).key);
+    }
+    meta.setFieldArray(sfAffectedNodes, nodes);
+    meta.setFieldAmount(sfDeliveredAmount, STAmount{Issue{usd, gw}, 100});
+    return meta;
+}
+
+// Ledger entries in the mix of a ledger_data page: accounts, trust lines
+// and offers.
+std::vector<std::shared_ptr<SLE>>
+makeEntries(std::size_t count)
+{
+    Currency const usd = to_currency("USD");
+    std::vector<std::shared_ptr<SLE>> entries;
+    entries.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        AccountID const account{i + 100};
+        std::int64_t const n = i;
+        std::shared_ptr<SLE> sle;
+        switch (i % 3)
+        {
+            case 0:
+                sle = std::make_shared<SLE>(keylet::account(account));
+                sle->setAccountID(sfAccount, account);
+                sle->setFieldAmount(sfBalance, XRPAmount{1000000000 + n});
+                sle->setFieldU32(sfSequence, i + 1);
+                sle->setFieldU32(sfOwnerCount, 2);
+                sle->setFieldH256(sfPreviousTxnID, uint256{i + 1});
+                sle->setFieldU32(sfPreviousTxnLgrSeq, 70000000);
+                break;
+            case 1:
+                sle = std::make_shared<SLE>(keylet::line(account, gw, usd));
+                sle->setFieldAmount(
+                    sfBalance, STAmount{Issue{usd, noAccount()}, i, -2});
+                sle->setFieldAmount(
+                    sfLowLimit, STAmount{Issue{usd, account}, 1000});
+                sle->setFieldAmount(sfHighLimit, STAmount{Issue{usd, gw}, 0});
+                sle->setFieldU32(sfFlags, 0x20000);
+                sle->setFieldU64(sfLowNode, 0);
+                sle->setFieldU64(sfHighNode, i);
+                sle->setFieldH256(sfPreviousTxnID, uint256{i + 1});
+                sle->setFieldU32(sfPreviousTxnLgrSeq, 70000000);
+                break;
+            default:
+                sle = std::make_shared<SLE>(keylet::offer(account, i));
+                sle->setAccountID(sfAccount, account);
+                sle->setFieldU32(sfSequence, i);
+                sle->setFieldAmount(
+                    sfTakerPays, STAmount{Issue{usd, gw}, 1000 + i, -1});
+                sle->setFieldAmount(sfTakerGets, XRPAmount{1000000 * n});
+                sle->setFieldH256(sfBookDirectory, uint256{i});
+                sle->setFieldU64(sfBookNode, 0);
+                sle->setFieldU64(sfOwnerNode, 0);
+                sle->setFieldH256(sfPreviousTxnID, uint256{i + 1});
+                sle->setFieldU32(sfPreviousTxnLgrSeq, 70000000);
+                break;
+        }
+        entries.push_back(std::move(sle));
+    }
+    return entries;
+}
+
+template <class T, class... Args>
+std::string
+written(T const& object, Args... args)
+{
+    std::string s;
+    {
+        auto root = Json::stringWriterObject(s);
+        writeJson(*root, object, args...);
+    }
+    return s;
+}
+
+template <class T>
+std::string
+writtenCBOR(T const& object)
+{
+    std::string s;
+    {
+        Json::WriterObject root(
+            Json::stringOutput(s), Json::Writer::Format::cbor);
+        writeJson(*root, object);
+    }
+    return s;
+}
+
+// Reads the CBOR written by Json::Writer into a Json::Value, with byte
+// strings as hex and decimal fractions as "<mantissa>e<exponent>".
+class CBORReader
+{
+    std::string const& s_;
+    std::size_t pos_ = 0;
+
+    std::uint8_t
+    byte()
+    {
+        if (pos_ == s_.size())
+            Throw<std::runtime_error>("CBOR truncated");
+        return static_cast<std::uint8_t>(s_[pos_++]);
+    }
+
+    std::uint64_t
+    argument(std::uint8_t info)
+    {
+        if (info < 24)
+            return info;
+        if (info > 27)
+            Throw<std::runtime_error>("CBOR argument");
+        std::uint64_t value = 0;
+        for (std::size_t n = std::size_t{1} << (info - 24); n != 0; --n)
+            value = (value << 8) | byte();
+        return value;
+    }
+
+    bool
+    atBreak()
+    {
+        if (pos_ < s_.size() && static_cast<std::uint8_t>(s_[pos_]) == 0xff)
+        {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+public:
+    explicit CBORReader(std::string const& s) : s_(s)
+    {
+    }
+
+    bool
+    done() const
+    {
+        return pos_ == s_.size();
+    }
+
+    Json::Value
+    read()
+    {
+        auto const initial = byte();
+        auto const info = initial & 0x1f;
+        switch (initial >> 5)
+        {
+            case 0: {
+                auto const value = argument(info);
+                if (value <= std::numeric_limits<Json::UInt>::max())
+                    return Json::UInt(value);
+                return std::to_string(value);
+            }
+            case 1: {
+                auto const value =
+                    -1 - static_cast<std::int64_t>(argument(info));
+                if (value >= std::numeric_limits<Json::Int>::min())
+                    return Json::Int(value);
+                return std::to_string(value);
+            }
+            case 2: {
+                auto const size = argument(info);
+                auto const bytes = s_.substr(pos_, size);
+                pos_ += size;
+                return strHex(bytes);
+            }
+            case 3: {
+                auto const size = argument(info);
+                auto const text = s_.substr(pos_, size);
+                pos_ += size;
+                return text;
+            }
+            case 4: {
+                Json::Value array(Json::arrayValue);
+                if (info == 31)
+                {
+                    while (!atBreak())
+                        array.append(read());
+                }
+                else
+                {
+                    for (auto n = argument(info); n != 0; --n)
+                        array.append(read());
+                }
+                return array;
+            }
+            case 5: {
+                if (info != 31)
+                    Throw<std::runtime_error>("CBOR map length");
+                Json::Value object(Json::objectValue);
+                while (!atBreak())
+                {
+                    auto const key = read().asString();
+                    object[key] = read();
+                }
+                return object;
+            }
+            case 6: {
+                if (argument(info) != 4)
+                    Throw<std::runtime_error>("CBOR tag");
+                auto const fraction = read();
+                return fraction[1u].asString() + "e" +
+                    fraction[0u].asString();
+            }
+            default:
+                if (initial == 0xf4 || initial == 0xf5)
+                    return initial == 0xf5;
+                if (initial == 0xf6)
+                    return Json::nullValue;
+                Throw<std::runtime_error>("CBOR simple value");
+        }
+        return {};
+    }
+};
+
+}  // namespace
+
+class STJsonWriter_test : public beast::unit_test::suite
+{
+    // The written text must parse to the same value as getJson.
+    void
+    check(std::string const& text, Json::Value const& expected)
+    {
+        Json::Value parsed;
+        BEAST_EXPECT(Json::Reader().parse(text, parsed));
+        BEAST_EXPECT(parsed == expected);
+    }
+
+    void
+    testTransaction()
+    {
+        testcase("Transaction");
+
+        auto const tx = makePayment();
+        check(written(tx), tx.getJson(JsonOptions::none));
+    }
+
+    void
+    testMetadata()
+    {
+        testcase("Metadata");
+
+        auto const meta = makeMeta();
+        check(written(meta), meta.getJson(JsonOptions::none));
+        check(
+            written(meta, JsonOptions::include_date),
+            meta.getJson(JsonOptions::include_date));
+
+        // Absent optional fields are not written
+        STObject empty(sfTransactionMetaData);
+        BEAST_EXPECT(written(empty) == "{}");
+    }
+
+    void
+    testLedgerEntry()
+    {
+        testcase("Ledger entry");
+
+        Currency const usd = to_currency("USD");
+        auto const sle = std::make_shared<SLE>(keylet::line(alice, gw, usd));
+        sle->setFieldAmount(sfBalance, STAmount{Issue{usd, noAccount()}, 5});
+        sle->setFieldAmount(sfLowLimit, STAmount{Issue{usd, alice}, 100});
+        sle->setFieldAmount(sfHighLimit, STAmount{Issue{usd, gw}, 0});
+        sle->setFieldU64(sfLowNode, 3);
+        check(written(*sle), sle->getJson(JsonOptions::none));
+
+        auto const dir =
+            std::make_shared<SLE>(keylet::page(keylet::ownerDir(alice), 0));
+        dir->setAccountID(sfOwner, alice);
+        dir->setFieldH256(sfRootIndex, dir->key());
+        STVector256 indexes;
+        indexes.push_back(sle->key());
+        indexes.push_back(keylet::offer(alice, 7).key);
+        dir->setFieldV256(sfIndexes, indexes);
+        check(written(*dir), dir->getJson(JsonOptions::none));
+    }
+
+    void
+    testCBOR()
+    {
+        testcase("CBOR");
+
+        Currency const usd = to_currency("USD");
+        {
+            auto const tx = makePayment();
+            auto const cbor = writtenCBOR(tx);
+            CBORReader reader(cbor);
+            auto const value = reader.read();
+            BEAST_EXPECT(reader.done());
+
+            // Accounts, blobs and hashes are bytes
+            BEAST_EXPECT(value[sfAccount.jsonName] == strHex(alice));
+            BEAST_EXPECT(value[sfDestination.jsonName] == strHex(gw));
+            BEAST_EXPECT(
+                value[sfSigningPubKey.jsonName] == strHex(Blob(33, 0x02)));
+            BEAST_EXPECT(
+                value[jss::hash] == to_string(tx.getTransactionID()));
+
+            // XRP is an integer, other amounts a decimal fraction
+            BEAST_EXPECT(value[sfFee.jsonName] == 12);
+            auto const& amount = value[sfAmount.jsonName];
+            BEAST_EXPECT(amount[jss::currency] == strHex(usd));
+            BEAST_EXPECT(amount[jss::issuer] == strHex(gw));
+            BEAST_EXPECT(amount[jss::value] == "1000000000000000e-13");
+
+            // Other fields are as in JSON
+            auto const json = tx.getJson(JsonOptions::none);
+            BEAST_EXPECT(value[sfSequence.jsonName] == 42);
+            BEAST_EXPECT(
+                value[sfTransactionType.jsonName] ==
+                json[sfTransactionType.jsonName]);
+            BEAST_EXPECT(value[sfMemos.jsonName] == json[sfMemos.jsonName]);
+            BEAST_EXPECT(value.size() == json.size());
+        }
+        {
+            auto const sle =
+                std::make_shared<SLE>(keylet::line(alice, gw, usd));
+            sle->setFieldAmount(
+                sfBalance, STAmount{Issue{usd, noAccount()}, -5});
+            sle->setFieldAmount(sfHighLimit, STAmount{Issue{usd, gw}, 0});
+            sle->setFieldU64(sfLowNode, 0x1234567890ull);
+            auto const cbor = writtenCBOR(*sle);
+            CBORReader reader(cbor);
+            auto const value = reader.read();
+            BEAST_EXPECT(reader.done());
+
+            BEAST_EXPECT(value[jss::index] == to_string(sle->key()));
+            BEAST_EXPECT(
+                value[sfBalance.jsonName][jss::value] ==
+                "-5000000000000000e-15");
+            BEAST_EXPECT(value[sfHighLimit.jsonName][jss::value] == "0e0");
+            BEAST_EXPECT(value[sfLowNode.jsonName] == "78187493520");
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testTransaction();
+        testMetadata();
+        testLedgerEntry();
+        testCBOR();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(STJsonWriter, protocol, ripple);
+
+//------------------------------------------------------------------------------
+
+/*  Compares building a Json::Value and converting it to a string with
+    writing the JSON or CBOR directly from a transaction and its metadata.
+
+    It then compares the size and the time to write JSON and CBOR replies
+    in the shape of those of ledger_data (a page of ledger entries), ledger
+    (an expanded ledger with metadata) and account_tx.  The first two are
+    streamed from the STObjects, as their handlers do, and account_tx
+    converts the Json::Value its handler builds.
+
+    Usage:
+        rippled --unittest=STJsonWriterBenchmark --unittest-arg=<count>
+*/
+class STJsonWriterBenchmark_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+    using Format = Json::Writer::Format;
+
+    template <class F>
+    void
+    measure(std::string const& name, std::size_t count, F&& f)
+    {
+        std::uint64_t bytes = 0;
+        for (std::size_t i = 0; i < std::min<std::size_t>(count, 100); ++i)
+            bytes += f();
+
+        bytes = 0;
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < count; ++i)
+            bytes += f();
+        auto const elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_type::now() - start);
+
+        std::ostringstream ss;
+        ss << std::left << std::setw(20) << name << std::right << std::fixed
+           << std::setprecision(1) << std::setw(12)
+           << double(elapsed.count()) / count << " ns/op" << std::setw(9)
+           << bytes / count << " bytes";
+        log << ss.str() << std::endl;
+        BEAST_EXPECT(bytes != 0);
+    }
+
+    template <class F>
+    static std::size_t
+    reply(Format format, F&& f)
+    {
+        std::string s;
+        {
+            Json::WriterObject root(Json::stringOutput(s), format);
+            f(*root);
+        }
+        return s.size();
+    }
+
+    void
+    measureLedgerData(std::size_t count)
+    {
+        auto const entries = makeEntries(256);
+        auto const write = [&](Format format) {
+            return reply(format, [&](Json::Object& root) {
+                root[jss::ledger_index] = 70000000;
+                root[jss::marker] = to_string(entries.back()->key());
+                auto state = Json::setArray(root, jss::state);
+                for (auto const& sle : entries)
+                {
+                    auto entry = state.appendObject();
+                    writeJson(entry, *sle);
+                }
+            });
+        };
+        measure("ledger_data JSON", count, [&]() {
+            return write(Format::json);
+        });
+        measure("ledger_data CBOR", count, [&]() {
+            return write(Format::cbor);
+        });
+    }
+
+    void
+    measureLedger(std::size_t count)
+    {
+        auto const tx = makePayment();
+        auto const meta = makeMeta();
+        auto const write = [&](Format format) {
+            return reply(format, [&](Json::Object& root) {
+                auto ledger = Json::addObject(root, jss::ledger);
+                ledger[jss::ledger_index] = "70000000";
+                ledger[jss::ledger_hash] = to_string(uint256{1});
+                ledger[jss::parent_hash] = to_string(uint256{2});
+                ledger[jss::closed] = true;
+                auto txns = Json::setArray(ledger, jss::transactions);
+                for (int i = 0; i < 200; ++i)
+                {
+                    auto txJson = txns.appendObject();
+                    writeJson(txJson, tx);
+                    auto object = Json::addObject(txJson, jss::metaData);
+                    writeJson(object, meta);
+                }
+            });
+        };
+        measure("ledger JSON", count, [&]() { return write(Format::json); });
+        measure("ledger CBOR", count, [&]() { return write(Format::cbor); });
+    }
+
+    void
+    measureAccountTx(std::size_t count)
+    {
+        auto const tx = makePayment();
+        auto const meta = makeMeta();
+        Json::Value result(Json::objectValue);
+        result[jss::account] = toBase58(alice);
+        result[jss::ledger_index_min] = 1;
+        result[jss::ledger_index_max] = 70000000;
+        auto& txns = result[jss::transactions] = Json::arrayValue;
+        for (int i = 0; i < 200; ++i)
+        {
+            auto& entry = txns.append(Json::objectValue);
+            entry[jss::tx] = tx.getJson(JsonOptions::none);
+            entry[jss::meta] = meta.getJson(JsonOptions::none);
+            entry[jss::validated] = true;
+        }
+
+        measure("account_tx JSON", count, [&]() {
+            std::string s;
+            Json::outputJson(result, Json::stringOutput(s));
+            return s.size();
+        });
+        measure("account_tx CBOR", count, [&]() {
+            std::string s;
+            Json::outputCBOR(result, Json::stringOutput(s));
+            return s.size();
+        });
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 100000;
+        if (!arg().empty())
+            count = beast::lexicalCastThrow<std::size_t>(arg());
+
+        auto const tx = makePayment();
+        auto const meta = makeMeta();
+
+        measure("Json::Value", count, [&]() {
+            auto json = tx.getJson(JsonOptions::none);
+            json["metaData"] = meta.getJson(JsonOptions::none);
+            return to_string(json).size();
+        });
+
+        measure("writeJson", count, [&]() {
+            std::string s;
+            {
+                auto root = Json::stringWriterObject(s);
+                writeJson(*root, tx);
+                auto object = root->setObject("metaData");
+                writeJson(object, meta);
+            }
+            return s.size();
+        });
+
+        measure("writeJson CBOR", count, [&]() {
+            std::string s;
+            {
+                Json::WriterObject root(
+                    Json::stringOutput(s), Json::Writer::Format::cbor);
+                writeJson(*root, tx);
+                auto object = root->setObject("metaData");
+                writeJson(object, meta);
+            }
+            return s.size();
+        });
+
+        // Each reply holds a few hundred entries
+        auto const replies = std::max<std::size_t>(count / 200, 1);
+        measureLedgerData(replies);
+        measureLedger(replies);
+        measureAccountTx(replies);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STJsonWriterBenchmark, protocol, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,455 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/Buffer.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STLedgerEntryView.h>
+#include <ripple/protocol/st.h>
+#include <test/jtx.h>
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace ripple {
+
+namespace {
+
+std::shared_ptr<SLEView const>
+makeView(SLE const& sle)
+{
+    Serializer s;
+    sle.add(s);
+    auto const buffer = std::make_shared<Buffer const>(s.slice());
+    return std::make_shared<SLEView const>(buffer, *buffer, sle.key());
+}
+
+std::shared_ptr<SLE>
+makeAccountRoot(AccountID const& id)
+{
+    auto sle = std::make_shared<SLE>(keylet::account(id));
+    sle->setAccountID(sfAccount, id);
+    sle->setFieldU32(sfSequence, 17);
+    sle->setFieldAmount(sfBalance, XRPAmount{123456789});
+    sle->setFieldU32(sfOwnerCount, 4);
+    sle->setFieldH256(sfPreviousTxnID, uint256{42});
+    sle->setFieldU32(sfPreviousTxnLgrSeq, 1234);
+    sle->setFieldU32(sfFlags, lsfRequireDestTag | lsfDefaultRipple);
+    sle->setFieldH128(sfEmailHash, uint128{7});
+    sle->setFieldVL(sfDomain, makeSlice(std::string("example.com")));
+    return sle;
+}
+
+std::shared_ptr<SLE>
+makeRippleState(AccountID const& low, AccountID const& high)
+{
+    Currency const usd = to_currency("USD");
+    auto sle = std::make_shared<SLE>(keylet::line(low, high, usd));
+    sle->setFieldAmount(sfBalance, STAmount{Issue{usd, noAccount()}, 25, -1});
+    sle->setFieldAmount(sfLowLimit, STAmount{Issue{usd, low}, 1000});
+    sle->setFieldAmount(sfHighLimit, STAmount{Issue{usd, high}, 0});
+    sle->setFieldH256(sfPreviousTxnID, uint256{43});
+    sle->setFieldU32(sfPreviousTxnLgrSeq, 1235);
+    sle->setFieldU64(sfLowNode, 0);
+    sle->setFieldU64(sfHighNode, 3);
+    sle->setFieldU32(sfFlags, lsfLowReserve | lsfHighNoRipple);
+    return sle;
+}
+
+std::shared_ptr<SLE>
+makeOffer(AccountID const& owner, AccountID const& issuer)
+{
+    Currency const usd = to_currency("USD");
+    auto sle = std::make_shared<SLE>(keylet::offer(owner, 9));
+    sle->setAccountID(sfAccount, owner);
+    sle->setFieldU32(sfSequence, 9);
+    sle->setFieldAmount(sfTakerPays, XRPAmount{5000000});
+    sle->setFieldAmount(sfTakerGets, STAmount{Issue{usd, issuer}, 5});
+    sle->setFieldH256(sfBookDirectory, uint256{44});
+    sle->setFieldU64(sfBookNode, 0);
+    sle->setFieldU64(sfOwnerNode, 1);
+    sle->setFieldH256(sfPreviousTxnID, uint256{45});
+    sle->setFieldU32(sfPreviousTxnLgrSeq, 1236);
+    return sle;
+}
+
+}  // namespace
+
+class STLedgerEntryView_test : public beast::unit_test::suite
+{
+    void
+    testAccountRoot()
+    {
+        testcase("AccountRoot");
+
+        auto const alice = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("alice")).first);
+        auto const sle = makeAccountRoot(alice);
+        auto const view = makeView(*sle);
+
+        BEAST_EXPECT(view->key() == sle->key());
+        BEAST_EXPECT(view->getType() == ltACCOUNT_ROOT);
+        BEAST_EXPECT(keylet::account(alice).check(*view));
+        BEAST_EXPECT(!keylet::offer(alice, 1).check(*view));
+
+        BEAST_EXPECT(view->getAccountID(sfAccount) == alice);
+        BEAST_EXPECT(view->getFieldU32(sfSequence) == 17);
+        BEAST_EXPECT(
+            view->getFieldAmount(sfBalance).xrp() == XRPAmount{123456789});
+        BEAST_EXPECT(view->getFieldU32(sfOwnerCount) == 4);
+        BEAST_EXPECT(view->getFieldH256(sfPreviousTxnID) == uint256{42});
+        BEAST_EXPECT(view->getFieldH128(sfEmailHash) == uint128{7});
+        BEAST_EXPECT(view->getFlags() == sle->getFlags());
+        BEAST_EXPECT(view->isFlag(lsfRequireDestTag));
+        BEAST_EXPECT(!view->isFlag(lsfDisallowXRP));
+        BEAST_EXPECT(view->getFieldVL(sfDomain) == sle->getFieldVL(sfDomain));
+        BEAST_EXPECT((*view)[sfDomain] == (*sle)[sfDomain]);
+        BEAST_EXPECT((*view)[sfOwnerCount] == 4);
+        BEAST_EXPECT((*view)[~sfOwnerCount] == 4u);
+
+        // Absent optional fields behave as they do for STObject
+        BEAST_EXPECT(view->isFieldPresent(sfDomain));
+        BEAST_EXPECT(!view->isFieldPresent(sfRegularKey));
+        BEAST_EXPECT(
+            view->getAccountID(sfRegularKey) ==
+            sle->getAccountID(sfRegularKey));
+        BEAST_EXPECT(!(*view)[~sfRegularKey]);
+        BEAST_EXPECT(!(*view)[~sfExpiration]);
+        try
+        {
+            (*view)[sfRegularKey];
+            fail("missing optional field");
+        }
+        catch (STObject::FieldErr const&)
+        {
+            pass();
+        }
+
+        // Fields outside of the format can't be read by value
+        try
+        {
+            view->getFieldU32(sfExpiration);
+            fail("field not in format");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+
+        BEAST_EXPECT(*view->sle() == *sle);
+    }
+
+    void
+    testRippleStateAndOffer()
+    {
+        testcase("RippleState and Offer");
+
+        auto const alice = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("alice")).first);
+        auto const gw = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("gw")).first);
+        auto const low = std::min(alice, gw);
+        auto const high = std::max(alice, gw);
+
+        {
+            auto const sle = makeRippleState(low, high);
+            auto const view = makeView(*sle);
+            BEAST_EXPECT(view->getType() == ltRIPPLE_STATE);
+            for (auto const field : {&sfBalance, &sfLowLimit, &sfHighLimit})
+            {
+                auto const amount = view->getFieldAmount(*field);
+                BEAST_EXPECT(amount == sle->getFieldAmount(*field));
+                BEAST_EXPECT(
+                    amount.issue() == sle->getFieldAmount(*field).issue());
+            }
+            BEAST_EXPECT(view->getFieldU64(sfHighNode) == 3);
+            BEAST_EXPECT(view->isFlag(lsfHighNoRipple));
+            BEAST_EXPECT(!view->isFieldPresent(sfLowQualityIn));
+            BEAST_EXPECT(view->getFieldU32(sfLowQualityIn) == 0);
+            BEAST_EXPECT(*view->sle() == *sle);
+        }
+
+        {
+            auto const sle = makeOffer(alice, gw);
+            auto const view = makeView(*sle);
+            BEAST_EXPECT(keylet::offer(alice, 9).check(*view));
+            BEAST_EXPECT(view->getAccountID(sfAccount) == alice);
+            BEAST_EXPECT(
+                view->getFieldAmount(sfTakerPays) ==
+                sle->getFieldAmount(sfTakerPays));
+            BEAST_EXPECT(
+                view->getFieldAmount(sfTakerGets) ==
+                sle->getFieldAmount(sfTakerGets));
+            BEAST_EXPECT((*view)[sfBookDirectory] == uint256{44});
+            BEAST_EXPECT(view->getFieldU64(sfOwnerNode) == 1);
+            BEAST_EXPECT(*view->sle() == *sle);
+        }
+    }
+
+    void
+    testInnerObjects()
+    {
+        testcase("Inner objects");
+
+        auto const alice = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("alice")).first);
+
+        {
+            // Fields are located past an array of inner objects
+            auto sle = std::make_shared<SLE>(keylet::signers(alice));
+            sle->setFieldU64(sfOwnerNode, 2);
+            sle->setFieldU32(sfSignerQuorum, 3);
+            STArray entries;
+            for (auto const& name : {"bob", "carol"})
+            {
+                entries.emplace_back(sfSignerEntry);
+                auto& entry = entries.back();
+                entry.setAccountID(
+                    sfAccount,
+                    calcAccountID(generateKeyPair(
+                                      KeyType::secp256k1, generateSeed(name))
+                                      .first));
+                entry.setFieldU16(sfSignerWeight, 2);
+            }
+            sle->setFieldArray(sfSignerEntries, entries);
+            sle->setFieldU32(sfSignerListID, 0);
+            sle->setFieldH256(sfPreviousTxnID, uint256{46});
+            sle->setFieldU32(sfPreviousTxnLgrSeq, 1237);
+
+            auto const view = makeView(*sle);
+            BEAST_EXPECT(view->getType() == ltSIGNER_LIST);
+            BEAST_EXPECT(view->getFieldU32(sfSignerQuorum) == 3);
+            BEAST_EXPECT(view->getFieldU64(sfOwnerNode) == 2);
+            BEAST_EXPECT(view->isFieldPresent(sfSignerEntries));
+            BEAST_EXPECT(view->getFieldU32(sfPreviousTxnLgrSeq) == 1237);
+            BEAST_EXPECT(*view->sle() == *sle);
+        }
+
+        {
+            auto sle = std::make_shared<SLE>(keylet::ownerDir(alice));
+            STVector256 indexes;
+            for (int i = 1; i <= 5; ++i)
+                indexes.push_back(uint256{i});
+            sle->setFieldV256(sfIndexes, indexes);
+            sle->setFieldH256(sfRootIndex, sle->key());
+            sle->setAccountID(sfOwner, alice);
+
+            auto const view = makeView(*sle);
+            BEAST_EXPECT(view->getFieldV256(sfIndexes) == indexes);
+            BEAST_EXPECT((*view)[sfIndexes] == indexes.value());
+            BEAST_EXPECT(view->getAccountID(sfOwner) == alice);
+        }
+    }
+
+    void
+    testMalformed()
+    {
+        testcase("Malformed");
+
+        auto const alice = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("alice")).first);
+        auto const sle = makeAccountRoot(alice);
+
+        Serializer s;
+        sle->add(s);
+        auto const buffer =
+            std::make_shared<Buffer const>(s.data(), s.size() - 3);
+        SLEView const view(buffer, *buffer, sle->key());
+        try
+        {
+            view.getFieldU32(sfSequence);
+            fail("truncated entry");
+        }
+        catch (std::runtime_error const&)
+        {
+            pass();
+        }
+    }
+
+    void
+    testReadLazy()
+    {
+        testcase("readLazy");
+
+        using namespace test::jtx;
+        Env env{*this};
+        Account const alice{"alice"};
+        Account const bob{"bob"};
+        env.fund(XRP(10000), alice);
+        env.close();
+
+        // A closed ledger decodes from its state map
+        {
+            auto const view = env.closed()->readLazy(keylet::account(alice));
+            if (BEAST_EXPECT(view))
+            {
+                BEAST_EXPECT(
+                    view->getFieldAmount(sfBalance) ==
+                    env.balance(alice).value());
+                auto const sle = env.closed()->read(keylet::account(alice));
+                BEAST_EXPECT(*view->sle() == *sle);
+            }
+            BEAST_EXPECT(!env.closed()->readLazy(keylet::account(bob)));
+            BEAST_EXPECT(!env.closed()->readLazy(
+                Keylet{ltOFFER, keylet::account(alice).key}));
+        }
+
+        // The open ledger sees its own modifications
+        env(noop(alice));
+        {
+            auto const view = env.current()->readLazy(keylet::account(alice));
+            if (BEAST_EXPECT(view))
+                BEAST_EXPECT(view->getFieldU32(sfSequence) == env.seq(alice));
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testAccountRoot();
+        testRippleStateAndOffer();
+        testInnerObjects();
+        testMalformed();
+        testReadLazy();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(STLedgerEntryView, protocol, ripple);
+
+//------------------------------------------------------------------------------
+
+/*  Compares full deserialization of ledger entries with lazy views.
+
+    Each case reads the fields a typical read-only caller needs, with the
+    entry and the view allocated as they are when read from a ReadView.
+
+    Usage:
+        rippled --unittest=STLedgerEntryViewBenchmark --unittest-arg=<count>
+*/
+class STLedgerEntryViewBenchmark_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    std::chrono::nanoseconds
+    measure(std::size_t count, F&& f)
+    {
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < count; ++i)
+            f();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   clock_type::now() - start) /
+            count;
+    }
+
+    template <class Read>
+    void
+    compare(
+        std::string const& name,
+        SLE const& sle,
+        std::size_t count,
+        Read&& read)
+    {
+        Serializer s;
+        sle.add(s);
+        auto const buffer = std::make_shared<Buffer const>(s.slice());
+        Slice const data = *buffer;
+
+        std::uint64_t sink = 0;
+        auto const full = measure(count, [&]() {
+            auto const entry =
+                std::make_shared<SLE const>(SerialIter{data}, sle.key());
+            sink += read(*entry);
+        });
+        auto const lazy = measure(count, [&]() {
+            auto const view =
+                std::make_shared<SLEView const>(buffer, data, sle.key());
+            sink += read(*view);
+        });
+        auto const all = measure(count, [&]() {
+            auto const view =
+                std::make_shared<SLEView const>(buffer, data, sle.key());
+            sink += read(*view->sle());
+        });
+
+        std::ostringstream ss;
+        ss << std::left << std::setw(12) << name << std::right
+           << " size=" << std::setw(4) << data.size()
+           << " full=" << std::setw(6) << full.count() << "ns"
+           << " lazy=" << std::setw(6) << lazy.count() << "ns"
+           << " lazy+sle=" << std::setw(6) << all.count() << "ns"
+           << " speedup=" << std::fixed << std::setprecision(2)
+           << (lazy.count() ? double(full.count()) / lazy.count() : 0.0)
+           << "x";
+        log << ss.str() << std::endl;
+        BEAST_EXPECT(sink != 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 100000;
+        if (!arg().empty())
+            count = beast::lexicalCastThrow<std::size_t>(arg());
+
+        auto const alice = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("alice")).first);
+        auto const gw = calcAccountID(
+            generateKeyPair(KeyType::secp256k1, generateSeed("gw")).first);
+
+        // account_info and reserve checks
+        compare(
+            "AccountRoot",
+            *makeAccountRoot(alice),
+            count,
+            [](auto const& entry) -> std::uint64_t {
+                return entry.getFieldAmount(sfBalance).xrp().drops() +
+                    entry.getFieldU32(sfOwnerCount) + entry.getFlags();
+            });
+
+        // account_lines and path finding
+        compare(
+            "RippleState",
+            *makeRippleState(std::min(alice, gw), std::max(alice, gw)),
+            count,
+            [](auto const& entry) -> std::uint64_t {
+                return entry.getFieldAmount(sfBalance).mantissa() +
+                    entry.getFlags();
+            });
+
+        // book_offers and offer crossing
+        compare(
+            "Offer",
+            *makeOffer(alice, gw),
+            count,
+            [](auto const& entry) -> std::uint64_t {
+                return entry.getFieldAmount(sfTakerPays).mantissa() +
+                    entry.getFieldAmount(sfTakerGets).mantissa() +
+                    entry.getAccountID(sfAccount).begin()[0];
+            });
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STLedgerEntryViewBenchmark, protocol, ripple);
+
+}  // namespace ripple
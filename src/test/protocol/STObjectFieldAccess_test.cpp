@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/LedgerFormats.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STLedgerEntry.h>
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace ripple {
+
+/*  Measures the cost of reading fields from a ledger entry.
+
+    The typed getters find a field through the object's template and check
+    its type against the serialized type of the requested class. The
+    "dynamic_cast" case repeats the lookup with a dynamic_cast for
+    comparison, and the "getField" case looks fields up by their code as
+    the deserializer does.
+
+    Usage:
+        rippled --unittest=STObjectFieldAccess --unittest-arg=<count>
+*/
+class STObjectFieldAccess_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    void
+    measure(std::string const& name, std::size_t count, F&& f)
+    {
+        std::uint64_t sink = 0;
+        for (std::size_t i = 0; i < 1000; ++i)
+            sink += f();
+
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < count; ++i)
+            sink += f();
+        auto const elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_type::now() - start);
+
+        std::ostringstream ss;
+        ss << std::left << std::setw(20) << name << std::right << std::fixed
+           << std::setprecision(1) << std::setw(8)
+           << double(elapsed.count()) / count << " ns/op";
+        log << ss.str() << std::endl;
+        BEAST_EXPECT(sink != 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 10000000;
+        if (!arg().empty())
+            count = beast::lexicalCastThrow<std::size_t>(arg());
+
+        Currency const usd = to_currency("USD");
+        AccountID const alice{1};
+        AccountID const gw{2};
+
+        auto const sle = std::make_shared<SLE>(keylet::line(alice, gw, usd));
+        sle->setFieldAmount(sfBalance, STAmount{Issue{usd, noAccount()}, 5});
+        sle->setFieldAmount(sfLowLimit, STAmount{Issue{usd, alice}, 100});
+        sle->setFieldAmount(sfHighLimit, STAmount{Issue{usd, gw}, 0});
+        sle->setFieldU32(sfFlags, lsfLowReserve);
+        sle->setFieldU64(sfLowNode, 3);
+
+        auto const root = std::make_shared<SLE>(keylet::account(gw));
+        root->setAccountID(sfAccount, gw);
+        root->setFieldAmount(sfBalance, XRPAmount{1000000});
+        root->setFieldU32(sfSequence, 10);
+        root->setAccountID(sfRegularKey, alice);
+
+        measure("getFieldAmount", count, [&]() {
+            return sle->getFieldAmount(sfLowLimit).mantissa();
+        });
+        measure("getAccountID", count, [&]() {
+            return root->getAccountID(sfRegularKey).begin()[0] + 1;
+        });
+        measure("getFieldU32", count, [&]() {
+            return root->getFieldU32(sfSequence);
+        });
+        measure("operator[]", count, [&]() {
+            return (*root)[sfSequence] + (*sle)[sfLowNode];
+        });
+        measure("isFlag", count, [&]() {
+            return sle->isFlag(lsfLowReserve) ? 1 : 0;
+        });
+        measure("dynamic_cast", count, [&]() {
+            auto const amount =
+                dynamic_cast<STAmount const*>(sle->peekAtPField(sfLowLimit));
+            return amount ? amount->mantissa() : 0;
+        });
+        measure("getField", count, [&]() {
+            return SField::getField(sfLowLimit.getCode()).fieldValue;
+        });
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STObjectFieldAccess, protocol, ripple);
+
+}  // namespace ripple
@@ -704,6 +704,63 @@ testMalformed()
     }
 }
 
+void
+testFieldLookup()
+{
+    testcase("Field lookup");
+
+    // Every field can be found by its code and its name
+    for (SField const* f : std::initializer_list<SField const*>{
+             &sfGeneric,
+             &sfLedgerEntry,
+             &sfTransaction,
+             &sfMetadata,
+             &sfCloseResolution,
+             &sfLedgerEntryType,
+             &sfFlags,
+             &sfIndexNext,
+             &sfAmount,
+             &sfAccount,
+             &sfPublicKey,
+             &sfLedgerHash,
+             &sfPaths,
+             &sfIndexes,
+             &sfMemos})
+    {
+        BEAST_EXPECT(&SField::getField(f->getCode()) == f);
+        if (f == &sfGeneric)
+            continue;
+        BEAST_EXPECT(&SField::getField(f->fieldType, f->fieldValue) == f);
+        BEAST_EXPECT(&SField::getField(f->getName()) == f);
+    }
+
+    BEAST_EXPECT(SField::getField(STI_HASH256, 257).getName() == "hash");
+    BEAST_EXPECT(SField::getField(STI_HASH256, 258).getName() == "index");
+
+    // Unknown codes, in and out of the range of serialized types
+    BEAST_EXPECT(SField::getField(-1) == sfInvalid);
+    BEAST_EXPECT(SField::getField(STI_UINT32, 0) == sfInvalid);
+    BEAST_EXPECT(SField::getField(STI_UINT32, 256) == sfInvalid);
+    BEAST_EXPECT(SField::getField(STI_VECTOR256 + 1, 1) == sfInvalid);
+    BEAST_EXPECT(SField::getField(STI_TRANSACTION, 1) == sfInvalid);
+    BEAST_EXPECT(SField::getField(0x7fffffff) == sfInvalid);
+    BEAST_EXPECT(SField::getField("NoSuchField") == sfInvalid);
+
+    // The typed accessors check the type of the field
+    STObject st(sfGeneric);
+    st.setFieldU32(sfFlags, 5);
+    st.setFieldAmount(sfAmount, XRPAmount{10});
+    st.setAccountID(sfAccount, AccountID{1});
+    BEAST_EXPECT(st.getFieldU32(sfFlags) == 5);
+    BEAST_EXPECT(st.getFieldAmount(sfAmount) == XRPAmount{10});
+    BEAST_EXPECT(st.getAccountID(sfAccount) == AccountID{1});
+    BEAST_EXPECT(std::as_const(st)[sfAccount] == AccountID{1});
+    BEAST_EXPECT(st.getFlags() == 5);
+    except<std::runtime_error>([&]() { st.getFieldU64(sfFlags); });
+    except<std::runtime_error>([&]() { st.getFieldVL(sfAmount); });
+    except<std::runtime_error>([&]() { st.setFieldU16(sfAccount, 1); });
+}
+
 void
 run() override
 {
@@ -716,6 +773,7 @@ run() override
     testParseJSONArrayWithInvalidChildrenObjects();
     testParseJSONEdgeCases();
     testMalformed();
+    testFieldLookup();
 }
 }
 ;
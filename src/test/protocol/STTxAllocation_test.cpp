@@ -0,0 +1,289 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/basics/ThreadLocalPool.h>
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/Indexes.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STLedgerEntry.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/SecretKey.h>
+#include <ripple/protocol/TxFlags.h>
+#include <ripple/protocol/UintTypes.h>
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace ripple {
+
+/*  Measures allocations made while parsing transactions and ledger
+    entries.
+
+    Each transaction is parsed from its wire format into an STTx and then
+    serialized again, and each ledger entry is parsed into an SLE, first
+    with the thread local pool disabled and then enabled. The allocation
+    counts cover the field lists of STObject and STArray; the per-field
+    buffers of variable length fields and the serializer's own storage
+    always come from the global allocator.
+
+    Usage:
+        rippled --unittest=STTxAllocation --unittest-arg=<count>
+*/
+class STTxAllocation_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    struct Keys
+    {
+        PublicKey pk;
+        SecretKey sk;
+        AccountID id;
+
+        explicit Keys(std::string const& name)
+        {
+            std::tie(pk, sk) =
+                generateKeyPair(KeyType::secp256k1, generateSeed(name));
+            id = calcAccountID(pk);
+        }
+    };
+
+    static Buffer
+    serialize(STObject const& obj)
+    {
+        Serializer s;
+        obj.add(s);
+        return Buffer(s.data(), s.size());
+    }
+
+    void
+    measure(std::string const& name, STTx const& tx, std::size_t count)
+    {
+        auto const wire = serialize(tx);
+        std::uint64_t sink = 0;
+        measure(name, wire.size(), count, [&]() {
+            auto const parsed =
+                std::make_shared<STTx const>(SerialIter{wire});
+            Serializer s;
+            parsed->add(s);
+            sink += s.size();
+        });
+        BEAST_EXPECT(sink != 0);
+    }
+
+    void
+    measure(std::string const& name, SLE const& sle, std::size_t count)
+    {
+        auto const wire = serialize(sle);
+        std::uint64_t sink = 0;
+        measure(name, wire.size(), count, [&]() {
+            auto const entry = std::make_shared<SLE const>(
+                SerialIter{wire.data(), wire.size()}, sle.key());
+            sink += entry->getCount();
+        });
+        BEAST_EXPECT(sink != 0);
+    }
+
+    template <class F>
+    void
+    measure(
+        std::string const& name,
+        std::size_t size,
+        std::size_t count,
+        F const& once)
+    {
+        std::ostringstream ss;
+        ss << std::left << std::setw(16) << name << std::right
+           << " size=" << std::setw(4) << size;
+
+        bool const wasEnabled = ThreadLocalPool::enabled();
+        for (bool const pooled : {false, true})
+        {
+            ThreadLocalPool::enable(pooled);
+
+            // Warm up the caches
+            for (int i = 0; i < 100; ++i)
+                once();
+
+            auto const before = ThreadLocalPool::stats();
+            auto const start = clock_type::now();
+            for (std::size_t i = 0; i < count; ++i)
+                once();
+            auto const elapsed =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock_type::now() - start);
+            auto const after = ThreadLocalPool::stats();
+
+            ss << (pooled ? " pooled:" : " global:") << " requests="
+               << std::fixed << std::setprecision(1)
+               << double(after.requests - before.requests) / count
+               << " allocations="
+               << double(after.allocations - before.allocations) / count
+               << " time=" << elapsed.count() / count << "ns";
+        }
+        ThreadLocalPool::enable(wasEnabled);
+
+        log << ss.str() << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 100000;
+        if (!arg().empty())
+            count = beast::lexicalCastThrow<std::size_t>(arg());
+
+        Keys const alice{"alice"};
+        Keys const bob{"bob"};
+        Keys const carol{"carol"};
+        Keys const gw{"gw"};
+        Currency const usd = to_currency("USD");
+        Currency const eur = to_currency("EUR");
+
+        // A plain XRP payment
+        STTx payment(ttPAYMENT, [&](STObject& obj) {
+            obj.setAccountID(sfAccount, alice.id);
+            obj.setAccountID(sfDestination, bob.id);
+            obj.setFieldAmount(sfAmount, XRPAmount{25000000});
+            obj.setFieldAmount(sfFee, XRPAmount{12});
+            obj.setFieldU32(sfSequence, 42);
+            obj.setFieldU32(sfLastLedgerSequence, 1000);
+            obj.setFieldVL(sfSigningPubKey, alice.pk.slice());
+        });
+        payment.sign(alice.pk, alice.sk);
+        measure("Payment", payment, count);
+
+        // A cross currency payment with paths and a memo
+        STTx pathPayment(ttPAYMENT, [&](STObject& obj) {
+            obj.setAccountID(sfAccount, alice.id);
+            obj.setAccountID(sfDestination, bob.id);
+            obj.setFieldAmount(sfAmount, STAmount{Issue{usd, gw.id}, 100});
+            obj.setFieldAmount(sfSendMax, STAmount{Issue{eur, gw.id}, 95});
+            obj.setFieldAmount(sfFee, XRPAmount{12});
+            obj.setFieldU32(sfSequence, 43);
+            obj.setFieldU32(sfDestinationTag, 7);
+            obj.setFieldVL(sfSigningPubKey, alice.pk.slice());
+
+            STPathSet paths;
+            for (auto const& hop : {carol.id, bob.id})
+            {
+                STPath path;
+                path.emplace_back(hop, usd, gw.id);
+                path.emplace_back(std::nullopt, xrpCurrency(), std::nullopt);
+                path.emplace_back(std::nullopt, usd, gw.id);
+                paths.push_back(path);
+            }
+            obj.setFieldPathSet(sfPaths, paths);
+
+            STArray memos(sfMemos, 1);
+            memos.emplace_back(sfMemo);
+            memos.back().setFieldVL(
+                sfMemoType, makeSlice(std::string("text/plain")));
+            memos.back().setFieldVL(
+                sfMemoData, makeSlice(std::string("invoice 12345")));
+            obj.setFieldArray(sfMemos, memos);
+        });
+        pathPayment.sign(alice.pk, alice.sk);
+        measure("PathPayment", pathPayment, count);
+
+        // An offer
+        STTx offer(ttOFFER_CREATE, [&](STObject& obj) {
+            obj.setAccountID(sfAccount, alice.id);
+            obj.setFieldAmount(sfTakerPays, STAmount{Issue{usd, gw.id}, 50});
+            obj.setFieldAmount(sfTakerGets, XRPAmount{100000000});
+            obj.setFieldAmount(sfFee, XRPAmount{12});
+            obj.setFieldU32(sfSequence, 44);
+            obj.setFieldU32(sfExpiration, 700000000);
+            obj.setFieldU32(sfFlags, tfSell);
+            obj.setFieldVL(sfSigningPubKey, alice.pk.slice());
+        });
+        offer.sign(alice.pk, alice.sk);
+        measure("OfferCreate", offer, count);
+
+        // A multi-signed payment. The signatures aren't checked here.
+        STTx multiSigned(ttPAYMENT, [&](STObject& obj) {
+            obj.setAccountID(sfAccount, gw.id);
+            obj.setAccountID(sfDestination, bob.id);
+            obj.setFieldAmount(sfAmount, STAmount{Issue{usd, gw.id}, 10});
+            obj.setFieldAmount(sfFee, XRPAmount{48});
+            obj.setFieldU32(sfSequence, 45);
+            obj.setFieldVL(sfSigningPubKey, Slice{});
+
+            STArray signers(sfSigners, 3);
+            for (auto const keys : {&alice, &bob, &carol})
+            {
+                signers.emplace_back(sfSigner);
+                auto& signer = signers.back();
+                signer.setAccountID(sfAccount, keys->id);
+                signer.setFieldVL(sfSigningPubKey, keys->pk.slice());
+                signer.setFieldVL(
+                    sfTxnSignature,
+                    sign(keys->pk, keys->sk, keys->pk.slice()));
+            }
+            obj.setFieldArray(sfSigners, signers);
+        });
+        measure("MultiSigned", multiSigned, count);
+
+        SLE account(keylet::account(alice.id));
+        account.setAccountID(sfAccount, alice.id);
+        account.setFieldAmount(sfBalance, XRPAmount{1000000000});
+        account.setFieldU32(sfSequence, 46);
+        account.setFieldU32(sfOwnerCount, 3);
+        account.setFieldH256(sfPreviousTxnID, payment.getTransactionID());
+        account.setFieldU32(sfPreviousTxnLgrSeq, 999);
+        measure("AccountRoot", account, count);
+
+        SLE line(keylet::line(alice.id, gw.id, usd));
+        line.setFieldAmount(sfBalance, STAmount{Issue{usd, noAccount()}, 5});
+        line.setFieldAmount(sfLowLimit, STAmount{Issue{usd, alice.id}, 100});
+        line.setFieldAmount(sfHighLimit, STAmount{Issue{usd, gw.id}, 0});
+        line.setFieldU64(sfLowNode, 0);
+        line.setFieldU64(sfHighNode, 0);
+        line.setFieldH256(sfPreviousTxnID, payment.getTransactionID());
+        line.setFieldU32(sfPreviousTxnLgrSeq, 999);
+        measure("RippleState", line, count);
+
+        SLE book(keylet::offer(alice.id, 44));
+        book.setAccountID(sfAccount, alice.id);
+        book.setFieldU32(sfSequence, 44);
+        book.setFieldAmount(sfTakerPays, STAmount{Issue{usd, gw.id}, 50});
+        book.setFieldAmount(sfTakerGets, XRPAmount{100000000});
+        book.setFieldH256(sfBookDirectory, offer.getTransactionID());
+        book.setFieldU64(sfBookNode, 0);
+        book.setFieldU64(sfOwnerNode, 0);
+        book.setFieldH256(sfPreviousTxnID, offer.getTransactionID());
+        book.setFieldU32(sfPreviousTxnLgrSeq, 999);
+        measure("Offer", book, count);
+
+        SLE directory(keylet::ownerDir(alice.id));
+        directory.setAccountID(sfOwner, alice.id);
+        directory.setFieldH256(sfRootIndex, directory.key());
+        STVector256 indexes;
+        for (auto const& sle : {account, line, book})
+            indexes.push_back(sle.key());
+        directory.setFieldV256(sfIndexes, indexes);
+        measure("DirectoryNode", directory, count);
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(STTxAllocation, protocol, ripple);
+
+}  // namespace ripple
@@ -0,0 +1,258 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/core/LexicalCast.h>
+#include <ripple/beast/unit_test.h>
+#include <ripple/protocol/STAccount.h>
+#include <ripple/protocol/STArray.h>
+#include <ripple/protocol/STTx.h>
+#include <ripple/protocol/Serializer.h>
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+namespace ripple {
+
+class Serializer_test : public beast::unit_test::suite
+{
+    void
+    testIntegers()
+    {
+        testcase("Integers");
+
+        Serializer s;
+        BEAST_EXPECT(s.add8(0x01) == 0);
+        BEAST_EXPECT(s.add16(0x0203) == 1);
+        BEAST_EXPECT(s.add32(0x04050607) == 3);
+        BEAST_EXPECT(s.add64(0x08090a0b0c0d0e0f) == 7);
+        BEAST_EXPECT(s.add32(HashPrefix::transactionID) == 15);
+        BEAST_EXPECT(s.size() == 19);
+
+        // Integers are written in big-endian order
+        for (int i = 0; i < 15; ++i)
+            BEAST_EXPECT(s.peekData()[i] == i + 1);
+
+        SerialIter sit(s.slice());
+        BEAST_EXPECT(sit.get8() == 0x01);
+        BEAST_EXPECT(sit.get16() == 0x0203);
+        BEAST_EXPECT(sit.get32() == 0x04050607);
+        BEAST_EXPECT(sit.get64() == 0x08090a0b0c0d0e0f);
+        BEAST_EXPECT(
+            sit.get32() ==
+            safe_cast<std::uint32_t>(HashPrefix::transactionID));
+        BEAST_EXPECT(sit.empty());
+
+        // Extreme values survive the round trip
+        Serializer t;
+        t.add16(0xffff);
+        t.add32(0xffffffff);
+        t.add64(0xffffffffffffffff);
+        t.add64(0);
+        SerialIter tit(t.slice());
+        BEAST_EXPECT(tit.get16() == 0xffff);
+        BEAST_EXPECT(tit.get32() == 0xffffffff);
+        BEAST_EXPECT(tit.get64() == 0xffffffffffffffff);
+        BEAST_EXPECT(tit.get64() == 0);
+
+        // Reads past the end throw and consume nothing
+        std::uint8_t const three[] = {1, 2, 3};
+        SerialIter short3(three);
+        except<std::runtime_error>([&]() { short3.get32(); });
+        BEAST_EXPECT(short3.getBytesLeft() == 3);
+        except<std::runtime_error>([&]() { short3.get64(); });
+        BEAST_EXPECT(short3.get16() == 0x0102);
+        except<std::runtime_error>([&]() { short3.get16(); });
+        BEAST_EXPECT(short3.get8() == 0x03);
+        except<std::runtime_error>([&]() { short3.get8(); });
+        BEAST_EXPECT(short3.empty());
+    }
+
+    void
+    testFieldIDs()
+    {
+        testcase("Field IDs");
+
+        // Each combination of common and uncommon types and names
+        std::pair<int, int> const ids[] = {
+            {1, 1}, {15, 15}, {2, 16}, {16, 2}, {16, 16}, {255, 255}};
+        std::size_t const sizes[] = {1, 1, 2, 2, 3, 3};
+
+        Serializer s;
+        for (std::size_t i = 0; i < std::size(ids); ++i)
+        {
+            auto const before = s.size();
+            s.addFieldID(ids[i].first, ids[i].second);
+            BEAST_EXPECT(s.size() - before == sizes[i]);
+        }
+
+        SerialIter sit(s.slice());
+        for (auto const& [type, name] : ids)
+        {
+            int t, n;
+            sit.getFieldID(t, n);
+            BEAST_EXPECT(t == type);
+            BEAST_EXPECT(n == name);
+        }
+        BEAST_EXPECT(sit.empty());
+    }
+
+    void
+    testVL()
+    {
+        testcase("Variable length");
+
+        for (std::size_t const size :
+             {0, 1, 192, 193, 12480, 12481, 918744})
+        {
+            Blob const data(size, 0x5a);
+            Serializer s;
+            s.addVL(makeSlice(data));
+            s.add8(0xa5);
+
+            SerialIter sit(s.slice());
+            BEAST_EXPECT(sit.getVL() == data);
+            BEAST_EXPECT(sit.get8() == 0xa5);
+            BEAST_EXPECT(sit.empty());
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testIntegers();
+        testFieldIDs();
+        testVL();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(Serializer, protocol, ripple);
+
+//------------------------------------------------------------------------------
+
+/*  Measures serialization throughput.
+
+    Usage:
+        rippled --unittest=SerializerBenchmark --unittest-arg=<count>
+*/
+class SerializerBenchmark_test : public beast::unit_test::suite
+{
+    using clock_type = std::chrono::steady_clock;
+
+    template <class F>
+    void
+    measure(std::string const& name, std::size_t count, F&& f)
+    {
+        std::uint64_t bytes = 0;
+        for (std::size_t i = 0; i < 100; ++i)
+            bytes += f();
+
+        bytes = 0;
+        auto const start = clock_type::now();
+        for (std::size_t i = 0; i < count; ++i)
+            bytes += f();
+        auto const elapsed =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_type::now() - start);
+
+        std::ostringstream ss;
+        ss << std::left << std::setw(16) << name << std::right << std::fixed
+           << std::setprecision(1) << std::setw(8)
+           << double(elapsed.count()) / count << " ns/op" << std::setw(10)
+           << (elapsed.count() ? bytes * 1000.0 / elapsed.count() : 0.0)
+           << " MB/s";
+        log << ss.str() << std::endl;
+        BEAST_EXPECT(bytes != 0);
+    }
+
+public:
+    void
+    run() override
+    {
+        std::size_t count = 1000000;
+        if (!arg().empty())
+            count = beast::lexicalCastThrow<std::size_t>(arg());
+
+        AccountID const alice{1};
+        AccountID const bob{2};
+        Currency const usd = to_currency("USD");
+
+        STTx const tx(ttPAYMENT, [&](STObject& obj) {
+            obj.setAccountID(sfAccount, alice);
+            obj.setAccountID(sfDestination, bob);
+            obj.setFieldAmount(sfAmount, STAmount{Issue{usd, bob}, 100});
+            obj.setFieldAmount(sfSendMax, STAmount{Issue{usd, bob}, 101});
+            obj.setFieldAmount(sfFee, XRPAmount{12});
+            obj.setFieldU32(sfSequence, 42);
+            obj.setFieldU32(sfLastLedgerSequence, 1000);
+            obj.setFieldU32(sfDestinationTag, 7);
+            obj.setFieldVL(sfSigningPubKey, Blob(33, 0x02));
+            obj.setFieldVL(sfTxnSignature, Blob(71, 0x30));
+
+            STArray memos(sfMemos, 1);
+            memos.emplace_back(sfMemo);
+            memos.back().setFieldVL(sfMemoData, Blob(32, 0x41));
+            obj.setFieldArray(sfMemos, memos);
+        });
+
+        Serializer wire;
+        tx.add(wire);
+
+        measure("integers", count, []() {
+            Serializer s(64);
+            for (std::uint32_t i = 0; i < 4; ++i)
+            {
+                s.add8(i);
+                s.add16(i);
+                s.add32(i);
+                s.add64(i);
+            }
+            return s.size();
+        });
+
+        measure("SerialIter", count, [&]() {
+            SerialIter sit(wire.slice());
+            while (sit.getBytesLeft() >= 8)
+                sit.get64();
+            return wire.size() - sit.getBytesLeft();
+        });
+
+        measure("STObject::add", count, [&]() {
+            Serializer s;
+            tx.add(s);
+            return s.size();
+        });
+
+        measure("getSigningHash", count, [&]() {
+            auto const hash = tx.getSigningHash();
+            return hash.isNonZero() ? wire.size() : 0;
+        });
+
+        measure("parse", count, [&]() {
+            SerialIter sit(wire.slice());
+            STTx const parsed(sit);
+            return wire.size();
+        });
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(SerializerBenchmark, protocol, ripple);
+
+}  // namespace ripple
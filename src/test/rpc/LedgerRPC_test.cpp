@@ -24,6 +24,7 @@
 #include <ripple/protocol/ErrorCodes.h>
 #include <ripple/protocol/jss.h>
 #include <test/jtx.h>
+#include <test/jtx/WSClient.h>
 
 namespace ripple {
 
@@ -1681,6 +1682,63 @@ class LedgerRPC_test : public beast::unit_test::suite
         }
     }
 
+    void
+    testStreamedResult()
+    {
+        testcase("Ledger Request, Streamed Result");
+        using namespace test::jtx;
+
+        Env env{*this};
+        Account const alice{"alice"};
+        Account const gw{"gateway"};
+        auto const USD = gw["USD"];
+
+        env.fund(XRP(10000), alice, gw);
+        env.close();
+        env.trust(USD(1000), alice);
+        env(pay(gw, alice, USD(100)));
+        env(offer(alice, XRP(10), USD(10)));
+        env.close();
+
+        // The JSON-RPC reply is written directly from the ledger, while the
+        // websocket reply is built as a Json::Value.  Both must agree.
+        Json::Value jvParams;
+        jvParams[jss::ledger_index] = env.closed()->info().seq;
+        jvParams[jss::transactions] = true;
+        jvParams[jss::accounts] = true;
+        jvParams[jss::expand] = true;
+        jvParams[jss::owner_funds] = true;
+
+        auto const jrr =
+            env.rpc("json", "ledger", to_string(jvParams))[jss::result];
+        BEAST_EXPECT(jrr[jss::status] == "success");
+        BEAST_EXPECT(jrr[jss::ledger][jss::transactions].size() == 3u);
+
+        auto const wsc = test::makeWSClient(env.app().config());
+        auto const jv = wsc->invoke("ledger", jvParams);
+        BEAST_EXPECT(jv[jss::status] == "success");
+        BEAST_EXPECT(jrr[jss::ledger] == jv[jss::result][jss::ledger]);
+        BEAST_EXPECT(
+            jrr[jss::ledger_index] == jv[jss::result][jss::ledger_index]);
+
+        bool delivered = false;
+        for (auto const& tx : jrr[jss::ledger][jss::transactions])
+        {
+            if (tx[jss::TransactionType] == jss::Payment)
+                delivered = tx[jss::metaData].isMember(jss::delivered_amount);
+        }
+        BEAST_EXPECT(delivered);
+
+        // Errors are reported along with the masked request
+        jvParams[jss::ledger_index] = "invalid";
+        jvParams[jss::secret] = "not a secret";
+        auto const err =
+            env.rpc("json", "ledger", to_string(jvParams))[jss::result];
+        BEAST_EXPECT(err[jss::status] == "error");
+        BEAST_EXPECT(err.isMember(jss::error));
+        BEAST_EXPECT(err[jss::request][jss::secret] == "<masked>");
+    }
+
 public:
     void
     run() override
@@ -1706,6 +1764,7 @@ public:
         testNoQueue();
         testQueue();
         testLedgerAccountsOption();
+        testStreamedResult();
     }
 };
 
@@ -0,0 +1,486 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/json/json_reader.h>
+#include <ripple/protocol/jss.h>
+#include <ripple/rpc/impl/ResponseStream.h>
+#include <ripple/rpc/impl/Tuning.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http.hpp>
+#include <test/jtx.h>
+#include <test/jtx/WSClient.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+class ResponseStream_test : public beast::unit_test::suite
+{
+    static std::size_t constexpr limit = 4096;
+    static std::size_t constexpr chunkSize = 1000;
+
+    class gate
+    {
+    private:
+        std::condition_variable cv_;
+        std::mutex mutex_;
+        bool signaled_ = false;
+
+    public:
+        // Thread safe, blocks until signaled or period expires.
+        // Returns `true` if signaled.
+        template <class Rep, class Period>
+        bool
+        wait_for(std::chrono::duration<Rep, Period> const& rel_time)
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            auto b = cv_.wait_for(lk, rel_time, [=] { return signaled_; });
+            signaled_ = false;
+            return b;
+        }
+
+        void
+        signal()
+        {
+            std::lock_guard lk(mutex_);
+            signaled_ = true;
+            cv_.notify_all();
+        }
+    };
+
+    // A body with a recognizable pattern
+    static std::string
+    makeBody(std::size_t size)
+    {
+        std::string body;
+        body.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+            body.push_back('a' + (i * 7 + i / 26) % 26);
+        return body;
+    }
+
+    // Returns the content of a chunked body, or nothing if it is malformed
+    static std::optional<std::string>
+    dechunk(std::string const& s)
+    {
+        std::string content;
+        std::size_t pos = 0;
+        for (;;)
+        {
+            auto const end = s.find("\r\n", pos);
+            if (end == std::string::npos)
+                return std::nullopt;
+            auto const size = std::stoul(s.substr(pos, end - pos), nullptr, 16);
+            pos = end + 2;
+            if (size == 0)
+            {
+                if (s.substr(pos) != "\r\n")
+                    return std::nullopt;
+                return content;
+            }
+            content += s.substr(pos, size);
+            pos += size;
+            if (s.substr(pos, 2) != "\r\n")
+                return std::nullopt;
+            pos += 2;
+        }
+    }
+
+    // Writes the body from a coroutine, in pieces of varying size
+    struct Producer
+    {
+        std::shared_ptr<ResponseStream> stream;
+        std::atomic<std::size_t> written{0};
+        gate done;
+
+        void
+        run(jtx::Env& env,
+            std::string const& body,
+            ResponseStream::Framing framing,
+            ResponseStream::OverflowHandler onOverflow)
+        {
+            env.app().getJobQueue().postCoro(
+                jtCLIENT,
+                "ResponseStream-Test",
+                [&, onOverflow](auto const& c) {
+                    stream = std::make_shared<ResponseStream>(
+                        c, framing, limit, chunkSize);
+                    stream->onOverflow(onOverflow);
+                    std::size_t pos = 0;
+                    for (std::size_t n = 1; pos < body.size(); n = n * 3 % 997)
+                    {
+                        n = std::min(n, body.size() - pos);
+                        stream->write({body.data() + pos, n});
+                        pos += n;
+                        written = pos;
+                    }
+                    stream->finish();
+                    done.signal();
+                });
+        }
+    };
+
+    // Takes the session's role, handing out the adapter when it overflows
+    template <class Adapter>
+    struct Handoff
+    {
+        std::mutex mutex;
+        std::shared_ptr<Adapter> adapter;
+        gate ready;
+
+        void
+        set(std::shared_ptr<Adapter> a)
+        {
+            {
+                std::lock_guard lock(mutex);
+                adapter = std::move(a);
+            }
+            ready.signal();
+        }
+
+        std::shared_ptr<Adapter>
+        get()
+        {
+            std::lock_guard lock(mutex);
+            return std::move(adapter);
+        }
+    };
+
+    void
+    testBuffered()
+    {
+        testcase("Buffered");
+
+        using namespace std::chrono_literals;
+        jtx::Env env(*this);
+        auto const body = makeBody(limit);
+
+        bool overflowed = false;
+        Producer producer;
+        producer.run(
+            env,
+            body,
+            ResponseStream::Framing::chunked,
+            [&](ResponseStream&) { overflowed = true; });
+        BEAST_EXPECT(producer.done.wait_for(5s));
+        BEAST_EXPECT(!overflowed);
+        BEAST_EXPECT(!producer.stream->started());
+        BEAST_EXPECT(producer.stream->buffer() == body);
+        BEAST_EXPECT(producer.stream->size() == body.size());
+    }
+
+    void
+    testChunked()
+    {
+        testcase("Chunked");
+
+        using namespace std::chrono_literals;
+        jtx::Env env(*this);
+        auto const body = makeBody(200 * limit);
+
+        Handoff<Writer> handoff;
+        Producer producer;
+        producer.run(
+            env,
+            body,
+            ResponseStream::Framing::chunked,
+            [&](ResponseStream& stream) {
+                stream.start("header\r\n\r\n");
+                handoff.set(stream.writer());
+            });
+        BEAST_EXPECT(handoff.ready.wait_for(5s));
+        auto const writer = handoff.get();
+        if (!BEAST_EXPECT(writer))
+            return;
+
+        gate resumed;
+        std::string received;
+        std::size_t maxAhead = 0;
+        while (!writer->complete())
+        {
+            if (!writer->prepare(65536, [&] { resumed.signal(); }))
+            {
+                if (!BEAST_EXPECT(resumed.wait_for(5s)))
+                    return;
+                continue;
+            }
+            std::size_t n = 0;
+            for (auto const& b : writer->data())
+            {
+                received.append(static_cast<char const*>(b.data()), b.size());
+                n += b.size();
+            }
+
+            // Give the producer time to run ahead if it can
+            std::this_thread::sleep_for(100us);
+            auto const written = producer.written.load();
+            if (written > received.size())
+                maxAhead = std::max(maxAhead, written - received.size());
+            writer->consume(n);
+        }
+        BEAST_EXPECT(producer.done.wait_for(5s));
+
+        // No more than the limit waits, besides what is being collected
+        BEAST_EXPECT(maxAhead <= limit + chunkSize);
+        BEAST_EXPECT(received.substr(0, 10) == "header\r\n\r\n");
+        BEAST_EXPECT(dechunk(received.substr(10)) == body);
+    }
+
+    void
+    testFragments()
+    {
+        testcase("Fragments");
+
+        using namespace std::chrono_literals;
+        jtx::Env env(*this);
+        auto const body = makeBody(200 * limit);
+
+        Handoff<WSMsg> handoff;
+        Producer producer;
+        producer.run(
+            env,
+            body,
+            ResponseStream::Framing::none,
+            [&](ResponseStream& stream) {
+                stream.start();
+                handoff.set(stream.message());
+            });
+        BEAST_EXPECT(handoff.ready.wait_for(5s));
+        auto const message = handoff.get();
+        if (!BEAST_EXPECT(message))
+            return;
+
+        gate resumed;
+        std::string received;
+        std::size_t maxAhead = 0;
+        for (;;)
+        {
+            auto const result =
+                message->prepare(700, [&] { resumed.signal(); });
+            if (boost::indeterminate(result.first))
+            {
+                if (!BEAST_EXPECT(resumed.wait_for(5s)))
+                    return;
+                continue;
+            }
+            std::size_t n = 0;
+            for (auto const& b : result.second)
+            {
+                received.append(static_cast<char const*>(b.data()), b.size());
+                n += b.size();
+            }
+            BEAST_EXPECT(n <= 700);
+
+            std::this_thread::sleep_for(100us);
+            auto const written = producer.written.load();
+            if (written > received.size())
+                maxAhead = std::max(maxAhead, written - received.size());
+            if (result.first)
+                break;
+        }
+        BEAST_EXPECT(producer.done.wait_for(5s));
+
+        BEAST_EXPECT(maxAhead <= limit + chunkSize);
+        BEAST_EXPECT(received == body);
+    }
+
+    void
+    testAbandoned()
+    {
+        testcase("Abandoned");
+
+        using namespace std::chrono_literals;
+        jtx::Env env(*this);
+        auto const body = makeBody(200 * limit);
+
+        Handoff<Writer> handoff;
+        Producer producer;
+        producer.run(
+            env,
+            body,
+            ResponseStream::Framing::chunked,
+            [&](ResponseStream& stream) {
+                stream.start();
+                handoff.set(stream.writer());
+            });
+        BEAST_EXPECT(handoff.ready.wait_for(5s));
+        auto writer = handoff.get();
+        if (!BEAST_EXPECT(writer))
+            return;
+
+        // Take one piece and go away.  The suspended producer must be
+        // resumed and finish without waiting for anyone.
+        BEAST_EXPECT(writer->prepare(65536, [] {}));
+        std::size_t n = 0;
+        for (auto const& b : writer->data())
+            n += b.size();
+        writer->consume(n);
+        writer.reset();
+
+        BEAST_EXPECT(producer.done.wait_for(5s));
+        BEAST_EXPECT(producer.stream->abandoned());
+        BEAST_EXPECT(producer.stream->size() == body.size());
+    }
+
+    // Fill the closed ledger with more state than the reply buffer holds
+    static void
+    fillLedger(jtx::Env& env)
+    {
+        using namespace jtx;
+        for (int i = 0; i < 24; ++i)
+        {
+            Account const account{"account" + std::to_string(i)};
+            env.fund(XRP(20000), account);
+            env.close();
+            env(ticket::create(account, 250));
+        }
+        env.close();
+    }
+
+    static Json::Value
+    ledgerRequest()
+    {
+        Json::Value params;
+        params[jss::ledger_index] = "closed";
+        params[jss::accounts] = true;
+        params[jss::expand] = true;
+        return params;
+    }
+
+    // The reply holds every ticket and was too large to buffer
+    bool
+    checkLedger(Json::Value const& result, std::size_t size)
+    {
+        if (!BEAST_EXPECT(result[jss::status] == jss::success))
+            return false;
+        auto const& state = result[jss::ledger][jss::accountState];
+        BEAST_EXPECT(state.size() > 24 * 250);
+        return BEAST_EXPECT(size > RPC::Tuning::maxBufferedReplySize);
+    }
+
+    void
+    testHTTP()
+    {
+        testcase("HTTP");
+
+        namespace http = boost::beast::http;
+        using boost::asio::ip::tcp;
+
+        jtx::Env env(*this);
+        fillLedger(env);
+
+        auto const& section = env.app().config()["port_rpc"];
+        auto const ip = section.get<std::string>("ip");
+        auto const port = section.get<std::uint16_t>("port");
+        if (!BEAST_EXPECT(ip && port))
+            return;
+
+        boost::asio::io_context ios;
+        tcp::socket socket{ios};
+        socket.connect({boost::asio::ip::make_address(*ip), *port});
+        boost::beast::flat_buffer buffer;
+
+        auto const request = [&](bool keepAlive) {
+            Json::Value body;
+            body[jss::method] = "ledger";
+            body[jss::params] = Json::arrayValue;
+            body[jss::params].append(ledgerRequest());
+
+            http::request<http::string_body> req{http::verb::post, "/", 11};
+            req.set(http::field::host, *ip);
+            req.set(http::field::content_type, "application/json");
+            req.keep_alive(keepAlive);
+            req.body() = to_string(body);
+            req.prepare_payload();
+            http::write(socket, req);
+
+            http::response_parser<http::string_body> parser;
+            parser.body_limit(64 * 1024 * 1024);
+            http::read(socket, buffer, parser);
+            return parser.release();
+        };
+
+        auto const check = [&](auto const& response) {
+            BEAST_EXPECT(response.result() == http::status::ok);
+            BEAST_EXPECT(response.chunked());
+            Json::Value jv;
+            return BEAST_EXPECT(Json::Reader().parse(response.body(), jv)) &&
+                checkLedger(jv[jss::result], response.body().size());
+        };
+
+        // A streamed reply leaves the connection open for the next request
+        auto const first = request(true);
+        BEAST_EXPECT(first.keep_alive());
+        if (!check(first))
+            return;
+
+        // Unless the client asked to close it
+        auto const second = request(false);
+        BEAST_EXPECT(!second.keep_alive());
+        BEAST_EXPECT(second[http::field::connection] == "close");
+        check(second);
+
+        boost::system::error_code ec;
+        char c;
+        socket.read_some(boost::asio::buffer(&c, 1), ec);
+        BEAST_EXPECT(ec == boost::asio::error::eof);
+    }
+
+    void
+    testWebSocket()
+    {
+        testcase("WebSocket");
+
+        jtx::Env env(*this);
+        fillLedger(env);
+
+        auto const client = makeWSClient(env.app().config(), true, 1);
+        auto const jv = client->invoke("ledger", ledgerRequest());
+        if (!checkLedger(jv[jss::result], to_string(jv).size()))
+            return;
+
+        // The connection is usable after a fragmented message
+        auto const info = client->invoke("ping");
+        BEAST_EXPECT(info[jss::status] == jss::success);
+    }
+
+public:
+    void
+    run() override
+    {
+        testBuffered();
+        testChunked();
+        testFragments();
+        testAbandoned();
+        testHTTP();
+        testWebSocket();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(ResponseStream, rpc, ripple);
+
+}  // namespace test
+}  // namespace ripple
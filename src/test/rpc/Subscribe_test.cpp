@@ -20,16 +20,60 @@
 #include <ripple/app/misc/NetworkOPs.h>
 #include <ripple/beast/unit_test.h>
 #include <ripple/core/ConfigSections.h>
+#include <ripple/net/InfoSub.h>
 #include <ripple/protocol/jss.h>
 #include <test/jtx.h>
 #include <test/jtx/WSClient.h>
 #include <test/jtx/envconfig.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 namespace ripple {
 namespace test {
 
 class Subscribe_test : public beast::unit_test::suite
 {
+    // Records the ledgers published to it, can claim to be backlogged, and
+    // can hold up the publisher
+    class LedgerSub : public InfoSub
+    {
+    public:
+        std::atomic<bool> backlogged{false};
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<std::uint32_t> ledgers;
+        // While held, sending a ledger waits until it is released
+        bool held = false;
+        bool waiting = false;
+
+        explicit LedgerSub(Source& source) : InfoSub(source)
+        {
+        }
+
+        void
+        send(Json::Value const& jv, bool) override
+        {
+            std::unique_lock lock(mutex);
+            if (jv[jss::type] != "ledgerClosed")
+                return;
+            ledgers.push_back(jv[jss::ledger_index].asUInt());
+            waiting = true;
+            cv.notify_all();
+            cv.wait(lock, [this] { return !held; });
+            waiting = false;
+        }
+
+        bool
+        isBacklogged() override
+        {
+            return backlogged;
+        }
+    };
+
 public:
     void
     testServer()
@@ -691,6 +735,123 @@ public:
         }
     }
 
+    void
+    testPublishQueue()
+    {
+        testcase("Publish queue");
+
+        using namespace std::chrono_literals;
+        using namespace jtx;
+        Env env(*this);
+        auto wsc = makeWSClient(env.app().config());
+
+        Json::Value stream;
+        stream[jss::streams] = Json::arrayValue;
+        stream[jss::streams].append("ledger");
+        auto jv = wsc->invoke("subscribe", stream);
+        BEAST_EXPECT(jv[jss::status] == "success");
+
+        // Ledgers are published in order, after the close returns
+        for (int i = 0; i < 5; ++i)
+            env.close();
+        for (int seq = 3; seq < 8; ++seq)
+        {
+            auto const msg = wsc->getMsg(5s);
+            BEAST_EXPECT(msg && (*msg)[jss::ledger_index] == seq);
+        }
+
+        // The publisher catches up with the validated ledger
+        auto const published = [&]() {
+            Json::Value pub;
+            for (int i = 0; i < 100; ++i)
+            {
+                pub = env.rpc("server_info")[jss::result][jss::info]
+                                            [jss::publish_queue];
+                if (pub[jss::lag_ledgers] == 0 &&
+                    pub[jss::queued_ledgers] == 0)
+                    break;
+                std::this_thread::sleep_for(10ms);
+            }
+            return pub;
+        };
+        auto pub = published();
+        BEAST_EXPECT(pub[jss::queued_ledgers] == 0);
+        BEAST_EXPECT(pub[jss::skipped_ledgers].isUInt());
+        BEAST_EXPECT(pub[jss::skipped_ledgers] == 0);
+        BEAST_EXPECT(pub[jss::lag_ledgers] == 0);
+        BEAST_EXPECT(pub.isMember(jss::lag_ms));
+
+        // A backlogged subscriber misses ledgers, and only it does
+        auto sub = std::make_shared<LedgerSub>(env.app().getOPs());
+        Json::Value result;
+        env.app().getOPs().subLedger(sub, result);
+        auto const rebuilds = [&]() {
+            return env.rpc("server_info")[jss::result][jss::info]
+                                         [jss::order_book_index]
+                                         [jss::full_rebuilds];
+        };
+        auto const fullRebuilds = rebuilds();
+
+        sub->backlogged = true;
+        for (int i = 0; i < 3; ++i)
+            env.close();
+        published();
+        sub->backlogged = false;
+        env.close();
+        pub = published();
+
+        BEAST_EXPECT(pub[jss::skipped_ledgers] == 3);
+        {
+            std::lock_guard lock(sub->mutex);
+            std::vector<std::uint32_t> const expected{env.closed()->seq()};
+            BEAST_EXPECT(sub->ledgers == expected);
+        }
+        for (int seq = 8; seq < 12; ++seq)
+        {
+            auto const msg = wsc->getMsg(5s);
+            BEAST_EXPECT(msg && (*msg)[jss::ledger_index] == seq);
+        }
+
+        // The book index followed every ledger
+        BEAST_EXPECT(rebuilds() == fullRebuilds);
+
+        // Hold up the publisher on the next ledger
+        {
+            std::lock_guard lock(sub->mutex);
+            sub->held = true;
+        }
+        env.close();
+        {
+            std::unique_lock lock(sub->mutex);
+            BEAST_EXPECT(
+                sub->cv.wait_for(lock, 5s, [&] { return sub->waiting; }));
+        }
+
+        // Past 32 waiting ledgers, they are all skipped for every stream
+        // and the newest waits alone.  Queueing the same ledger again is
+        // enough to fill the queue.
+        auto const skipped = pub[jss::skipped_ledgers].asUInt();
+        for (int i = 0; i < 40; ++i)
+            env.app().getOPs().pubLedger(env.closed());
+        pub = env.rpc("server_info")[jss::result][jss::info]
+                                    [jss::publish_queue];
+        BEAST_EXPECT(pub[jss::queued_ledgers] == 8);
+        BEAST_EXPECT(pub[jss::skipped_ledgers] == skipped + 32);
+
+        {
+            std::lock_guard lock(sub->mutex);
+            sub->held = false;
+        }
+        sub->cv.notify_all();
+        pub = published();
+        BEAST_EXPECT(pub[jss::queued_ledgers] == 0);
+        BEAST_EXPECT(pub[jss::skipped_ledgers] == skipped + 32);
+        {
+            std::lock_guard lock(sub->mutex);
+            BEAST_EXPECT(sub->ledgers.size() == 2 + 8);
+        }
+    }
+
     void
     run() override
     {
@@ -702,6 +863,7 @@ public:
         testSubErrors(true);
         testSubErrors(false);
         testSubByUrl();
+        testPublishQueue();
     }
 };
 
@@ -23,6 +23,7 @@
 #include <ripple/core/ConfigSections.h>
 #include <ripple/server/Server.h>
 #include <ripple/server/Session.h>
+#include <ripple/server/impl/JSONRPCUtil.h>
 
 #include <test/jtx.h>
 #include <test/jtx/CaptureLogs.h>
@@ -504,12 +505,48 @@ public:
             messages.find("Missing section: [port_peer]") != std::string::npos);
     }
 
+    void
+    testAcceptedFormat()
+    {
+        testcase("Accepted format");
+        using Json::Writer;
+        auto const cbor = [](char const* accept) {
+            return acceptedFormat(accept) == Writer::Format::cbor;
+        };
+
+        BEAST_EXPECT(!cbor(""));
+        BEAST_EXPECT(!cbor("*/*"));
+        BEAST_EXPECT(!cbor("application/*"));
+        BEAST_EXPECT(!cbor("application/json"));
+        BEAST_EXPECT(!cbor("text/html, */*;q=0.8"));
+        BEAST_EXPECT(cbor("application/cbor"));
+        BEAST_EXPECT(cbor("Application/CBOR"));
+        BEAST_EXPECT(cbor("application/json, application/cbor"));
+        BEAST_EXPECT(cbor("application/cbor, */*;q=0.5"));
+        BEAST_EXPECT(cbor("application/cbor;q=0.9, */*;q=0.5"));
+        BEAST_EXPECT(cbor("application/cbor ; q = 0.5, application/*;q=0.1"));
+        BEAST_EXPECT(cbor("application/cbor;q=bad, application/json;q=0.5"));
+
+        // Excluded
+        BEAST_EXPECT(!cbor("application/cbor;q=0"));
+        BEAST_EXPECT(!cbor("application/cbor;q=0.000, */*"));
+        BEAST_EXPECT(!cbor("*/*, application/cbor;q=0"));
+        // Less preferred than JSON
+        BEAST_EXPECT(!cbor("application/cbor;q=0.5, application/json"));
+        BEAST_EXPECT(!cbor("application/cbor;q=0.5, */*"));
+        BEAST_EXPECT(!cbor("application/cbor;q=0.5, application/*;q=0.6"));
+        BEAST_EXPECT(cbor("application/cbor;q=0.5, */*;q=0.4"));
+        // The most specific range decides
+        BEAST_EXPECT(cbor("application/cbor, application/json;q=0.5, */*"));
+    }
+
     void
     run() override
     {
         basicTests();
         stressTest();
         testBadConfig();
+        testAcceptedFormat();
     }
 };
 
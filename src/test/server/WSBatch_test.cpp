@@ -0,0 +1,278 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2021 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <ripple/beast/unit_test.h>
+#include <ripple/json/to_string.h>
+#include <ripple/protocol/jss.h>
+#include <test/jtx.h>
+#include <test/jtx/envconfig.h>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace ripple {
+namespace test {
+
+// A WebSocket client of the transactions stream, which counts the frames
+// and stream messages it receives on its own thread.
+class StreamCounter
+{
+    boost::asio::io_context ios_;
+    boost::asio::ip::tcp::socket socket_{ios_};
+    boost::beast::websocket::stream<boost::asio::ip::tcp::socket&> ws_{
+        socket_};
+    std::thread thread_;
+
+public:
+    std::atomic<std::size_t> frames{0};
+    std::atomic<std::size_t> messages{0};
+    std::atomic<std::size_t> arrays{0};
+    std::string reply;
+
+    explicit StreamCounter(Config const& cfg)
+    {
+        auto const& section = cfg["port_ws"];
+        boost::asio::ip::tcp::endpoint const ep{
+            boost::asio::ip::make_address(*section.get<std::string>("ip")),
+            *section.get<std::uint16_t>("port")};
+        socket_.connect(ep);
+        ws_.handshake(ep.address().to_string(), "/");
+
+        Json::Value jv;
+        jv[jss::command] = "subscribe";
+        jv[jss::streams].append("transactions");
+        ws_.write(boost::asio::buffer(to_string(jv)));
+        boost::beast::flat_buffer b;
+        ws_.read(b);
+        reply.assign(static_cast<char const*>(b.data().data()), b.size());
+
+        thread_ = std::thread([this] { read(); });
+    }
+
+    ~StreamCounter()
+    {
+        boost::system::error_code ec;
+        socket_.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+        socket_.close(ec);
+        thread_.join();
+    }
+
+    // Wait until `n` messages have arrived
+    bool
+    wait(std::size_t n, std::chrono::seconds timeout)
+    {
+        auto const end = std::chrono::steady_clock::now() + timeout;
+        while (messages < n)
+        {
+            if (std::chrono::steady_clock::now() > end)
+                return false;
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return true;
+    }
+
+private:
+    void
+    read()
+    {
+        boost::beast::flat_buffer b;
+        boost::system::error_code ec;
+        for (;;)
+        {
+            ws_.read(b, ec);
+            if (ec)
+                return;
+            boost::beast::string_view const s{
+                static_cast<char const*>(b.data().data()), b.size()};
+            std::size_t n = 0;
+            for (auto pos = s.find("\"type\":\"transaction\"");
+                 pos != boost::beast::string_view::npos;
+                 pos = s.find("\"type\":\"transaction\"", pos + 1))
+                ++n;
+            if (!s.empty() && s.front() == '[')
+                ++arrays;
+            messages += n;
+            ++frames;
+            b.consume(b.size());
+        }
+    }
+};
+
+class WSBatch_test : public beast::unit_test::suite
+{
+protected:
+    static std::unique_ptr<Config>
+    config(std::uint16_t batchLimit)
+    {
+        return jtx::envconfig([batchLimit](std::unique_ptr<Config> cfg) {
+            (*cfg)["port_ws"].set(
+                "send_batch_limit", std::to_string(batchLimit));
+            (*cfg)["port_ws"].set("send_queue_limit", "10000");
+            return cfg;
+        });
+    }
+
+    // Submit `count` payments, spread across the accounts
+    static void
+    pay(jtx::Env& env,
+        std::vector<jtx::Account> const& accounts,
+        std::size_t count)
+    {
+        using namespace jtx;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto const& from = accounts[i % accounts.size()];
+            auto const& to = accounts[(i + 1) % accounts.size()];
+            env(jtx::pay(from, to, drops(1)));
+        }
+    }
+
+    static std::vector<jtx::Account>
+    fund(jtx::Env& env, std::size_t count)
+    {
+        using namespace jtx;
+        std::vector<Account> accounts;
+        for (std::size_t i = 0; i < count; ++i)
+            accounts.emplace_back("a" + std::to_string(i));
+        for (auto const& a : accounts)
+            env.fund(XRP(10000), a);
+        env.close();
+        return accounts;
+    }
+
+private:
+    void
+    testBatching(std::uint16_t batchLimit)
+    {
+        testcase << "send_batch_limit " << batchLimit;
+
+        using namespace jtx;
+        using namespace std::chrono_literals;
+        Env env(*this, config(batchLimit));
+        auto const accounts = fund(env, 10);
+
+        StreamCounter counter(env.app().config());
+        std::size_t const count = 40;
+        pay(env, accounts, count / 2);
+        env.close();
+        pay(env, accounts, count / 2);
+        env.close();
+
+        // Replies to requests are never batched
+        BEAST_EXPECT(!counter.reply.empty() && counter.reply.front() == '{');
+
+        BEAST_EXPECT(counter.wait(count, 10s));
+        // Nothing more should arrive
+        std::this_thread::sleep_for(100ms);
+        BEAST_EXPECT(counter.messages == count);
+        if (batchLimit == 0)
+        {
+            BEAST_EXPECT(counter.arrays == 0);
+            BEAST_EXPECT(counter.frames == count);
+        }
+        else
+        {
+            // Every stream message is in an array, and none holds more
+            // than the limit
+            BEAST_EXPECT(counter.arrays == counter.frames);
+            BEAST_EXPECT(counter.frames >= count / batchLimit);
+            BEAST_EXPECT(counter.frames <= count);
+        }
+    }
+
+public:
+    void
+    run() override
+    {
+        testBatching(0);
+        testBatching(1);
+        testBatching(8);
+    }
+};
+
+// Delivery of the transactions stream to many subscribers at once, with
+// and without batching.
+class WSBatchBenchmark_test : public WSBatch_test
+{
+    void
+    measure(std::uint16_t batchLimit)
+    {
+        using namespace jtx;
+        using namespace std::chrono_literals;
+        using clock = std::chrono::steady_clock;
+
+        std::size_t const subscribers = 100;
+        std::size_t const ledgers = 20;
+        std::size_t const perLedger = 100;
+
+        Env env(*this, config(batchLimit));
+        auto const accounts = fund(env, perLedger);
+
+        std::vector<std::unique_ptr<StreamCounter>> counters;
+        for (std::size_t i = 0; i < subscribers; ++i)
+            counters.emplace_back(
+                std::make_unique<StreamCounter>(env.app().config()));
+
+        clock::duration elapsed{};
+        std::size_t expected = 0;
+        for (std::size_t l = 0; l < ledgers; ++l)
+        {
+            pay(env, accounts, perLedger);
+            expected += perLedger;
+            auto const start = clock::now();
+            env.close();
+            for (auto const& c : counters)
+            {
+                if (!BEAST_EXPECT(c->wait(expected, 60s)))
+                    return;
+            }
+            elapsed += clock::now() - start;
+        }
+
+        std::size_t frames = 0;
+        for (auto const& c : counters)
+            frames += c->frames;
+        auto const seconds =
+            std::chrono::duration_cast<std::chrono::duration<double>>(elapsed)
+                .count();
+        log << "send_batch_limit " << batchLimit << ": "
+            << static_cast<std::size_t>(subscribers * expected / seconds)
+            << " messages/s in " << frames << " frames" << std::endl;
+    }
+
+public:
+    void
+    run() override
+    {
+        for (std::uint16_t batchLimit : {0, 16, 256})
+            measure(batchLimit);
+        pass();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(WSBatch, server, ripple);
+BEAST_DEFINE_TESTSUITE_MANUAL(WSBatchBenchmark, server, ripple);
+
+}  // namespace test
+}  // namespace ripple